@@ -14,6 +14,7 @@ namespace gl {
 
     void EditorApplication::onCreate() {
         Application::onCreate();
+        if (!mDevice) return;
 
         info("onCreate()");
 
@@ -111,49 +112,65 @@ namespace gl {
         mHuman.addComponent<Draggable>(onEntityDragged);
         mHuman.addComponent<Shadowable>();
 
+        // models, geometry and textures are prepared on worker threads and uploaded by ResourceLoader
+        // within its frame budget, meshes are drawn as placeholder cubes and materials use their factors until then
+
         // setup 3D model
-        mBackpackModel.generate("Assets/models/backpack/backpack.obj");
-        mBackpackModel.init(*mBackpack.getComponent<DrawableElements>());
+        ResourceLoader::initPlaceholder(*mBackpack.drawable());
+        mBackpackModel = ResourceLoader::loadModel<Model>("Assets/models/backpack/backpack.obj", [this](Model& model) {
+            model.quantized = true;
+            mBackpack.drawable()->free();
+            model.init(*mBackpack.drawable());
+            mBackpack.addComponent<MeshLod>(model.lods, model.bounds);
+            mBackpack.addComponent<TextureStreaming>(model.bounds, model.surfaceArea());
+        });
 //        model_shadow.init(model);
-        mBackpack.material()->load(
-                true,
-                "Assets/models/backpack/diffuse.jpg",
-                "Assets/models/backpack/normal.png",
-                null,
-                "Assets/models/backpack/specular.jpg",
-                "Assets/models/backpack/roughness.jpg",
-                "Assets/models/backpack/ao.jpg"
+        ResourceLoader::loadMaterial(
+                {
+                    "Assets/models/backpack/diffuse.jpg",
+                    "Assets/models/backpack/normal.png",
+                    {},
+                    "Assets/models/backpack/specular.jpg",
+                    "Assets/models/backpack/roughness.jpg",
+                    "Assets/models/backpack/ao.jpg",
+                    {},
+                    true
+                },
+                [this](Material& material) { mBackpack.material()->setTextures(material); }
         );
         mBackpack.material()->metallicFactor = 1;
         mBackpack.material()->roughnessFactor = 0.5;
         mBackpack.material()->aoFactor = 1;
 
         // setup mHuman model
-        mHumanModel.generate("Assets/models/dancing-stormtrooper/source/silly_dancing.fbx");
-        mHumanModel.init(*mHuman.getComponent<DrawableElements>());
-        mHuman.material()->load(
-                false,
-                "Assets/models/dancing-stormtrooper/textures/Stormtrooper_D.png",
-                null,
-                null,
-                null,
-                null,
-                null
+        ResourceLoader::initPlaceholder(*mHuman.drawable());
+        mHumanModel = ResourceLoader::loadModel<SkeletalModel>("Assets/models/dancing-stormtrooper/source/silly_dancing.fbx", [this](SkeletalModel& model) {
+            model.quantized = true;
+            mHuman.drawable()->free();
+            model.init(*mHuman.drawable());
+            mHuman.addComponent<MeshLod>(model.lods, model.bounds);
+            mHuman.addComponent<TextureStreaming>(model.bounds, model.surfaceArea());
+            mHumanAnimator = Animator(&model.animation);
+        });
+        ResourceLoader::loadMaterial(
+                { "Assets/models/dancing-stormtrooper/textures/Stormtrooper_D.png" },
+                [this](Material& material) { mHuman.material()->setTextures(material); }
         );
         mHuman.material()->metallicFactor = 0.8;
         mHuman.material()->roughnessFactor = 0.2;
         mHuman.material()->aoFactor = 1.0;
-        mHumanAnimator = Animator(&mHumanModel.animation);
 
         // setup horizontal plane
-        mTerrainBuilder.terrain.material.load(
-                false,
-                null,
-                "Assets/images/bumpy-rockface1-bl/normal.png",
-                null,
-                "Assets/images/bumpy-rockface1-bl/metallic.png",
-                "Assets/images/bumpy-rockface1-bl/roughness.png",
-                "Assets/images/bumpy-rockface1-bl/ao.png"
+        ResourceLoader::loadMaterial(
+                {
+                    {},
+                    "Assets/images/bumpy-rockface1-bl/normal.png",
+                    {},
+                    "Assets/images/bumpy-rockface1-bl/metallic.png",
+                    "Assets/images/bumpy-rockface1-bl/roughness.png",
+                    "Assets/images/bumpy-rockface1-bl/ao.png"
+                },
+                [this](Material& material) { mTerrainBuilder.terrain.material.setTextures(material); }
         );
         mTerrainBuilder.terrain.material.color = { 1, 1, 1, 1 };
         mTerrainBuilder.terrain.material.metallicFactor = 1;
@@ -161,94 +178,131 @@ namespace gl {
         mTerrainBuilder.terrain.material.aoFactor = 1;
 
         // setup sphere
-        SphereTBN sphere_geometry = { 64, 64 };
-        sphere_geometry.init(*mWoodSphere.getComponent<DrawableElements>());
-        sphere_geometry.init(*mMetalSphere.getComponent<DrawableElements>());
+        ResourceLoader::initPlaceholder(*mWoodSphere.drawable());
+        ResourceLoader::initPlaceholder(*mMetalSphere.drawable());
+        ResourceLoader::submit<SphereTBN>(ThreadPool::submit([]() {
+            SphereTBN sphere_geometry = { 64, 64 };
+            MeshSimplifier::generateLods(sphere_geometry.vertices, sphere_geometry.indices, sphere_geometry.lods);
+            return sphere_geometry;
+        }), [this](SphereTBN& sphere_geometry) {
+            mWoodSphere.drawable()->free();
+            mMetalSphere.drawable()->free();
+            sphere_geometry.init(*mWoodSphere.drawable());
+            sphere_geometry.init(*mMetalSphere.drawable());
+            mWoodSphere.addComponent<MeshLod>(sphere_geometry.lodLevels(), sphere_geometry.bounds());
+            mMetalSphere.addComponent<MeshLod>(sphere_geometry.lodLevels(), sphere_geometry.bounds());
+            mWoodSphere.addComponent<TextureStreaming>(sphere_geometry.bounds(), sphere_geometry.surfaceArea());
+            mMetalSphere.addComponent<TextureStreaming>(sphere_geometry.bounds(), sphere_geometry.surfaceArea());
+            MeshletMesh meshlets;
+            MeshletBuilder::build(meshlets, sphere_geometry);
+            mWoodSphere.addComponent<MeshletCulling>(meshlets);
+            mMetalSphere.addComponent<MeshletCulling>(meshlets);
+            size_t bytes = sphere_geometry.vertices.size() + sphere_geometry.indices.size();
+            sphere_geometry.free();
+            return bytes * 2;
+        });
 //        SphereTBN sphere_shadow_geometry;
 //        sphere_shadow_geometry.init_default();
         // setup rock sphere
-        mRockSphereGeometry.init(*mRockSphere.getComponent<DrawableElements>());
+        ResourceLoader::initPlaceholder(*mRockSphere.drawable());
+        ResourceLoader::submit<Image>(ThreadPool::submit([this]() {
+            MeshSimplifier::generateLods(mRockSphereGeometry.vertices, mRockSphereGeometry.indices, mRockSphereGeometry.lods);
+            Image rock_height_map = ImageReader::read("Assets/images/columned_lava/height.png");
+            rock_height_map.resize(mRockSphereGeometry.xSegments + 1, mRockSphereGeometry.ySegments + 1);
+            return rock_height_map;
+        }), [this](Image& rock_height_map) {
+            mRockSphere.drawable()->free();
+            mRockSphereGeometry.init(*mRockSphere.drawable());
+            mRockSphere.addComponent<MeshLod>(mRockSphereGeometry.lodLevels(), mRockSphereGeometry.bounds());
+            mRockSphere.addComponent<TextureStreaming>(mRockSphereGeometry.bounds(), mRockSphereGeometry.surfaceArea());
+
+            // displace rock sphere
+            mRockSphere.addComponent<DisplacementTBN>();
+            auto* rock_sphere_displacement = mRockSphere.getComponent<DisplacementTBN>();
+            rock_sphere_displacement->setOriginVertices(&mRockSphereGeometry.vertices);
+            rock_sphere_displacement->scale = 0.1f;
+            rock_sphere_displacement->map = HeightMap(rock_height_map);
+            rock_sphere_displacement->displace(*mRockSphere.drawable());
+
+            rock_height_map.free();
+            return mRockSphereGeometry.vertices.size() + mRockSphereGeometry.indices.size();
+        });
 //        sphere_rock_shadow_geometry.x_segments = 2047;
 //        sphere_rock_shadow_geometry.y_segments = 2047;
 //        sphere_rock_shadow_geometry.init_default(sphere_rock_shadow);
 
         {
             mRockSphere.material()->color = {1, 1, 1, 1 };
-            mRockSphere.material()->load(
-                    false,
-                    "Assets/images/columned_lava/albedo.png",
-                    "Assets/images/columned_lava/normal.png",
-                    null,
-                    "Assets/images/columned_lava/metallic.png",
-                    "Assets/images/columned_lava/roughness.png",
-                    "Assets/images/columned_lava/ao.png",
-                    "Assets/images/columned_lava/emission.png"
+            ResourceLoader::loadMaterial(
+                    {
+                        "Assets/images/columned_lava/albedo.png",
+                        "Assets/images/columned_lava/normal.png",
+                        {},
+                        "Assets/images/columned_lava/metallic.png",
+                        "Assets/images/columned_lava/roughness.png",
+                        "Assets/images/columned_lava/ao.png",
+                        "Assets/images/columned_lava/emission.png"
+                    },
+                    [this](Material& material) { mRockSphere.material()->setTextures(material); }
             );
             mRockSphere.material()->metallicFactor = 1;
             mRockSphere.material()->roughnessFactor = 1;
             mRockSphere.material()->aoFactor = 1;
             mRockSphere.material()->emissionFactor = { 1, 1, 1 };
 
-            // displacement
+            // displace terrain
             {
-                // displace rock sphere
-                Image rock_height_map = ImageReader::read("Assets/images/columned_lava/height.png");
-                rock_height_map.resize(mRockSphereGeometry.xSegments + 1, mRockSphereGeometry.ySegments + 1);
-
-                mRockSphere.addComponent<DisplacementTBN>();
-                auto* rock_sphere_displacement = mRockSphere.getComponent<DisplacementTBN>();
-                rock_sphere_displacement->setOriginVertices(&mRockSphereGeometry.vertices);
-                rock_sphere_displacement->scale = 0.1f;
-                rock_sphere_displacement->map = HeightMap(rock_height_map);
-                rock_sphere_displacement->displace(*mRockSphere.getComponent<DrawableElements>());
-
-                rock_height_map.free();
-
-                // displace terrain
-                Image terrain_height_map = ImageReader::read("Assets/images/terrain/earth_heightmap.png");
-                terrain_height_map.resize(mTerrainBuilder.size(), mTerrainBuilder.size());
-
                 mTerrainBuilder.displaceWith(MidPointFormation(mTerrainBuilder.size(), mTerrainBuilder.size(), 10, 0, 1), 1);
                 mImageMixer.displacementMap = &mTerrainBuilder.displacement.map;
-                mImageMixer.addImage({-1.0, -0.5, 0 }, "Assets/images/terrain/rock_tile.png");
-                mImageMixer.addImage({0, 0.1, 0.2 }, "Assets/images/terrain/sand_tile.jpg");
-                mImageMixer.addImage({0.20, 0.45, 0.70 }, "Assets/images/terrain/grass_tile.png");
-                mImageMixer.addImage({0.70, 0.77, 0.85 }, "Assets/images/terrain/rock_tile.png");
-                mImageMixer.addImage({0.85, 0.90, 1.0 }, "Assets/images/terrain/snow_tile.png");
-                mImageMixer.mix(mTerrainBuilder.size(), mTerrainBuilder.size());
-                ImageWriter::write("Assets/images/terrain/mixed_image.png", mImageMixer.mixedImage);
-
-                terrain_height_map.free();
-
-                ImageParams params;
-                params.minFilter = GL_LINEAR_MIPMAP_LINEAR;
-                mTerrainBuilder.terrain.material.albedo.init();
-                mTerrainBuilder.terrain.material.albedo.load(mImageMixer.mixedImage, params);
-                mTerrainBuilder.terrain.material.enableAlbedo = mTerrainBuilder.terrain.material.albedo.id != InvalidImageBuffer;
+
+                ResourceLoader::submit<bool>(ThreadPool::submit([this]() {
+                    mImageMixer.addImage({-1.0, -0.5, 0 }, "Assets/images/terrain/rock_tile.png");
+                    mImageMixer.addImage({0, 0.1, 0.2 }, "Assets/images/terrain/sand_tile.jpg");
+                    mImageMixer.addImage({0.20, 0.45, 0.70 }, "Assets/images/terrain/grass_tile.png");
+                    mImageMixer.addImage({0.70, 0.77, 0.85 }, "Assets/images/terrain/rock_tile.png");
+                    mImageMixer.addImage({0.85, 0.90, 1.0 }, "Assets/images/terrain/snow_tile.png");
+                    mImageMixer.mix(mTerrainBuilder.size(), mTerrainBuilder.size());
+                    ImageWriter::write("Assets/images/terrain/mixed_image.png", mImageMixer.mixedImage);
+                    return mImageMixer.mixedImage.pixels != null;
+                }), [this](bool& mixed) {
+                    if (!mixed) {
+                        return (size_t) 0;
+                    }
+
+                    ImageParams params;
+                    params.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+                    mTerrainBuilder.terrain.material.albedo.init();
+                    mTerrainBuilder.terrain.material.albedo.load(mImageMixer.mixedImage, params);
+                    mTerrainBuilder.terrain.material.enableAlbedo = mTerrainBuilder.terrain.material.albedo.id != InvalidImageBuffer;
+                    return mImageMixer.mixedImage.size();
+                });
             }
 
-            mWoodSphere.material()->load(
-                    false,
-                    null,
-                    "Assets/images/cheap-plywood1-bl/normal.png",
-                    null,
-                    "Assets/images/cheap-plywood1-bl/metallic.png",
-                    "Assets/images/cheap-plywood1-bl/roughness.png",
-                    "Assets/images/cheap-plywood1-bl/ao.png"
+            ResourceLoader::loadMaterial(
+                    {
+                        {},
+                        "Assets/images/cheap-plywood1-bl/normal.png",
+                        {},
+                        "Assets/images/cheap-plywood1-bl/metallic.png",
+                        "Assets/images/cheap-plywood1-bl/roughness.png",
+                        "Assets/images/cheap-plywood1-bl/ao.png"
+                    },
+                    [this](Material& material) { mWoodSphere.material()->setTextures(material); }
             );
             mWoodSphere.material()->color = { 1, 1, 1, 0.5 };
             mWoodSphere.material()->metallicFactor = 1;
             mWoodSphere.material()->roughnessFactor = 1;
             mWoodSphere.material()->aoFactor = 1;
 
-            mMetalSphere.material()->load(
-                    false,
-                    "Assets/images/light-gold-bl/albedo.png",
-                    "Assets/images/light-gold-bl/normal.png",
-                    null,
-                    "Assets/images/light-gold-bl/metallic.png",
-                    "Assets/images/light-gold-bl/roughness.png",
-                    null
+            ResourceLoader::loadMaterial(
+                    {
+                        "Assets/images/light-gold-bl/albedo.png",
+                        "Assets/images/light-gold-bl/normal.png",
+                        {},
+                        "Assets/images/light-gold-bl/metallic.png",
+                        "Assets/images/light-gold-bl/roughness.png"
+                    },
+                    [this](Material& material) { mMetalSphere.material()->setTextures(material); }
             );
             mMetalSphere.material()->metallicFactor = 1;
             mMetalSphere.material()->roughnessFactor = 1;
@@ -267,13 +321,13 @@ namespace gl {
         mEnvironment->enable = true;
         mEnvironment->resolution = { 1024, 1024 };
         mEnvironment->prefilterResolution = { 512, 512 };
-        mEnvironment->hdr.loadHDR("Assets/images/hdr/Arches_E_PineTree_3k.hdr", true);
+        mEnvironment->setHDR("Assets/images/hdr/Arches_E_PineTree_3k.hdr", true);
         mEnvironment->init();
         setEnvironment(mEnvironment);
     }
 
     void EditorApplication::initCamera() {
-        mCamera = new Camera(0, mWindow);
+        mCamera = mWindow ? new Camera(0, mWindow) : new Camera(0, mWidth, mHeight);
         mCamera->zFar = 1000.0f;
         mCamera->position = {-5, 2, 10 };
         setCamera(mCamera);
@@ -320,6 +374,11 @@ namespace gl {
     }
 
     void EditorApplication::onDestroy() {
+        if (!mDevice) {
+            Application::onDestroy();
+            return;
+        }
+
         info("onDestroy()");
 
         mWoodSphere.free();
@@ -339,12 +398,16 @@ namespace gl {
         mBackpack.free();
         mBackpack.material()->free();
         mBackpack.drawable()->free();
-        mBackpackModel.free();
+        if (mBackpackModel.isReady()) {
+            mBackpackModel->free();
+        }
 
         mHuman.free();
         mHuman.material()->free();
         mHuman.drawable()->free();
-        mHumanModel.free();
+        if (mHumanModel.isReady()) {
+            mHumanModel->free();
+        }
 
         delete mCamera;
 
@@ -410,6 +473,7 @@ namespace gl {
         PropertiesWindow::render();
         EntityWindow::render();
         ComponentWindow::render();
+        ProfilerWindow::render();
     }
 
     void EditorApplication::onKeyPress(const KEY key) {
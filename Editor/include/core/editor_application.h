@@ -44,7 +44,7 @@ namespace gl {
     private:
         LightVisual mPointLightVisual;
 
-        Model mBackpackModel;
+        ModelHandle mBackpackModel;
         PBR_Entity mBackpack;
 
         Ray mRay = { 0, 0, 0 };
@@ -58,7 +58,7 @@ namespace gl {
         Font* mFontRobotoRegular = null;
 
         Animator mHumanAnimator;
-        SkeletalModel mHumanModel;
+        SkeletalModelHandle mHumanModel;
         PBR_Entity mHuman;
 
         SphereTBN mRockSphereGeometry = {256, 256 };
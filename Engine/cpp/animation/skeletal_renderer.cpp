@@ -1,5 +1,7 @@
 #include <animation/skeletal_renderer.h>
 
+#include <features/draw_storage.h>
+
 namespace gl {
 
     void SkeletalRenderer::use() {
@@ -17,12 +19,16 @@ namespace gl {
     }
 
     void SkeletalRenderer::render(Transform& transform, DrawableElements& drawable) {
-        transform.update(mShader);
+        u32 index = DrawStorage::push(transform, drawable);
+        if (index == InvalidDrawIndex) return;
+        DrawStorage::bind(mShader, index);
         drawable.draw();
     }
 
     void SkeletalRenderer::render(Transform& transform, DrawableElements& drawable, Material& material) {
-        transform.update(mShader);
+        u32 index = DrawStorage::push(transform, drawable, material);
+        if (index == InvalidDrawIndex) return;
+        DrawStorage::bind(mShader, index);
         material.update(mShader, 0);
         drawable.draw();
     }
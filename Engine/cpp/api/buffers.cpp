@@ -1,4 +1,5 @@
 #include <api/buffers.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -7,11 +8,11 @@ namespace gl {
     }
 
     void VertexArray::free() {
-        glDeleteVertexArrays(1, &id);
+        StateCache::deleteVertexArray(id);
     }
 
     void VertexArray::bind() const {
-        glBindVertexArray(id);
+        StateCache::bindVertexArray(id);
     }
 
     void VertexBuffer::init() {
@@ -38,13 +39,31 @@ namespace gl {
         size_t offset = 0;
         size_t stride = format.stride;
         for (auto& attribute : format.attrs) {
-            glVertexAttribPointer(
-                    attribute.location, attribute.primitiveType,
-                    GL_FLOAT, GL_FALSE,
-                    stride, (void*) offset
-            );
+            switch (attribute.type) {
+                case ATTRIBUTE_U8:
+                    glVertexAttribIPointer(attribute.location, attribute.primitiveType, GL_UNSIGNED_BYTE, stride, (void*) offset);
+                    break;
+                case ATTRIBUTE_I32:
+                    glVertexAttribIPointer(attribute.location, attribute.primitiveType, GL_INT, stride, (void*) offset);
+                    break;
+                case ATTRIBUTE_F16:
+                    glVertexAttribPointer(attribute.location, attribute.primitiveType, GL_HALF_FLOAT, GL_FALSE, stride, (void*) offset);
+                    break;
+                case ATTRIBUTE_UNORM16:
+                    glVertexAttribPointer(attribute.location, attribute.primitiveType, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*) offset);
+                    break;
+                case ATTRIBUTE_SNORM16:
+                    glVertexAttribPointer(attribute.location, attribute.primitiveType, GL_SHORT, GL_TRUE, stride, (void*) offset);
+                    break;
+                case ATTRIBUTE_UNORM8:
+                    glVertexAttribPointer(attribute.location, attribute.primitiveType, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*) offset);
+                    break;
+                default:
+                    glVertexAttribPointer(attribute.location, attribute.primitiveType, GL_FLOAT, GL_FALSE, stride, (void*) offset);
+                    break;
+            }
             glEnableVertexAttribArray(attribute.location);
-            offset += attribute.primitiveType * sizeof(float);
+            offset += attribute.size();
         }
     }
 
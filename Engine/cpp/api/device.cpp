@@ -8,10 +8,10 @@ namespace gl {
 
     Device* Device::sInstance = null;
 
-    Device::Device(int width, int height) {
+    Device::Device(int width, int height, void* (*loader)(const char* name)) {
         sInstance = this;
 
-        int status = gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+        int status = gladLoadGLLoader(loader ? (GLADloadproc) loader : (GLADloadproc) glfwGetProcAddress);
         if (status == GLFW_FALSE) {
             error("Failed to initialize GLAD");
             assert(false);
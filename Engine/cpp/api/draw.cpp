@@ -18,31 +18,78 @@ namespace gl {
     }
 
     void DrawableElements::free() {
+        if (mesh != InvalidMesh) {
+            GeometryPool::free(mesh);
+            mesh = InvalidMesh;
+            return;
+        }
         vao.free();
         vbo.free();
         ibo.free();
     }
 
     void DrawableElements::draw() const {
+        if (mesh != InvalidMesh) {
+            const PooledMesh& pooled = GeometryPool::getMesh(mesh);
+            GeometryPool::bind(pooled.pool);
+            for (u32 strip = 0; strip < strips; strip++)
+            {
+                glDrawElementsBaseVertex(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * (pooled.firstIndex() + indexOffset + verticesPerStrip * strip)), pooled.baseVertex());
+            }
+            return;
+        }
+
         vao.bind();
         ibo.bind();
         // draws with either triangles or triangle strips
         for (u32 strip = 0; strip < strips; strip++)
         {
-            glDrawElements(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * verticesPerStrip * strip));
+            glDrawElements(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * (indexOffset + verticesPerStrip * strip)));
         }
     }
 
     void DrawableElements::draw(int instances) const {
+        if (mesh != InvalidMesh) {
+            const PooledMesh& pooled = GeometryPool::getMesh(mesh);
+            GeometryPool::bind(pooled.pool);
+            for (u32 strip = 0; strip < strips; strip++)
+            {
+                glDrawElementsInstancedBaseVertex(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * (pooled.firstIndex() + indexOffset + verticesPerStrip * strip)), instances, pooled.baseVertex());
+            }
+            return;
+        }
+
         vao.bind();
         ibo.bind();
         // draws with either triangles or triangle strips
         for (u32 strip = 0; strip < strips; strip++)
         {
-            glDrawElementsInstanced(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * verticesPerStrip * strip), instances);
+            glDrawElementsInstanced(type, verticesPerStrip, GL_UNSIGNED_INT, (void*)(sizeof(u32) * (indexOffset + verticesPerStrip * strip)), instances);
         }
     }
 
+    void DrawIndirectBuffer::init() {
+        glGenBuffers(1, &id);
+    }
+
+    void DrawIndirectBuffer::free() {
+        glDeleteBuffers(1, &id);
+        id = 0;
+    }
+
+    void DrawIndirectBuffer::update(const std::vector<DrawElementsIndirectCommand>& commands) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, id);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void DrawIndirectBuffer::draw(DrawType type, u32 pool, u32 first, u32 count) const {
+        GeometryPool::bind(pool);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, id);
+        glMultiDrawElementsIndirect(type, GL_UNSIGNED_INT, (void*)(sizeof(DrawElementsIndirectCommand) * first), count, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
     void DrawableQuad::init() {
         vao.init();
     }
@@ -1,4 +1,5 @@
 #include <api/frame.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -62,19 +63,19 @@ namespace gl {
     }
 
     void FrameBuffer::bind() const {
-        glBindFramebuffer(GL_FRAMEBUFFER, id);
+        StateCache::bindFramebuffer(GL_FRAMEBUFFER, id);
     }
 
     void FrameBuffer::bindWriting() const {
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id);
+        StateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, id);
     }
 
     void FrameBuffer::bindReading() const {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, id);
+        StateCache::bindFramebuffer(GL_READ_FRAMEBUFFER, id);
     }
 
     void FrameBuffer::unbind() {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        StateCache::bindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     void FrameBuffer::free() {
@@ -82,7 +83,7 @@ namespace gl {
         depth.free();
         depthStencil.free();
         rbo.free();
-        glDeleteFramebuffers(1, &id);
+        StateCache::deleteFramebuffer(id);
     }
 
     void FrameBuffer::clearColorBuffers() const {
@@ -125,8 +126,8 @@ namespace gl {
             u32 out_fbo, int out_w, int out_h,
             int buffers_size, int buffer_bit, int filter
     ) {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, in_fbo);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, out_fbo);
+        StateCache::bindFramebuffer(GL_READ_FRAMEBUFFER, in_fbo);
+        StateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, out_fbo);
         u32* buffers = (u32*) calloc(buffers_size, sizeof(u32));
         for (int i = 0 ; i < buffers_size ; i++) {
             buffers[i] = GL_COLOR_ATTACHMENT0 + i;
@@ -144,8 +145,8 @@ namespace gl {
     ) {
         u32 read_buffer = GL_COLOR_ATTACHMENT0 + in_attachment;
         u32 draw_buffer = GL_COLOR_ATTACHMENT0 + out_attachment;
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, in_fbo);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, out_fbo);
+        StateCache::bindFramebuffer(GL_READ_FRAMEBUFFER, in_fbo);
+        StateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, out_fbo);
         glReadBuffer(read_buffer);
         glDrawBuffer(draw_buffer);
         glBlitFramebuffer(0, 0, in_w, in_h, 0, 0, out_w, out_h, GL_COLOR_BUFFER_BIT, filter);
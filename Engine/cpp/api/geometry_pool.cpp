@@ -0,0 +1,285 @@
+#include <api/geometry_pool.h>
+#include <api/state_cache.h>
+
+namespace gl {
+
+    u32 GeometryPool::s_vertexCapacity = 0;
+    std::vector<GeometryPool::VertexPool> GeometryPool::s_pools;
+    u32 GeometryPool::s_indexBuffer = 0;
+    OffsetAllocator GeometryPool::s_indexAllocator;
+    std::vector<PooledMesh> GeometryPool::s_meshes;
+    std::vector<u32> GeometryPool::s_freeMeshes;
+
+    void GeometryPool::init(u32 vertexCapacity, u32 indexCapacity) {
+        s_vertexCapacity = vertexCapacity;
+        s_indexBuffer = createBuffer((size_t) indexCapacity * sizeof(u32));
+        s_indexAllocator.init(indexCapacity);
+    }
+
+    void GeometryPool::free() {
+        for (auto& pool : s_pools) {
+            pool.vao.free();
+            glDeleteBuffers(1, &pool.buffer);
+            pool.allocator.free();
+        }
+        s_pools.clear();
+
+        glDeleteBuffers(1, &s_indexBuffer);
+        s_indexBuffer = 0;
+        s_indexAllocator.free();
+
+        s_meshes.clear();
+        s_freeMeshes.clear();
+    }
+
+    u32 GeometryPool::createBuffer(size_t size) {
+        u32 buffer;
+        glGenBuffers(1, &buffer);
+        // copy target, so that element buffer binding of bound vertex array isn't touched
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, size, null, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return buffer;
+    }
+
+    void GeometryPool::copyBuffer(u32 src, size_t srcOffset, u32 dst, size_t dstOffset, size_t size) {
+        glBindBuffer(GL_COPY_READ_BUFFER, src);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, dst);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, size);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void GeometryPool::attach(VertexPool& pool) {
+        pool.vao.bind();
+        glBindBuffer(GL_ARRAY_BUFFER, pool.buffer);
+        VertexBuffer::setFormat(*pool.format);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_indexBuffer);
+        StateCache::bindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    u32 GeometryPool::getPool(const VertexFormat& format) {
+        for (u32 i = 0 ; i < s_pools.size() ; i++) {
+            if (s_pools[i].format == &format) {
+                return i;
+            }
+        }
+
+        VertexPool pool;
+        pool.format = &format;
+        pool.vao.init();
+        pool.buffer = createBuffer((size_t) s_vertexCapacity * format.stride);
+        pool.allocator.init(s_vertexCapacity);
+        attach(pool);
+        s_pools.emplace_back(std::move(pool));
+        return s_pools.size() - 1;
+    }
+
+    bool GeometryPool::growVertices(VertexPool& pool, u32 vertexCount) {
+        u64 size = pool.allocator.getSize();
+        u64 capacity = std::max<u64>(size * 2, size + vertexCount);
+        if (capacity > 0xFFFFFFFF) {
+            return false;
+        }
+
+        u32 buffer = createBuffer(capacity * pool.format->stride);
+        copyBuffer(pool.buffer, 0, buffer, 0, size * pool.format->stride);
+        glDeleteBuffers(1, &pool.buffer);
+        pool.buffer = buffer;
+        pool.allocator.grow(capacity);
+        attach(pool);
+        return true;
+    }
+
+    bool GeometryPool::growIndices(u32 indexCount) {
+        u64 size = s_indexAllocator.getSize();
+        u64 capacity = std::max<u64>(size * 2, size + indexCount);
+        if (capacity > 0xFFFFFFFF) {
+            return false;
+        }
+
+        u32 buffer = createBuffer(capacity * sizeof(u32));
+        copyBuffer(s_indexBuffer, 0, buffer, 0, size * sizeof(u32));
+        glDeleteBuffers(1, &s_indexBuffer);
+        s_indexBuffer = buffer;
+        s_indexAllocator.grow(capacity);
+        for (auto& pool : s_pools) {
+            attach(pool);
+        }
+        return true;
+    }
+
+    u32 GeometryPool::allocate(const VertexFormat& format, u32 vertexCount, u32 indexCount) {
+        if (vertexCount == 0 || indexCount == 0) {
+            return InvalidMesh;
+        }
+
+        PooledMesh mesh;
+        mesh.pool = getPool(format);
+        mesh.vertexCount = vertexCount;
+        mesh.indexCount = indexCount;
+
+        VertexPool& pool = s_pools[mesh.pool];
+        mesh.vertices = pool.allocator.allocate(vertexCount);
+        if (!mesh.vertices.isValid() && isFragmented(pool.allocator, vertexCount)) {
+            defragmentVertices(mesh.pool);
+            mesh.vertices = pool.allocator.allocate(vertexCount);
+        }
+        if (!mesh.vertices.isValid()) {
+            if (!growVertices(pool, vertexCount)) {
+                error("GeometryPool: failed to allocate {0} vertices", vertexCount);
+                return InvalidMesh;
+            }
+            mesh.vertices = pool.allocator.allocate(vertexCount);
+        }
+
+        mesh.indices = s_indexAllocator.allocate(indexCount);
+        if (!mesh.indices.isValid() && isFragmented(s_indexAllocator, indexCount)) {
+            // vertices of new mesh aren't in s_meshes yet, but only index buffer is packed
+            defragmentIndices();
+            mesh.indices = s_indexAllocator.allocate(indexCount);
+        }
+        if (!mesh.indices.isValid()) {
+            if (!growIndices(indexCount)) {
+                error("GeometryPool: failed to allocate {0} indices", indexCount);
+                pool.allocator.free(mesh.vertices);
+                return InvalidMesh;
+            }
+            mesh.indices = s_indexAllocator.allocate(indexCount);
+        }
+
+        u32 handle;
+        if (s_freeMeshes.empty()) {
+            handle = s_meshes.size();
+            s_meshes.emplace_back(mesh);
+        } else {
+            handle = s_freeMeshes.back();
+            s_freeMeshes.pop_back();
+            s_meshes[handle] = mesh;
+        }
+        return handle;
+    }
+
+    void GeometryPool::free(u32 mesh) {
+        if (mesh >= s_meshes.size() || !s_meshes[mesh].vertices.isValid()) {
+            return;
+        }
+
+        PooledMesh& pooled = s_meshes[mesh];
+        s_pools[pooled.pool].allocator.free(pooled.vertices);
+        s_indexAllocator.free(pooled.indices);
+        pooled = {};
+        s_freeMeshes.emplace_back(mesh);
+    }
+
+    void GeometryPool::uploadVertices(u32 mesh, u32 first, u32 count, const void* vertices) {
+        const PooledMesh& pooled = s_meshes[mesh];
+        const VertexPool& pool = s_pools[pooled.pool];
+        size_t stride = pool.format->stride;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool.buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (pooled.vertices.offset + first) * stride, count * stride, vertices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void GeometryPool::uploadIndices(u32 mesh, u32 first, u32 count, const u32* indices) {
+        const PooledMesh& pooled = s_meshes[mesh];
+        glBindBuffer(GL_COPY_WRITE_BUFFER, s_indexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (pooled.indices.offset + first) * sizeof(u32), count * sizeof(u32), indices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    const PooledMesh& GeometryPool::getMesh(u32 mesh) {
+        return s_meshes[mesh];
+    }
+
+    u32 GeometryPool::getVertexArray(u32 pool) {
+        return s_pools[pool].vao.id;
+    }
+
+    void GeometryPool::bind(u32 pool) {
+        s_pools[pool].vao.bind();
+    }
+
+    void GeometryPool::defragment() {
+        for (u32 p = 0 ; p < s_pools.size() ; p++) {
+            defragmentVertices(p);
+        }
+        defragmentIndices();
+        info("GeometryPool: defragmented {0} meshes", s_meshes.size() - s_freeMeshes.size());
+    }
+
+    bool GeometryPool::isFragmented(const OffsetAllocator& allocator, u32 count) {
+        // free space is enough, but scattered over holes. nearly full buffer grows anyway, as packing it would be repeated soon
+        u32 freeSize = allocator.getFreeSize();
+        return freeSize >= count && freeSize >= allocator.getSize() / DEFRAGMENT_FREE_DIVISOR;
+    }
+
+    std::vector<u32> GeometryPool::getMeshOrder(bool byVertices) {
+        std::vector<u32> order;
+        for (u32 i = 0 ; i < s_meshes.size() ; i++) {
+            if (s_meshes[i].vertices.isValid()) {
+                order.emplace_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [byVertices](u32 left, u32 right) {
+            return byVertices
+            ? s_meshes[left].vertices.offset < s_meshes[right].vertices.offset
+            : s_meshes[left].indices.offset < s_meshes[right].indices.offset;
+        });
+        return order;
+    }
+
+    void GeometryPool::defragmentVertices(u32 p) {
+        VertexPool& pool = s_pools[p];
+        size_t stride = pool.format->stride;
+        u32 size = pool.allocator.getSize();
+
+        u32 buffer = createBuffer((size_t) size * stride);
+        pool.allocator.init(size);
+        for (u32 i : getMeshOrder(true)) {
+            PooledMesh& mesh = s_meshes[i];
+            if (mesh.pool != p) {
+                continue;
+            }
+            OffsetAllocation vertices = pool.allocator.allocate(mesh.vertexCount);
+            copyBuffer(pool.buffer, (size_t) mesh.vertices.offset * stride, buffer, (size_t) vertices.offset * stride, (size_t) mesh.vertexCount * stride);
+            mesh.vertices = vertices;
+        }
+        glDeleteBuffers(1, &pool.buffer);
+        pool.buffer = buffer;
+        attach(pool);
+    }
+
+    void GeometryPool::defragmentIndices() {
+        u32 size = s_indexAllocator.getSize();
+        u32 buffer = createBuffer((size_t) size * sizeof(u32));
+        s_indexAllocator.init(size);
+        for (u32 i : getMeshOrder(false)) {
+            PooledMesh& mesh = s_meshes[i];
+            OffsetAllocation indices = s_indexAllocator.allocate(mesh.indexCount);
+            copyBuffer(s_indexBuffer, (size_t) mesh.indices.offset * sizeof(u32), buffer, (size_t) indices.offset * sizeof(u32), (size_t) mesh.indexCount * sizeof(u32));
+            mesh.indices = indices;
+        }
+        glDeleteBuffers(1, &s_indexBuffer);
+        s_indexBuffer = buffer;
+
+        for (auto& pool : s_pools) {
+            attach(pool);
+        }
+    }
+
+    GeometryPoolStats GeometryPool::getStats() {
+        GeometryPoolStats stats;
+        stats.pools = s_pools.size();
+        stats.meshes = s_meshes.size() - s_freeMeshes.size();
+        for (auto& pool : s_pools) {
+            stats.vertexBytes += (size_t) pool.allocator.getSize() * pool.format->stride;
+            stats.freeVertexBytes += (size_t) pool.allocator.getFreeSize() * pool.format->stride;
+        }
+        stats.indexBytes = (size_t) s_indexAllocator.getSize() * sizeof(u32);
+        stats.freeIndexBytes = (size_t) s_indexAllocator.getFreeSize() * sizeof(u32);
+        return stats;
+    }
+
+}
@@ -1,10 +1,10 @@
 #include <api/image.h>
+#include <api/state_cache.h>
 #include <api/device.h>
+#include <api/image_kernels.h>
 
 #include <io/image_loader.h>
 
-#include <stb_image_resize.h>
-
 namespace gl {
 
     static int PIXEL_FORMATS[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA };
@@ -19,50 +19,22 @@ namespace gl {
         ::free(pixels);
     }
 
-    void Image::resize(int w, int h) {
-        if (width == w || height == h)
-            return;
-
-        void* resizedData;
-
-        if (pixelType == PixelType::U8) {
-            resizedData = malloc(width * height * sizeof(u8));
-            int status = stbir_resize_uint8((u8*) pixels, width, height, 0, (u8*) resizedData, w, h, 0, channels);
-            if (!status) {
-                error("Failed to resize 8-bit pixels [{0}, {1}]", w, h);
-                return;
-            }
-        }
-
-        else if (pixelType == PixelType::U16) {
-            // todo consider how to resize 16-bit pixels
-            resizedData = malloc(width * height * sizeof(u16));
-//            int status = stbir_resize_uint16_generic((u16*) data, width, height, 0, (u16*) resizedData, w, h, 0, channels);
-//            if (!status) {
-//                print_err("Image::resize: failed to resize 16-bit pixels [ " << width << " , " << height << "] -> [ , ] << w << ", height" << h);
-//                return;
-//            }
-        }
-
-        else if (pixelType == PixelType::FLOAT) {
-            resizedData = malloc(width * height * sizeof(float));
-            int status = stbir_resize_float((float*) pixels, width, height, 0, (float*) resizedData, w, h, 0, channels);
-            if (!status) {
-                error("Failed to resize 32-bit pixels [{0}, {1}]", w, h);
-                return;
-            }
-        }
+    bool Image::resize(int w, int h) {
+        if (width == w && height == h)
+            return true;
 
-        else {
-            error("Failed to resize unknown image type!");
-            return;
+        Image resized;
+        if (!ImageKernels::resize(*this, resized, w, h)) {
+            error("Failed to resize image [{0}, {1}] -> [{2}, {3}]", width, height, w, h);
+            return false;
         }
 
         free();
 
-        pixels = resizedData;
+        pixels = resized.pixels;
         width = w;
         height = h;
+        return true;
     }
 
     glm::vec4 Image::getColor(int x, int y) {
@@ -88,16 +60,39 @@ namespace gl {
         return width * height * channels;
     }
 
+    int CompressedImage::getInternalFormat() const {
+        switch (format) {
+            case BC3:
+                return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case BC5:
+                return GL_COMPRESSED_RG_RGTC2;
+            case BC7:
+                return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+            default:
+                return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+    }
+
+    size_t CompressedImage::size() const {
+        size_t bytes = 0;
+        for (auto& mip : mips) {
+            bytes += mip.data.size();
+        }
+        return bytes;
+    }
+
     void ImageBuffer::init() {
         glGenTextures(1, &id);
     }
 
     void ImageBuffer::free() {
-        glDeleteTextures(1, &id);
+        StateCache::deleteTexture(id);
     }
 
     void ImageBuffer::free(int size) {
-        glDeleteTextures(size, &id);
+        for (int i = 0 ; i < size ; i++) {
+            StateCache::deleteTexture((&id)[i]);
+        }
     }
 
     void ImageBuffer::initHandle() {
@@ -123,7 +118,7 @@ namespace gl {
     }
 
     void ImageBuffer::bind() const {
-        glBindTexture(type, id);
+        StateCache::bindTexture(type, id);
     }
 
     void ImageBuffer::bindActivate(int slot) const {
@@ -132,26 +127,25 @@ namespace gl {
     }
 
     void ImageBuffer::bind(u32 type, u32 id) {
-        glBindTexture(type, id);
+        StateCache::bindTexture(type, id);
     }
 
     void ImageBuffer::activate(int slot) {
-        glActiveTexture(GL_TEXTURE0 + slot);
+        StateCache::activeTexture(slot);
     }
 
     void ImageBuffer::bindActivate(u32 type, u32 id, int slot) {
-        activate(slot);
-        bind(type, id);
+        StateCache::bindTexture(slot, type, id);
     }
 
     void ImageBuffer::unbind() {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        StateCache::activeTexture(0);
+        StateCache::bindTexture(GL_TEXTURE_2D, 0);
     }
 
     void ImageBuffer::generateMipmaps(const ImageParams &params) {
         u32 textureType = type;
-        glBindTexture(textureType, id);
+        StateCache::bindTexture(textureType, id);
         glGenerateMipmap(textureType);
         glTexParameteri(textureType, GL_TEXTURE_MIN_FILTER, params.minFilter);
         glTexParameterf(textureType, GL_TEXTURE_LOD_BIAS, params.lodBias);
@@ -159,7 +153,7 @@ namespace gl {
         glTexParameterf(textureType, GL_TEXTURE_MAX_ANISOTROPY_EXT, Device::get().MAX_ANISOTROPY_SAMPLES);
     }
 
-    void ImageBuffer::updateParams(const ImageParams &params) {
+    void ImageBuffer::updateParams(const ImageParams &params, bool generate, bool bindless) {
         u32 textureType = type;
         int minFilter = params.minFilter;
 
@@ -168,7 +162,9 @@ namespace gl {
             || minFilter == GL_LINEAR_MIPMAP_NEAREST
             || minFilter == GL_LINEAR_MIPMAP_LINEAR
         ) {
-            glGenerateMipmap(textureType);
+            if (generate) {
+                glGenerateMipmap(textureType);
+            }
             glTexParameterf(textureType, GL_TEXTURE_LOD_BIAS, params.lodBias);
             glTexParameterf(textureType, GL_TEXTURE_BASE_LEVEL, params.baseLevel);
             glTexParameterf(textureType, GL_TEXTURE_MAX_ANISOTROPY_EXT, Device::get().MAX_ANISOTROPY_SAMPLES);
@@ -181,11 +177,13 @@ namespace gl {
         glTexParameteri(textureType, GL_TEXTURE_MIN_FILTER, minFilter);
         glTexParameteri(textureType, GL_TEXTURE_MAG_FILTER, params.magFilter);
 
-        initHandle();
+        if (bindless) {
+            initHandle();
+        }
     }
 
     void ImageBuffer::bindParams(const ImageParams &params) {
-        glBindTexture(type, id);
+        StateCache::bindTexture(type, id);
         updateParams(params);
     }
 
@@ -259,6 +257,43 @@ namespace gl {
         updateParams(params);
     }
 
+    void ImageBuffer::load(const CompressedImage& image, const ImageParams& params) {
+        bind();
+        int internalFormat = image.getInternalFormat();
+        for (int level = 0 ; level < image.mips.size() ; level++) {
+            auto& mip = image.mips[level];
+            glCompressedTexImage2D(
+                    type, level,
+                    internalFormat,
+                    mip.width, mip.height, 0,
+                    mip.data.size(), mip.data.data()
+            );
+        }
+        glTexParameteri(type, GL_TEXTURE_MAX_LEVEL, std::max((int) image.mips.size() - 1, 0));
+        updateParams(params, false);
+    }
+
+    void ImageBuffer::loadMip(const CompressedMip& mip, int level, int internalFormat) {
+        bind();
+        glCompressedTexImage2D(
+                type, level,
+                internalFormat,
+                mip.width, mip.height, 0,
+                mip.data.size(), mip.data.data()
+        );
+    }
+
+    void ImageBuffer::freeMip(int level, int internalFormat) {
+        bind();
+        glCompressedTexImage2D(type, level, internalFormat, 0, 0, 0, 0, null);
+    }
+
+    void ImageBuffer::setMipRange(int baseLevel, int maxLevel) {
+        bind();
+        glTexParameteri(type, GL_TEXTURE_BASE_LEVEL, baseLevel);
+        glTexParameteri(type, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    }
+
     void ImageBuffer::loadCubemap(const Image &image, const ImageParams& params) {
         bind();
         storeCubemap(image);
@@ -0,0 +1,546 @@
+#include <api/image_kernels.h>
+#include <core/thread_pool.h>
+
+namespace gl {
+
+    static size_t getChannelSize(PixelType pixelType) {
+        switch (pixelType) {
+            case PixelType::U16:
+                return sizeof(u16);
+            case PixelType::FLOAT:
+                return sizeof(float);
+            default:
+                return sizeof(u8);
+        }
+    }
+
+    static bool isSupported(const Image& image) {
+        if (!image.pixels || image.width <= 0 || image.height <= 0 || image.channels <= 0 || image.channels > 4) {
+            error("Image kernels: invalid image [{0}, {1}] with {2} channels", image.width, image.height, image.channels);
+            return false;
+        }
+
+        if (image.pixelType != PixelType::U8 && image.pixelType != PixelType::U16 && image.pixelType != PixelType::FLOAT) {
+            error("Image kernels: unsupported pixel type {0}", (u32) image.pixelType);
+            return false;
+        }
+
+        return true;
+    }
+
+    static void allocate(Image& image, int width, int height, int channels, PixelType pixelType, bool srgb) {
+        image.width = width;
+        image.height = height;
+        image.channels = channels;
+        image.pixelType = pixelType;
+        // sRGB internal formats exist only for RGB and RGBA
+        image.srgb = srgb && channels >= 3;
+        image.pixels = malloc((size_t) width * height * channels * getChannelSize(pixelType));
+        image.setFormat();
+    }
+
+    // alpha of RA and RGBA images is never gamma encoded
+    static int getColorChannels(int channels) {
+        return channels == 2 || channels == 4 ? channels - 1 : channels;
+    }
+
+    static float toLinear(float color) {
+        return color <= 0.04045f ? color / 12.92f : std::pow((color + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float toSrgb(float color) {
+        return color <= 0.0031308f ? color * 12.92f : 1.055f * std::pow(color, 1.0f / 2.4f) - 0.055f;
+    }
+
+    static const float* getSrgbToLinearTable() {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> result {};
+            for (int i = 0 ; i < 256 ; i++) {
+                result[i] = toLinear((float) i / 255.0f);
+            }
+            return result;
+        }();
+        return table.data();
+    }
+
+    static constexpr int LINEAR_TO_SRGB_SIZE = 4096;
+
+    static const u8* getLinearToSrgbTable() {
+        static const std::array<u8, LINEAR_TO_SRGB_SIZE> table = [] {
+            std::array<u8, LINEAR_TO_SRGB_SIZE> result {};
+            for (int i = 0 ; i < LINEAR_TO_SRGB_SIZE ; i++) {
+                result[i] = (u8) std::lround(toSrgb((float) i / (LINEAR_TO_SRGB_SIZE - 1)) * 255.0f);
+            }
+            return result;
+        }();
+        return table.data();
+    }
+
+    // row of image as floats, U8 and U16 are normalized into [0, 1]
+    static void loadRow(const Image& image, int y, float* row, bool linearize) {
+        int channels = image.channels;
+        int colorChannels = linearize ? getColorChannels(channels) : 0;
+        size_t count = (size_t) image.width * channels;
+
+        switch (image.pixelType) {
+            case PixelType::U8: {
+                const u8* src = (const u8*) image.pixels + (size_t) y * count;
+                for (size_t i = 0 ; i < count ; i++) {
+                    row[i] = (float) src[i] * (1.0f / 255.0f);
+                }
+                if (colorChannels > 0) {
+                    const float* table = getSrgbToLinearTable();
+                    for (size_t i = 0 ; i < count ; i += channels) {
+                        for (int c = 0 ; c < colorChannels ; c++) {
+                            row[i + c] = table[src[i + c]];
+                        }
+                    }
+                }
+                return;
+            }
+
+            case PixelType::U16: {
+                const u16* src = (const u16*) image.pixels + (size_t) y * count;
+                for (size_t i = 0 ; i < count ; i++) {
+                    row[i] = (float) src[i] * (1.0f / 65535.0f);
+                }
+                break;
+            }
+
+            default:
+                std::memcpy(row, (const float*) image.pixels + (size_t) y * count, count * sizeof(float));
+                break;
+        }
+
+        if (colorChannels > 0) {
+            for (size_t i = 0 ; i < count ; i += channels) {
+                for (int c = 0 ; c < colorChannels ; c++) {
+                    row[i + c] = toLinear(row[i + c]);
+                }
+            }
+        }
+    }
+
+    // inverse of loadRow, values of U8 and U16 rows are clamped and rounded
+    static void storeRow(Image& image, int y, const float* row, bool encode) {
+        int channels = image.channels;
+        int colorChannels = encode ? getColorChannels(channels) : 0;
+        size_t count = (size_t) image.width * channels;
+
+        switch (image.pixelType) {
+            case PixelType::U8: {
+                u8* dst = (u8*) image.pixels + (size_t) y * count;
+                for (size_t i = 0 ; i < count ; i++) {
+                    dst[i] = (u8) (std::clamp(row[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+                if (colorChannels > 0) {
+                    const u8* table = getLinearToSrgbTable();
+                    for (size_t i = 0 ; i < count ; i += channels) {
+                        for (int c = 0 ; c < colorChannels ; c++) {
+                            dst[i + c] = table[(int) (std::clamp(row[i + c], 0.0f, 1.0f) * (LINEAR_TO_SRGB_SIZE - 1) + 0.5f)];
+                        }
+                    }
+                }
+                break;
+            }
+
+            case PixelType::U16: {
+                u16* dst = (u16*) image.pixels + (size_t) y * count;
+                for (size_t i = 0 ; i < count ; i++) {
+                    float value = row[i];
+                    if (colorChannels > 0 && (int) (i % channels) < colorChannels) {
+                        value = toSrgb(std::clamp(value, 0.0f, 1.0f));
+                    }
+                    dst[i] = (u16) (std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+                }
+                break;
+            }
+
+            default: {
+                float* dst = (float*) image.pixels + (size_t) y * count;
+                std::memcpy(dst, row, count * sizeof(float));
+                if (colorChannels > 0) {
+                    for (size_t i = 0 ; i < count ; i += channels) {
+                        for (int c = 0 ; c < colorChannels ; c++) {
+                            dst[i + c] = toSrgb(std::max(dst[i + c], 0.0f));
+                        }
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    static float getSupport(ImageFilter filter) {
+        switch (filter) {
+            case IMAGE_FILTER_BOX:
+                return 0.5f;
+            case IMAGE_FILTER_KAISER:
+                return 3.0f;
+            default:
+                return 2.0f;
+        }
+    }
+
+    // zeroth order modified Bessel function of the first kind
+    static float bessel0(float x) {
+        float sum = 1.0f;
+        float term = 1.0f;
+        float halfX = x * 0.5f;
+        for (int k = 1 ; k < 32 ; k++) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1e-7f) {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    static float evaluate(ImageFilter filter, float t) {
+        t = std::abs(t);
+        switch (filter) {
+            case IMAGE_FILTER_BOX:
+                return t < 0.5f ? 1.0f : (t == 0.5f ? 0.5f : 0.0f);
+
+            case IMAGE_FILTER_KAISER: {
+                if (t >= 3.0f) {
+                    return 0.0f;
+                }
+                constexpr float ALPHA = 4.0f;
+                float x = t / 3.0f;
+                float window = bessel0(ALPHA * std::sqrt(1.0f - x * x)) / bessel0(ALPHA);
+                float sinc = t < 1e-5f ? 1.0f : std::sin(PI * t) / (PI * t);
+                return sinc * window;
+            }
+
+            default: {
+                constexpr float B = 1.0f / 3.0f;
+                constexpr float C = 1.0f / 3.0f;
+                if (t < 1.0f) {
+                    return ((12 - 9 * B - 6 * C) * t * t * t + (-18 + 12 * B + 6 * C) * t * t + (6 - 2 * B)) / 6.0f;
+                }
+                if (t < 2.0f) {
+                    return ((-B - 6 * C) * t * t * t + (6 * B + 30 * C) * t * t + (-12 * B - 48 * C) * t + (8 * B + 24 * C)) / 6.0f;
+                }
+                return 0.0f;
+            }
+        }
+    }
+
+    // fixed number of source indices and normalized weights for every destination coordinate
+    struct FilterTaps final {
+        int taps = 0;
+        std::vector<int> indices;
+        std::vector<float> weights;
+    };
+
+    static FilterTaps computeTaps(int srcSize, int dstSize, ImageFilter filter, ImageEdge edge) {
+        FilterTaps result;
+        float scale = (float) dstSize / (float) srcSize;
+        // filter is stretched when minifying, so that every source texel contributes
+        float filterScale = std::max(1.0f, 1.0f / scale);
+        float support = getSupport(filter) * filterScale;
+        result.taps = (int) std::ceil(support * 2.0f) + 1;
+        result.indices.resize((size_t) dstSize * result.taps);
+        result.weights.resize((size_t) dstSize * result.taps);
+
+        for (int i = 0 ; i < dstSize ; i++) {
+            float center = ((float) i + 0.5f) / scale - 0.5f;
+            int first = (int) std::ceil(center - support);
+            int last = (int) std::floor(center + support);
+            int* indices = &result.indices[(size_t) i * result.taps];
+            float* weights = &result.weights[(size_t) i * result.taps];
+
+            float sum = 0;
+            for (int k = 0 ; k < result.taps ; k++) {
+                int j = first + k;
+                weights[k] = j <= last ? evaluate(filter, ((float) j - center) / filterScale) : 0.0f;
+                indices[k] = edge == IMAGE_EDGE_WRAP ? ((j % srcSize) + srcSize) % srcSize : std::clamp(j, 0, srcSize - 1);
+                sum += weights[k];
+            }
+
+            if (sum != 0) {
+                for (int k = 0 ; k < result.taps ; k++) {
+                    weights[k] /= sum;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    bool ImageKernels::resize(const Image& src, Image& dst, int width, int height, ImageFilter filter, ImageEdge edge) {
+        if (!isSupported(src)) {
+            return false;
+        }
+
+        if (width <= 0 || height <= 0) {
+            error("Image kernels: invalid resize size [{0}, {1}]", width, height);
+            return false;
+        }
+
+        int channels = src.channels;
+        bool linear = src.srgb && src.pixelType == PixelType::U8;
+        FilterTaps horizontal = computeTaps(src.width, width, filter, edge);
+        FilterTaps vertical = computeTaps(src.height, height, filter, edge);
+        size_t rowSize = (size_t) width * channels;
+
+        // horizontal pass over every source row into float image of destination width
+        std::vector<float> horizontalPass((size_t) src.height * rowSize);
+        ThreadPool::parallelFor(src.height, [&](u32 y) {
+            thread_local std::vector<float> row;
+            row.resize((size_t) src.width * channels);
+            loadRow(src, y, row.data(), linear);
+
+            float* out = &horizontalPass[y * rowSize];
+            for (int x = 0 ; x < width ; x++) {
+                const int* indices = &horizontal.indices[(size_t) x * horizontal.taps];
+                const float* weights = &horizontal.weights[(size_t) x * horizontal.taps];
+                float* pixel = &out[(size_t) x * channels];
+                for (int c = 0 ; c < channels ; c++) {
+                    pixel[c] = 0;
+                }
+                for (int k = 0 ; k < horizontal.taps ; k++) {
+                    const float* texel = &row[(size_t) indices[k] * channels];
+                    float weight = weights[k];
+                    for (int c = 0 ; c < channels ; c++) {
+                        pixel[c] += weight * texel[c];
+                    }
+                }
+            }
+        });
+
+        allocate(dst, width, height, channels, src.pixelType, src.srgb);
+
+        // vertical pass accumulates whole rows, which is a plain multiply-add over contiguous floats
+        ThreadPool::parallelFor(height, [&](u32 y) {
+            thread_local std::vector<float> row;
+            row.assign(rowSize, 0.0f);
+            const int* indices = &vertical.indices[(size_t) y * vertical.taps];
+            const float* weights = &vertical.weights[(size_t) y * vertical.taps];
+            float* out = row.data();
+            for (int k = 0 ; k < vertical.taps ; k++) {
+                float weight = weights[k];
+                if (weight == 0) {
+                    continue;
+                }
+                const float* in = &horizontalPass[(size_t) indices[k] * rowSize];
+                for (size_t i = 0 ; i < rowSize ; i++) {
+                    out[i] += weight * in[i];
+                }
+            }
+            storeRow(dst, y, out, linear);
+        });
+
+        return true;
+    }
+
+    bool ImageKernels::downsample(const Image& src, Image& dst, ImageFilter filter, ImageEdge edge) {
+        return resize(src, dst, std::max(src.width / 2, 1), std::max(src.height / 2, 1), filter, edge);
+    }
+
+    void ImageKernels::generateMips(const Image& src, std::vector<Image>& mips, ImageFilter filter, ImageEdge edge) {
+        mips.clear();
+        if (!isSupported(src)) {
+            return;
+        }
+
+        Image base;
+        allocate(base, src.width, src.height, src.channels, src.pixelType, src.srgb);
+        std::memcpy(base.pixels, src.pixels, (size_t) src.width * src.height * src.channels * getChannelSize(src.pixelType));
+        mips.emplace_back(base);
+
+        while (mips.back().width > 1 || mips.back().height > 1) {
+            Image mip;
+            if (!downsample(mips.back(), mip, filter, edge)) {
+                return;
+            }
+            mips.emplace_back(mip);
+        }
+    }
+
+    void ImageKernels::srgbToLinear(const Image& src, Image& dst) {
+        if (!isSupported(src)) {
+            return;
+        }
+
+        allocate(dst, src.width, src.height, src.channels, PixelType::FLOAT, false);
+        size_t rowSize = (size_t) src.width * src.channels;
+        ThreadPool::parallelFor(src.height, [&](u32 y) {
+            loadRow(src, y, (float*) dst.pixels + y * rowSize, true);
+        });
+    }
+
+    void ImageKernels::linearToSrgb(const Image& src, Image& dst) {
+        if (!isSupported(src)) {
+            return;
+        }
+
+        allocate(dst, src.width, src.height, src.channels, PixelType::U8, true);
+        ThreadPool::parallelFor(src.height, [&](u32 y) {
+            thread_local std::vector<float> row;
+            row.resize((size_t) src.width * src.channels);
+            loadRow(src, y, row.data(), false);
+            storeRow(dst, y, row.data(), true);
+        });
+    }
+
+    // mapping of dst channel: source channel, -1 for zero and -2 for one
+    template<typename T>
+    static void remap(const std::array<const Image*, 4>& sources, const int* mapping, Image& dst, T one) {
+        int channels = dst.channels;
+        ThreadPool::parallelFor(dst.height, [&](u32 y) {
+            T* out = (T*) dst.pixels + (size_t) y * dst.width * channels;
+            for (int c = 0 ; c < channels ; c++) {
+                const Image* source = sources[c];
+                int channel = mapping[c];
+                if (channel < 0) {
+                    T value = channel == -2 ? one : T(0);
+                    for (int x = 0 ; x < dst.width ; x++) {
+                        out[(size_t) x * channels + c] = value;
+                    }
+                    continue;
+                }
+
+                int stride = source->channels;
+                const T* in = (const T*) source->pixels + (size_t) y * source->width * stride + channel;
+                for (int x = 0 ; x < dst.width ; x++) {
+                    out[(size_t) x * channels + c] = in[(size_t) x * stride];
+                }
+            }
+        });
+    }
+
+    static void remap(const std::array<const Image*, 4>& sources, const int* mapping, Image& dst) {
+        switch (dst.pixelType) {
+            case PixelType::U16:
+                remap<u16>(sources, mapping, dst, 65535);
+                break;
+            case PixelType::FLOAT:
+                remap<float>(sources, mapping, dst, 1.0f);
+                break;
+            default:
+                remap<u8>(sources, mapping, dst, 255);
+                break;
+        }
+    }
+
+    bool ImageKernels::swizzle(const Image& src, Image& dst, const char* pattern) {
+        if (!isSupported(src)) {
+            return false;
+        }
+
+        int channels = pattern ? (int) std::strlen(pattern) : 0;
+        if (channels < 1 || channels > 4) {
+            error("Image kernels: invalid swizzle pattern {0}", pattern ? pattern : "");
+            return false;
+        }
+
+        int mapping[4];
+        for (int c = 0 ; c < channels ; c++) {
+            switch (pattern[c]) {
+                case 'r': mapping[c] = 0; break;
+                case 'g': mapping[c] = 1; break;
+                case 'b': mapping[c] = 2; break;
+                case 'a': mapping[c] = 3; break;
+                case '0': mapping[c] = -1; break;
+                case '1': mapping[c] = -2; break;
+                default:
+                    error("Image kernels: invalid swizzle pattern {0}", pattern);
+                    return false;
+            }
+
+            if (mapping[c] >= src.channels) {
+                error("Image kernels: swizzle pattern {0} reads missing channel of {1} channel image", pattern, src.channels);
+                return false;
+            }
+        }
+
+        allocate(dst, src.width, src.height, channels, src.pixelType, src.srgb);
+        remap({ &src, &src, &src, &src }, mapping, dst);
+        return true;
+    }
+
+    bool ImageKernels::pack(const std::array<const Image*, 4>& sources, int channels, Image& dst) {
+        if (channels < 1 || channels > 4) {
+            error("Image kernels: invalid pack channels {0}", channels);
+            return false;
+        }
+
+        const Image* first = null;
+        int mapping[4];
+        for (int c = 0 ; c < channels ; c++) {
+            const Image* source = sources[c];
+            mapping[c] = source ? 0 : (c == 3 ? -2 : -1);
+            if (!source) {
+                continue;
+            }
+
+            if (!isSupported(*source)) {
+                return false;
+            }
+
+            if (!first) {
+                first = source;
+            } else if (source->width != first->width || source->height != first->height || source->pixelType != first->pixelType) {
+                error("Image kernels: packed images must have same size and pixel type");
+                return false;
+            }
+        }
+
+        if (!first) {
+            error("Image kernels: nothing to pack");
+            return false;
+        }
+
+        allocate(dst, first->width, first->height, channels, first->pixelType, false);
+        remap(sources, mapping, dst);
+        return true;
+    }
+
+    bool ImageKernels::normalFromHeight(const Image& height, Image& normal, float strength, ImageEdge edge) {
+        if (!isSupported(height)) {
+            return false;
+        }
+
+        int width = height.width;
+        int rows = height.height;
+        std::vector<float> heights((size_t) width * rows);
+        ThreadPool::parallelFor(rows, [&](u32 y) {
+            thread_local std::vector<float> row;
+            row.resize((size_t) width * height.channels);
+            loadRow(height, y, row.data(), false);
+            for (int x = 0 ; x < width ; x++) {
+                heights[(size_t) y * width + x] = row[(size_t) x * height.channels];
+            }
+        });
+
+        auto index = [edge](int i, int size) {
+            return edge == IMAGE_EDGE_WRAP ? (i + size) % size : std::clamp(i, 0, size - 1);
+        };
+
+        allocate(normal, width, rows, 3, PixelType::U8, false);
+        ThreadPool::parallelFor(rows, [&](u32 y) {
+            const float* top = &heights[(size_t) index((int) y - 1, rows) * width];
+            const float* middle = &heights[(size_t) y * width];
+            const float* bottom = &heights[(size_t) index((int) y + 1, rows) * width];
+            u8* out = (u8*) normal.pixels + (size_t) y * width * 3;
+
+            for (int x = 0 ; x < width ; x++) {
+                int left = index(x - 1, width);
+                int right = index(x + 1, width);
+                float dx = (top[right] + 2.0f * middle[right] + bottom[right]) - (top[left] + 2.0f * middle[left] + bottom[left]);
+                float dy = (bottom[left] + 2.0f * bottom[x] + bottom[right]) - (top[left] + 2.0f * top[x] + top[right]);
+                // rows go down in image, so slope towards +Y of texture space is negated row slope
+                glm::vec3 n = glm::normalize(glm::vec3(-dx * strength, dy * strength, 1.0f));
+                out[x * 3] = (u8) std::lround((n.x * 0.5f + 0.5f) * 255.0f);
+                out[x * 3 + 1] = (u8) std::lround((n.y * 0.5f + 0.5f) * 255.0f);
+                out[x * 3 + 2] = (u8) std::lround((n.z * 0.5f + 0.5f) * 255.0f);
+            }
+        });
+
+        return true;
+    }
+
+}
@@ -0,0 +1,807 @@
+#include <api/null_device.h>
+
+#include <glad/glad.h>
+
+#include <regex>
+
+// counts call of entry point, slot of entry point is looked up once per function
+#define NULL_DEVICE_RECORD(name) static const u32 slot = getSlot(name); record(slot)
+
+namespace gl {
+
+    enum NullCallType : u8 {
+        NULL_CALL_OTHER,
+        NULL_CALL_BUFFER,
+        NULL_CALL_TEXTURE,
+        NULL_CALL_SHADER,
+        NULL_CALL_DRAW,
+        NULL_CALL_UNIFORM
+    };
+
+    struct NullEntryPoint final {
+        const char* name = null;
+        u64 calls = 0;
+        NullCallType type = NULL_CALL_OTHER;
+    };
+
+    struct NullUniform final {
+        std::string name;
+        int size = 1;
+    };
+
+    struct NullProgram final {
+        std::vector<u32> shaders;
+        std::vector<NullUniform> uniforms;
+        std::unordered_map<std::string, int> locations;
+        int maxNameLength = 0;
+    };
+
+    static constexpr u32 MAX_ENTRY_POINTS = 2048;
+
+    static const char* EXTENSIONS[] = {
+            "GL_ARB_bindless_texture"
+    };
+    static constexpr int EXTENSION_COUNT = sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]);
+
+    static NullDeviceStats s_stats;
+    static NullEntryPoint s_entryPoints[MAX_ENTRY_POINTS];
+    static u32 s_entryPointCount = 0;
+    static std::unordered_map<std::string, u32> s_slots;
+
+    static u32 s_nextId = 1;
+    static u64 s_nextHandle = 1;
+    static std::unordered_map<GLenum, u32> s_boundBuffers;
+    static std::unordered_map<u32, size_t> s_bufferSizes;
+    static std::unordered_map<u32, std::vector<u8>> s_mappedBuffers;
+    static std::unordered_map<u32, std::string> s_shaderSources;
+    static std::unordered_map<u32, NullProgram> s_programs;
+
+    static NullCallType getCallType(const std::string& name) {
+        auto startsWith = [&name](const char* prefix) { return name.rfind(prefix, 0) == 0; };
+        auto contains = [&name](const char* part) { return name.find(part) != std::string::npos; };
+
+        if (startsWith("glUniform") || startsWith("glProgramUniform")) {
+            return NULL_CALL_UNIFORM;
+        }
+        if ((startsWith("glDraw") && !startsWith("glDrawBuffer")) || startsWith("glMultiDraw") || startsWith("glDispatchCompute")) {
+            return NULL_CALL_DRAW;
+        }
+        if (contains("Shader") || contains("Program")) {
+            return NULL_CALL_SHADER;
+        }
+        // draw and read buffers are framebuffer state
+        bool framebuffer = contains("Framebuffer") || contains("Renderbuffer") || startsWith("glDrawBuffer") || startsWith("glReadBuffer");
+        if (contains("Buffer") && !framebuffer) {
+            return NULL_CALL_BUFFER;
+        }
+        if (contains("Tex") || contains("Image") || contains("Sampler") || contains("Mipmap")) {
+            return NULL_CALL_TEXTURE;
+        }
+        return NULL_CALL_OTHER;
+    }
+
+    static u32 getSlot(const char* name) {
+        auto it = s_slots.find(name);
+        if (it != s_slots.end()) {
+            return it->second;
+        }
+
+        if (s_entryPointCount == MAX_ENTRY_POINTS) {
+            error("NullDevice: too many entry points, {0} is not counted separately", name);
+            return MAX_ENTRY_POINTS - 1;
+        }
+
+        u32 slot = s_entryPointCount++;
+        s_entryPoints[slot].name = name;
+        s_entryPoints[slot].type = getCallType(name);
+        s_slots[name] = slot;
+        return slot;
+    }
+
+    static inline void record(u32 slot) {
+        NullEntryPoint& entryPoint = s_entryPoints[slot];
+        entryPoint.calls++;
+        s_stats.calls++;
+
+        switch (entryPoint.type) {
+            case NULL_CALL_BUFFER:
+                s_stats.bufferCalls++;
+                break;
+            case NULL_CALL_TEXTURE:
+                s_stats.textureCalls++;
+                break;
+            case NULL_CALL_SHADER:
+                s_stats.shaderCalls++;
+                break;
+            case NULL_CALL_DRAW:
+                s_stats.drawCalls++;
+                break;
+            case NULL_CALL_UNIFORM:
+                s_stats.uniformCalls++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // entry points without own behaviour, return value is zero for any return type.
+    // GL functions of every signature are called through this one, which is undefined in C++, but works where
+    // caller cleans up arguments and integer and pointer results come back in RAX, that is x86-64 System V and Win64 ABIs.
+    // 32-bit Windows APIENTRY is __stdcall, where callee pops arguments, so that stack would be corrupted.
+    // other targets are not verified, null device is unsupported there and headless run uses real context
+#if defined(__x86_64__) || defined(_M_X64)
+#define NULL_DEVICE_SUPPORTED
+
+    template<u32 Slot>
+    static u64 APIENTRY recordCall() {
+        record(Slot);
+        return 0;
+    }
+
+    template<u32... Slots>
+    static std::array<void*, sizeof...(Slots)> createRecorders(std::integer_sequence<u32, Slots...>) {
+        return { (void*) &recordCall<Slots>... };
+    }
+
+    static const std::array<void*, MAX_ENTRY_POINTS> s_recorders = createRecorders(std::make_integer_sequence<u32, MAX_ENTRY_POINTS>());
+
+#endif
+
+    static void generateIds(GLsizei n, GLuint* ids) {
+        for (GLsizei i = 0 ; i < n ; i++) {
+            ids[i] = s_nextId++;
+        }
+    }
+
+    static size_t getBoundBufferSize(GLenum target) {
+        auto it = s_bufferSizes.find(s_boundBuffers[target]);
+        return it == s_bufferSizes.end() ? 0 : it->second;
+    }
+
+    static size_t getPixelSize(GLenum format, GLenum type) {
+        size_t components;
+        switch (format) {
+            case GL_RG:
+            case GL_RG_INTEGER:
+                components = 2;
+                break;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+                components = 3;
+                break;
+            case GL_RGBA:
+            case GL_BGRA:
+            case GL_RGBA_INTEGER:
+                components = 4;
+                break;
+            default:
+                components = 1;
+                break;
+        }
+
+        switch (type) {
+            case GL_UNSIGNED_BYTE:
+            case GL_BYTE:
+                return components;
+            case GL_UNSIGNED_SHORT:
+            case GL_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                return 4;
+            default:
+                return components * 4;
+        }
+    }
+
+    // "uniform type name;" and "uniform type name[N];" declarations outside of blocks
+    static void reflect(NullProgram& program) {
+        static const std::regex declaration(R"(\buniform\s+\w+\s+(\w+)\s*(\[\s*(\d+)\s*\])?\s*[;=])");
+
+        program.uniforms.clear();
+        program.locations.clear();
+        program.maxNameLength = 0;
+        int location = 0;
+
+        for (u32 shader : program.shaders) {
+            const std::string& source = s_shaderSources[shader];
+            for (auto it = std::sregex_iterator(source.begin(), source.end(), declaration) ; it != std::sregex_iterator() ; it++) {
+                std::string name = (*it)[1].str();
+                if (program.locations.find(name) != program.locations.end()) {
+                    continue;
+                }
+
+                NullUniform uniform;
+                uniform.size = (*it)[3].matched ? std::max(std::stoi((*it)[3].str()), 1) : 1;
+                program.locations[name] = location;
+                if ((*it)[2].matched) {
+                    uniform.name = name + "[0]";
+                    for (int i = 0 ; i < uniform.size ; i++) {
+                        program.locations[name + "[" + std::to_string(i) + "]"] = location + i;
+                    }
+                } else {
+                    uniform.name = name;
+                }
+
+                location += uniform.size;
+                program.maxNameLength = std::max(program.maxNameLength, (int) uniform.name.size() + 1);
+                program.uniforms.emplace_back(uniform);
+            }
+        }
+    }
+
+    static const GLubyte* APIENTRY glGetStringNull(GLenum name) {
+        NULL_DEVICE_RECORD("glGetString");
+        switch (name) {
+            case GL_VENDOR: return (const GLubyte*) "Gabriel";
+            case GL_RENDERER: return (const GLubyte*) "Null Device";
+            case GL_VERSION: return (const GLubyte*) "4.6.0 Null Device";
+            case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*) "4.60";
+            default: return (const GLubyte*) "";
+        }
+    }
+
+    static const GLubyte* APIENTRY glGetStringiNull(GLenum name, GLuint index) {
+        NULL_DEVICE_RECORD("glGetStringi");
+        if (name == GL_EXTENSIONS && index < EXTENSION_COUNT) {
+            return (const GLubyte*) EXTENSIONS[index];
+        }
+        return (const GLubyte*) "";
+    }
+
+    static GLenum APIENTRY glGetErrorNull() {
+        NULL_DEVICE_RECORD("glGetError");
+        return GL_NO_ERROR;
+    }
+
+    static void APIENTRY glGetIntegervNull(GLenum name, GLint* data) {
+        NULL_DEVICE_RECORD("glGetIntegerv");
+        switch (name) {
+            case GL_NUM_EXTENSIONS:
+                *data = EXTENSION_COUNT;
+                break;
+            case GL_MAX_VERTEX_ATTRIBS:
+            case GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS:
+            case GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_GEOMETRY_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_TESS_CONTROL_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_TESS_EVALUATION_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS:
+            case GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS:
+            case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT:
+                *data = 16;
+                break;
+            case GL_MAX_SHADER_STORAGE_BLOCK_SIZE:
+                *data = 1 << 27;
+                break;
+            case GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS:
+                *data = 1024;
+                break;
+            case GL_MAX_SAMPLES:
+                *data = 8;
+                break;
+            case GL_MAX_TEXTURE_SIZE:
+                *data = 16384;
+                break;
+            case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+                *data = 256;
+                break;
+            // no program binary formats, so that programs of null device never reach program cache
+            default:
+                *data = 0;
+                break;
+        }
+    }
+
+    static void APIENTRY glGetIntegeri_vNull(GLenum name, GLuint index, GLint* data) {
+        NULL_DEVICE_RECORD("glGetIntegeri_v");
+        switch (name) {
+            case GL_MAX_COMPUTE_WORK_GROUP_COUNT:
+                *data = 65535;
+                break;
+            case GL_MAX_COMPUTE_WORK_GROUP_SIZE:
+                *data = index < 2 ? 1024 : 64;
+                break;
+            default:
+                *data = 0;
+                break;
+        }
+    }
+
+    static void APIENTRY glGetFloatvNull(GLenum name, GLfloat* data) {
+        NULL_DEVICE_RECORD("glGetFloatv");
+        *data = name == GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT ? 16.0f : 0.0f;
+    }
+
+    static GLboolean APIENTRY glIsEnabledNull(GLenum capability) {
+        NULL_DEVICE_RECORD("glIsEnabled");
+        return GL_FALSE;
+    }
+
+    static void APIENTRY glGenBuffersNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenBuffers");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenTexturesNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenTextures");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenVertexArraysNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenVertexArrays");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenFramebuffersNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenFramebuffers");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenRenderbuffersNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenRenderbuffers");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenQueriesNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenQueries");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGenSamplersNull(GLsizei n, GLuint* ids) {
+        NULL_DEVICE_RECORD("glGenSamplers");
+        generateIds(n, ids);
+    }
+
+    static void APIENTRY glGetQueryObjectui64vNull(GLuint id, GLenum name, GLuint64* params) {
+        NULL_DEVICE_RECORD("glGetQueryObjectui64v");
+        *params = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    static void APIENTRY glGetQueryObjectuivNull(GLuint id, GLenum name, GLuint* params) {
+        NULL_DEVICE_RECORD("glGetQueryObjectuiv");
+        *params = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    static void APIENTRY glGetQueryObjectivNull(GLuint id, GLenum name, GLint* params) {
+        NULL_DEVICE_RECORD("glGetQueryObjectiv");
+        *params = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    static GLuint APIENTRY glCreateShaderNull(GLenum type) {
+        NULL_DEVICE_RECORD("glCreateShader");
+        return s_nextId++;
+    }
+
+    static void APIENTRY glShaderSourceNull(GLuint shader, GLsizei count, const GLchar** strings, const GLint* lengths) {
+        NULL_DEVICE_RECORD("glShaderSource");
+        std::string& source = s_shaderSources[shader];
+        source.clear();
+        for (GLsizei i = 0 ; i < count ; i++) {
+            if (lengths && lengths[i] >= 0) {
+                source.append(strings[i], lengths[i]);
+            } else {
+                source.append(strings[i]);
+            }
+        }
+    }
+
+    static void APIENTRY glGetShaderivNull(GLuint shader, GLenum name, GLint* params) {
+        NULL_DEVICE_RECORD("glGetShaderiv");
+        *params = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    static void APIENTRY glGetShaderInfoLogNull(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+        NULL_DEVICE_RECORD("glGetShaderInfoLog");
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            infoLog[0] = 0;
+        }
+    }
+
+    static void APIENTRY glDeleteShaderNull(GLuint shader) {
+        NULL_DEVICE_RECORD("glDeleteShader");
+        s_shaderSources.erase(shader);
+    }
+
+    static GLuint APIENTRY glCreateProgramNull() {
+        NULL_DEVICE_RECORD("glCreateProgram");
+        u32 program = s_nextId++;
+        s_programs[program] = {};
+        return program;
+    }
+
+    static void APIENTRY glAttachShaderNull(GLuint program, GLuint shader) {
+        NULL_DEVICE_RECORD("glAttachShader");
+        s_programs[program].shaders.emplace_back(shader);
+    }
+
+    static void APIENTRY glDetachShaderNull(GLuint program, GLuint shader) {
+        NULL_DEVICE_RECORD("glDetachShader");
+        auto& shaders = s_programs[program].shaders;
+        shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+    }
+
+    static void APIENTRY glLinkProgramNull(GLuint program) {
+        NULL_DEVICE_RECORD("glLinkProgram");
+        reflect(s_programs[program]);
+    }
+
+    static void APIENTRY glGetProgramivNull(GLuint program, GLenum name, GLint* params) {
+        NULL_DEVICE_RECORD("glGetProgramiv");
+        const NullProgram& nullProgram = s_programs[program];
+        switch (name) {
+            case GL_LINK_STATUS:
+                *params = GL_TRUE;
+                break;
+            case GL_ACTIVE_UNIFORMS:
+                *params = nullProgram.uniforms.size();
+                break;
+            case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+                *params = nullProgram.maxNameLength;
+                break;
+            default:
+                *params = 0;
+                break;
+        }
+    }
+
+    static void APIENTRY glGetProgramInfoLogNull(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+        NULL_DEVICE_RECORD("glGetProgramInfoLog");
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            infoLog[0] = 0;
+        }
+    }
+
+    static void APIENTRY glGetActiveUniformNull(
+            GLuint program, GLuint index, GLsizei bufSize,
+            GLsizei* length, GLint* size, GLenum* type, GLchar* name
+    ) {
+        NULL_DEVICE_RECORD("glGetActiveUniform");
+        // index out of range is GL_INVALID_VALUE in GL, outputs are zeroed so that caller doesn't read garbage
+        auto it = s_programs.find(program);
+        if (it == s_programs.end() || index >= it->second.uniforms.size()) {
+            if (bufSize > 0) {
+                name[0] = 0;
+            }
+            if (length) {
+                *length = 0;
+            }
+            *size = 0;
+            *type = 0;
+            return;
+        }
+
+        const NullUniform& uniform = it->second.uniforms[index];
+        GLsizei nameLength = bufSize > 0 ? std::min<GLsizei>(uniform.name.size(), bufSize - 1) : 0;
+        if (bufSize > 0) {
+            memcpy(name, uniform.name.data(), nameLength);
+            name[nameLength] = 0;
+        }
+        if (length) {
+            *length = nameLength;
+        }
+        *size = uniform.size;
+        *type = GL_FLOAT;
+    }
+
+    static GLint APIENTRY glGetUniformLocationNull(GLuint program, const GLchar* name) {
+        NULL_DEVICE_RECORD("glGetUniformLocation");
+        const auto& locations = s_programs[program].locations;
+        auto it = locations.find(name);
+        return it == locations.end() ? -1 : it->second;
+    }
+
+    static void APIENTRY glDeleteProgramNull(GLuint program) {
+        NULL_DEVICE_RECORD("glDeleteProgram");
+        s_programs.erase(program);
+    }
+
+    static GLenum APIENTRY glCheckFramebufferStatusNull(GLenum target) {
+        NULL_DEVICE_RECORD("glCheckFramebufferStatus");
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    static void APIENTRY glBindBufferNull(GLenum target, GLuint buffer) {
+        NULL_DEVICE_RECORD("glBindBuffer");
+        s_boundBuffers[target] = buffer;
+    }
+
+    static void APIENTRY glBindBufferBaseNull(GLenum target, GLuint index, GLuint buffer) {
+        NULL_DEVICE_RECORD("glBindBufferBase");
+        s_boundBuffers[target] = buffer;
+    }
+
+    static void APIENTRY glBindBufferRangeNull(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        NULL_DEVICE_RECORD("glBindBufferRange");
+        s_boundBuffers[target] = buffer;
+    }
+
+    static void APIENTRY glBufferDataNull(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+        NULL_DEVICE_RECORD("glBufferData");
+        s_bufferSizes[s_boundBuffers[target]] = size;
+        if (data) {
+            s_stats.bufferBytes += size;
+        }
+    }
+
+    static void APIENTRY glBufferStorageNull(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+        NULL_DEVICE_RECORD("glBufferStorage");
+        s_bufferSizes[s_boundBuffers[target]] = size;
+        if (data) {
+            s_stats.bufferBytes += size;
+        }
+    }
+
+    static void APIENTRY glBufferSubDataNull(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+        NULL_DEVICE_RECORD("glBufferSubData");
+        s_stats.bufferBytes += size;
+    }
+
+    // mapped memory is kept until buffer is deleted, so that persistent mappings stay valid
+    static u8* mapBuffer(GLenum target) {
+        std::vector<u8>& memory = s_mappedBuffers[s_boundBuffers[target]];
+        memory.resize(getBoundBufferSize(target));
+        return memory.data();
+    }
+
+    static void* APIENTRY glMapBufferNull(GLenum target, GLenum access) {
+        NULL_DEVICE_RECORD("glMapBuffer");
+        return mapBuffer(target);
+    }
+
+    static void* APIENTRY glMapBufferRangeNull(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        NULL_DEVICE_RECORD("glMapBufferRange");
+        return mapBuffer(target) + offset;
+    }
+
+    static GLboolean APIENTRY glUnmapBufferNull(GLenum target) {
+        NULL_DEVICE_RECORD("glUnmapBuffer");
+        return GL_TRUE;
+    }
+
+    static void APIENTRY glDeleteBuffersNull(GLsizei n, const GLuint* ids) {
+        NULL_DEVICE_RECORD("glDeleteBuffers");
+        for (GLsizei i = 0 ; i < n ; i++) {
+            s_bufferSizes.erase(ids[i]);
+            s_mappedBuffers.erase(ids[i]);
+        }
+    }
+
+    static GLsync APIENTRY glFenceSyncNull(GLenum condition, GLbitfield flags) {
+        NULL_DEVICE_RECORD("glFenceSync");
+        return (GLsync) (uintptr_t) s_nextId++;
+    }
+
+    static GLenum APIENTRY glClientWaitSyncNull(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+        NULL_DEVICE_RECORD("glClientWaitSync");
+        return GL_ALREADY_SIGNALED;
+    }
+
+    // pixels are offset into unpack buffer when it is bound
+    static bool hasPixels(const void* pixels) {
+        return pixels || s_boundBuffers[GL_PIXEL_UNPACK_BUFFER] != 0;
+    }
+
+    static void APIENTRY glTexImage2DNull(
+            GLenum target, GLint level, GLint internalFormat,
+            GLsizei width, GLsizei height, GLint border,
+            GLenum format, GLenum type, const void* pixels
+    ) {
+        NULL_DEVICE_RECORD("glTexImage2D");
+        if (hasPixels(pixels)) {
+            s_stats.textureBytes += (u64) width * height * getPixelSize(format, type);
+        }
+    }
+
+    static void APIENTRY glTexSubImage2DNull(
+            GLenum target, GLint level, GLint x, GLint y,
+            GLsizei width, GLsizei height,
+            GLenum format, GLenum type, const void* pixels
+    ) {
+        NULL_DEVICE_RECORD("glTexSubImage2D");
+        if (hasPixels(pixels)) {
+            s_stats.textureBytes += (u64) width * height * getPixelSize(format, type);
+        }
+    }
+
+    static void APIENTRY glCompressedTexImage2DNull(
+            GLenum target, GLint level, GLenum internalFormat,
+            GLsizei width, GLsizei height, GLint border,
+            GLsizei imageSize, const void* data
+    ) {
+        NULL_DEVICE_RECORD("glCompressedTexImage2D");
+        if (hasPixels(data)) {
+            s_stats.textureBytes += imageSize;
+        }
+    }
+
+    // invalid handle makes ImageBuffer fall back to NV bindless, so that every handle is valid
+    static GLuint64 APIENTRY glGetTextureHandleARBNull(GLuint texture) {
+        NULL_DEVICE_RECORD("glGetTextureHandleARB");
+        return s_nextHandle++;
+    }
+
+    static GLuint64 APIENTRY glGetTextureSamplerHandleARBNull(GLuint texture, GLuint sampler) {
+        NULL_DEVICE_RECORD("glGetTextureSamplerHandleARB");
+        return s_nextHandle++;
+    }
+
+    static GLuint64 APIENTRY glGetImageHandleARBNull(GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum format) {
+        NULL_DEVICE_RECORD("glGetImageHandleARB");
+        return s_nextHandle++;
+    }
+
+#define NULL_DEVICE_UNIFORM(function, T) \
+    static void APIENTRY function##Null(GLint location, T value) { \
+        NULL_DEVICE_RECORD(#function); \
+        s_stats.uniformBytes += sizeof(T); \
+    }
+
+#define NULL_DEVICE_UNIFORM_VECTOR(function, T, components) \
+    static void APIENTRY function##Null(GLint location, GLsizei count, const T* value) { \
+        NULL_DEVICE_RECORD(#function); \
+        s_stats.uniformBytes += sizeof(T) * components * count; \
+    }
+
+#define NULL_DEVICE_UNIFORM_MATRIX(function, T, components) \
+    static void APIENTRY function##Null(GLint location, GLsizei count, GLboolean transpose, const T* value) { \
+        NULL_DEVICE_RECORD(#function); \
+        s_stats.uniformBytes += sizeof(T) * components * count; \
+    }
+
+    NULL_DEVICE_UNIFORM(glUniform1i, GLint)
+    NULL_DEVICE_UNIFORM(glUniform1ui, GLuint)
+    NULL_DEVICE_UNIFORM(glUniform1f, GLfloat)
+    NULL_DEVICE_UNIFORM(glUniform1d, GLdouble)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform2iv, GLint, 2)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform3iv, GLint, 3)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform4iv, GLint, 4)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform2fv, GLfloat, 2)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform3fv, GLfloat, 3)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform4fv, GLfloat, 4)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform2dv, GLdouble, 2)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform3dv, GLdouble, 3)
+    NULL_DEVICE_UNIFORM_VECTOR(glUniform4dv, GLdouble, 4)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix2fv, GLfloat, 4)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix3fv, GLfloat, 9)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix4fv, GLfloat, 16)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix2dv, GLdouble, 4)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix3dv, GLdouble, 9)
+    NULL_DEVICE_UNIFORM_MATRIX(glUniformMatrix4dv, GLdouble, 16)
+
+#define NULL_DEVICE_OVERRIDE(function) { #function, (void*) &function##Null }
+
+    // entry points whose results are used by engine, others are recorded by recordCall()
+    static const std::unordered_map<std::string, void*> s_overrides = {
+            NULL_DEVICE_OVERRIDE(glGetString),
+            NULL_DEVICE_OVERRIDE(glGetStringi),
+            NULL_DEVICE_OVERRIDE(glGetError),
+            NULL_DEVICE_OVERRIDE(glGetIntegerv),
+            NULL_DEVICE_OVERRIDE(glGetIntegeri_v),
+            NULL_DEVICE_OVERRIDE(glGetFloatv),
+            NULL_DEVICE_OVERRIDE(glIsEnabled),
+            NULL_DEVICE_OVERRIDE(glGenBuffers),
+            NULL_DEVICE_OVERRIDE(glGenTextures),
+            NULL_DEVICE_OVERRIDE(glGenVertexArrays),
+            NULL_DEVICE_OVERRIDE(glGenFramebuffers),
+            NULL_DEVICE_OVERRIDE(glGenRenderbuffers),
+            NULL_DEVICE_OVERRIDE(glGenQueries),
+            NULL_DEVICE_OVERRIDE(glGenSamplers),
+            NULL_DEVICE_OVERRIDE(glGetQueryObjectui64v),
+            NULL_DEVICE_OVERRIDE(glGetQueryObjectuiv),
+            NULL_DEVICE_OVERRIDE(glGetQueryObjectiv),
+            NULL_DEVICE_OVERRIDE(glCreateShader),
+            NULL_DEVICE_OVERRIDE(glShaderSource),
+            NULL_DEVICE_OVERRIDE(glGetShaderiv),
+            NULL_DEVICE_OVERRIDE(glGetShaderInfoLog),
+            NULL_DEVICE_OVERRIDE(glDeleteShader),
+            NULL_DEVICE_OVERRIDE(glCreateProgram),
+            NULL_DEVICE_OVERRIDE(glAttachShader),
+            NULL_DEVICE_OVERRIDE(glDetachShader),
+            NULL_DEVICE_OVERRIDE(glLinkProgram),
+            NULL_DEVICE_OVERRIDE(glGetProgramiv),
+            NULL_DEVICE_OVERRIDE(glGetProgramInfoLog),
+            NULL_DEVICE_OVERRIDE(glGetActiveUniform),
+            NULL_DEVICE_OVERRIDE(glGetUniformLocation),
+            NULL_DEVICE_OVERRIDE(glDeleteProgram),
+            NULL_DEVICE_OVERRIDE(glCheckFramebufferStatus),
+            NULL_DEVICE_OVERRIDE(glBindBuffer),
+            NULL_DEVICE_OVERRIDE(glBindBufferBase),
+            NULL_DEVICE_OVERRIDE(glBindBufferRange),
+            NULL_DEVICE_OVERRIDE(glBufferData),
+            NULL_DEVICE_OVERRIDE(glBufferStorage),
+            NULL_DEVICE_OVERRIDE(glBufferSubData),
+            NULL_DEVICE_OVERRIDE(glMapBuffer),
+            NULL_DEVICE_OVERRIDE(glMapBufferRange),
+            NULL_DEVICE_OVERRIDE(glUnmapBuffer),
+            NULL_DEVICE_OVERRIDE(glDeleteBuffers),
+            NULL_DEVICE_OVERRIDE(glFenceSync),
+            NULL_DEVICE_OVERRIDE(glClientWaitSync),
+            NULL_DEVICE_OVERRIDE(glTexImage2D),
+            NULL_DEVICE_OVERRIDE(glTexSubImage2D),
+            NULL_DEVICE_OVERRIDE(glCompressedTexImage2D),
+            NULL_DEVICE_OVERRIDE(glGetTextureHandleARB),
+            NULL_DEVICE_OVERRIDE(glGetTextureSamplerHandleARB),
+            NULL_DEVICE_OVERRIDE(glGetImageHandleARB),
+            NULL_DEVICE_OVERRIDE(glUniform1i),
+            NULL_DEVICE_OVERRIDE(glUniform1ui),
+            NULL_DEVICE_OVERRIDE(glUniform1f),
+            NULL_DEVICE_OVERRIDE(glUniform1d),
+            NULL_DEVICE_OVERRIDE(glUniform2iv),
+            NULL_DEVICE_OVERRIDE(glUniform3iv),
+            NULL_DEVICE_OVERRIDE(glUniform4iv),
+            NULL_DEVICE_OVERRIDE(glUniform2fv),
+            NULL_DEVICE_OVERRIDE(glUniform3fv),
+            NULL_DEVICE_OVERRIDE(glUniform4fv),
+            NULL_DEVICE_OVERRIDE(glUniform2dv),
+            NULL_DEVICE_OVERRIDE(glUniform3dv),
+            NULL_DEVICE_OVERRIDE(glUniform4dv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix2fv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix3fv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix4fv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix2dv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix3dv),
+            NULL_DEVICE_OVERRIDE(glUniformMatrix4dv),
+    };
+
+    bool NullDevice::isSupported() {
+#ifdef NULL_DEVICE_SUPPORTED
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void* NullDevice::getProcAddress(const char* name) {
+#ifdef NULL_DEVICE_SUPPORTED
+        u32 slot = getSlot(name);
+        auto it = s_overrides.find(name);
+        return it != s_overrides.end() ? it->second : s_recorders[slot];
+#else
+        error("NullDevice: not supported on this platform, {0} is not loaded", name);
+        return null;
+#endif
+    }
+
+    void NullDevice::free() {
+        s_boundBuffers.clear();
+        s_bufferSizes.clear();
+        s_mappedBuffers.clear();
+        s_shaderSources.clear();
+        s_programs.clear();
+    }
+
+    const NullDeviceStats& NullDevice::getStats() {
+        return s_stats;
+    }
+
+    void NullDevice::resetStats() {
+        s_stats = {};
+        for (u32 i = 0 ; i < s_entryPointCount ; i++) {
+            s_entryPoints[i].calls = 0;
+        }
+    }
+
+    std::vector<NullDeviceCall> NullDevice::getCalls() {
+        std::vector<NullDeviceCall> calls;
+        for (u32 i = 0 ; i < s_entryPointCount ; i++) {
+            if (s_entryPoints[i].calls > 0) {
+                calls.push_back({ s_entryPoints[i].name, s_entryPoints[i].calls });
+            }
+        }
+        std::sort(calls.begin(), calls.end(), [](const NullDeviceCall& left, const NullDeviceCall& right) {
+            return left.calls > right.calls;
+        });
+        return calls;
+    }
+
+}
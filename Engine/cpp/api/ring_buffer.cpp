@@ -0,0 +1,93 @@
+#include <api/ring_buffer.h>
+
+namespace gl {
+
+    static constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    void RingBuffer::init(u32 target, u32 binding, size_t frameSize) {
+        mTarget = target;
+        mBinding = binding;
+
+        int alignment = 256;
+        glGetIntegerv(target == GL_UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        mFrameSize = (frameSize + alignment - 1) / alignment * alignment;
+
+        glGenBuffers(1, &mId);
+        glBindBuffer(target, mId);
+        glBufferStorage(target, mFrameSize * FRAME_COUNT, null, MAP_FLAGS);
+        mData = (u8*) glMapBufferRange(target, 0, mFrameSize * FRAME_COUNT, MAP_FLAGS);
+        glBindBuffer(target, 0);
+
+        if (!mData) {
+            error("RingBuffer: failed to map {0} bytes persistently", mFrameSize * FRAME_COUNT);
+        }
+
+        // the first begin moves to region 0
+        mFrame = FRAME_COUNT - 1;
+        mHead = 0;
+    }
+
+    void RingBuffer::free() {
+        for (auto& fence : mFences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = null;
+            }
+        }
+
+        if (mData) {
+            glBindBuffer(mTarget, mId);
+            glUnmapBuffer(mTarget);
+            glBindBuffer(mTarget, 0);
+            mData = null;
+        }
+
+        glDeleteBuffers(1, &mId);
+        mId = 0;
+    }
+
+    void RingBuffer::begin() {
+        mFrame = (mFrame + 1) % FRAME_COUNT;
+        mHead = 0;
+
+        GLsync& fence = mFences[mFrame];
+        if (fence) {
+            // commands are flushed on first wait only, next waits poll in 1ms steps
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (true) {
+                GLenum status = glClientWaitSync(fence, flags, 1000000);
+                if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                    break;
+                }
+                if (status == GL_WAIT_FAILED) {
+                    error("RingBuffer: failed to wait for frame {0}", mFrame);
+                    break;
+                }
+                flags = 0;
+            }
+            glDeleteSync(fence);
+            fence = null;
+        }
+
+        glBindBufferRange(mTarget, mBinding, mId, mFrame * mFrameSize, mFrameSize);
+    }
+
+    void RingBuffer::end() {
+        if (mFences[mFrame]) {
+            glDeleteSync(mFences[mFrame]);
+        }
+        mFences[mFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void* RingBuffer::allocate(size_t size, size_t alignment, size_t& offset) {
+        size_t head = (mHead + alignment - 1) / alignment * alignment;
+        if (!mData || head + size > mFrameSize) {
+            return null;
+        }
+
+        offset = head;
+        mHead = head + size;
+        return mData + mFrame * mFrameSize + head;
+    }
+
+}
@@ -1,54 +1,147 @@
 #include <api/shader.h>
+#include <api/state_cache.h>
 
 #include "io/writers.h"
+#include "io/derived_data_cache.h"
+#include "io/file_system.h"
 
 namespace gl {
 
-    std::string ShaderReader::read(const std::string& path, std::string includeIdentifier) {
-        includeIdentifier += ' ';
-        static bool recursive = false;
+    std::unordered_map<std::string, ShaderReader::Include> ShaderReader::s_includes;
 
-        std::string fullSrc = "";
-        std::ifstream file(path);
+    std::string ShaderReader::read(const std::string& path, const std::string& includeIdentifier, std::vector<std::string>* includes) {
+        const Include* include = resolve(path, includeIdentifier, 0);
+        if (!include) {
+            return {};
+        }
+
+        if (includes) {
+            includes->insert(includes->end(), include->includes.begin(), include->includes.end());
+        }
+
+        return include->src;
+    }
+
+    void ShaderReader::free() {
+        s_includes.clear();
+    }
 
-        if (!file.is_open()) {
+    const ShaderReader::Include* ShaderReader::resolve(const std::string& path, const std::string& includeIdentifier, u32 depth) {
+        std::string key = includeIdentifier + "|" + FileSystem::normalize(path);
+        auto it = s_includes.find(key);
+        if (it != s_includes.end()) {
+            return &it->second;
+        }
+
+        if (depth > MAX_INCLUDE_DEPTH) {
+            error("Shader includes are nested deeper than {0} at {1}, they are probably cyclic", MAX_INCLUDE_DEPTH, path);
+            return null;
+        }
+
+        std::string text;
+        if (!FileSystem::readText(path, text)) {
             error("Failed to open file {0}", path.c_str());
-            return fullSrc;
+            return null;
         }
 
-        std::string lineBuffer;
-        while (std::getline(file, lineBuffer)) {
-            // Look for the new m_shader include identifier
-            if (lineBuffer.find(includeIdentifier) != lineBuffer.npos) {
-                // Remove the include identifier, this will cause the path to remain
-                lineBuffer.erase(0, includeIdentifier.size());
+        // include paths are relative to the including file
+        std::string directory;
+        getFilepath(path, directory);
 
-                // The include path is relative to the current m_shader file path
-                std::string pathOfThisFile;
-                getFilepath(path, pathOfThisFile);
-                lineBuffer.insert(0, pathOfThisFile);
+        Include result;
+        result.src.reserve(text.size());
 
-                // By using recursion, the new include file can be extracted
-                // and inserted at this location in the m_shader source code
-                recursive = true;
-                fullSrc += read(lineBuffer, includeIdentifier);
+        size_t lineBegin = 0;
+        while (lineBegin < text.size()) {
+            size_t lineEnd = text.find('\n', lineBegin);
+            if (lineEnd == std::string::npos) {
+                lineEnd = text.size();
+            }
 
-                // Do not add this line to the m_shader source code, as the include
-                // path would generate a compilation issue in the final source code
-                continue;
+            size_t begin = text.find_first_not_of(" \t", lineBegin);
+            if (begin < lineEnd && text.compare(begin, includeIdentifier.size(), includeIdentifier) == 0) {
+                size_t pathBegin = text.find_first_not_of(" \t\"<", begin + includeIdentifier.size());
+                size_t pathEnd = text.find_last_not_of(" \t\r\">", lineEnd - 1);
+                if (pathBegin < lineEnd && pathEnd >= pathBegin) {
+                    std::string includePath = directory + text.substr(pathBegin, pathEnd - pathBegin + 1);
+                    result.includes.emplace_back(includePath);
+                    // nested include is resolved once and its source is spliced in place of directive
+                    const Include* include = resolve(includePath, includeIdentifier, depth + 1);
+                    if (include) {
+                        result.src += include->src;
+                        result.includes.insert(result.includes.end(), include->includes.begin(), include->includes.end());
+                    }
+                }
+            } else {
+                result.src.append(text, lineBegin, lineEnd - lineBegin);
+                result.src += '\n';
+            }
+
+            lineBegin = lineEnd + 1;
+        }
+
+        return &(s_includes[key] = std::move(result));
+    }
+
+    static constexpr u32 SHADER_CACHE_MAGIC = 0x52445347; // GSDR
+    static constexpr u32 SHADER_CACHE_VERSION = 2;
+
+    std::string ShaderReader::readCached(const std::string& path, const std::string& includeIdentifier) {
+        u64 sourceHash = DerivedDataCache::hashFile(path);
+        if (sourceHash == 0) {
+            return read(path, includeIdentifier);
+        }
+
+        std::string cachePath = DerivedDataCache::getPath("shaders", DerivedDataCache::hash(includeIdentifier, sourceHash), ".glsl");
+
+        // entry: dependency count | dependency path and content hash | source
+        BinaryStream stream;
+        if (DerivedDataCache::load(cachePath, stream) && stream.size() >= sizeof(u32) * 3) {
+            u32 magic = 0;
+            u32 version = 0;
+            u32 includeCount = 0;
+            stream.get(magic);
+            stream.get(version);
+            stream.get(includeCount);
+
+            bool valid = magic == SHADER_CACHE_MAGIC && version == SHADER_CACHE_VERSION;
+            for (u32 i = 0 ; valid && i < includeCount ; i++) {
+                std::string include;
+                u64 includeHash = 0;
+                stream.getString(include);
+                stream.get(includeHash);
+                valid = DerivedDataCache::hashFile(include) == includeHash;
             }
 
-            fullSrc += lineBuffer + '\n';
+            if (valid) {
+                std::string src;
+                stream.getString(src);
+                return src;
+            }
         }
 
-        // Only add the null terminator at the end of the complete file,
-        // essentially skipping recursive function calls this way
-        if (!recursive)
-            fullSrc += '\0';
+        std::vector<std::string> includes;
+        std::string src = read(path, includeIdentifier, &includes);
+        if (src.empty()) {
+            return src;
+        }
 
-        file.close();
+        stream.clear();
+        u32 magic = SHADER_CACHE_MAGIC;
+        u32 version = SHADER_CACHE_VERSION;
+        u32 includeCount = includes.size();
+        stream.add(magic);
+        stream.add(version);
+        stream.add(includeCount);
+        for (auto& include : includes) {
+            u64 includeHash = DerivedDataCache::hashFile(include);
+            stream.addString(include);
+            stream.add(includeHash);
+        }
+        stream.addString(src);
+        DerivedDataCache::store(cachePath, stream);
 
-        return fullSrc;
+        return src;
     }
 
     void ShaderReader::getFilepath(
@@ -60,14 +153,11 @@ namespace gl {
         pathWithoutFilename = fullPath.substr(0, found + 1);
     }
 
-    ShaderStage::ShaderStage(u32 type, const char* filepath) {
-
-        // read and preprocess shader from filepath
-        std::string src = ShaderReader::read(filepath);
-        const char* cSrc = src.c_str();
+    ShaderStage::ShaderStage(u32 type, const char* filepath, const std::string& src) {
+        id = 0;
         if (src.empty()) {
             error("Failed to read stage from file {0}", filepath);
-            id = 0;
+            return;
         }
 
 #ifdef DEBUG
@@ -77,6 +167,7 @@ namespace gl {
 #endif
 
         // create and compile shader
+        const char* cSrc = src.c_str();
         id = glCreateShader(type);
         glShaderSource(id, 1, &cSrc, null);
         glCompileShader(id);
@@ -88,6 +179,7 @@ namespace gl {
         if (!status) {
             glGetShaderInfoLog(id, 512, null, info);
             error("Failed stage compilation {0}", info);
+            glDeleteShader(id);
             id = 0;
         }
     }
@@ -109,83 +201,284 @@ namespace gl {
         FileWriter::write(generatedFilepath.c_str(), src);
     }
 
-    void Shader::complete() {
-        if (stages.empty()) {
-            error("Shader has no stages to complete");
+    static constexpr u32 PROGRAM_CACHE_MAGIC = 0x47525047; // GPRG
+    static constexpr u32 PROGRAM_CACHE_VERSION = 1;
+
+    u64 Shader::getDriverHash() {
+        static u64 driverHash = 0;
+        if (driverHash == 0) {
+            std::stringstream ss;
+            ss << glGetString(GL_VENDOR) << "|" << glGetString(GL_RENDERER) << "|" << glGetString(GL_VERSION);
+            driverHash = DerivedDataCache::hash(ss.str());
+        }
+        return driverHash;
+    }
+
+    u64 Shader::getProgramKey() const {
+        u64 key = DerivedDataCache::hash(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION), getDriverHash());
+        for (auto& stage : stages) {
+            key = DerivedDataCache::hash(&stage.type, sizeof(stage.type), key);
+            key = DerivedDataCache::hash(stage.src, key);
+        }
+        return key;
+    }
+
+    bool Shader::loadBinary(const std::string& cachePath) {
+        // entry: magic | version | binary format | binary
+        BinaryStream stream;
+        if (!DerivedDataCache::load(cachePath, stream) || stream.size() <= sizeof(u32) * 3) {
+            return false;
+        }
+
+        u32 magic = 0;
+        u32 version = 0;
+        u32 format = 0;
+        stream.get(magic);
+        stream.get(version);
+        stream.get(format);
+        if (magic != PROGRAM_CACHE_MAGIC || version != PROGRAM_CACHE_VERSION) {
+            return false;
+        }
+
+        size_t headerSize = sizeof(u32) * 3;
+        id = glCreateProgram();
+        glProgramBinary(id, format, stream.data() + headerSize, stream.size() - headerSize);
+
+        // driver may reject binary after update, then program is built from sources
+        int status;
+        glGetProgramiv(id, GL_LINK_STATUS, &status);
+        if (!status) {
+            glDeleteProgram(id);
+            id = 0;
+            return false;
+        }
+
+        return true;
+    }
+
+    void Shader::storeBinary(const std::string& cachePath) {
+        int length = 0;
+        glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
             return;
         }
 
+        std::vector<u8> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(id, length, &length, &format, binary.data());
+
+        BinaryStream stream;
+        u32 magic = PROGRAM_CACHE_MAGIC;
+        u32 version = PROGRAM_CACHE_VERSION;
+        u32 binaryFormat = format;
+        stream.add(magic);
+        stream.add(version);
+        stream.add(binaryFormat);
+        stream.add(binary.data(), length);
+        DerivedDataCache::store(cachePath, stream);
+    }
+
+    bool Shader::link() {
+        std::vector<u32> ids;
+        ids.reserve(stages.size());
+        for (auto& stage : stages) {
+            u32 stageId = ShaderStage(stage.type, stage.filepath.c_str(), stage.src).id;
+            if (stageId != 0) {
+                ids.emplace_back(stageId);
+            }
+        }
+
         id = glCreateProgram();
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-        for (u32 stage : stages) {
-            glAttachShader(id, stage);
+        for (u32 stageId : ids) {
+            glAttachShader(id, stageId);
         }
 
         glLinkProgram(id);
 
+        for (u32 stageId : ids) {
+            glDetachShader(id, stageId);
+            glDeleteShader(stageId);
+        }
+
         int status;
         char info[512];
         glGetProgramiv(id, GL_LINK_STATUS, &status);
         if (!status) {
             glGetProgramInfoLog(id, 512, null, info);
             error("Failed shader program linkage {0}", info);
+            return false;
+        }
+
+        return true;
+    }
+
+    void Shader::complete() {
+        if (stages.empty()) {
+            error("Shader has no stages to complete");
+            return;
+        }
+
+        mSourceHash = 0;
+        for (auto& stage : stages) {
+            mSourceHash = DerivedDataCache::hash(&stage.type, sizeof(stage.type), mSourceHash);
+            mSourceHash = DerivedDataCache::hash(stage.src, mSourceHash);
+        }
+
+        int binaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+
+        std::string cachePath;
+        if (binaryFormats > 0) {
+            cachePath = DerivedDataCache::getPath("programs", getProgramKey(), ".bin");
+            if (loadBinary(cachePath)) {
+                stages.clear();
+                reflect();
+                return;
+            }
+        }
+
+        if (link() && binaryFormats > 0) {
+            storeBinary(cachePath);
+        }
+
+        stages.clear();
+        reflect();
+    }
+
+    void Shader::reflect() {
+        mUniforms.clear();
+
+        int count = 0;
+        int maxLength = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        if (count <= 0) {
+            return;
+        }
+
+        // every array element gets its own slot, so table is sized after counting them
+        std::vector<std::string> names(count);
+        std::vector<int> sizes(count);
+        std::vector<char> name(maxLength + 1);
+        u32 slotCount = 0;
+        for (int i = 0 ; i < count ; i++) {
+            int length = 0;
+            GLenum type;
+            glGetActiveUniform(id, i, maxLength + 1, &length, &sizes[i], &type, name.data());
+            names[i].assign(name.data(), length);
+            slotCount += sizes[i] + 1;
+        }
+
+        size_t capacity = 16;
+        while (capacity < slotCount * 2) {
+            capacity *= 2;
+        }
+        mUniforms.resize(capacity);
+
+        for (int i = 0 ; i < count ; i++) {
+            auto& uniformName = names[i];
+            int location = glGetUniformLocation(id, uniformName.c_str());
+            // members of uniform blocks have no location
+            if (location < 0) {
+                continue;
+            }
+
+            // arrays are reported as "name[0]", both "name" and every "name[i]" are addressable
+            size_t bracket = uniformName.size() > 3 ? uniformName.size() - 3 : std::string::npos;
+            if (bracket != std::string::npos && uniformName.compare(bracket, 3, "[0]") == 0) {
+                std::string baseName = uniformName.substr(0, bracket);
+                u64 baseHash = UniformName::hash(baseName.c_str());
+                addUniform(baseHash, location);
+                addUniform(UniformName::hashIndex(0, baseHash), location);
+                for (int element = 1 ; element < sizes[i] ; element++) {
+                    std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                    addUniform(UniformName::hashIndex(element, baseHash), glGetUniformLocation(id, elementName.c_str()));
+                }
+            } else {
+                addUniform(UniformName::hash(uniformName.c_str()), location);
+            }
+        }
+    }
+
+    void Shader::addUniform(u64 hash, int location) {
+        if (hash == 0 || location < 0) {
             return;
         }
 
-        for (u32 stage : stages) {
-            glDeleteShader(stage);
+        size_t mask = mUniforms.size() - 1;
+        for (size_t i = hash & mask ; ; i = (i + 1) & mask) {
+            auto& slot = mUniforms[i];
+            if (slot.hash == 0) {
+                slot.hash = hash;
+                slot.location = location;
+                return;
+            }
+
+            if (slot.hash == hash) {
+                if (slot.location != location) {
+                    error("Uniforms with locations {0} and {1} have the same name hash", slot.location, location);
+                }
+                return;
+            }
+        }
+    }
+
+    int Shader::getUniformLocation(u64 hash) const {
+        if (mUniforms.empty()) {
+            return -1;
+        }
+
+        size_t mask = mUniforms.size() - 1;
+        for (size_t i = hash & mask ; ; i = (i + 1) & mask) {
+            auto& slot = mUniforms[i];
+            if (slot.hash == hash) {
+                return slot.location;
+            }
+            if (slot.hash == 0) {
+                return -1;
+            }
         }
     }
 
     void Shader::use() {
-        glUseProgram(id);
+        StateCache::useProgram(id);
     }
 
     void Shader::stop() {
-        glUseProgram(0);
+        StateCache::useProgram(0);
     }
 
     void Shader::free() {
-        glDeleteProgram(id);
+        StateCache::deleteProgram(id);
     }
 
     int Shader::getUniformLocation(const char* name) const {
-        return glGetUniformLocation(id, name);
+        return getUniformLocation(UniformName::hash(name));
     }
 
     int Shader::getUniformArrayLocation(u32 index, const char* name) {
-        std::stringstream ss;
-        ss << name << "[" << index << "]";
-        std::string s = ss.str();
-        return getUniformLocation(s.c_str());
+        return getUniformLocation(UniformName::hashIndex(index, UniformName::hash(name)));
     }
 
     int Shader::getUniformStructLocation(const char *structName, const char *fieldName) {
-        std::stringstream ss;
-        ss << structName << "." << fieldName;
-        std::string s = ss.str();
-        return getUniformLocation(s.c_str());
+        return getUniformLocation(UniformName::hashField(structName, fieldName));
     }
 
     int Shader::getUniformArrayStructLocation(const char *structName, const char *fieldName, u32 index) {
-        std::stringstream ss;
-        ss << structName << "." << fieldName << "[" << index << "]";
-        std::string s = ss.str();
-        return getUniformLocation(s.c_str());
+        return getUniformLocation(UniformName::hashIndex(index, UniformName::hashField(structName, fieldName)));
     }
 
     int Shader::getUniformStructArrayLocation(const char* structName, const char* fieldName, u32 index) {
-        std::stringstream ss;
-        ss << structName << "[" << index << "]" << "." << fieldName;
-        std::string s = ss.str();
-        return getUniformLocation(s.c_str());
+        u64 hash = UniformName::hashIndex(index, UniformName::hash(structName));
+        return getUniformLocation(UniformName::hash(fieldName, UniformName::hash(".", hash)));
     }
 
     int Shader::getUniformArrayStructArrayLocation(const char* structName, const char* fieldName, u32 struct_index, u32 field_index) {
-        std::stringstream ss;
-        ss << structName << "[" << struct_index << "]" << "." << fieldName << "[" << field_index << "]";
-        std::string s = ss.str();
-        return getUniformLocation(s.c_str());
+        u64 hash = UniformName::hashIndex(struct_index, UniformName::hash(structName));
+        hash = UniformName::hash(fieldName, UniformName::hash(".", hash));
+        return getUniformLocation(UniformName::hashIndex(field_index, hash));
     }
 
     void Shader::setUniform(int location, float value) {
@@ -294,15 +587,22 @@ namespace gl {
         setUniform(getUniformStructLocation(struct_name, name), slot);
     }
 
+    void Shader::bindSampler(const SamplerHandle& sampler, int slot, const ImageBuffer& buffer) {
+        ImageBuffer::bindActivate(buffer.type, buffer.id, slot);
+        setUniform(getUniformLocation(sampler.hash), slot);
+    }
+
     void Shader::bindSamplerStruct(const char* struct_name, const ImageSampler& sampler, const ImageBuffer &buffer) {
         bindSamplerStruct(struct_name, sampler.name, sampler.slot, buffer);
     }
 
     void Shader::addStage(u32 type, const char* filepath) {
-        u32 stage = ShaderStage(type, filepath).id;
-        if (stage != 0) {
-            stages.emplace_back(stage);
-        }
+        // stages are compiled by complete only if program binary isn't cached
+        StageSource stage;
+        stage.type = type;
+        stage.filepath = filepath;
+        stage.src = ShaderReader::readCached(filepath);
+        stages.emplace_back(stage);
     }
 
     void Shader::addVertexStage(const char *filepath) {
@@ -0,0 +1,358 @@
+#include <api/state_cache.h>
+
+namespace gl {
+
+    static constexpr u32 UNKNOWN = 0xFFFFFFFF;
+
+#ifdef DEBUG
+    bool StateCache::validation = true;
+#else
+    bool StateCache::validation = false;
+#endif
+
+    StateCacheStats StateCache::s_stats;
+    u32 StateCache::s_capabilities[CAPABILITY_COUNT];
+    u32 StateCache::s_program;
+    u32 StateCache::s_vao;
+    u32 StateCache::s_drawFramebuffer;
+    u32 StateCache::s_readFramebuffer;
+    u32 StateCache::s_activeTexture;
+    StateCache::TextureUnit StateCache::s_textureUnits[TEXTURE_UNITS];
+    u32 StateCache::s_blendSrc;
+    u32 StateCache::s_blendDst;
+    u32 StateCache::s_blendEquation;
+    u32 StateCache::s_depthFunc;
+    u32 StateCache::s_depthMask;
+    u32 StateCache::s_stencilFunc;
+    int StateCache::s_stencilRef;
+    u32 StateCache::s_stencilFuncMask;
+    u32 StateCache::s_stencilFail;
+    u32 StateCache::s_stencilDepthFail;
+    u32 StateCache::s_stencilDepthPass;
+    u32 StateCache::s_stencilMask;
+    u32 StateCache::s_cullFace;
+
+    static const u32 CAPABILITIES[] = { GL_DEPTH_TEST, GL_STENCIL_TEST, GL_BLEND, GL_CULL_FACE };
+
+    void StateCache::init() {
+        invalidate();
+        resetStats();
+    }
+
+    void StateCache::invalidate() {
+        std::fill(std::begin(s_capabilities), std::end(s_capabilities), UNKNOWN);
+        s_program = UNKNOWN;
+        s_vao = UNKNOWN;
+        s_drawFramebuffer = UNKNOWN;
+        s_readFramebuffer = UNKNOWN;
+        s_activeTexture = UNKNOWN;
+        for (auto& unit : s_textureUnits) {
+            unit = { UNKNOWN, UNKNOWN };
+        }
+        s_blendSrc = UNKNOWN;
+        s_blendDst = UNKNOWN;
+        s_blendEquation = UNKNOWN;
+        s_depthFunc = UNKNOWN;
+        s_depthMask = UNKNOWN;
+        s_stencilFunc = UNKNOWN;
+        s_stencilRef = 0;
+        s_stencilFuncMask = UNKNOWN;
+        s_stencilFail = UNKNOWN;
+        s_stencilDepthFail = UNKNOWN;
+        s_stencilDepthPass = UNKNOWN;
+        s_stencilMask = UNKNOWN;
+        s_cullFace = UNKNOWN;
+    }
+
+    bool StateCache::skip(bool equal) {
+        if (equal) {
+            s_stats.skipped++;
+        } else {
+            s_stats.issued++;
+        }
+        return equal;
+    }
+
+    int StateCache::getCapability(u32 capability) {
+        for (int i = 0 ; i < CAPABILITY_COUNT ; i++) {
+            if (CAPABILITIES[i] == capability) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void StateCache::setEnabled(u32 capability, bool enabled) {
+        int index = getCapability(capability);
+        if (index != -1) {
+            if (skip(s_capabilities[index] == (u32) enabled)) {
+                return;
+            }
+            s_capabilities[index] = enabled;
+        }
+
+        if (enabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+
+    void StateCache::enable(u32 capability) {
+        setEnabled(capability, true);
+    }
+
+    void StateCache::disable(u32 capability) {
+        setEnabled(capability, false);
+    }
+
+    void StateCache::useProgram(u32 program) {
+        if (skip(s_program == program)) {
+            return;
+        }
+        s_program = program;
+        glUseProgram(program);
+    }
+
+    void StateCache::bindVertexArray(u32 vao) {
+        if (skip(s_vao == vao)) {
+            return;
+        }
+        s_vao = vao;
+        glBindVertexArray(vao);
+    }
+
+    void StateCache::bindFramebuffer(u32 target, u32 framebuffer) {
+        if (target == GL_FRAMEBUFFER) {
+            if (skip(s_drawFramebuffer == framebuffer && s_readFramebuffer == framebuffer)) {
+                return;
+            }
+            s_drawFramebuffer = framebuffer;
+            s_readFramebuffer = framebuffer;
+        } else if (target == GL_DRAW_FRAMEBUFFER) {
+            if (skip(s_drawFramebuffer == framebuffer)) {
+                return;
+            }
+            s_drawFramebuffer = framebuffer;
+        } else {
+            if (skip(s_readFramebuffer == framebuffer)) {
+                return;
+            }
+            s_readFramebuffer = framebuffer;
+        }
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    void StateCache::activeTexture(int slot) {
+        if (skip(s_activeTexture == (u32) slot)) {
+            return;
+        }
+        s_activeTexture = slot;
+        glActiveTexture(GL_TEXTURE0 + slot);
+    }
+
+    void StateCache::bindTexture(u32 type, u32 texture) {
+        // unit stays unknown until active texture is set through cache
+        if (s_activeTexture >= TEXTURE_UNITS) {
+            s_stats.issued++;
+            glBindTexture(type, texture);
+            return;
+        }
+
+        // unit remembers last bound target only, binding of another target is always issued
+        TextureUnit& unit = s_textureUnits[s_activeTexture];
+        if (skip(unit.type == type && unit.texture == texture)) {
+            return;
+        }
+        unit = { type, texture };
+        glBindTexture(type, texture);
+    }
+
+    void StateCache::bindTexture(int slot, u32 type, u32 texture) {
+        // texture already bound to unit needs no switch of active unit either
+        if (slot < TEXTURE_UNITS && s_textureUnits[slot].type == type && s_textureUnits[slot].texture == texture) {
+            s_stats.skipped++;
+            return;
+        }
+        activeTexture(slot);
+        bindTexture(type, texture);
+    }
+
+    void StateCache::setBlendFunc(u32 src, u32 dst) {
+        if (skip(s_blendSrc == src && s_blendDst == dst)) {
+            return;
+        }
+        s_blendSrc = src;
+        s_blendDst = dst;
+        glBlendFunc(src, dst);
+    }
+
+    void StateCache::setBlendFunc(u32 buffer, u32 src, u32 dst) {
+        s_stats.issued++;
+        s_blendSrc = UNKNOWN;
+        s_blendDst = UNKNOWN;
+        glBlendFunci(buffer, src, dst);
+    }
+
+    void StateCache::setBlendEquation(u32 mode) {
+        if (skip(s_blendEquation == mode)) {
+            return;
+        }
+        s_blendEquation = mode;
+        glBlendEquation(mode);
+    }
+
+    void StateCache::setDepthFunc(u32 func) {
+        if (skip(s_depthFunc == func)) {
+            return;
+        }
+        s_depthFunc = func;
+        glDepthFunc(func);
+    }
+
+    void StateCache::setDepthMask(bool mask) {
+        if (skip(s_depthMask == (u32) mask)) {
+            return;
+        }
+        s_depthMask = mask;
+        glDepthMask(mask);
+    }
+
+    void StateCache::setStencilFunc(u32 func, int ref, u32 mask) {
+        if (skip(s_stencilFunc == func && s_stencilRef == ref && s_stencilFuncMask == mask)) {
+            return;
+        }
+        s_stencilFunc = func;
+        s_stencilRef = ref;
+        s_stencilFuncMask = mask;
+        glStencilFunc(func, ref, mask);
+    }
+
+    void StateCache::setStencilOp(u32 stencilFail, u32 depthFail, u32 depthPass) {
+        if (skip(s_stencilFail == stencilFail && s_stencilDepthFail == depthFail && s_stencilDepthPass == depthPass)) {
+            return;
+        }
+        s_stencilFail = stencilFail;
+        s_stencilDepthFail = depthFail;
+        s_stencilDepthPass = depthPass;
+        glStencilOp(stencilFail, depthFail, depthPass);
+    }
+
+    void StateCache::setStencilMask(u32 mask) {
+        if (skip(s_stencilMask == mask)) {
+            return;
+        }
+        s_stencilMask = mask;
+        glStencilMask(mask);
+    }
+
+    void StateCache::setCullFace(u32 face) {
+        if (skip(s_cullFace == face)) {
+            return;
+        }
+        s_cullFace = face;
+        glCullFace(face);
+    }
+
+    void StateCache::deleteProgram(u32 program) {
+        if (s_program == program) {
+            s_program = UNKNOWN;
+        }
+        glDeleteProgram(program);
+    }
+
+    void StateCache::deleteVertexArray(u32 vao) {
+        if (s_vao == vao) {
+            s_vao = 0;
+        }
+        glDeleteVertexArrays(1, &vao);
+    }
+
+    void StateCache::deleteFramebuffer(u32 framebuffer) {
+        if (s_drawFramebuffer == framebuffer) {
+            s_drawFramebuffer = 0;
+        }
+        if (s_readFramebuffer == framebuffer) {
+            s_readFramebuffer = 0;
+        }
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    void StateCache::deleteTexture(u32 texture) {
+        for (auto& unit : s_textureUnits) {
+            if (unit.texture == texture) {
+                unit.texture = 0;
+            }
+        }
+        glDeleteTextures(1, &texture);
+    }
+
+    static u32 getInteger(u32 name) {
+        int value = 0;
+        glGetIntegerv(name, &value);
+        return value;
+    }
+
+    static bool validateState(const char* name, u32 cached, u32 actual) {
+        if (cached == UNKNOWN || cached == actual) {
+            return true;
+        }
+        error("StateCache: {0} is {1} in cache, but {2} in driver", name, cached, actual);
+        return false;
+    }
+
+    static u32 getTextureBinding(u32 type) {
+        switch (type) {
+            case GL_TEXTURE_1D: return GL_TEXTURE_BINDING_1D;
+            case GL_TEXTURE_2D: return GL_TEXTURE_BINDING_2D;
+            case GL_TEXTURE_3D: return GL_TEXTURE_BINDING_3D;
+            case GL_TEXTURE_2D_ARRAY: return GL_TEXTURE_BINDING_2D_ARRAY;
+            case GL_TEXTURE_CUBE_MAP: return GL_TEXTURE_BINDING_CUBE_MAP;
+            case GL_TEXTURE_CUBE_MAP_ARRAY: return GL_TEXTURE_BINDING_CUBE_MAP_ARRAY;
+            case GL_TEXTURE_2D_MULTISAMPLE: return GL_TEXTURE_BINDING_2D_MULTISAMPLE;
+            default: return 0;
+        }
+    }
+
+    bool StateCache::validate() {
+        bool valid = true;
+
+        for (int i = 0 ; i < CAPABILITY_COUNT ; i++) {
+            valid &= validateState("capability", s_capabilities[i], glIsEnabled(CAPABILITIES[i]));
+        }
+
+        valid &= validateState("program", s_program, getInteger(GL_CURRENT_PROGRAM));
+        valid &= validateState("vertex array", s_vao, getInteger(GL_VERTEX_ARRAY_BINDING));
+        valid &= validateState("draw framebuffer", s_drawFramebuffer, getInteger(GL_DRAW_FRAMEBUFFER_BINDING));
+        valid &= validateState("read framebuffer", s_readFramebuffer, getInteger(GL_READ_FRAMEBUFFER_BINDING));
+
+        u32 activeTexture = getInteger(GL_ACTIVE_TEXTURE);
+        valid &= validateState("active texture", s_activeTexture == UNKNOWN ? UNKNOWN : GL_TEXTURE0 + s_activeTexture, activeTexture);
+        for (u32 slot = 0 ; slot < TEXTURE_UNITS ; slot++) {
+            const TextureUnit& unit = s_textureUnits[slot];
+            u32 binding = getTextureBinding(unit.type);
+            if (unit.type == UNKNOWN || binding == 0) {
+                continue;
+            }
+            glActiveTexture(GL_TEXTURE0 + slot);
+            valid &= validateState("texture", unit.texture, getInteger(binding));
+        }
+        glActiveTexture(activeTexture);
+
+        valid &= validateState("blend src", s_blendSrc, getInteger(GL_BLEND_SRC_RGB));
+        valid &= validateState("blend dst", s_blendDst, getInteger(GL_BLEND_DST_RGB));
+        valid &= validateState("blend equation", s_blendEquation, getInteger(GL_BLEND_EQUATION_RGB));
+        valid &= validateState("depth func", s_depthFunc, getInteger(GL_DEPTH_FUNC));
+        valid &= validateState("depth mask", s_depthMask, getInteger(GL_DEPTH_WRITEMASK));
+        valid &= validateState("stencil func", s_stencilFunc, getInteger(GL_STENCIL_FUNC));
+        valid &= validateState("stencil func mask", s_stencilFuncMask, getInteger(GL_STENCIL_VALUE_MASK));
+        valid &= validateState("stencil fail", s_stencilFail, getInteger(GL_STENCIL_FAIL));
+        valid &= validateState("stencil depth fail", s_stencilDepthFail, getInteger(GL_STENCIL_PASS_DEPTH_FAIL));
+        valid &= validateState("stencil depth pass", s_stencilDepthPass, getInteger(GL_STENCIL_PASS_DEPTH_PASS));
+        valid &= validateState("stencil mask", s_stencilMask, getInteger(GL_STENCIL_WRITEMASK));
+        valid &= validateState("cull face", s_cullFace, getInteger(GL_CULL_FACE_MODE));
+
+        return valid;
+    }
+
+}
@@ -11,11 +11,18 @@ namespace gl {
         update();
     }
 
+    Camera::Camera(const u32 binding, int width, int height) : mWidth(width), mHeight(height) {
+        mUbo.init(binding, sizeof(CameraUniform));
+        update();
+    }
+
     Camera::~Camera() {
         mUbo.free();
     }
 
     void Camera::onMouseCursor(const double x, const double y, const float dt) {
+        if (!mWindow) return;
+
         if (!enableLook || !mWindow->isMousePress(GLFW_MOUSE_BUTTON_RIGHT)) {
             mWindow->setCursorMode(CursorMode::NORMAL);
             return;
@@ -50,11 +57,11 @@ namespace gl {
 #ifdef IMGUI
 
         if (!enableLook || !ImGui::IsMouseDown(GLFW_MOUSE_BUTTON_RIGHT)) {
-            mWindow->setCursorMode(CursorMode::NORMAL);
+            if (mWindow) mWindow->setCursorMode(CursorMode::NORMAL);
             return;
         }
 
-        mWindow->setCursorMode(CursorMode::DISABLED);
+        if (mWindow) mWindow->setCursorMode(CursorMode::DISABLED);
         float fx = x;
         float fy = y;
 
@@ -83,10 +90,10 @@ namespace gl {
 
     void Camera::onMouseScroll(const double y, const float dt) {
         if (!enableZoom) {
-            mWindow->setCursorMode(CursorMode::NORMAL);
+            if (mWindow) mWindow->setCursorMode(CursorMode::NORMAL);
             return;
         }
-        mWindow->setCursorMode(CursorMode::DISABLED);
+        if (mWindow) mWindow->setCursorMode(CursorMode::DISABLED);
 
         mZoomedFOV -= (float) y * zoomSpeed / dt;
         clamp(mZoomedFOV, 1.0f, fov);
@@ -129,7 +136,7 @@ namespace gl {
     }
 
     void Camera::move(const float dt) {
-        if (!enableMove) return;
+        if (!enableMove || !mWindow) return;
 
         float distance = moveSpeed / dt;
 
@@ -195,7 +202,9 @@ namespace gl {
     ViewRay Camera::raycastView(const double x, const double y) {
         // mouse Screen -> NDC
         ScreenRay mouseScreenRay((float) x, (float) y, -1.0f, 1.0f);
-        NDCRay mouseNdcRay = mouseScreenRay.ndcSpace(mWindow->getFrameWidth(), mWindow->getFrameHeight());
+        int width = mWindow ? mWindow->getFrameWidth() : mWidth;
+        int height = mWindow ? mWindow->getFrameHeight() : mHeight;
+        NDCRay mouseNdcRay = mouseScreenRay.ndcSpace(width, height);
         // mouse NDC -> Clip
         // ignore inverse perspective division, since mouse NDC ray is a vector without depth length
         ClipRay mouseClipRay(mouseNdcRay.x(), mouseNdcRay.y(), -1, 1);
@@ -211,21 +220,13 @@ namespace gl {
     }
 
     Frustum Camera::frustrum() {
-        Frustum frustum;
-        const float halfVSide = zFar * tanf(fov * 0.5f);
-        const float halfHSide = halfVSide * getAspectRatio();
-        const glm::vec3 frontMultFar = zFar * front;
-        glm::vec3 right = glm::cross(front, up);
-        float positionLength = glm::length(position);
-
-        frustum.nearFace = { glm::length(position + zNear * front), front };
-        frustum.farFace = { glm::length(position + frontMultFar), -front };
-        frustum.rightFace = { positionLength, glm::cross(frontMultFar - right * halfHSide, up) };
-        frustum.leftFace = { positionLength, glm::cross(up, frontMultFar + right * halfHSide) };
-        frustum.topFace = { positionLength, glm::cross(right, frontMultFar - up * halfVSide) };
-        frustum.bottomFace = { positionLength, glm::cross(frontMultFar + up * halfVSide, right) };
-
-        return frustum;
+        return Frustum(perspective() * view());
+    }
+
+    float Camera::getPixelsPerUnit(float distance) const {
+        float height = mWindow ? (float) mWindow->getHeight() : (float) mHeight;
+        float projection = height / (2.0f * tanf(glm::radians(fov) * 0.5f));
+        return projection / std::max(distance, zNear);
     }
 
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include <core/application.h>
+#include <api/state_cache.h>
+#include <api/null_device.h>
 
 namespace gl {
 
+    static const char* ARCHIVE_FILEPATH = "Assets.gpak";
+
     static void onWindowError(int code, const char* message) {
         error("Error code: {0}\nError message: {1}", code, message);
     }
@@ -23,6 +27,7 @@ namespace gl {
 
         while (mRunning) {
             Timer::begin();
+            Profiler::beginFrame();
 
             mRunning = mWindow->isOpen();
 
@@ -44,8 +49,12 @@ namespace gl {
 
             }
 
-            mWindow->swap();
+            {
+                PROFILE_SCOPE("Swap");
+                mWindow->swap();
+            }
 
+            Profiler::endFrame();
             Timer::end();
 
             printDt();
@@ -56,20 +65,136 @@ namespace gl {
         onDestroy();
     }
 
+    bool Application::pack(const char* archiveFilepath, const std::vector<std::string>& directories) {
+#ifdef DEBUG
+        initLogger();
+#endif
+        bool packed = PackedArchive::pack(archiveFilepath, directories);
+#ifdef DEBUG
+        Logger::free();
+#endif
+        return packed;
+    }
+
+    void Application::runHeadless(const HeadlessParams& params) {
+        mHeadless = params;
+        mHeadless.enabled = true;
+        onCreate();
+
+        if (!mDevice || !mScene || !mCamera) {
+            error("Headless run has no GL context, scene or camera to render");
+            onDestroy();
+            return;
+        }
+
+        // fixed step keeps simulation and animations equal between runs
+        const float dt = 1000.0f / 60.0f;
+        std::vector<float> frameTimes;
+        frameTimes.reserve(mHeadless.frames);
+
+        for (u32 i = 0 ; i < mHeadless.warmupFrames + mHeadless.frames ; i++) {
+            if (i == mHeadless.warmupFrames && mHeadless.nullDevice) {
+                NullDevice::resetStats();
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            Profiler::beginFrame();
+
+            onSimulate(dt);
+            onRender(dt);
+            // waits for GPU, so that frame time includes all work of frame
+            {
+                PROFILE_SCOPE("Finish");
+                glFinish();
+            }
+
+            Profiler::endFrame();
+
+            TimeMillis frameTime = std::chrono::steady_clock::now() - begin;
+            if (i >= mHeadless.warmupFrames) {
+                frameTimes.emplace_back(frameTime.count());
+            }
+        }
+
+        std::vector<float> sortedTimes = frameTimes;
+        std::sort(sortedTimes.begin(), sortedTimes.end());
+        float total = 0;
+        for (float frameTime : frameTimes) {
+            total += frameTime;
+        }
+        info("Headless: {0} frames {1}x{2}, avg={3} ms, min={4} ms, p50={5} ms, p95={6} ms, max={7} ms",
+             frameTimes.size(), mWidth, mHeight,
+             total / frameTimes.size(),
+             sortedTimes.front(),
+             sortedTimes[sortedTimes.size() / 2],
+             sortedTimes[sortedTimes.size() * 95 / 100],
+             sortedTimes.back());
+
+        if (mHeadless.nullDevice) {
+            const NullDeviceStats& stats = NullDevice::getStats();
+            u64 frames = frameTimes.size();
+            info("Headless: per frame GL calls={0}, buffer={1}, texture={2}, shader={3}, draw={4}, uniform={5}",
+                 stats.calls / frames, stats.bufferCalls / frames, stats.textureCalls / frames,
+                 stats.shaderCalls / frames, stats.drawCalls / frames, stats.uniformCalls / frames);
+            info("Headless: per frame bytes buffer={0}, texture={1}, uniform={2}",
+                 stats.bufferBytes / frames, stats.textureBytes / frames, stats.uniformBytes / frames);
+
+            auto calls = NullDevice::getCalls();
+            for (size_t i = 0 ; i < std::min<size_t>(calls.size(), 10) ; i++) {
+                info("Headless: {0} calls per frame={1}", calls[i].name, calls[i].calls / frames);
+            }
+        }
+
+        if (mHeadless.dumpFilepath && mHeadless.nullDevice) {
+            info("Headless: null device renders nothing, {0} is not written", mHeadless.dumpFilepath);
+        } else if (mHeadless.dumpFilepath) {
+            dumpFinalRenderTarget(mHeadless.dumpFilepath);
+        }
+
+        if (mHeadless.traceFilepath) {
+            Profiler::exportTrace(mHeadless.traceFilepath);
+        }
+
+        onDestroy();
+    }
+
     void Application::onCreate() {
 
 #ifdef DEBUG
         initLogger();
 #endif
 
-        initWindow();
+        Profiler::setThreadName("Main");
+
+        ThreadPool::init();
+
+        IOService::init();
+
+        // shipping builds read assets and shaders from archive, development builds read loose files without it
+        if (std::filesystem::exists(ARCHIVE_FILEPATH)) {
+            FileSystem::mount(ARCHIVE_FILEPATH);
+        }
+
+        if (mHeadless.enabled) {
+            initHeadless();
+            if (mHeadlessContext && !mHeadlessContext->isCreated()) {
+                error("Failed to create headless GL context, nothing can be rendered");
+                return;
+            }
+        } else {
+            initWindow();
+        }
 
         initApi();
 
+        ResourceLoader::init();
+
         initNetwork();
 
 #ifdef IMGUI
-        initImgui();
+        if (!mHeadless.enabled) {
+            initImgui();
+        }
 #endif
 
     }
@@ -77,6 +202,20 @@ namespace gl {
     void Application::onCreateImgui() {}
 
     void Application::onDestroy() {
+        // onCreate stopped before device was created, only services started ahead of it are freed
+        if (!mDevice) {
+            FileSystem::free();
+            IOService::free();
+            ThreadPool::free();
+            Profiler::free();
+            delete mWindow;
+            delete mHeadlessContext;
+#ifdef DEBUG
+            Logger::free();
+#endif
+            return;
+        }
+
         delete mDatabaseService;
         delete mTcpClient;
         NetworkCore::free();
@@ -93,8 +232,24 @@ namespace gl {
 
         LightStorage::free();
 
+        DrawStorage::free();
+
+        GeometryPool::free();
+
         FontAtlas::free();
 
+        ResourceLoader::free();
+
+        TextureStreamer::free();
+
+        TextureCache::free();
+
+        ShaderReader::free();
+
+        DerivedDataCache::free();
+
+        FileSystem::free();
+
         delete mScreenRenderer;
 
         delete mPbrPipeline;
@@ -105,20 +260,33 @@ namespace gl {
         delete mHdrRenderer;
         delete mBlurRenderer;
         delete mBloomRenderer;
+        mRenderTargetPool.free();
 
         mTerrainBuilder.free();
 
         delete mEntityControl;
 
 #ifdef IMGUI
-        ImguiCore::free();
+        if (!mHeadless.enabled) {
+            ImguiCore::free();
+        }
 #endif
 
         delete mEnvironment;
         delete mScene;
 
+        IOService::free();
+
+        ThreadPool::free();
+
+        // after worker threads are joined, so that none of them writes into freed profiler rings
+        Profiler::free();
         delete mDevice;
         delete mWindow;
+        delete mHeadlessContext;
+        if (mHeadless.nullDevice) {
+            NullDevice::free();
+        }
 
 #ifdef DEBUG
         delete mDebugger;
@@ -128,51 +296,82 @@ namespace gl {
     }
 
     void Application::onRender(const float dt) {
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_STENCIL_TEST);
-        glEnable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
-        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glStencilMask(GL_FALSE);
+        // resources that finished loading are uploaded before anything is drawn with them
+        {
+            PROFILE_SCOPE("ResourceLoader");
+            ResourceLoader::update();
+        }
+
+        {
+            PROFILE_SCOPE("Streaming");
+            LodSelector::select(mScene, *mCamera);
+            TextureStreamer::update(mScene, *mCamera);
+        }
+
+        StateCache::resetStats();
+
+        StateCache::enable(GL_DEPTH_TEST);
+        StateCache::enable(GL_STENCIL_TEST);
+        StateCache::enable(GL_BLEND);
+        StateCache::enable(GL_CULL_FACE);
+        StateCache::setStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        StateCache::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        StateCache::setStencilMask(GL_FALSE);
+        DrawStorage::begin();
         mShadowPipeline->render();
         mPbrPipeline->render();
-        mRayTraceRenderer->render();
+        DrawStorage::end();
+        {
+            PROFILE_PASS("RayTrace");
+            mRayTraceRenderer->render();
+        }
         mColorFrame = mPbrPipeline->getColorFrame();
         mDepthFrame = mPbrPipeline->getDepthFrame();
 
         // Post processing chain
-        glDisable(GL_CULL_FACE);
-        glDisable(GL_STENCIL_TEST);
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
+        StateCache::disable(GL_CULL_FACE);
+        StateCache::disable(GL_STENCIL_TEST);
+        StateCache::disable(GL_DEPTH_TEST);
+        StateCache::disable(GL_BLEND);
         mScreenRenderer->getParams().buffer = mPbrPipeline->getRenderTarget();
         onRenderPostFX(dt);
 
         // UI pipeline
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
+        StateCache::enable(GL_DEPTH_TEST);
+        StateCache::enable(GL_BLEND);
 
-        mUiPipeline->blitColorDepth(mWidth, mHeight, mColorFrame.id, mDepthFrame.id);
-        mUiPipeline->render();
+        {
+            PROFILE_PASS("UI");
+            mUiPipeline->blitColorDepth(mWidth, mHeight, mColorFrame.id, mDepthFrame.id);
+            mUiPipeline->render();
+        }
         mColorFrame = mUiPipeline->getColorFrame();
         mDepthFrame = mUiPipeline->getDepthFrame();
         mFinalRenderTarget = mUiPipeline->getRenderTarget();
 
-        glDisable(GL_BLEND);
+        StateCache::disable(GL_BLEND);
+
+        // headless frame ends in final render target, there is no back buffer and ImGui
+        if (mHeadless.enabled) {
+            StateCache::disable(GL_DEPTH_TEST);
+            return;
+        }
 
 #ifdef IMGUI
 
-        glEnable(GL_CULL_FACE);
+        StateCache::enable(GL_CULL_FACE);
 
-        mVisualsPipeline->blitColorDepth(mWidth, mHeight, mColorFrame.id, mDepthFrame.id);
-        mVisualsPipeline->render();
+        {
+            PROFILE_PASS("Visuals");
+            mVisualsPipeline->blitColorDepth(mWidth, mHeight, mColorFrame.id, mDepthFrame.id);
+            mVisualsPipeline->render();
+        }
         mColorFrame = mVisualsPipeline->getColorFrame();
         mDepthFrame = mVisualsPipeline->getDepthFrame();
         mFinalRenderTarget = mVisualsPipeline->getRenderTarget();
 
-        glDisable(GL_CULL_FACE);
-        glDisable(GL_DEPTH_TEST);
+        StateCache::disable(GL_CULL_FACE);
+        StateCache::disable(GL_DEPTH_TEST);
 
 #ifdef DEBUG
 
@@ -188,12 +387,18 @@ namespace gl {
 
 #endif
 
-        mScreenRenderer->render();
+        {
+            PROFILE_PASS("Screen");
+            mScreenRenderer->render();
+        }
+        if (StateCache::validation) {
+            StateCache::validate();
+        }
         renderImgui(dt);
 
 #else
 
-        glDisable(GL_DEPTH_TEST);
+        StateCache::disable(GL_DEPTH_TEST);
 
 #ifdef DEBUG
 
@@ -209,47 +414,93 @@ namespace gl {
 
 #endif
 
-        mScreenRenderer->renderBackBuffer();
+        {
+            PROFILE_PASS("Screen");
+            mScreenRenderer->renderBackBuffer();
+        }
+        if (StateCache::validation) {
+            StateCache::validate();
+        }
 
 #endif
 
     }
 
+    u32 Application::addPostFX(
+            const char* name, u32 input, const RenderTextureDesc& desc,
+            const std::function<void(const ImageBuffer&, const FrameBuffer&)>& render
+    ) {
+        u32 output = mPostFxGraph.createTexture(name, desc);
+        u32 pass = mPostFxGraph.addPass(name, [input, output, render](const RenderGraphResources& resources) {
+            render(resources.getTexture(input), *resources.getFrame(output));
+        });
+        mPostFxGraph.read(pass, input);
+        mPostFxGraph.write(pass, output);
+        return output;
+    }
+
     void Application::onRenderPostFX(const float dt) {
+        PROFILE_PASS("PostFX");
+        // every effect is declared, disabled effects are left out of chain and culled by graph
+        mPostFxGraph.clear();
+        u32 color = mPostFxGraph.importTexture("scene", mScreenRenderer->getParams().buffer);
+        RenderTextureDesc hdrDesc = { mWidth, mHeight, GL_RGB16F, GL_RGB, PixelType::FLOAT };
+        RenderTextureDesc ldrDesc = { mWidth, mHeight, GL_RGB, GL_RGB, PixelType::U8 };
+
         // Bloom effect
+        u32 bloom = addPostFX("bloom", color, hdrDesc, [this](const ImageBuffer& input, const FrameBuffer& output) {
+            mBloomRenderer->getHdrBuffer() = input;
+            mBloomRenderer->render(output);
+        });
         if (mBloomRenderer->isEnabled) {
-            mBloomRenderer->getHdrBuffer() = mScreenRenderer->getParams().buffer;
-            mBloomRenderer->render();
-            mScreenRenderer->getParams().buffer = mBloomRenderer->getRenderTarget();
-            mColorFrame = mBloomRenderer->getColorFrame();
+            color = bloom;
         }
         // HDR effect
+        u32 hdr = addPostFX("hdr", color, ldrDesc, [this](const ImageBuffer& input, const FrameBuffer& output) {
+            mHdrRenderer->getParams().sceneBuffer = input;
+            mHdrRenderer->render(output);
+        });
         if (mHdrRenderer->isEnabled) {
-            mHdrRenderer->getParams().sceneBuffer = mScreenRenderer->getParams().buffer;
-            mHdrRenderer->render();
-            mScreenRenderer->getParams().buffer = mHdrRenderer->getRenderTarget();
-            mColorFrame = mHdrRenderer->getColorFrame();
+            color = hdr;
         }
         // FXAA effect
+        u32 fxaa = addPostFX("fxaa", color, ldrDesc, [this](const ImageBuffer& input, const FrameBuffer& output) {
+            mFxaaRenderer->getParams().srcBuffer = input;
+            mFxaaRenderer->render(output);
+        });
         if (mFxaaRenderer->isEnabled) {
-            mFxaaRenderer->getParams().srcBuffer = mScreenRenderer->getParams().buffer;
-            mFxaaRenderer->render();
-            mScreenRenderer->getParams().buffer = mFxaaRenderer->getRenderTarget();
-            mColorFrame = mFxaaRenderer->getColorFrame();
+            color = fxaa;
         }
         // Blur effect
+        u32 blur = addPostFX("blur", color, ldrDesc, [this](const ImageBuffer& input, const FrameBuffer& output) {
+            mBlurRenderer->getParams().sceneBuffer = input;
+            mBlurRenderer->render(output);
+        });
         if (mBlurRenderer->isEnabled) {
-            mBlurRenderer->getParams().sceneBuffer = mScreenRenderer->getParams().buffer;
-            mBlurRenderer->render();
-            mScreenRenderer->getParams().buffer = mBlurRenderer->getRenderTarget();
-            mColorFrame = mBlurRenderer->getColorFrame();
+            color = blur;
+        }
+
+        mPostFxGraph.setOutput(color);
+        if (!mPostFxGraph.compile()) {
+            return;
+        }
+        mRenderTargetPool.acquire(mPostFxGraph);
+        mPostFxGraph.execute(mRenderTargetPool);
+
+        mScreenRenderer->getParams().buffer = mRenderTargetPool.getTexture(color);
+        const FrameBuffer* colorFrame = mRenderTargetPool.getFrame(color);
+        if (colorFrame) {
+            mColorFrame = *colorFrame;
         }
     }
 
     void Application::renderImgui(const float dt) {
+        PROFILE_PASS("ImGui");
         ImguiCore::begin();
         onRenderImgui(dt);
         ImguiCore::end();
+        // ImGui backend changes GL state behind the cache
+        StateCache::invalidate();
 
         if (ImguiCore::close) {
             mWindow->close();
@@ -303,6 +554,7 @@ namespace gl {
         mCamera = camera;
         mShadowPipeline->directShadow.camera = camera;
         mShadowPipeline->pointShadow.camera = camera;
+        mPbrPipeline->camera = camera;
 
 #ifdef IMGUI
         ImguiCore::camera = mCamera;
@@ -334,8 +586,36 @@ namespace gl {
         mWindow->loadIcon(mLogoName);
     }
 
+    void Application::initHeadless() {
+        if (mHeadless.nullDevice && !NullDevice::isSupported()) {
+            error("Headless: null device is not supported on this platform, real GL context is used instead");
+            mHeadless.nullDevice = false;
+        }
+
+        if (mHeadless.nullDevice) {
+            // IBL maps and other data read back from GPU would be garbage, so that they are kept apart from real cache
+            DerivedDataCache::setDirectory(DerivedDataCache::getDirectory() + "/null_device");
+            info("Headless: null device, GL calls are counted and nothing is rendered");
+            return;
+        }
+        mHeadlessContext = new HeadlessContext(mWidth, mHeight);
+    }
+
     void Application::initApi() {
-        mDevice = new Device(mWidth, mHeight);
+        void* (*loader)(const char* name) = null;
+        if (mHeadless.nullDevice) {
+            loader = NullDevice::getProcAddress;
+        } else if (mHeadlessContext) {
+            loader = HeadlessContext::getProcAddress;
+        }
+        mDevice = new Device(mWidth, mHeight, loader);
+        StateCache::init();
+        // null device keeps no state to validate cache against
+        if (mHeadless.nullDevice) {
+            StateCache::validation = false;
+            // timestamps of null device are zero
+            Profiler::isGpuEnabled = false;
+        }
 
 #ifdef DEBUG
         mDebugger = new Debugger();
@@ -343,12 +623,12 @@ namespace gl {
 
         mScreenRenderer = new ScreenRenderer(mWidth, mHeight);
 
-        mHdrRenderer = new HdrRenderer(mWidth, mHeight);
+        mHdrRenderer = new HdrRenderer();
         mHdrRenderer->isEnabled = true;
         mHdrRenderer->getParams().exposure.value = 1.2f;
         mHdrRenderer->updateExposure();
 
-        mBlurRenderer = new BlurRenderer(mWidth, mHeight);
+        mBlurRenderer = new BlurRenderer();
         mBlurRenderer->isEnabled = false;
 
         mBloomRenderer = new BloomRenderer(mWidth, mHeight);
@@ -380,6 +660,7 @@ namespace gl {
         mPbrPipeline->setDirectShadow(&mShadowPipeline->directShadow);
         mPbrPipeline->setPointShadow(&mShadowPipeline->pointShadow);
         mPbrPipeline->terrain = &mTerrainBuilder.terrain;
+        mPbrPipeline->camera = mCamera;
 
         mUiPipeline = new UI_Pipeline(mScene, mWidth, mHeight);
         mVisualsPipeline = new VisualsPipeline(mScene, mWidth, mHeight);
@@ -392,6 +673,10 @@ namespace gl {
         FontAtlas::init();
 
         EnvStorage::init();
+
+        DrawStorage::init();
+
+        GeometryPool::init();
     }
 
     void Application::initNetwork() {
@@ -437,6 +722,31 @@ namespace gl {
         }
     }
 
+    void Application::dumpFinalRenderTarget(const char* filepath) {
+        Image image;
+        image.width = mWidth;
+        image.height = mHeight;
+        image.channels = 4;
+        image.init();
+        glGetTextureImage(mFinalRenderTarget.id, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.size(), image.pixels);
+
+        // GL rows go from bottom to top
+        size_t rowSize = image.width * image.channels;
+        std::vector<u8> row(rowSize);
+        u8* pixels = (u8*) image.pixels;
+        for (int y = 0 ; y < image.height / 2 ; y++) {
+            u8* top = pixels + y * rowSize;
+            u8* bottom = pixels + (image.height - 1 - y) * rowSize;
+            memcpy(row.data(), top, rowSize);
+            memcpy(top, bottom, rowSize);
+            memcpy(bottom, row.data(), rowSize);
+        }
+
+        ImageWriter::write(filepath, image);
+        image.free();
+        info("Headless: final render target is written into {0}", filepath);
+    }
+
     void Application::onWindowClose() {
         trace("");
     }
@@ -464,8 +774,6 @@ namespace gl {
         mWindow->onFrameResized(w, h);
 
         mScreenRenderer->resize(w, h);
-        mHdrRenderer->resize(w, h);
-        mBlurRenderer->resize(w, h);
         mBloomRenderer->resize(w, h);
         mSsaoRenderer->resize(w, h);
         mFxaaRenderer->resize(w, h);
@@ -1,7 +1,84 @@
 #include "core/assimp_core.h"
+#include "io/file_system.h"
+
+#include "assimp/IOSystem.hpp"
+#include "assimp/IOStream.hpp"
 
 namespace gl {
 
+    // read-only stream over virtual file, so that Assimp and its references to materials and textures go through FileSystem
+    struct FileSystemStream final : Assimp::IOStream {
+        FileBlob blob;
+        size_t cursor = 0;
+
+        size_t Read(void* buffer, size_t size, size_t count) override {
+            if (size == 0) {
+                return 0;
+            }
+            size_t readCount = std::min(count, (blob.size - cursor) / size);
+            std::memcpy(buffer, blob.data + cursor, readCount * size);
+            cursor += readCount * size;
+            return readCount;
+        }
+
+        size_t Write(const void* buffer, size_t size, size_t count) override {
+            return 0;
+        }
+
+        aiReturn Seek(size_t offset, aiOrigin origin) override {
+            size_t position = offset;
+            if (origin == aiOrigin_CUR) {
+                position = cursor + offset;
+            } else if (origin == aiOrigin_END) {
+                position = blob.size - offset;
+            }
+
+            if (position > blob.size) {
+                return aiReturn_FAILURE;
+            }
+            cursor = position;
+            return aiReturn_SUCCESS;
+        }
+
+        size_t Tell() const override {
+            return cursor;
+        }
+
+        size_t FileSize() const override {
+            return blob.size;
+        }
+
+        void Flush() override {}
+    };
+
+    struct FileSystemIO final : Assimp::IOSystem {
+
+        bool Exists(const char* filepath) const override {
+            return FileSystem::exists(filepath);
+        }
+
+        char getOsSeparator() const override {
+            return '/';
+        }
+
+        Assimp::IOStream* Open(const char* filepath, const char* mode) override {
+            if (std::strchr(mode, 'w') || std::strchr(mode, 'a')) {
+                return null;
+            }
+
+            auto* stream = new FileSystemStream();
+            if (!FileSystem::read(filepath, stream->blob)) {
+                delete stream;
+                return null;
+            }
+            return stream;
+        }
+
+        void Close(Assimp::IOStream* stream) override {
+            delete stream;
+        }
+    };
+
     glm::vec3 AssimpCore::toVec3(const aiVector3D& vec3) {
         return { vec3.x, vec3.y, vec3.z };
     }
@@ -24,6 +101,8 @@ namespace gl {
             const std::string &filepath, u32 flags
     ) {
         Assimp::Importer importer;
+        // importer owns IO handler
+        importer.SetIOHandler(new FileSystemIO());
         const aiScene* scene = importer.ReadFile(filepath, flags);
 
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
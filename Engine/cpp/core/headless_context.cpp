@@ -0,0 +1,171 @@
+#include <core/headless_context.h>
+
+#include <glad/glad.h>
+
+#if defined(OSMESA)
+#include <GL/osmesa.h>
+#elif defined(LINUX)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace gl {
+
+    HeadlessParams HeadlessParams::parse(int argc, char** argv) {
+        HeadlessParams params;
+
+        for (int i = 1 ; i < argc ; i++) {
+            const char* arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (strcmp(arg, "--headless") == 0) {
+                params.enabled = true;
+            } else if (strcmp(arg, "--null-device") == 0) {
+                params.nullDevice = true;
+            } else if (strcmp(arg, "--frames") == 0 && hasValue) {
+                params.frames = std::max(atoi(argv[++i]), 1);
+            } else if (strcmp(arg, "--warmup") == 0 && hasValue) {
+                params.warmupFrames = std::max(atoi(argv[++i]), 0);
+            } else if (strcmp(arg, "--dump") == 0 && hasValue) {
+                params.dumpFilepath = argv[++i];
+            } else if (strcmp(arg, "--trace") == 0 && hasValue) {
+                params.traceFilepath = argv[++i];
+            }
+        }
+
+        return params;
+    }
+
+#if defined(OSMESA)
+
+    HeadlessContext::HeadlessContext(int width, int height, int majorVersion, int minorVersion) {
+        const int attributes[] = {
+                OSMESA_FORMAT, OSMESA_RGBA,
+                OSMESA_DEPTH_BITS, 24,
+                OSMESA_STENCIL_BITS, 8,
+                OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+                OSMESA_CONTEXT_MAJOR_VERSION, majorVersion,
+                OSMESA_CONTEXT_MINOR_VERSION, minorVersion,
+                0
+        };
+
+        OSMesaContext context = OSMesaCreateContextAttribs(attributes, null);
+        if (!context) {
+            error("Failed to create OSMesa context {0}.{1}", majorVersion, minorVersion);
+            return;
+        }
+        mContext = context;
+
+        mBuffer.resize((size_t) width * height * 4);
+        if (!OSMesaMakeCurrent(context, mBuffer.data(), GL_UNSIGNED_BYTE, width, height)) {
+            error("Failed to make OSMesa context current");
+            return;
+        }
+
+        mCreated = true;
+        info("Headless context created with OSMesa {0}.{1}", majorVersion, minorVersion);
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        if (mContext) {
+            OSMesaDestroyContext((OSMesaContext) mContext);
+        }
+    }
+
+    void* HeadlessContext::getProcAddress(const char* name) {
+        return (void*) OSMesaGetProcAddress(name);
+    }
+
+#elif defined(LINUX)
+
+    HeadlessContext::HeadlessContext(int width, int height, int majorVersion, int minorVersion) {
+        // surfaceless platform doesn't need display server, default display is used if driver doesn't provide it
+        EGLDisplay display = EGL_NO_DISPLAY;
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, null);
+        }
+        if (display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint eglMajor, eglMinor;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajor, &eglMinor)) {
+            error("Failed to initialize EGL display, error={0}", eglGetError());
+            return;
+        }
+        mDisplay = display;
+
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            error("Failed to bind OpenGL API to EGL, error={0}", eglGetError());
+            return;
+        }
+
+        const EGLint configAttributes[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+            error("Failed to choose EGL config, error={0}", eglGetError());
+            return;
+        }
+
+        const EGLint contextAttributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+                EGL_CONTEXT_MINOR_VERSION, minorVersion,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifdef DEBUG
+                EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+                EGL_NONE
+        };
+        EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT) {
+            error("Failed to create EGL context {0}.{1}, error={2}", majorVersion, minorVersion, eglGetError());
+            return;
+        }
+        mContext = context;
+
+        // requires EGL_KHR_surfaceless_context
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            error("Failed to make EGL context current without surface, error={0}", eglGetError());
+            return;
+        }
+
+        mCreated = true;
+        info("Headless context created with EGL {0}.{1}, OpenGL {2}.{3}", eglMajor, eglMinor, majorVersion, minorVersion);
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        if (!mDisplay) {
+            return;
+        }
+
+        eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (mContext) {
+            eglDestroyContext(mDisplay, mContext);
+        }
+        eglTerminate(mDisplay);
+    }
+
+    void* HeadlessContext::getProcAddress(const char* name) {
+        return (void*) eglGetProcAddress(name);
+    }
+
+#else
+
+    HeadlessContext::HeadlessContext(int width, int height, int majorVersion, int minorVersion) {
+        error("Headless context requires EGL on Linux or engine built with OSMESA");
+    }
+
+    HeadlessContext::~HeadlessContext() = default;
+
+    void* HeadlessContext::getProcAddress(const char* name) {
+        return null;
+    }
+
+#endif
+
+}
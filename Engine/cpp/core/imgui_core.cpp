@@ -1,6 +1,7 @@
 #include <core/imgui_core.h>
 
 #include <io/image_loader.h>
+#include <io/file_system.h>
 
 #include <imgui/gizmo.h>
 
@@ -38,6 +39,9 @@ namespace gl {
     TransparentRenderer* ImguiCore::transparentRenderer = null;
 
     ShadowPipeline* ImguiCore::shadowPipeline = null;
+
+    // font data is read through FileSystem and must outlive atlas, which doesn't own it
+    static std::vector<FileBlob> s_fontBlobs;
     PBR_Pipeline* ImguiCore::pbrPipeline = null;
     UI_Pipeline* ImguiCore::uiPipeline = null;
     VisualsPipeline* ImguiCore::visualsPipeline = null;
@@ -78,6 +82,7 @@ namespace gl {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
+        s_fontBlobs.clear();
     }
 
     void ImguiCore::setDarkTheme() {
@@ -148,12 +153,25 @@ namespace gl {
             callback->resample(samples);
     }
 
+    static ImFont* addFont(ImGuiIO* io, const char* filepath, float size, ImFontConfig config = {}, const ImWchar* ranges = null) {
+        FileBlob blob;
+        if (!FileSystem::read(filepath, blob)) {
+            error("Failed to read font {0}", filepath);
+            return null;
+        }
+
+        config.FontDataOwnedByAtlas = false;
+        ImFont* font = io->Fonts->AddFontFromMemoryTTF((void*) blob.data, (int) blob.size, size, &config, ranges);
+        s_fontBlobs.emplace_back(std::move(blob));
+        return font;
+    }
+
     void ImguiCore::addRegularFont(const char* filepath, float size) {
-        regularFont = IO->Fonts->AddFontFromFileTTF(filepath, size);
+        regularFont = addFont(IO, filepath, size);
     }
 
     void ImguiCore::addBoldFont(const char* filepath, float size) {
-        boldFont = IO->Fonts->AddFontFromFileTTF(filepath, size);
+        boldFont = addFont(IO, filepath, size);
     }
 
     void ImguiCore::addIconFont(const char* filepath, float size) {
@@ -163,7 +181,7 @@ namespace gl {
         iconsConfig.MergeMode = true;
         iconsConfig.PixelSnapH = true;
 
-        IO->Fonts->AddFontFromFileTTF(filepath, size, &iconsConfig, iconsRange);
+        addFont(IO, filepath, size, iconsConfig, iconsRange);
     }
 
     void ImguiCore::setFont(ImFont *font) {
@@ -0,0 +1,256 @@
+#include <core/offset_allocator.h>
+
+namespace gl {
+
+    static u32 findLastSet(u32 value) {
+        u32 bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+
+    static u32 findFirstSet(u32 value) {
+        u32 bit = 0;
+        while (!(value & 1)) {
+            value >>= 1;
+            bit++;
+        }
+        return bit;
+    }
+
+    void OffsetAllocator::init(u32 size) {
+        mNodes.clear();
+        mReleasedNodes.clear();
+        std::fill(std::begin(mBins), std::end(mBins), OffsetAllocation::INVALID);
+        mFirstLevelMask = 0;
+        std::fill(std::begin(mSecondLevelMasks), std::end(mSecondLevelMasks), 0);
+        mSize = 0;
+        mFreeSize = 0;
+        mLastNode = OffsetAllocation::INVALID;
+        grow(size);
+    }
+
+    void OffsetAllocator::free() {
+        mNodes.clear();
+        mNodes.shrink_to_fit();
+        mReleasedNodes.clear();
+        mReleasedNodes.shrink_to_fit();
+        mSize = 0;
+        mFreeSize = 0;
+    }
+
+    u32 OffsetAllocator::getBin(u32 size) {
+        if (size < SECOND_LEVEL_COUNT) {
+            return size;
+        }
+        u32 msb = findLastSet(size);
+        u32 firstLevel = msb - SECOND_LEVEL_BITS + 1;
+        u32 secondLevel = (size >> (msb - SECOND_LEVEL_BITS)) & (SECOND_LEVEL_COUNT - 1);
+        return firstLevel * SECOND_LEVEL_COUNT + secondLevel;
+    }
+
+    u32 OffsetAllocator::getBinRoundUp(u32 size) {
+        if (size < SECOND_LEVEL_COUNT) {
+            return size;
+        }
+        // any node of rounded bin fits the size
+        u32 round = (1u << (findLastSet(size) - SECOND_LEVEL_BITS)) - 1;
+        if (size > 0xFFFFFFFF - round) {
+            return BIN_COUNT;
+        }
+        return getBin(size + round);
+    }
+
+    u32 OffsetAllocator::createNode(u32 offset, u32 size) {
+        u32 index;
+        if (mReleasedNodes.empty()) {
+            index = mNodes.size();
+            mNodes.emplace_back();
+        } else {
+            index = mReleasedNodes.back();
+            mReleasedNodes.pop_back();
+            mNodes[index] = {};
+        }
+        mNodes[index].offset = offset;
+        mNodes[index].size = size;
+        return index;
+    }
+
+    void OffsetAllocator::releaseNode(u32 node) {
+        mReleasedNodes.emplace_back(node);
+    }
+
+    void OffsetAllocator::insertFree(u32 index) {
+        Node& node = mNodes[index];
+        u32 bin = getBin(node.size);
+        u32 head = mBins[bin];
+
+        node.used = false;
+        node.prevFree = OffsetAllocation::INVALID;
+        node.nextFree = head;
+        if (head != OffsetAllocation::INVALID) {
+            mNodes[head].prevFree = index;
+        }
+        mBins[bin] = index;
+
+        mFirstLevelMask |= 1u << (bin / SECOND_LEVEL_COUNT);
+        mSecondLevelMasks[bin / SECOND_LEVEL_COUNT] |= 1u << (bin % SECOND_LEVEL_COUNT);
+        mFreeSize += node.size;
+    }
+
+    void OffsetAllocator::removeFree(u32 index) {
+        Node& node = mNodes[index];
+        u32 bin = getBin(node.size);
+
+        if (node.prevFree != OffsetAllocation::INVALID) {
+            mNodes[node.prevFree].nextFree = node.nextFree;
+        } else {
+            mBins[bin] = node.nextFree;
+        }
+        if (node.nextFree != OffsetAllocation::INVALID) {
+            mNodes[node.nextFree].prevFree = node.prevFree;
+        }
+
+        if (mBins[bin] == OffsetAllocation::INVALID) {
+            u32 firstLevel = bin / SECOND_LEVEL_COUNT;
+            mSecondLevelMasks[firstLevel] &= ~(1u << (bin % SECOND_LEVEL_COUNT));
+            if (mSecondLevelMasks[firstLevel] == 0) {
+                mFirstLevelMask &= ~(1u << firstLevel);
+            }
+        }
+
+        node.prevFree = OffsetAllocation::INVALID;
+        node.nextFree = OffsetAllocation::INVALID;
+        mFreeSize -= node.size;
+    }
+
+    u32 OffsetAllocator::findFree(u32 size) const {
+        u32 bin = getBinRoundUp(size);
+        if (bin < BIN_COUNT) {
+            u32 firstLevel = bin / SECOND_LEVEL_COUNT;
+            u32 secondLevelMask = mSecondLevelMasks[firstLevel] & (~0u << (bin % SECOND_LEVEL_COUNT));
+            if (secondLevelMask) {
+                return mBins[firstLevel * SECOND_LEVEL_COUNT + findFirstSet(secondLevelMask)];
+            }
+
+            u32 firstLevelMask = firstLevel + 1 < FIRST_LEVEL_COUNT ? mFirstLevelMask & (~0u << (firstLevel + 1)) : 0;
+            if (firstLevelMask) {
+                firstLevel = findFirstSet(firstLevelMask);
+                return mBins[firstLevel * SECOND_LEVEL_COUNT + findFirstSet(mSecondLevelMasks[firstLevel])];
+            }
+        }
+
+        // larger bins are empty, nodes of exact bin may still fit
+        for (u32 node = mBins[getBin(size)] ; node != OffsetAllocation::INVALID ; node = mNodes[node].nextFree) {
+            if (mNodes[node].size >= size) {
+                return node;
+            }
+        }
+
+        return OffsetAllocation::INVALID;
+    }
+
+    OffsetAllocation OffsetAllocator::allocate(u32 size) {
+        OffsetAllocation allocation;
+        if (size == 0) {
+            return allocation;
+        }
+
+        u32 index = findFree(size);
+        if (index == OffsetAllocation::INVALID) {
+            return allocation;
+        }
+
+        removeFree(index);
+        mNodes[index].used = true;
+
+        // remainder stays free right after allocation, so that sequential allocations are packed
+        u32 remainder = mNodes[index].size - size;
+        if (remainder > 0) {
+            u32 rest = createNode(mNodes[index].offset + size, remainder);
+            Node& node = mNodes[index];
+            mNodes[rest].prev = index;
+            mNodes[rest].next = node.next;
+            if (node.next != OffsetAllocation::INVALID) {
+                mNodes[node.next].prev = rest;
+            } else {
+                mLastNode = rest;
+            }
+            node.next = rest;
+            node.size = size;
+            insertFree(rest);
+        }
+
+        allocation.offset = mNodes[index].offset;
+        allocation.node = index;
+        return allocation;
+    }
+
+    void OffsetAllocator::free(const OffsetAllocation& allocation) {
+        if (!allocation.isValid() || allocation.node >= mNodes.size() || !mNodes[allocation.node].used) {
+            return;
+        }
+
+        u32 index = allocation.node;
+        mNodes[index].used = false;
+
+        // merge with free neighbours
+        u32 prev = mNodes[index].prev;
+        if (prev != OffsetAllocation::INVALID && !mNodes[prev].used) {
+            removeFree(prev);
+            mNodes[prev].size += mNodes[index].size;
+            mNodes[prev].next = mNodes[index].next;
+            if (mNodes[index].next != OffsetAllocation::INVALID) {
+                mNodes[mNodes[index].next].prev = prev;
+            } else {
+                mLastNode = prev;
+            }
+            releaseNode(index);
+            index = prev;
+        }
+
+        u32 next = mNodes[index].next;
+        if (next != OffsetAllocation::INVALID && !mNodes[next].used) {
+            removeFree(next);
+            mNodes[index].size += mNodes[next].size;
+            mNodes[index].next = mNodes[next].next;
+            if (mNodes[next].next != OffsetAllocation::INVALID) {
+                mNodes[mNodes[next].next].prev = index;
+            } else {
+                mLastNode = index;
+            }
+            releaseNode(next);
+        }
+
+        insertFree(index);
+    }
+
+    void OffsetAllocator::grow(u32 size) {
+        if (size <= mSize) {
+            return;
+        }
+
+        u32 extra = size - mSize;
+        if (mLastNode != OffsetAllocation::INVALID && !mNodes[mLastNode].used) {
+            removeFree(mLastNode);
+            mNodes[mLastNode].size += extra;
+            insertFree(mLastNode);
+        } else {
+            u32 node = createNode(mSize, extra);
+            mNodes[node].prev = mLastNode;
+            if (mLastNode != OffsetAllocation::INVALID) {
+                mNodes[mLastNode].next = node;
+            }
+            mLastNode = node;
+            insertFree(node);
+        }
+
+        mSize = size;
+    }
+
+    u32 OffsetAllocator::getAllocationSize(const OffsetAllocation& allocation) const {
+        return allocation.isValid() ? mNodes[allocation.node].size : 0;
+    }
+
+}
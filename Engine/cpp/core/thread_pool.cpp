@@ -0,0 +1,92 @@
+#include <core/thread_pool.h>
+
+#include <debugging/profiler.h>
+
+namespace gl {
+
+    std::vector<std::thread> ThreadPool::s_threads;
+    std::queue<std::function<void()>> ThreadPool::s_jobs;
+    std::mutex ThreadPool::s_mutex;
+    std::condition_variable ThreadPool::s_condition;
+    bool ThreadPool::s_running = false;
+    thread_local bool ThreadPool::s_worker = false;
+
+    void ThreadPool::init(u32 threadCount) {
+        if (s_running) {
+            return;
+        }
+
+        if (threadCount == 0) {
+            u32 hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        s_running = true;
+        s_threads.reserve(threadCount);
+        for (u32 i = 0 ; i < threadCount ; i++) {
+            s_threads.emplace_back(work);
+        }
+
+        info("ThreadPool initialized with {0} threads", threadCount);
+    }
+
+    void ThreadPool::free() {
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            s_running = false;
+        }
+        s_condition.notify_all();
+
+        for (auto& thread : s_threads) {
+            thread.join();
+        }
+        s_threads.clear();
+    }
+
+    u32 ThreadPool::getThreadCount() {
+        return s_threads.size();
+    }
+
+    bool ThreadPool::isWorker() {
+        return s_worker;
+    }
+
+    void ThreadPool::enqueue(std::function<void()>&& job) {
+        // no workers, run in place so that callers don't block forever on futures
+        if (!s_running) {
+            job();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            s_jobs.emplace(std::move(job));
+        }
+        s_condition.notify_one();
+    }
+
+    void ThreadPool::work() {
+        s_worker = true;
+        Profiler::setThreadName("Worker");
+
+        while (true) {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock(s_mutex);
+                s_condition.wait(lock, [] { return !s_running || !s_jobs.empty(); });
+
+                if (!s_running && s_jobs.empty()) {
+                    return;
+                }
+
+                job = std::move(s_jobs.front());
+                s_jobs.pop();
+            }
+
+            PROFILE_SCOPE("Job");
+            job();
+        }
+    }
+
+}
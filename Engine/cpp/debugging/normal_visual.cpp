@@ -21,6 +21,7 @@ namespace gl {
         mShader.setUniformArgs("color", normalVisual.color);
         mShader.setUniformArgs("length", normalVisual.length);
         transform.update(mShader);
+        drawable.dequantization.update(mShader);
         drawable.draw();
     }
 
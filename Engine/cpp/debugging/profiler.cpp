@@ -0,0 +1,358 @@
+#include <debugging/profiler.h>
+
+#include <glad/glad.h>
+
+namespace gl {
+
+    struct ProfileThread final {
+        std::string name;
+        u32 index = 0;
+        u32 depth = 0;
+        std::vector<ProfileEvent> ring;
+        // written by owner thread only, events before it are complete
+        std::atomic<u64> head = 0;
+        // read by collecting thread only
+        u64 tail = 0;
+    };
+
+    struct GpuScope final {
+        const char* name;
+        u32 beginQuery;
+        u32 endQuery;
+        u32 depth;
+    };
+
+    struct GpuFrame final {
+        u64 frameIndex = 0;
+        std::vector<u32> queries;
+        u32 usedQueries = 0;
+        std::vector<GpuScope> scopes;
+        // CPU time minus GPU time at the beginning of frame
+        int64_t offset = 0;
+        bool pending = false;
+    };
+
+    bool Profiler::isEnabled = true;
+    bool Profiler::isGpuEnabled = true;
+
+    static const auto s_start = std::chrono::steady_clock::now();
+
+    static std::vector<ProfileThread*> s_threads;
+    static std::mutex s_threadsMutex;
+    static thread_local ProfileThread* t_thread = null;
+    static u32 s_mainThread = 0;
+
+    static std::vector<ProfileFrame> s_frames;
+    // index of oldest frame in s_frames once history is full
+    static u32 s_firstFrame = 0;
+    static u64 s_frameIndex = 0;
+    static u64 s_frameBegin = 0;
+
+    static GpuFrame s_gpuFrames[Profiler::GPU_LATENCY];
+    static u32 s_gpuDepth = 0;
+
+    static ProfileThread* getThread() {
+        if (t_thread) {
+            return t_thread;
+        }
+
+        auto* thread = new ProfileThread();
+        thread->ring.resize(Profiler::RING_SIZE);
+        {
+            std::lock_guard<std::mutex> lock(s_threadsMutex);
+            thread->index = s_threads.size();
+            thread->name = "Thread " + std::to_string(thread->index);
+            s_threads.emplace_back(thread);
+        }
+        t_thread = thread;
+        return thread;
+    }
+
+    void Profiler::setThreadName(const char* name) {
+        ProfileThread* thread = getThread();
+        std::lock_guard<std::mutex> lock(s_threadsMutex);
+        thread->name = name;
+    }
+
+    u64 Profiler::now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_start).count();
+    }
+
+    void Profiler::beginFrame() {
+        s_mainThread = getThread()->index;
+        s_frameIndex++;
+        s_frameBegin = now();
+
+        if (!isEnabled || !isGpuEnabled) {
+            return;
+        }
+
+        // frames in flight are read back as soon as GPU is done with them
+        for (u32 i = 0 ; i < GPU_LATENCY ; i++) {
+            resolveGpu(i);
+        }
+
+        // slot of this frame still holds queries of frame GPU_LATENCY frames ago,
+        // if GPU hasn't finished it yet, its timings are dropped instead of stalling CPU
+        u32 slot = s_frameIndex % GPU_LATENCY;
+
+        GpuFrame& gpuFrame = s_gpuFrames[slot];
+        gpuFrame.frameIndex = s_frameIndex;
+        gpuFrame.usedQueries = 0;
+        gpuFrame.scopes.clear();
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        gpuFrame.offset = (int64_t) now() - gpuNow;
+        gpuFrame.pending = true;
+    }
+
+    void Profiler::endFrame() {
+        if (!isEnabled) {
+            return;
+        }
+
+        ProfileFrame frame;
+        frame.index = s_frameIndex;
+        frame.begin = s_frameBegin;
+        frame.end = now();
+        collect(frame);
+
+        if (s_frames.size() < MAX_FRAMES) {
+            s_frames.emplace_back(std::move(frame));
+        } else {
+            s_frames[s_firstFrame] = std::move(frame);
+            s_firstFrame = (s_firstFrame + 1) % MAX_FRAMES;
+        }
+    }
+
+    void Profiler::collect(ProfileFrame& frame) {
+        std::lock_guard<std::mutex> lock(s_threadsMutex);
+        for (auto* thread : s_threads) {
+            u64 head = thread->head.load(std::memory_order_acquire);
+            // thread wrote more than ring holds since last collect
+            if (head - thread->tail > RING_SIZE - RING_MARGIN) {
+                thread->tail = head - (RING_SIZE - RING_MARGIN);
+            }
+
+            u64 first = thread->tail;
+            size_t firstEvent = frame.events.size();
+            for ( ; thread->tail < head ; thread->tail++) {
+                frame.events.emplace_back(thread->ring[thread->tail % RING_SIZE]);
+            }
+
+            // owner may have lapped the ring while events were copied, overwritten ones are dropped.
+            // slot of new head may be in the middle of writing, so that it counts as overwritten too
+            u64 newHead = thread->head.load(std::memory_order_acquire);
+            if (newHead + 1 > first + RING_SIZE) {
+                u64 overwritten = std::min<u64>(newHead + 1 - RING_SIZE, head) - first;
+                frame.events.erase(frame.events.begin() + firstEvent, frame.events.begin() + firstEvent + overwritten);
+            }
+        }
+    }
+
+    void Profiler::free() {
+        for (auto& gpuFrame : s_gpuFrames) {
+            if (!gpuFrame.queries.empty()) {
+                glDeleteQueries(gpuFrame.queries.size(), gpuFrame.queries.data());
+            }
+            gpuFrame = {};
+        }
+        s_gpuDepth = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(s_threadsMutex);
+            for (auto* thread : s_threads) {
+                delete thread;
+            }
+            s_threads.clear();
+        }
+        // other threads are stopped, only calling thread may still point to its ring
+        t_thread = null;
+
+        s_frames.clear();
+        s_firstFrame = 0;
+    }
+
+    u32 Profiler::beginGpu(const char* name) {
+        if (!isEnabled || !isGpuEnabled) {
+            return InvalidGpuScope;
+        }
+
+        GpuFrame& gpuFrame = s_gpuFrames[s_frameIndex % GPU_LATENCY];
+        if (gpuFrame.usedQueries + 2 > gpuFrame.queries.size()) {
+            size_t size = gpuFrame.queries.size();
+            u32 count = std::max<u32>(size, 32);
+            gpuFrame.queries.resize(size + count);
+            glGenQueries(count, gpuFrame.queries.data() + size);
+        }
+
+        GpuScope scope;
+        scope.name = name;
+        scope.beginQuery = gpuFrame.queries[gpuFrame.usedQueries++];
+        scope.endQuery = gpuFrame.queries[gpuFrame.usedQueries++];
+        scope.depth = s_gpuDepth++;
+        // timestamps nest, GL_TIME_ELAPSED queries may not be active at the same time
+        glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+        gpuFrame.scopes.emplace_back(scope);
+        return gpuFrame.scopes.size() - 1;
+    }
+
+    void Profiler::endGpu(u32 scope) {
+        if (scope == InvalidGpuScope) {
+            return;
+        }
+
+        GpuFrame& gpuFrame = s_gpuFrames[s_frameIndex % GPU_LATENCY];
+        glQueryCounter(gpuFrame.scopes[scope].endQuery, GL_TIMESTAMP);
+        s_gpuDepth--;
+    }
+
+    void Profiler::resolveGpu(u32 slot) {
+        GpuFrame& gpuFrame = s_gpuFrames[slot];
+        if (!gpuFrame.pending) {
+            return;
+        }
+
+        // reading result of query that isn't available waits for GPU, frame stays pending until it's done
+        for (const auto& scope : gpuFrame.scopes) {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(scope.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                return;
+            }
+        }
+        gpuFrame.pending = false;
+
+        // frame may have left history already
+        ProfileFrame* frame = null;
+        for (auto& historyFrame : s_frames) {
+            if (historyFrame.index == gpuFrame.frameIndex) {
+                frame = &historyFrame;
+                break;
+            }
+        }
+        if (!frame) {
+            return;
+        }
+
+        for (const auto& scope : gpuFrame.scopes) {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+
+            ProfileEvent event;
+            event.name = scope.name;
+            event.begin = (u64) std::max<int64_t>((int64_t) begin + gpuFrame.offset, 0);
+            event.end = (u64) std::max<int64_t>((int64_t) end + gpuFrame.offset, 0);
+            event.depth = scope.depth;
+            frame->gpuEvents.emplace_back(event);
+        }
+    }
+
+    u32 Profiler::getFrameCount() {
+        return s_frames.size();
+    }
+
+    const ProfileFrame& Profiler::getFrame(u32 i) {
+        return s_frames[(s_firstFrame + i) % s_frames.size()];
+    }
+
+    u32 Profiler::getThreadCount() {
+        std::lock_guard<std::mutex> lock(s_threadsMutex);
+        return s_threads.size();
+    }
+
+    std::string Profiler::getThreadName(u32 thread) {
+        std::lock_guard<std::mutex> lock(s_threadsMutex);
+        return s_threads[thread]->name;
+    }
+
+    static void writeTraceName(std::stringstream& ss, const char* name) {
+        ss << '"';
+        for (const char* c = name ; *c ; c++) {
+            if (*c == '"' || *c == '\\') {
+                ss << '\\';
+            }
+            ss << *c;
+        }
+        ss << '"';
+    }
+
+    static void writeTraceEvent(std::stringstream& ss, const char* name, u32 pid, u32 tid, u64 begin, u64 end) {
+        ss << ",\n{\"name\":";
+        writeTraceName(ss, name);
+        ss << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+           << ",\"ts\":" << begin / 1000.0 << ",\"dur\":" << (end - begin) / 1000.0 << "}";
+    }
+
+    bool Profiler::exportTrace(const char* filepath) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        // CPU threads are in process 0, GPU is process 1
+        ss << "{\"traceEvents\":[\n"
+           << R"({"name":"process_name","ph":"M","pid":0,"args":{"name":"CPU"}},)" << "\n"
+           << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"GPU"}})";
+
+        for (u32 i = 0 ; i < getThreadCount() ; i++) {
+            ss << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":";
+            writeTraceName(ss, getThreadName(i).c_str());
+            ss << "}}";
+        }
+
+        for (u32 i = 0 ; i < getFrameCount() ; i++) {
+            const ProfileFrame& frame = getFrame(i);
+            writeTraceEvent(ss, "Frame", 0, s_mainThread, frame.begin, frame.end);
+            for (const auto& event : frame.events) {
+                writeTraceEvent(ss, event.name, 0, event.thread, event.begin, event.end);
+            }
+            for (const auto& event : frame.gpuEvents) {
+                writeTraceEvent(ss, event.name, 1, 0, event.begin, event.end);
+            }
+        }
+
+        ss << "\n]}";
+
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            error("Failed to export profiler trace into {0}", filepath);
+            return false;
+        }
+        file << ss.str();
+        info("Profiler trace of {0} frames is exported into {1}", getFrameCount(), filepath);
+        return true;
+    }
+
+    ProfileScope::ProfileScope(const char* name) : mName(name), mEnabled(Profiler::isEnabled) {
+        if (mEnabled) {
+            getThread()->depth++;
+            mBegin = Profiler::now();
+        }
+    }
+
+    ProfileScope::~ProfileScope() {
+        if (!mEnabled) {
+            return;
+        }
+
+        u64 end = Profiler::now();
+        ProfileThread* thread = getThread();
+        thread->depth--;
+
+        u64 head = thread->head.load(std::memory_order_relaxed);
+        ProfileEvent& event = thread->ring[head % Profiler::RING_SIZE];
+        event.name = mName;
+        event.begin = mBegin;
+        event.end = end;
+        event.depth = thread->depth;
+        event.thread = thread->index;
+        thread->head.store(head + 1, std::memory_order_release);
+    }
+
+    GpuProfileScope::GpuProfileScope(const char* name) : mScope(Profiler::beginGpu(name)) {}
+
+    GpuProfileScope::~GpuProfileScope() {
+        Profiler::endGpu(mScope);
+    }
+
+}
@@ -0,0 +1,227 @@
+#include <features/batching.h>
+
+namespace gl {
+
+    void DrawBatch::draw(Shader& shader, int slot) const {
+        DrawStorage::bind(shader, first);
+        if (material) {
+            material->update(shader, slot);
+        }
+        if (count == 1) {
+            drawable->draw();
+        } else {
+            drawable->draw(count);
+        }
+    }
+
+    void DrawBatcher::free() {
+        mIndirectBuffer.free();
+    }
+
+    void DrawBatcher::clear() {
+        mDraws.clear();
+        mRangeDrawables.clear();
+        mBatches.clear();
+        mGroups.clear();
+        mCommands.clear();
+        mBatchDraws.clear();
+    }
+
+    void DrawBatcher::add(const Transform& transform, const DrawableElements& drawable, Material* material) {
+        Draw draw;
+        draw.transform = &transform;
+        draw.drawable = &drawable;
+        draw.material = material;
+        draw.depth = glm::distance(viewPosition, transform.translation);
+        initKey(draw);
+        mDraws.emplace_back(draw);
+    }
+
+    void DrawBatcher::add(const Transform& transform, const DrawableElements& drawable, const std::vector<MeshletRange>& ranges, Material* material) {
+        for (const auto& range : ranges) {
+            DrawableElements& rangeDrawable = mRangeDrawables.emplace_back(drawable);
+            rangeDrawable.indexOffset = drawable.indexOffset + range.firstIndex;
+            rangeDrawable.verticesPerStrip = range.indexCount;
+            add(transform, rangeDrawable, material);
+        }
+    }
+
+    static u32 getTextureKey(const ImageBuffer& texture, bool enabled) {
+        return enabled ? texture.id : 0;
+    }
+
+    void DrawBatcher::initKey(Draw& draw) {
+        const DrawableElements& drawable = *draw.drawable;
+        u32* key = draw.key;
+
+        // textures go first, so that batches of different meshes with the same textures are neighbours
+        const Material* material = draw.material;
+        if (material) {
+            key[0] = getTextureKey(material->albedo, material->enableAlbedo);
+            key[1] = getTextureKey(material->normal, material->enableNormal);
+            key[2] = getTextureKey(material->parallax, material->enableParallax);
+            key[3] = getTextureKey(material->metallic, material->enableMetallic);
+            key[4] = getTextureKey(material->roughness, material->enableRoughness);
+            key[5] = getTextureKey(material->ao, material->enableAO);
+            key[6] = getTextureKey(material->emission, material->enableEmission);
+        } else {
+            std::memset(&key[0], 0, sizeof(u32) * 7);
+        }
+
+        if (drawable.mesh != InvalidMesh) {
+            const PooledMesh& mesh = GeometryPool::getMesh(drawable.mesh);
+            key[7] = GeometryPool::getVertexArray(mesh.pool);
+            key[8] = GeometryPool::getIndexBuffer();
+            key[10] = mesh.firstIndex() + drawable.indexOffset;
+            key[13] = mesh.baseVertex();
+        } else {
+            key[7] = drawable.vao.id;
+            key[8] = drawable.ibo.id;
+            key[10] = drawable.indexOffset;
+            key[13] = 0;
+        }
+        key[9] = drawable.type;
+        key[11] = drawable.verticesPerStrip;
+        key[12] = drawable.strips;
+    }
+
+    bool DrawBatcher::isEqual(const Draw& left, const Draw& right) {
+        return std::equal(std::begin(left.key), std::end(left.key), std::begin(right.key));
+    }
+
+    bool DrawBatcher::isIndirect(const Draw& left, const Draw& right) {
+        // same textures, vertex array, index buffer and draw type, a single strip each
+        return left.drawable->mesh != InvalidMesh && right.drawable->mesh != InvalidMesh
+            && left.drawable->strips == 1 && right.drawable->strips == 1
+            && std::equal(&left.key[0], &left.key[10], &right.key[0]);
+    }
+
+    static u64 hashKey(const u32* key, u32 count) {
+        u64 hash = 14695981039346656037ull;
+        for (u32 i = 0 ; i < count ; i++) {
+            hash = (hash ^ key[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    u32 DrawBatcher::getId(std::unordered_map<u64, u32>& ids, const u32* key, u32 count) {
+        // colliding hashes only share sort position, batches still compare full keys
+        auto result = ids.emplace(hashKey(key, count), (u32) ids.size());
+        return result.first->second;
+    }
+
+    void DrawBatcher::build() {
+        mBatches.clear();
+        mBatchDraws.clear();
+
+        // ids of texture sets and meshes in order of first use, so that they fit into RenderKey
+        mQueue.clear();
+        mMaterialIds.clear();
+        mMeshIds.clear();
+        for (u32 i = 0 ; i < mDraws.size() ; i++) {
+            const Draw& draw = mDraws[i];
+            u32 material = getId(mMaterialIds, &draw.key[0], 7);
+            u32 mesh = getId(mMeshIds, &draw.key[7], 7);
+            mQueue.push(RenderKey::create(pass, 0, 0, material, mesh, draw.depth), i);
+        }
+        // stable, so that draws of one batch keep order they were added in
+        mQueue.sort();
+
+        const std::vector<RenderItem>& items = mQueue.getItems();
+        for (size_t i = 0 ; i < items.size() ; i++) {
+            const Draw& draw = mDraws[items[i].index];
+            u32 index = draw.material
+                    ? DrawStorage::push(*draw.transform, *draw.drawable, *draw.material)
+                    : DrawStorage::push(*draw.transform, *draw.drawable);
+            if (index == InvalidDrawIndex) {
+                continue;
+            }
+
+            if (!mBatches.empty() && isEqual(mDraws[items[i - 1].index], draw)) {
+                DrawBatch& batch = mBatches.back();
+                if (batch.first + batch.count == index) {
+                    batch.count++;
+                    continue;
+                }
+            }
+
+            DrawBatch batch;
+            batch.drawable = draw.drawable;
+            batch.material = draw.material;
+            batch.first = index;
+            batch.count = 1;
+            mBatches.emplace_back(batch);
+            mBatchDraws.emplace_back(items[i].index);
+        }
+
+        buildGroups();
+    }
+
+    void DrawBatcher::buildGroups() {
+        mGroups.clear();
+        mCommands.clear();
+
+        for (u32 i = 0 ; i < mBatches.size() ; i++) {
+            if (!mGroups.empty()) {
+                DrawGroup& group = mGroups.back();
+                const Draw& last = mDraws[mBatchDraws[group.batch + group.batchCount - 1]];
+                if (isIndirect(last, mDraws[mBatchDraws[i]])) {
+                    group.batchCount++;
+                    continue;
+                }
+            }
+
+            DrawGroup group;
+            group.batch = i;
+            group.batchCount = 1;
+            mGroups.emplace_back(group);
+        }
+
+        // single batches are cheaper to draw directly
+        for (auto& group : mGroups) {
+            if (group.batchCount < 2) {
+                continue;
+            }
+
+            group.indirect = true;
+            group.command = mCommands.size();
+            for (u32 i = group.batch ; i < group.batch + group.batchCount ; i++) {
+                const DrawBatch& batch = mBatches[i];
+                const PooledMesh& mesh = GeometryPool::getMesh(batch.drawable->mesh);
+                DrawElementsIndirectCommand command;
+                command.count = batch.drawable->verticesPerStrip;
+                command.instanceCount = batch.count;
+                command.firstIndex = mesh.firstIndex() + batch.drawable->indexOffset;
+                command.baseVertex = mesh.baseVertex();
+                // shaders read per-draw data at gl_BaseInstance + gl_InstanceID
+                command.baseInstance = batch.first;
+                mCommands.emplace_back(command);
+            }
+        }
+
+        if (!mCommands.empty()) {
+            if (mIndirectBuffer.id == 0) {
+                mIndirectBuffer.init();
+            }
+            mIndirectBuffer.update(mCommands);
+        }
+    }
+
+    void DrawBatcher::draw(Shader& shader, int slot) {
+        for (auto& group : mGroups) {
+            if (!group.indirect) {
+                mBatches[group.batch].draw(shader, slot);
+                continue;
+            }
+
+            const DrawBatch& batch = mBatches[group.batch];
+            DrawStorage::bind(shader, 0);
+            if (batch.material) {
+                batch.material->update(shader, slot);
+            }
+            const PooledMesh& mesh = GeometryPool::getMesh(batch.drawable->mesh);
+            mIndirectBuffer.draw(batch.drawable->type, mesh.pool, group.command, group.batchCount);
+        }
+    }
+
+}
@@ -2,6 +2,8 @@
 
 #include <io/image_loader.h>
 
+#include <core/thread_pool.h>
+
 namespace gl {
 
     void DisplacementImageMixer::addImage(const DisplacementRange& range, const char* filepath, bool flipUV, PixelType pixelType) {
@@ -19,6 +21,14 @@ namespace gl {
             return;
         }
 
+        // images that can't be mixed are skipped with error, the rest is still blended
+        std::vector<u32> images;
+        resizeImages(width, height, images);
+        if (images.empty()) {
+            error("No displacement image can be mixed!");
+            return;
+        }
+
         mixedImage.width = width;
         mixedImage.height = height;
         mixedImage.channels = 4;
@@ -29,12 +39,11 @@ namespace gl {
         mixedImage.setFormat();
 
         u8* pixels = (u8*) mixedImage.pixels;
-        size_t imageSize = displacementImages.size();
         float displacementMapRatio = (float) displacementMap->rows / (float) height;
 
-//        resizeImages(width, height);
-
-        for (int y = 0 ; y < height ; y++) {
+        std::atomic<bool> outOfBounds = false;
+        ThreadPool::parallelFor(height, [&](u32 y) {
+            u8* row = pixels + (size_t) y * width * 4;
             for (int x = 0 ; x < width ; x++) {
                 float interpolatedHeight = displacementMap->getInterpolatedHeight(
                         (float) x * displacementMapRatio,
@@ -44,33 +53,47 @@ namespace gl {
                 float green = 0;
                 float blue = 0;
 
-                for (int i = 0 ; i < imageSize ; i++) {
+                for (u32 i : images) {
                     auto& image = displacementImages[i].image;
-                    glm::vec4 color = image.getColor(x, y);
+                    const u8* color = (const u8*) image.pixels + ((size_t) y * image.width + x) * image.channels;
                     float blendFactor = regionPercent(i, interpolatedHeight);
 
-                    red += blendFactor * color.r;
-                    green += blendFactor * color.g;
-                    blue += blendFactor * color.b;
+                    red += blendFactor * color[0];
+                    green += blendFactor * color[image.channels > 1 ? 1 : 0];
+                    blue += blendFactor * color[image.channels > 2 ? 2 : 0];
                 }
 
                 if (red >= 255.0f || green >= 255.0f || blue >= 255.0f) {
-                    error("RGB color out of bounds!");
-                    return;
+                    outOfBounds = true;
                 }
 
-                pixels[0] = (u8) red;
-                pixels[1] = (u8) green;
-                pixels[2] = (u8) blue;
-                pixels[3] = 255;
-                pixels += 4;
+                u8* pixel = row + x * 4;
+                pixel[0] = (u8) std::min(red, 255.0f);
+                pixel[1] = (u8) std::min(green, 255.0f);
+                pixel[2] = (u8) std::min(blue, 255.0f);
+                pixel[3] = 255;
             }
+        });
+
+        if (outOfBounds) {
+            error("RGB color out of bounds!");
         }
     }
 
-    void DisplacementImageMixer::resizeImages(int width, int height) {
-        for (auto& displacement_image : displacementImages) {
-            displacement_image.image.resize(width, height);
+    void DisplacementImageMixer::resizeImages(int width, int height, std::vector<u32>& images) {
+        for (u32 i = 0 ; i < displacementImages.size() ; i++) {
+            auto& image = displacementImages[i].image;
+            if (!image.pixels || image.pixelType != PixelType::U8 || image.channels < 1) {
+                error("Displacement image {0} is not a U8 image, skipped", i);
+                continue;
+            }
+
+            if (!image.resize(width, height)) {
+                error("Displacement image {0} can't be resized to [{1}, {2}], skipped", i, width, height);
+                continue;
+            }
+
+            images.emplace_back(i);
         }
     }
 
@@ -105,24 +128,22 @@ namespace gl {
     HeightMap::HeightMap(const Image &image) : DisplacementMap(image.height, image.width) {
         int channels = image.channels;
         u8* pixels = (u8*) image.pixels;
+        std::vector<float> rowMin(rows, min);
+        std::vector<float> rowMax(rows, max);
 
-        for (int i = 0; i < rows; i++) {
+        ThreadPool::parallelFor(rows, [&](u32 i) {
+            u8* texel = pixels + (size_t) columns * i * channels;
             for (int j = 0; j < columns; j++) {
-                // retrieve texel for (i, j) uv
-                u8* texel = pixels + (j + columns * i) * channels;
                 // raw height at coordinate
-                float h = (float) texel[0] / 255.0f;
-
-                if (min > h) {
-                    min = h;
-                }
-                else if (max < h) {
-                    max = h;
-                }
-
+                float h = (float) texel[j * channels] / 255.0f;
+                rowMin[i] = std::min(rowMin[i], h);
+                rowMax[i] = std::max(rowMax[i], h);
                 get(i, j) = h;
             }
-        }
+        });
+
+        min = *std::min_element(rowMin.begin(), rowMin.end());
+        max = *std::max_element(rowMax.begin(), rowMax.end());
     }
 
     FaultFormation::FaultFormation(int columns, int rows, int iterations, float minHeight, float maxHeight, float filter)
@@ -0,0 +1,88 @@
+#include <features/draw_storage.h>
+
+namespace gl {
+
+    RingBuffer DrawStorage::s_ring;
+    u32 DrawStorage::s_capacity = 0;
+    u32 DrawStorage::s_count = 0;
+    u32 DrawStorage::s_dropped = 0;
+
+    static constexpr UniformHandle<u32> DRAW_INDEX = "draw_index";
+
+    void DrawStorage::init(u32 capacity) {
+        s_capacity = capacity;
+        s_count = 0;
+        s_dropped = 0;
+        s_ring.init(GL_SHADER_STORAGE_BUFFER, BINDING, sizeof(DrawData) * capacity);
+    }
+
+    void DrawStorage::free() {
+        s_ring.free();
+    }
+
+    void DrawStorage::begin() {
+        // regions of old buffer that GPU still reads are kept alive by driver until it's done with them
+        if (s_dropped > 0) {
+            u32 capacity = std::max(s_capacity * 2, s_count + s_dropped);
+            info("DrawStorage: growing from {0} to {1} draws", s_capacity, capacity);
+            s_ring.free();
+            init(capacity);
+        }
+        s_count = 0;
+        s_dropped = 0;
+        s_ring.begin();
+    }
+
+    void DrawStorage::end() {
+        s_ring.end();
+    }
+
+    u32 DrawStorage::push(const Transform& transform, const DrawableElements& drawable, const Material& material) {
+        size_t offset = 0;
+        auto* data = (DrawData*) s_ring.allocate(sizeof(DrawData), sizeof(DrawData), offset);
+        if (!data) {
+            if (s_dropped++ == 0) {
+                error("DrawStorage: more than {0} draws in frame, the rest are dropped", s_capacity);
+            }
+            return InvalidDrawIndex;
+        }
+        s_count++;
+        u32 index = offset / sizeof(DrawData);
+
+        const VertexDequantization& dequantization = drawable.dequantization;
+
+        // written field by field, the mapped memory is write-combined and never read back
+        data->model = transform.value;
+        data->color = material.color;
+        data->emissionFactor = glm::vec4(material.emissionFactor, 0);
+        data->quantizationOffset = glm::vec4(dequantization.offset, 0);
+        data->quantizationScale = glm::vec4(dequantization.scale, 0);
+        data->heightScale = material.heightScale;
+        data->parallaxMinLayers = material.parallaxMinLayers;
+        data->parallaxMaxLayers = material.parallaxMaxLayers;
+        data->metallicFactor = material.metallicFactor;
+        data->roughnessFactor = material.roughnessFactor;
+        data->aoFactor = material.aoFactor;
+        data->flags = (material.enableAlbedo ? DRAW_ALBEDO : 0)
+                | (material.enableNormal ? DRAW_NORMAL : 0)
+                | (material.enableParallax ? DRAW_PARALLAX : 0)
+                | (material.enableMetallic ? DRAW_METALLIC : 0)
+                | (material.enableRoughness ? DRAW_ROUGHNESS : 0)
+                | (material.enableAO ? DRAW_AO : 0)
+                | (material.enableEmission ? DRAW_EMISSION : 0)
+                | (dequantization.enabled ? DRAW_QUANTIZED : 0);
+        data->padding = 0;
+
+        return index;
+    }
+
+    u32 DrawStorage::push(const Transform& transform, const DrawableElements& drawable) {
+        static const Material material = Material();
+        return push(transform, drawable, material);
+    }
+
+    void DrawStorage::bind(Shader& shader, u32 index) {
+        shader.setUniform(DRAW_INDEX, index);
+    }
+
+}
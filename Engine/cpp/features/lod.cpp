@@ -0,0 +1,39 @@
+#include <features/lod.h>
+
+namespace gl {
+
+    void MeshLod::select(const Camera& camera, const Transform& transform, DrawableElements& drawable) {
+        if (levels.empty()) {
+            return;
+        }
+
+        float scale = std::max(transform.scale.x, std::max(transform.scale.y, transform.scale.z));
+        glm::vec3 worldCenter = transform.translation + center * scale;
+        // distance to the closest point of bounding sphere, so that close large meshes keep full detail
+        float distance = glm::length(worldCenter - camera.position) - radius * scale;
+        float pixelsPerUnit = camera.getPixelsPerUnit(distance);
+
+        current = 0;
+        for (u32 i = levels.size() - 1 ; i > 0 ; i--) {
+            if (levels[i].error * scale * pixelsPerUnit <= pixelError) {
+                current = i;
+                break;
+            }
+        }
+
+        drawable.indexOffset = levels[current].indexOffset;
+        drawable.verticesPerStrip = levels[current].indexCount;
+    }
+
+    void LodSelector::select(Scene* scene, const Camera& camera) {
+        scene->eachComponent<MeshLod>([scene, &camera](MeshLod* lod) {
+            EntityID entityId = lod->entityId;
+            auto* transform = scene->getComponent<Transform>(entityId);
+            auto* drawable = scene->getComponent<DrawableElements>(entityId);
+            if (transform && drawable) {
+                lod->select(camera, *transform, *drawable);
+            }
+        });
+    }
+
+}
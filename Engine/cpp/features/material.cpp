@@ -1,5 +1,5 @@
 #include <features/material.h>
-#include <io/image_loader.h>
+#include <io/texture_cache.h>
 
 namespace gl {
 
@@ -15,23 +15,61 @@ namespace gl {
     ) {
         ImageParams params;
         params.minFilter = GL_LINEAR_MIPMAP_LINEAR;
-        load(albedoPath, flipUV, params, albedo, enableAlbedo);
-        load(normalPath, flipUV, params, normal, enableNormal);
-        load(parallaxPath, flipUV, params, parallax, enableParallax);
-        load(metallicPath, flipUV, params, metallic, enableMetallic);
-        load(roughnessPath, flipUV, params, roughness, enableRoughness);
-        load(aoPath, flipUV, params, ao, enableAO);
-        load(emissionPath, flipUV, params, emission, enableEmission);
+
+        const char* paths[] = { albedoPath, normalPath, parallaxPath, metallicPath, roughnessPath, aoPath, emissionPath };
+        ImageBuffer* buffers[] = { &albedo, &normal, &parallax, &metallic, &roughness, &ao, &emission };
+        bool* enables[] = { &enableAlbedo, &enableNormal, &enableParallax, &enableMetallic, &enableRoughness, &enableAO, &enableEmission };
+
+        // shared textures come from cache, missing ones are decoded in parallel
+        std::vector<TextureRequest> requests;
+        std::vector<int> slots;
+        for (int i = 0 ; i < 7 ; i++) {
+            if (paths[i]) {
+                TextureRequest request;
+                request.filepath = paths[i];
+                request.flipUV = flipUV;
+                request.normalMap = i == 1;
+                request.compress = true;
+                request.params = params;
+                requests.emplace_back(request);
+                slots.emplace_back(i);
+            }
+        }
+
+        TextureCache::acquire(requests);
+
+        for (int i = 0 ; i < requests.size() ; i++) {
+            int slot = slots[i];
+            *buffers[slot] = requests[i].buffer;
+            *enables[slot] = requests[i].buffer.id != InvalidImageBuffer;
+        }
+    }
+
+    static void takeTexture(const ImageBuffer& src, bool srcEnable, ImageBuffer& dst, bool& dstEnable) {
+        if (srcEnable) {
+            dst = src;
+            dstEnable = true;
+        }
+    }
+
+    void Material::setTextures(const Material& other) {
+        takeTexture(other.albedo, other.enableAlbedo, albedo, enableAlbedo);
+        takeTexture(other.normal, other.enableNormal, normal, enableNormal);
+        takeTexture(other.parallax, other.enableParallax, parallax, enableParallax);
+        takeTexture(other.metallic, other.enableMetallic, metallic, enableMetallic);
+        takeTexture(other.roughness, other.enableRoughness, roughness, enableRoughness);
+        takeTexture(other.ao, other.enableAO, ao, enableAO);
+        takeTexture(other.emission, other.enableEmission, emission, enableEmission);
     }
 
     void Material::free() {
-        albedo.free();
-        normal.free();
-        parallax.free();
-        metallic.free();
-        roughness.free();
-        ao.free();
-        emission.free();
+        TextureCache::release(albedo);
+        TextureCache::release(normal);
+        TextureCache::release(parallax);
+        TextureCache::release(metallic);
+        TextureCache::release(roughness);
+        TextureCache::release(ao);
+        TextureCache::release(emission);
     }
 
     void Material::free(std::vector<Material>& materials) {
@@ -40,68 +78,42 @@ namespace gl {
         }
     }
 
+    static constexpr SamplerHandle ALBEDO = { "material", "albedo" };
+    static constexpr SamplerHandle NORMAL = { "material", "normal" };
+    static constexpr SamplerHandle PARALLAX = { "material", "parallax" };
+    static constexpr SamplerHandle METALLIC = { "material", "metallic" };
+    static constexpr SamplerHandle ROUGHNESS = { "material", "roughness" };
+    static constexpr SamplerHandle AO = { "material", "ao" };
+    static constexpr SamplerHandle EMISSION = { "material", "emission" };
+
     void Material::update(Shader& shader, int slot) {
         if (enableAlbedo) {
-            shader.bindSamplerStruct("material", "albedo", slot++, albedo);
+            shader.bindSampler(ALBEDO, slot++, albedo);
         }
 
         if (enableNormal) {
-            shader.bindSamplerStruct("material", "normal", slot++, normal);
+            shader.bindSampler(NORMAL, slot++, normal);
         }
 
         if (enableParallax) {
-            shader.bindSamplerStruct("material", "parallax", slot++, parallax);
+            shader.bindSampler(PARALLAX, slot++, parallax);
         }
 
         if (enableMetallic) {
-            shader.bindSamplerStruct("material", "metallic", slot++, metallic);
+            shader.bindSampler(METALLIC, slot++, metallic);
         }
 
         if (enableRoughness) {
-            shader.bindSamplerStruct("material", "roughness", slot++, roughness);
+            shader.bindSampler(ROUGHNESS, slot++, roughness);
         }
 
         if (enableAO) {
-            shader.bindSamplerStruct("material", "ao", slot++, ao);
+            shader.bindSampler(AO, slot++, ao);
         }
 
         if (enableEmission) {
-            shader.bindSamplerStruct("material", "emission", slot++, emission);
-        }
-
-        shader.setUniformStructArgs("material", "color", color);
-        shader.setUniformStructArgs("material", "enable_albedo", enableAlbedo);
-
-        shader.setUniformStructArgs("material", "enable_normal", enableNormal);
-
-        shader.setUniformStructArgs("material", "height_scale", heightScale);
-        shader.setUniformStructArgs("material", "parallax_min_layers", parallaxMinLayers);
-        shader.setUniformStructArgs("material", "parallax_max_layers", parallaxMaxLayers);
-        shader.setUniformStructArgs("material", "enable_parallax", enableParallax);
-
-        shader.setUniformStructArgs("material", "enable_metallic", enableMetallic);
-        shader.setUniformStructArgs("material", "metallic_factor", metallicFactor);
-
-        shader.setUniformStructArgs("material", "enable_roughness", enableRoughness);
-        shader.setUniformStructArgs("material", "roughness_factor", roughnessFactor);
-
-        shader.setUniformStructArgs("material", "enable_ao", enableAO);
-        shader.setUniformStructArgs("material", "ao_factor", aoFactor);
-
-        shader.setUniformStructArgs("material", "enable_emission", enableEmission);
-        shader.setUniformStructArgs("material", "emission_factor", emissionFactor);
-    }
-
-    void Material::load(const char* filepath, const bool uv, const ImageParams& params, ImageBuffer &outBuffer, bool &outEnable) {
-        if (filepath) {
-            Image image = ImageReader::read(filepath, uv);
-
-            outBuffer.init();
-            outBuffer.load(image, params);
-            outEnable = outBuffer.id != InvalidImageBuffer;
-
-            image.free();
+            shader.bindSampler(EMISSION, slot++, emission);
         }
     }
 
-}
\ No newline at end of file
+}
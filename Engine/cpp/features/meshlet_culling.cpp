@@ -0,0 +1,30 @@
+#include <features/meshlet_culling.h>
+
+namespace gl {
+
+    bool MeshletCulling::cull(
+            std::vector<MeshletRange>& ranges,
+            const Transform& transform,
+            const DrawableElements& drawable,
+            const Frustum& frustum,
+            const glm::vec3* cameraPosition
+    ) {
+        if (mesh.meshlets.empty() || drawable.type != DrawType::TRIANGLES || drawable.strips != 1 || drawable.indexOffset != 0) {
+            return false;
+        }
+
+        const Meshlet& last = mesh.meshlets.back();
+        if ((last.triangleOffset + last.triangleCount) * 3 != drawable.verticesPerStrip) {
+            return false;
+        }
+
+        if (cameraPosition) {
+            MeshletCuller::cull(mVisible, mesh, frustum, transform.value, *cameraPosition);
+        } else {
+            MeshletCuller::cull(mVisible, mesh, frustum, transform.value);
+        }
+        MeshletCuller::getRanges(ranges, mesh, mVisible);
+        return true;
+    }
+
+}
@@ -1,4 +1,5 @@
 #include <features/outline.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -25,15 +26,15 @@ namespace gl {
     }
 
     void OutlineRenderer::bind() {
-        glStencilMask(GL_FALSE);
-        glStencilFunc(GL_NOTEQUAL, 1, GL_TRUE);
-        glDisable(GL_DEPTH_TEST);
+        StateCache::setStencilMask(GL_FALSE);
+        StateCache::setStencilFunc(GL_NOTEQUAL, 1, GL_TRUE);
+        StateCache::disable(GL_DEPTH_TEST);
     }
 
     void OutlineRenderer::unbind() {
-        glStencilMask(GL_TRUE);
-        glStencilFunc(GL_ALWAYS, 1, GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        StateCache::setStencilMask(GL_TRUE);
+        StateCache::setStencilFunc(GL_ALWAYS, 1, GL_TRUE);
+        StateCache::enable(GL_DEPTH_TEST);
     }
 
     void OutlineRenderer::use() {
@@ -43,6 +44,7 @@ namespace gl {
     void OutlineRenderer::render(Outline& outline, Transform& transform, DrawableElements& drawable) {
         mShader.update(outline);
         transform.update(mShader);
+        drawable.dequantization.update(mShader);
         drawable.draw();
     }
 
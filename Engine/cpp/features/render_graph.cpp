@@ -0,0 +1,220 @@
+#include <features/render_graph.h>
+
+#include <debugging/profiler.h>
+
+namespace gl {
+
+    bool RenderTextureDesc::operator ==(const RenderTextureDesc& other) const {
+        return width == other.width
+            && height == other.height
+            && internalFormat == other.internalFormat
+            && pixelFormat == other.pixelFormat
+            && pixelType == other.pixelType;
+    }
+
+    static size_t getTexelSize(int internalFormat) {
+        switch (internalFormat) {
+            case GL_R8: return 1;
+            case GL_RG8: return 2;
+            case GL_RGB8:
+            case GL_RGB: return 3;
+            case GL_RGBA8:
+            case GL_RGBA:
+            case GL_R32F:
+            case GL_R11F_G11F_B10F: return 4;
+            case GL_RGB16F: return 6;
+            case GL_RGBA16F: return 8;
+            case GL_RGB32F: return 12;
+            case GL_RGBA32F: return 16;
+            default: return 4;
+        }
+    }
+
+    size_t RenderTextureDesc::size() const {
+        return (size_t) width * height * getTexelSize(internalFormat);
+    }
+
+    void RenderGraph::clear() {
+        mResources.clear();
+        mPasses.clear();
+        mOutputs.clear();
+        mPhysicalDescs.clear();
+        mStats = {};
+    }
+
+    u32 RenderGraph::createTexture(const char* name, const RenderTextureDesc& desc) {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        mResources.emplace_back(resource);
+        return mResources.size() - 1;
+    }
+
+    u32 RenderGraph::importTexture(const char* name, const ImageBuffer& texture) {
+        Resource resource;
+        resource.name = name;
+        resource.imported = true;
+        resource.texture = texture;
+        mResources.emplace_back(resource);
+        return mResources.size() - 1;
+    }
+
+    u32 RenderGraph::addPass(const char* name, const Execute& execute) {
+        Pass pass;
+        pass.name = name;
+        pass.execute = execute;
+        mPasses.emplace_back(pass);
+        return mPasses.size() - 1;
+    }
+
+    void RenderGraph::read(u32 pass, u32 resource) {
+        mPasses[pass].reads.emplace_back(resource);
+    }
+
+    void RenderGraph::write(u32 pass, u32 resource) {
+        mPasses[pass].writes.emplace_back(resource);
+    }
+
+    void RenderGraph::setOutput(u32 resource) {
+        mOutputs.emplace_back(resource);
+    }
+
+    bool RenderGraph::compile() {
+        cull();
+        if (!computeLifetimes()) {
+            return false;
+        }
+        alias();
+        return true;
+    }
+
+    void RenderGraph::cull() {
+        // walks passes backwards from outputs, pass is needed if it writes resource that is read later
+        std::vector<bool> needed(mResources.size(), false);
+        for (u32 output : mOutputs) {
+            needed[output] = true;
+        }
+
+        for (u32 i = mPasses.size() ; i-- > 0 ;) {
+            Pass& pass = mPasses[i];
+            pass.culled = true;
+            for (u32 resource : pass.writes) {
+                if (needed[resource]) {
+                    pass.culled = false;
+                    break;
+                }
+            }
+            if (pass.culled) {
+                continue;
+            }
+
+            // resources written here are produced, earlier writes of them are not needed unless read again
+            for (u32 resource : pass.writes) {
+                needed[resource] = false;
+            }
+            for (u32 resource : pass.reads) {
+                needed[resource] = true;
+            }
+        }
+
+        mStats.passes = mPasses.size();
+        mStats.culledPasses = 0;
+        for (const auto& pass : mPasses) {
+            mStats.culledPasses += pass.culled;
+        }
+    }
+
+    bool RenderGraph::computeLifetimes() {
+        for (auto& resource : mResources) {
+            resource.firstPass = InvalidRenderResource;
+            resource.lastPass = InvalidRenderResource;
+            resource.physical = InvalidRenderResource;
+        }
+
+        for (u32 i = 0 ; i < mPasses.size() ; i++) {
+            const Pass& pass = mPasses[i];
+            if (pass.culled) {
+                continue;
+            }
+
+            for (u32 id : pass.reads) {
+                Resource& resource = mResources[id];
+                if (!resource.imported && resource.firstPass == InvalidRenderResource) {
+                    error("RenderGraph: pass {0} reads {1} before it is written", pass.name, resource.name);
+                    return false;
+                }
+                resource.lastPass = i;
+            }
+
+            for (u32 id : pass.writes) {
+                Resource& resource = mResources[id];
+                if (resource.firstPass == InvalidRenderResource) {
+                    resource.firstPass = i;
+                }
+                resource.lastPass = i;
+            }
+        }
+
+        // outputs are read after graph, so that nothing may alias them
+        for (u32 output : mOutputs) {
+            mResources[output].lastPass = mPasses.size();
+        }
+
+        return true;
+    }
+
+    void RenderGraph::alias() {
+        std::vector<u32> transients;
+        for (u32 i = 0 ; i < mResources.size() ; i++) {
+            const Resource& resource = mResources[i];
+            if (!resource.imported && resource.firstPass != InvalidRenderResource) {
+                transients.emplace_back(i);
+            }
+        }
+        std::stable_sort(transients.begin(), transients.end(), [this](u32 left, u32 right) {
+            return mResources[left].firstPass < mResources[right].firstPass;
+        });
+
+        // last pass that uses each physical slot
+        std::vector<u32> slotLastPass;
+        mPhysicalDescs.clear();
+        mStats.transientTextures = transients.size();
+        mStats.transientBytes = 0;
+
+        for (u32 id : transients) {
+            Resource& resource = mResources[id];
+            mStats.transientBytes += resource.desc.size();
+
+            // pass that reads one texture and writes another needs both, so that lifetimes must not touch
+            for (u32 slot = 0 ; slot < mPhysicalDescs.size() ; slot++) {
+                if (mPhysicalDescs[slot] == resource.desc && slotLastPass[slot] < resource.firstPass) {
+                    resource.physical = slot;
+                    break;
+                }
+            }
+
+            if (resource.physical == InvalidRenderResource) {
+                resource.physical = mPhysicalDescs.size();
+                mPhysicalDescs.emplace_back(resource.desc);
+                slotLastPass.emplace_back(0);
+            }
+            slotLastPass[resource.physical] = resource.lastPass;
+        }
+
+        mStats.physicalTextures = mPhysicalDescs.size();
+        mStats.physicalBytes = 0;
+        for (const auto& desc : mPhysicalDescs) {
+            mStats.physicalBytes += desc.size();
+        }
+    }
+
+    void RenderGraph::execute(const RenderGraphResources& resources) const {
+        for (const auto& pass : mPasses) {
+            if (!pass.culled) {
+                PROFILE_PASS(pass.name);
+                pass.execute(resources);
+            }
+        }
+    }
+
+}
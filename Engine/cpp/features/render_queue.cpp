@@ -0,0 +1,171 @@
+#include <features/render_queue.h>
+#include <core/thread_pool.h>
+
+namespace gl {
+
+    static constexpr u32 RADIX_BITS = 8;
+    static constexpr u32 RADIX_SIZE = 1 << RADIX_BITS;
+    static constexpr u32 RADIX_PASSES = 64 / RADIX_BITS;
+    // parallel sort splits queue into chunks not smaller than this
+    static constexpr u32 RADIX_CHUNK_SIZE = 1024;
+
+    static constexpr u64 OPAQUE_DEPTH_MASK = 0xFFFFFFull;
+    static constexpr u64 TRANSPARENT_DEPTH_MASK = 0xFFFFFFull << 32;
+
+    static inline u32 getDigit(u64 key, u32 pass) {
+        return (key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+    }
+
+    u32 RenderKey::quantizeDepth(float depth) {
+        // bits of non-negative floats grow with value, top 24 bits of them keep the order
+        depth = std::max(depth, 0.0f);
+        u32 bits;
+        std::memcpy(&bits, &depth, sizeof(u32));
+        return bits >> 7;
+    }
+
+    u64 RenderKey::create(RenderPass pass, u8 layer, u32 shader, u32 material, u32 mesh, float depth) {
+        u64 key = ((u64) (pass & 0xF) << 60) | ((u64) (layer & 0xF) << 56);
+        u64 state = ((u64) std::min(shader, MAX_SHADER) << 24)
+                | ((u64) std::min(material, MAX_MATERIAL) << 12)
+                | (u64) std::min(mesh, MAX_MESH);
+        u32 quantizedDepth = quantizeDepth(depth);
+
+        if (pass == RENDER_PASS_TRANSPARENT) {
+            // farthest first
+            return key | ((u64) (0xFFFFFF - quantizedDepth) << 32) | state;
+        }
+        return key | (state << 24) | quantizedDepth;
+    }
+
+    u64 RenderKey::getState(u64 key) {
+        return key & ~(getPass(key) == RENDER_PASS_TRANSPARENT ? TRANSPARENT_DEPTH_MASK : OPAQUE_DEPTH_MASK);
+    }
+
+    RenderQueueStats& RenderQueueStats::operator +=(const RenderQueueStats& other) {
+        draws += other.draws;
+        submittedStateChanges += other.submittedStateChanges;
+        sortedStateChanges += other.sortedStateChanges;
+        return *this;
+    }
+
+    void RenderQueue::clear() {
+        mItems.clear();
+        mStats = {};
+    }
+
+    void RenderQueue::push(u64 key, u32 index) {
+        mItems.push_back({ key, index });
+    }
+
+    u32 RenderQueue::countStateChanges(const std::vector<RenderItem>& items) {
+        u32 changes = 0;
+        u64 state = 0;
+        for (size_t i = 0 ; i < items.size() ; i++) {
+            u64 itemState = RenderKey::getState(items[i].key);
+            if (i == 0 || itemState != state) {
+                changes++;
+                state = itemState;
+            }
+        }
+        return changes;
+    }
+
+    void RenderQueue::sort() {
+        mStats.draws = mItems.size();
+        mStats.submittedStateChanges = countStateChanges(mItems);
+        if (mItems.size() < 2) {
+            mStats.sortedStateChanges = mStats.submittedStateChanges;
+            return;
+        }
+
+        mTemp.resize(mItems.size());
+        if (mItems.size() >= PARALLEL_THRESHOLD && ThreadPool::getThreadCount() > 0) {
+            sortParallel();
+        } else {
+            sortSerial();
+        }
+
+        mStats.sortedStateChanges = countStateChanges(mItems);
+    }
+
+    void RenderQueue::sortSerial() {
+        u32 count = mItems.size();
+        u32 histograms[RADIX_PASSES][RADIX_SIZE] = {};
+        for (const auto& item : mItems) {
+            for (u32 pass = 0 ; pass < RADIX_PASSES ; pass++) {
+                histograms[pass][getDigit(item.key, pass)]++;
+            }
+        }
+
+        for (u32 pass = 0 ; pass < RADIX_PASSES ; pass++) {
+            u32* histogram = histograms[pass];
+            // all keys have the same digit, order doesn't change
+            if (histogram[getDigit(mItems[0].key, pass)] == count) {
+                continue;
+            }
+
+            u32 offset = 0;
+            for (u32 digit = 0 ; digit < RADIX_SIZE ; digit++) {
+                u32 digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            }
+
+            for (const auto& item : mItems) {
+                mTemp[histogram[getDigit(item.key, pass)]++] = item;
+            }
+            mItems.swap(mTemp);
+        }
+    }
+
+    void RenderQueue::sortParallel() {
+        u32 count = mItems.size();
+        u32 chunkCount = std::min<u32>(ThreadPool::getThreadCount() + 1, count / RADIX_CHUNK_SIZE);
+        std::vector<u32> histograms(chunkCount * RADIX_SIZE);
+
+        for (u32 pass = 0 ; pass < RADIX_PASSES ; pass++) {
+            std::fill(histograms.begin(), histograms.end(), 0);
+
+            ThreadPool::parallelFor(chunkCount, [this, pass, count, chunkCount, &histograms](u32 chunk) {
+                u32* histogram = &histograms[chunk * RADIX_SIZE];
+                u32 begin = (u64) count * chunk / chunkCount;
+                u32 end = (u64) count * (chunk + 1) / chunkCount;
+                for (u32 i = begin ; i < end ; i++) {
+                    histogram[getDigit(mItems[i].key, pass)]++;
+                }
+            });
+
+            // chunks of one digit are written in chunk order, so that sort stays stable
+            u32 offset = 0;
+            bool sorted = false;
+            for (u32 digit = 0 ; digit < RADIX_SIZE ; digit++) {
+                u32 digitOffset = offset;
+                for (u32 chunk = 0 ; chunk < chunkCount ; chunk++) {
+                    u32& slot = histograms[chunk * RADIX_SIZE + digit];
+                    u32 digitCount = slot;
+                    slot = offset;
+                    offset += digitCount;
+                }
+                if (offset - digitOffset == count) {
+                    sorted = true;
+                }
+            }
+            if (sorted) {
+                continue;
+            }
+
+            ThreadPool::parallelFor(chunkCount, [this, pass, count, chunkCount, &histograms](u32 chunk) {
+                u32* histogram = &histograms[chunk * RADIX_SIZE];
+                u32 begin = (u64) count * chunk / chunkCount;
+                u32 end = (u64) count * (chunk + 1) / chunkCount;
+                for (u32 i = begin ; i < end ; i++) {
+                    const RenderItem& item = mItems[i];
+                    mTemp[histogram[getDigit(item.key, pass)]++] = item;
+                }
+            });
+            mItems.swap(mTemp);
+        }
+    }
+
+}
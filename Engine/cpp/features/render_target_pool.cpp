@@ -0,0 +1,90 @@
+#include <features/render_target_pool.h>
+
+namespace gl {
+
+    void RenderTargetPool::free() {
+        for (auto& frame : mFrames) {
+            frame.free();
+        }
+        mFrames.clear();
+        mDescs.clear();
+        mGraph = null;
+    }
+
+    FrameBuffer RenderTargetPool::createFrame(const RenderTextureDesc& desc) {
+        ColorAttachment color;
+
+        // data
+        color.image.width = desc.width;
+        color.image.height = desc.height;
+        color.image.internalFormat = desc.internalFormat;
+        color.image.pixelFormat = desc.pixelFormat;
+        color.image.pixelType = desc.pixelType;
+
+        // filter
+        color.params.s = GL_CLAMP_TO_EDGE;
+        color.params.t = GL_CLAMP_TO_EDGE;
+        color.params.r = GL_CLAMP_TO_EDGE;
+        color.params.minFilter = GL_LINEAR;
+        color.params.magFilter = GL_LINEAR;
+
+        color.init();
+
+        FrameBuffer frame;
+        frame.colors = { color };
+        frame.init();
+        frame.attachColors();
+        frame.complete();
+        return frame;
+    }
+
+    void RenderTargetPool::acquire(const RenderGraph& graph) {
+        mGraph = &graph;
+        const auto& descs = graph.getPhysicalDescs();
+
+        for (u32 slot = 0 ; slot < descs.size() ; slot++) {
+            if (slot < mDescs.size() && mDescs[slot] == descs[slot]) {
+                continue;
+            }
+
+            if (slot < mFrames.size()) {
+                mFrames[slot].free();
+                mFrames[slot] = createFrame(descs[slot]);
+                mDescs[slot] = descs[slot];
+            } else {
+                mFrames.emplace_back(createFrame(descs[slot]));
+                mDescs.emplace_back(descs[slot]);
+            }
+        }
+
+        // slots that aren't used anymore release their memory
+        for (u32 slot = descs.size() ; slot < mFrames.size() ; slot++) {
+            mFrames[slot].free();
+        }
+        mFrames.resize(descs.size());
+        mDescs.resize(descs.size());
+    }
+
+    const ImageBuffer& RenderTargetPool::getTexture(u32 resource) const {
+        if (mGraph->isImported(resource)) {
+            return mGraph->getImportedTexture(resource);
+        }
+        return mFrames[mGraph->getPhysical(resource)].colors[0].buffer;
+    }
+
+    const FrameBuffer* RenderTargetPool::getFrame(u32 resource) const {
+        if (mGraph->isImported(resource)) {
+            return null;
+        }
+        return &mFrames[mGraph->getPhysical(resource)];
+    }
+
+    size_t RenderTargetPool::getBytes() const {
+        size_t bytes = 0;
+        for (const auto& desc : mDescs) {
+            bytes += desc.size();
+        }
+        return bytes;
+    }
+
+}
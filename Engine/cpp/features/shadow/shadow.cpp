@@ -1,9 +1,13 @@
 #include <features/shadow/shadow.h>
+#include <api/state_cache.h>
 #include <features/lighting/light.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     ShadowPipeline::ShadowPipeline(Scene* scene, int width, int height, Camera* camera) : scene(scene) {
+        mBatcher.pass = RENDER_PASS_SHADOW;
         mDirectShadowRenderer = new DirectShadowRenderer();
         mPointShadowRenderer = new PointShadowRenderer();
 
@@ -57,6 +61,7 @@ namespace gl {
         mFrame.free();
         delete mDirectShadowRenderer;
         delete mPointShadowRenderer;
+        mBatcher.free();
     }
 
     void ShadowPipeline::resize(int width, int height) {
@@ -70,6 +75,7 @@ namespace gl {
     }
 
     void ShadowPipeline::render() {
+        PROFILE_PASS("Shadows");
         begin();
 
         bind(directShadow.map);
@@ -82,12 +88,12 @@ namespace gl {
     }
 
     void ShadowPipeline::begin() {
-        glCullFace(GL_FRONT);
+        StateCache::setCullFace(GL_FRONT);
         mFrame.bindWriting();
     }
 
     void ShadowPipeline::end() {
-        glCullFace(GL_BACK);
+        StateCache::setCullFace(GL_BACK);
     }
 
     void ShadowPipeline::bind(const DepthAttachment& shadowMap) {
@@ -105,22 +111,34 @@ namespace gl {
             glm::vec3 lightPos = directLightComponent->position;
 
             mDirectShadowRenderer->begin();
+            glm::mat4 lightSpace = mDirectShadowRenderer->update(directShadow, lightPos, lightDirection);
 
-            scene->eachComponent<Shadowable>([this, &lightDirection, &lightPos](Shadowable* shadowable) {
-                EntityID entityId = shadowable->entityId;
-                mDirectShadowRenderer->render(
-                        *scene->getComponent<Transform>(entityId),
-                        *scene->getComponent<DrawableElements>(entityId),
-                        directShadow,
-                        lightPos,
-                        lightDirection
-                );
-            });
+            // meshlets of casters are culled by light frustum, so casters are batched for every light
+            mBatcher.clear();
+            addCasters(Frustum(lightSpace));
+            mBatcher.build();
+            mDirectShadowRenderer->render(mBatcher);
 
             mDirectShadowRenderer->end();
         });
     }
 
+    void ShadowPipeline::addCasters(const Frustum& frustum) {
+        scene->eachComponent<Shadowable>([this, &frustum](Shadowable* shadowable) {
+            EntityID entityId = shadowable->entityId;
+            auto& transform = *scene->getComponent<Transform>(entityId);
+            auto& drawable = *scene->getComponent<DrawableElements>(entityId);
+            auto* meshlets = scene->getComponent<MeshletCulling>(entityId);
+
+            // front faces are culled in shadow pass, so only frustum test is done
+            if (meshlets && meshlets->cull(mMeshletRanges, transform, drawable, frustum)) {
+                mBatcher.add(transform, drawable, mMeshletRanges);
+            } else {
+                mBatcher.add(transform, drawable);
+            }
+        });
+    }
+
     void ShadowPipeline::renderPointShadows() {
         scene->eachComponent<PointLightComponent>([this](PointLightComponent* pointLightComponent) {
             glm::vec3 lightPosition = pointLightComponent->position;
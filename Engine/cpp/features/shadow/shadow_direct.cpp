@@ -67,17 +67,16 @@ namespace gl {
         Shader::stop();
     }
 
-    void DirectShadowRenderer::render(
-            Transform& transform,
-            DrawableElements& drawable,
-            DirectShadow& directShadow,
-            const glm::vec3& lightPos,
-            const glm::vec3& lightDirection
-    ) {
+    static constexpr UniformHandle<glm::mat4> DIRECT_LIGHT_SPACE = "direct_light_space";
+
+    glm::mat4 DirectShadowRenderer::update(DirectShadow& directShadow, const glm::vec3& lightPos, const glm::vec3& lightDirection) {
         glm::mat4 lightSpace = directShadow.update(lightPos, lightDirection);
-        mShader.setUniformArgs("direct_light_space", lightSpace);
-        transform.update(mShader);
-        drawable.draw();
+        mShader.setUniform(DIRECT_LIGHT_SPACE, lightSpace);
+        return lightSpace;
+    }
+
+    void DirectShadowRenderer::render(DrawBatcher& batcher) {
+        batcher.draw(mShader);
     }
 
 }
\ No newline at end of file
@@ -48,6 +48,7 @@ namespace gl {
         mShader.setUniform(zFarUniform);
         mShader.setUniform(lightPositionUniform);
         transform.update(mShader);
+        drawable.dequantization.update(mShader);
         drawable.draw();
     }
 
@@ -2,19 +2,21 @@
 
 namespace gl {
 
+    static constexpr UniformHandle<glm::mat4> MODEL = "model";
+    static constexpr UniformHandle<glm::mat4> MODELS = "models";
+
     void Transform::update(Shader &shader) {
-        UniformM4F model = { "model", value };
-        shader.setUniform(model);
+        shader.setUniform(MODEL, value);
     }
 
     void Transform::updateArrayElement(Shader &shader, int i, Transform& transform) {
-        shader.setUniform("models", transform.value, i);
+        shader.setUniform(MODELS, i, transform.value);
     }
 
     void Transform::updateArray(Shader &shader, std::vector<Transform> &transforms) {
         size_t size = transforms.size();
         for (int i = 0; i < size; i++) {
-            shader.setUniform("models", transforms[i].value, i);
+            shader.setUniform(MODELS, i, transforms[i].value);
         }
     }
 
@@ -1,4 +1,5 @@
 #include <features/transparency.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -95,27 +96,27 @@ namespace gl {
 //        mFrame.clearColorBuffers();
 //        FrameBuffer::clearBuffer(COLOR_CLEAR, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-        glDepthMask(GL_FALSE);
+        StateCache::setDepthMask(GL_FALSE);
 
-        glBlendFunci(0, GL_ONE, GL_ONE);
-        glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
-        glBlendEquation(GL_FUNC_ADD);
+        StateCache::setBlendFunc(0, GL_ONE, GL_ONE);
+        StateCache::setBlendFunc(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+        StateCache::setBlendEquation(GL_FUNC_ADD);
     }
 
     void TransparentRenderer::unbind() {
         mCompositeFrame.bind();
 //        FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-        glDepthFunc(GL_ALWAYS);
+        StateCache::setDepthFunc(GL_ALWAYS);
 
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        StateCache::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         mShader.use();
         mShader.update();
         mDrawable.draw();
 
-        glDepthMask(GL_TRUE);
-        glDepthFunc(GL_LESS);
+        StateCache::setDepthMask(GL_TRUE);
+        StateCache::setDepthFunc(GL_LESS);
     }
 
     void TransparentRenderer::blitColorDepth(int w, int h, u32 srcColorFrame, u32 srcDepthFrame) const {
@@ -18,4 +18,23 @@ namespace gl {
         memcpy(indices, src->indices, src->size());
     }
 
+    void Bounds::add(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Bounds::add(const Bounds& bounds) {
+        min = glm::min(min, bounds.min);
+        max = glm::max(max, bounds.max);
+    }
+
+    void SurfaceArea::add(const SurfaceArea& surfaceArea) {
+        area += surfaceArea.area;
+        uvArea += surfaceArea.uvArea;
+    }
+
+    float SurfaceArea::uvDensity() const {
+        return area > 0 && uvArea > 0 ? std::sqrt(uvArea / area) : 1.0f;
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include <geometry/mesh_optimizer.h>
+
+namespace gl {
+
+    // Forsyth scoring constants, see "Linear-Speed Vertex Cache Optimisation"
+    static constexpr int FORSYTH_CACHE_SIZE = 32;
+    static constexpr float FORSYTH_CACHE_DECAY = 1.5f;
+    static constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+    static constexpr float FORSYTH_VALENCE_SCALE = 2.0f;
+    static constexpr float FORSYTH_VALENCE_POWER = 0.5f;
+
+    static float forsythScore(int cachePosition, u32 remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0;
+
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // vertices of last triangle get fixed score, so it's not possible to pick the same triangle again
+                score = FORSYTH_LAST_TRIANGLE_SCORE;
+            } else {
+                float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scale, FORSYTH_CACHE_DECAY);
+            }
+        }
+
+        // boost vertices with few triangles left, so that lone triangles are not left behind
+        score += FORSYTH_VALENCE_SCALE * std::pow((float) remainingTriangles, -FORSYTH_VALENCE_POWER);
+
+        return score;
+    }
+
+    VertexCacheStats MeshOptimizer::analyzeVertexCache(const u32* indices, size_t indexCount, size_t vertexCount, u32 cacheSize) {
+        VertexCacheStats stats;
+        stats.triangles = indexCount / 3;
+        stats.vertices = vertexCount;
+
+        // FIFO cache, vertex is in cache if it was pushed less than cacheSize pushes ago
+        std::vector<u32> timestamps(vertexCount, 0);
+        u32 timestamp = cacheSize + 1;
+
+        for (size_t i = 0 ; i < indexCount ; i++) {
+            u32 index = indices[i];
+            if (timestamp - timestamps[index] > cacheSize) {
+                timestamps[index] = timestamp++;
+                stats.transformed++;
+            }
+        }
+
+        stats.acmr = stats.triangles == 0 ? 0 : (float) stats.transformed / (float) stats.triangles;
+        stats.atvr = stats.vertices == 0 ? 0 : (float) stats.transformed / (float) stats.vertices;
+
+        return stats;
+    }
+
+    void MeshOptimizer::optimizeVertexCache(u32* indices, size_t indexCount, size_t vertexCount) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // vertex -> triangles adjacency
+        std::vector<u32> valence(vertexCount, 0);
+        for (size_t i = 0 ; i < triangleCount * 3 ; i++) {
+            valence[indices[i]]++;
+        }
+
+        std::vector<u32> offsets(vertexCount + 1, 0);
+        for (size_t v = 0 ; v < vertexCount ; v++) {
+            offsets[v + 1] = offsets[v] + valence[v];
+        }
+
+        std::vector<u32> adjacency(triangleCount * 3);
+        std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0 ; t < triangleCount ; t++) {
+            for (int k = 0 ; k < 3 ; k++) {
+                u32 v = indices[t * 3 + k];
+                adjacency[fill[v]++] = t;
+            }
+        }
+
+        std::vector<int> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0 ; v < vertexCount ; v++) {
+            vertexScores[v] = forsythScore(-1, valence[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        for (size_t t = 0 ; t < triangleCount ; t++) {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<u32> result(triangleCount * 3);
+
+        u32 cache[FORSYTH_CACHE_SIZE + 3];
+        u32 newCache[FORSYTH_CACHE_SIZE + 3];
+        int cacheCount = 0;
+
+        size_t fallbackCursor = 0;
+        size_t best = 0;
+
+        for (size_t emittedCount = 0 ; emittedCount < triangleCount ; emittedCount++) {
+            const u32* triangle = &indices[best * 3];
+            std::memcpy(&result[emittedCount * 3], triangle, sizeof(u32) * 3);
+            emitted[best] = true;
+
+            // detach emitted triangle from its vertices
+            for (int k = 0 ; k < 3 ; k++) {
+                u32 v = triangle[k];
+                u32* begin = &adjacency[offsets[v]];
+                u32* end = begin + valence[v];
+                u32* it = std::find(begin, end, (u32) best);
+                *it = *(end - 1);
+                valence[v]--;
+            }
+
+            // push triangle vertices to the front of LRU cache
+            int newCacheCount = 0;
+            for (int k = 0 ; k < 3 ; k++) {
+                newCache[newCacheCount++] = triangle[k];
+            }
+            for (int i = 0 ; i < cacheCount ; i++) {
+                u32 v = cache[i];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                    newCache[newCacheCount++] = v;
+                }
+            }
+
+            // rescore cached vertices and their triangles, picking best candidate on the way
+            float bestScore = -1;
+            best = triangleCount;
+            for (int i = 0 ; i < newCacheCount ; i++) {
+                u32 v = newCache[i];
+                int position = i < FORSYTH_CACHE_SIZE ? i : -1;
+                cachePositions[v] = position;
+
+                float score = forsythScore(position, valence[v]);
+                float delta = score - vertexScores[v];
+                vertexScores[v] = score;
+
+                for (u32 j = 0 ; j < valence[v] ; j++) {
+                    u32 t = adjacency[offsets[v] + j];
+                    triangleScores[t] += delta;
+                    if (triangleScores[t] > bestScore) {
+                        bestScore = triangleScores[t];
+                        best = t;
+                    }
+                }
+            }
+
+            cacheCount = std::min(newCacheCount, FORSYTH_CACHE_SIZE);
+            std::memcpy(cache, newCache, sizeof(u32) * cacheCount);
+
+            // dead end, continue with first triangle in input order that is still left
+            if (best == triangleCount) {
+                while (fallbackCursor < triangleCount && emitted[fallbackCursor]) {
+                    fallbackCursor++;
+                }
+                best = fallbackCursor;
+            }
+        }
+
+        std::memcpy(indices, result.data(), sizeof(u32) * triangleCount * 3);
+    }
+
+    void MeshOptimizer::optimizeOverdraw(u32* indices, size_t indexCount, const u8* vertices, size_t vertexCount, size_t vertexStride) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+
+        auto position = [vertices, vertexStride](u32 index) {
+            glm::vec3 pos;
+            std::memcpy(&pos, vertices + index * vertexStride, sizeof(glm::vec3));
+            return pos;
+        };
+
+        // cluster boundaries are triangles that restart the cache, which are the points
+        // where reordering whole clusters doesn't hurt vertex cache
+        std::vector<u32> clusters;
+        std::vector<u32> timestamps(vertexCount, 0);
+        u32 timestamp = FIFO_CACHE_SIZE + 1;
+        for (size_t t = 0 ; t < triangleCount ; t++) {
+            int misses = 0;
+            for (int k = 0 ; k < 3 ; k++) {
+                u32 v = indices[t * 3 + k];
+                if (timestamp - timestamps[v] > FIFO_CACHE_SIZE) {
+                    timestamps[v] = timestamp++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3) {
+                clusters.emplace_back(t);
+            }
+        }
+
+        size_t clusterCount = clusters.size();
+        if (clusterCount < 2) {
+            return;
+        }
+        clusters.emplace_back(triangleCount);
+
+        glm::vec3 meshCentroid = { 0, 0, 0 };
+        for (size_t i = 0 ; i < indexCount ; i++) {
+            meshCentroid += position(indices[i]);
+        }
+        meshCentroid /= (float) indexCount;
+
+        // clusters that face away from the mesh center are likely to occlude the rest, so they go first
+        std::vector<float> sortKeys(clusterCount);
+        for (size_t c = 0 ; c < clusterCount ; c++) {
+            glm::vec3 centroid = { 0, 0, 0 };
+            glm::vec3 normal = { 0, 0, 0 };
+            float area = 0;
+
+            for (u32 t = clusters[c] ; t < clusters[c + 1] ; t++) {
+                glm::vec3 p0 = position(indices[t * 3]);
+                glm::vec3 p1 = position(indices[t * 3 + 1]);
+                glm::vec3 p2 = position(indices[t * 3 + 2]);
+                glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                float triangleArea = glm::length(n);
+                centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+                normal += n;
+                area += triangleArea;
+            }
+
+            if (area > 0) {
+                centroid /= area;
+            }
+
+            float normalLength = glm::length(normal);
+            if (normalLength > 0) {
+                normal /= normalLength;
+            }
+
+            sortKeys[c] = glm::dot(centroid - meshCentroid, normal);
+        }
+
+        std::vector<u32> order(clusterCount);
+        for (u32 c = 0 ; c < clusterCount ; c++) {
+            order[c] = c;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](u32 a, u32 b) {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<u32> result;
+        result.reserve(triangleCount * 3);
+        for (u32 c : order) {
+            result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+        }
+
+        std::memcpy(indices, result.data(), sizeof(u32) * triangleCount * 3);
+    }
+
+    size_t MeshOptimizer::remapDuplicates(u32* remap, const u8* vertices, size_t vertexCount, size_t vertexStride) {
+        // open addressing table of unique vertex indices, hashed by vertex bytes
+        size_t tableSize = 1;
+        while (tableSize < vertexCount * 2) {
+            tableSize <<= 1;
+        }
+        std::vector<u32> table(tableSize, INVALID_INDEX);
+
+        auto hash = [vertices, vertexStride](u32 index) {
+            // FNV-1a
+            const u8* data = vertices + index * vertexStride;
+            u64 h = 14695981039346656037ull;
+            for (size_t i = 0 ; i < vertexStride ; i++) {
+                h ^= data[i];
+                h *= 1099511628211ull;
+            }
+            return h;
+        };
+
+        size_t uniqueCount = 0;
+        for (u32 v = 0 ; v < vertexCount ; v++) {
+            size_t bucket = hash(v) & (tableSize - 1);
+
+            while (true) {
+                u32 candidate = table[bucket];
+
+                if (candidate == INVALID_INDEX) {
+                    table[bucket] = v;
+                    remap[v] = uniqueCount++;
+                    break;
+                }
+
+                if (std::memcmp(vertices + candidate * vertexStride, vertices + v * vertexStride, vertexStride) == 0) {
+                    remap[v] = remap[candidate];
+                    break;
+                }
+
+                bucket = (bucket + 1) & (tableSize - 1);
+            }
+        }
+
+        return uniqueCount;
+    }
+
+    size_t MeshOptimizer::remapVertexFetch(u32* remap, const u32* indices, size_t indexCount, size_t vertexCount) {
+        // vertices are laid out in order of first use, unused vertices are dropped
+        std::fill(remap, remap + vertexCount, INVALID_INDEX);
+
+        size_t newCount = 0;
+        for (size_t i = 0 ; i < indexCount ; i++) {
+            u32 index = indices[i];
+            if (remap[index] == INVALID_INDEX) {
+                remap[index] = newCount++;
+            }
+        }
+
+        return newCount;
+    }
+
+    void MeshOptimizer::remapVertices(u8* dst, const u8* src, size_t vertexCount, size_t vertexStride, const u32* remap) {
+        for (size_t v = 0 ; v < vertexCount ; v++) {
+            if (remap[v] != INVALID_INDEX) {
+                std::memcpy(dst + remap[v] * vertexStride, src + v * vertexStride, vertexStride);
+            }
+        }
+    }
+
+    void MeshOptimizer::remapIndices(u32* indices, size_t indexCount, const u32* remap) {
+        for (size_t i = 0 ; i < indexCount ; i++) {
+            indices[i] = remap[indices[i]];
+        }
+    }
+
+}
@@ -0,0 +1,421 @@
+#include <geometry/mesh_simplifier.h>
+
+namespace gl {
+
+    // symmetric 4x4 matrix of plane equations, error(v) = v^T * Q * v
+    struct Quadric final {
+        double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+        double a11 = 0, a12 = 0, a13 = 0;
+        double a22 = 0, a23 = 0;
+        double a33 = 0;
+        // sum of plane weights, normalizes error back to squared distance
+        double weight = 0;
+
+        void addPlane(const glm::vec3& n, double d, double weight) {
+            a00 += weight * n.x * n.x; a01 += weight * n.x * n.y; a02 += weight * n.x * n.z; a03 += weight * n.x * d;
+            a11 += weight * n.y * n.y; a12 += weight * n.y * n.z; a13 += weight * n.y * d;
+            a22 += weight * n.z * n.z; a23 += weight * n.z * d;
+            a33 += weight * d * d;
+            this->weight += weight;
+        }
+
+        void add(const Quadric& q) {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+            a11 += q.a11; a12 += q.a12; a13 += q.a13;
+            a22 += q.a22; a23 += q.a23;
+            a33 += q.a33;
+            weight += q.weight;
+        }
+
+        // squared distance from v to planes of the quadric
+        [[nodiscard]] double evaluate(const glm::vec3& v) const {
+            double x = v.x, y = v.y, z = v.z;
+            double result = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                    + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                    + a22 * z * z + 2 * a23 * z
+                    + a33;
+            return result > 0 && weight > 0 ? result / weight : 0;
+        }
+    };
+
+    // vertex classification of meshoptimizer, decides where vertex may collapse to
+    enum VertexKind : u8 {
+        // interior vertex, collapses anywhere
+        VERTEX_MANIFOLD,
+        // lies on open edges of mesh, stays to keep silhouette
+        VERTEX_BORDER,
+        // one of two vertices with the same position whose open edges match each other,
+        // collapses along the seam onto another seam vertex together with its pair
+        VERTEX_SEAM,
+        // non-manifold seams and borders, and everything else that can't move
+        VERTEX_LOCKED
+    };
+
+    static constexpr u32 NO_EDGE = UINT32_MAX;
+
+    struct Collapse final {
+        u32 from;
+        u32 to;
+        double error;
+    };
+
+    static glm::vec3 readPosition(const u8* vertices, size_t vertexStride, u32 index) {
+        glm::vec3 position;
+        std::memcpy(&position, vertices + index * vertexStride, sizeof(glm::vec3));
+        return position;
+    }
+
+    static u64 edgeKey(u32 a, u32 b) {
+        return a < b ? ((u64) a << 32) | b : ((u64) b << 32) | a;
+    }
+
+    // open edge a -> b is not used by any triangle in opposite direction,
+    // openOut[a] = b and openIn[b] = a, vertex itself if it has more than one open edge that way
+    static void findOpenEdges(const std::vector<u32>& indices, std::vector<u32>& openIn, std::vector<u32>& openOut) {
+        std::unordered_set<u64> halfEdges;
+        halfEdges.reserve(indices.size());
+        for (size_t i = 0 ; i < indices.size() ; i += 3) {
+            for (int k = 0 ; k < 3 ; k++) {
+                halfEdges.insert(((u64) indices[i + k] << 32) | indices[i + (k + 1) % 3]);
+            }
+        }
+
+        for (u64 edge : halfEdges) {
+            u32 a = edge >> 32;
+            u32 b = edge & 0xFFFFFFFF;
+            if (halfEdges.find(((u64) b << 32) | a) != halfEdges.end()) {
+                continue;
+            }
+            openOut[a] = openOut[a] == NO_EDGE ? b : a;
+            openIn[b] = openIn[b] == NO_EDGE ? a : b;
+        }
+    }
+
+    static bool isOpenEdge(u32 edge, u32 vertex) {
+        return edge != NO_EDGE && edge != vertex;
+    }
+
+    static void classifyVertices(
+            std::vector<VertexKind>& kinds,
+            const std::vector<u32>& remap,
+            const std::vector<u32>& wedges,
+            const std::vector<u32>& openIn,
+            const std::vector<u32>& openOut
+    ) {
+        for (u32 v = 0 ; v < kinds.size() ; v++) {
+            u32 w = wedges[v];
+
+            if (w == v) {
+                if (openIn[v] == NO_EDGE && openOut[v] == NO_EDGE) {
+                    kinds[v] = VERTEX_MANIFOLD;
+                } else if (isOpenEdge(openIn[v], v) && isOpenEdge(openOut[v], v)) {
+                    kinds[v] = VERTEX_BORDER;
+                } else {
+                    kinds[v] = VERTEX_LOCKED;
+                }
+                continue;
+            }
+
+            // seam has exactly two wedges, open edge coming into one goes out of other at the same positions
+            bool isSeam = wedges[w] == v
+                    && isOpenEdge(openIn[v], v) && isOpenEdge(openOut[v], v)
+                    && isOpenEdge(openIn[w], w) && isOpenEdge(openOut[w], w)
+                    && remap[openIn[v]] == remap[openOut[w]]
+                    && remap[openOut[v]] == remap[openIn[w]]
+                    && remap[openIn[v]] != remap[openOut[v]];
+            kinds[v] = isSeam ? VERTEX_SEAM : VERTEX_LOCKED;
+        }
+    }
+
+    // seam pair of "from" moves along the same seam edge, on its side edge goes the other way
+    static u32 getSeamTarget(const Collapse& collapse, const std::vector<u32>& wedges,
+                             const std::vector<u32>& openIn, const std::vector<u32>& openOut) {
+        u32 pair = wedges[collapse.from];
+        return openOut[collapse.from] == collapse.to ? openIn[pair] : openOut[pair];
+    }
+
+    // collapses of this pass moved open edges, edge onto vertex collapsed into its owner continues past it
+    static void remapOpenEdges(std::vector<u32>& edges, const std::vector<u32>& remap) {
+        for (u32 v = 0 ; v < edges.size() ; v++) {
+            u32 edge = edges[v];
+            if (!isOpenEdge(edge, v)) {
+                continue;
+            }
+            u32 target = remap[edge];
+            edges[v] = target == v ? edges[edge] : target;
+        }
+    }
+
+    // checks that moving "from" vertex onto "to" doesn't flip or degenerate any triangle around "from"
+    static bool isCollapseValid(
+            const Collapse& collapse,
+            const std::vector<glm::vec3>& positions,
+            const std::vector<u32>& indices,
+            const std::vector<u32>& offsets,
+            const std::vector<u32>& adjacency
+    ) {
+        const glm::vec3& target = positions[collapse.to];
+
+        for (u32 i = offsets[collapse.from] ; i < offsets[collapse.from + 1] ; i++) {
+            const u32* triangle = &indices[adjacency[i] * 3];
+
+            if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                continue;
+            }
+
+            glm::vec3 p0 = positions[triangle[0]];
+            glm::vec3 p1 = positions[triangle[1]];
+            glm::vec3 p2 = positions[triangle[2]];
+            glm::vec3 oldNormal = glm::cross(p1 - p0, p2 - p0);
+
+            for (int k = 0 ; k < 3 ; k++) {
+                if (triangle[k] == collapse.from) {
+                    (k == 0 ? p0 : k == 1 ? p1 : p2) = target;
+                }
+            }
+            glm::vec3 newNormal = glm::cross(p1 - p0, p2 - p0);
+
+            if (glm::dot(oldNormal, newNormal) <= 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t MeshSimplifier::simplify(
+            u32* dst,
+            const u32* srcIndices, size_t indexCount,
+            const u8* vertices, size_t vertexCount, size_t vertexStride,
+            size_t targetIndexCount, float targetError,
+            float& resultError
+    ) {
+        resultError = 0;
+        std::vector<u32> indices(srcIndices, srcIndices + indexCount);
+
+        std::vector<glm::vec3> positions(vertexCount);
+        for (u32 v = 0 ; v < vertexCount ; v++) {
+            positions[v] = readPosition(vertices, vertexStride, v);
+        }
+
+        // vertices with the same position, wedges link them into a cycle
+        std::vector<u32> positionRemap(vertexCount);
+        std::vector<u32> wedges(vertexCount);
+        {
+            MeshOptimizer::remapDuplicates(positionRemap.data(), (const u8*) positions.data(), vertexCount, sizeof(glm::vec3));
+            // remap points at unique index, first vertex of every position represents it
+            std::vector<u32> first(vertexCount, NO_EDGE);
+            for (u32 v = 0 ; v < vertexCount ; v++) {
+                u32& representative = first[positionRemap[v]];
+                if (representative == NO_EDGE) {
+                    representative = v;
+                }
+                positionRemap[v] = representative;
+                wedges[v] = v;
+            }
+            for (u32 v = 0 ; v < vertexCount ; v++) {
+                u32 representative = positionRemap[v];
+                if (representative != v) {
+                    wedges[v] = wedges[representative];
+                    wedges[representative] = v;
+                }
+            }
+        }
+
+        std::vector<u32> openIn(vertexCount, NO_EDGE);
+        std::vector<u32> openOut(vertexCount, NO_EDGE);
+        findOpenEdges(indices, openIn, openOut);
+
+        std::vector<VertexKind> kinds(vertexCount);
+        classifyVertices(kinds, positionRemap, wedges, openIn, openOut);
+
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0 ; i < indexCount ; i += 3) {
+            glm::vec3 p0 = positions[indices[i]];
+            glm::vec3 p1 = positions[indices[i + 1]];
+            glm::vec3 p2 = positions[indices[i + 2]];
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            if (area == 0) {
+                continue;
+            }
+            normal /= area;
+
+            // accumulated per position, so that both wedges of seam see the whole surface
+            Quadric quadric;
+            quadric.addPlane(normal, -glm::dot(normal, p0), area);
+            for (int k = 0 ; k < 3 ; k++) {
+                quadrics[positionRemap[indices[i + k]]].add(quadric);
+            }
+
+            // plane through seam edge perpendicular to triangle keeps seam from moving sideways
+            for (int k = 0 ; k < 3 ; k++) {
+                u32 a = indices[i + k];
+                u32 b = indices[i + (k + 1) % 3];
+                if (openOut[a] != b || (kinds[a] != VERTEX_SEAM && kinds[b] != VERTEX_SEAM)) {
+                    continue;
+                }
+                glm::vec3 edge = positions[b] - positions[a];
+                float length = glm::length(edge);
+                if (length == 0) {
+                    continue;
+                }
+                glm::vec3 edgeNormal = glm::cross(edge / length, normal);
+                Quadric edgeQuadric;
+                edgeQuadric.addPlane(edgeNormal, -glm::dot(edgeNormal, positions[a]), length * length);
+                quadrics[positionRemap[a]].add(edgeQuadric);
+                quadrics[positionRemap[b]].add(edgeQuadric);
+            }
+        }
+
+        // manifold vertices collapse anywhere, seam ones only along seam onto seam vertex
+        auto canCollapse = [&](u32 from, u32 to) {
+            switch (kinds[from]) {
+                case VERTEX_MANIFOLD:
+                    return true;
+                case VERTEX_SEAM:
+                    return kinds[to] == VERTEX_SEAM && (openOut[from] == to || openIn[from] == to);
+                default:
+                    return false;
+            }
+        };
+
+        std::vector<u32> remap(vertexCount);
+        std::vector<u32> offsets(vertexCount + 1);
+        std::vector<u32> adjacency;
+        std::vector<bool> touched(vertexCount);
+        std::vector<Collapse> collapses;
+        std::unordered_set<u64> edges;
+
+        double maxError = (double) targetError * (double) targetError;
+        double appliedError = 0;
+
+        while (indices.size() > targetIndexCount) {
+            size_t triangleCount = indices.size() / 3;
+
+            // vertex -> triangles adjacency of current mesh
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (u32 index : indices) {
+                offsets[index + 1]++;
+            }
+            for (size_t v = 0 ; v < vertexCount ; v++) {
+                offsets[v + 1] += offsets[v];
+            }
+            adjacency.resize(indices.size());
+            std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+            for (u32 t = 0 ; t < triangleCount ; t++) {
+                for (int k = 0 ; k < 3 ; k++) {
+                    adjacency[fill[indices[t * 3 + k]]++] = t;
+                }
+            }
+
+            // cheapest direction of every edge
+            collapses.clear();
+            edges.clear();
+            for (u32 t = 0 ; t < triangleCount ; t++) {
+                for (int k = 0 ; k < 3 ; k++) {
+                    u32 a = indices[t * 3 + k];
+                    u32 b = indices[t * 3 + (k + 1) % 3];
+                    if (a == b || !edges.insert(edgeKey(a, b)).second) {
+                        continue;
+                    }
+
+                    double errorAB = canCollapse(a, b) ? quadrics[positionRemap[a]].evaluate(positions[b]) : DBL_MAX;
+                    double errorBA = canCollapse(b, a) ? quadrics[positionRemap[b]].evaluate(positions[a]) : DBL_MAX;
+
+                    if (errorAB == DBL_MAX && errorBA == DBL_MAX) {
+                        continue;
+                    }
+
+                    collapses.push_back(errorAB <= errorBA ? Collapse { a, b, errorAB } : Collapse { b, a, errorBA });
+                }
+            }
+
+            if (collapses.empty()) {
+                break;
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) {
+                return l.error < r.error;
+            });
+
+            // every collapse removes about two triangles, stop the pass when enough are scheduled
+            size_t trianglesToRemove = (indices.size() - targetIndexCount) / 3;
+            size_t collapseLimit = std::max<size_t>(trianglesToRemove / 2, 1);
+
+            for (u32 v = 0 ; v < vertexCount ; v++) {
+                remap[v] = v;
+            }
+            std::fill(touched.begin(), touched.end(), false);
+
+            size_t collapseCount = 0;
+            for (auto& collapse : collapses) {
+                if (collapseCount >= collapseLimit || collapse.error > maxError) {
+                    break;
+                }
+
+                if (touched[collapse.from] || touched[collapse.to]) {
+                    continue;
+                }
+
+                if (!isCollapseValid(collapse, positions, indices, offsets, adjacency)) {
+                    continue;
+                }
+
+                // the same collapse unless vertex has pair on other side of seam
+                Collapse seamCollapse = collapse;
+                if (kinds[collapse.from] == VERTEX_SEAM) {
+                    seamCollapse.from = wedges[collapse.from];
+                    seamCollapse.to = getSeamTarget(collapse, wedges, openIn, openOut);
+                    if (touched[seamCollapse.from] || touched[seamCollapse.to]
+                        || !isCollapseValid(seamCollapse, positions, indices, offsets, adjacency)) {
+                        continue;
+                    }
+                }
+
+                remap[seamCollapse.from] = seamCollapse.to;
+                remap[collapse.from] = collapse.to;
+                quadrics[positionRemap[collapse.to]].add(quadrics[positionRemap[collapse.from]]);
+                appliedError = std::max(appliedError, collapse.error);
+                collapseCount++;
+
+                // neighbours of collapsed vertices can't move in this pass, adjacency of them is stale now
+                for (u32 from : { collapse.from, seamCollapse.from }) {
+                    for (u32 i = offsets[from] ; i < offsets[from + 1] ; i++) {
+                        const u32* triangle = &indices[adjacency[i] * 3];
+                        touched[triangle[0]] = true;
+                        touched[triangle[1]] = true;
+                        touched[triangle[2]] = true;
+                    }
+                }
+            }
+
+            if (collapseCount == 0) {
+                break;
+            }
+
+            // apply collapses and drop degenerate triangles
+            size_t writeIndex = 0;
+            for (size_t i = 0 ; i < indices.size() ; i += 3) {
+                u32 a = remap[indices[i]];
+                u32 b = remap[indices[i + 1]];
+                u32 c = remap[indices[i + 2]];
+                if (a == b || b == c || a == c) {
+                    continue;
+                }
+                indices[writeIndex++] = a;
+                indices[writeIndex++] = b;
+                indices[writeIndex++] = c;
+            }
+            indices.resize(writeIndex);
+
+            remapOpenEdges(openIn, remap);
+            remapOpenEdges(openOut, remap);
+        }
+
+        resultError = (float) std::sqrt(appliedError);
+        std::memcpy(dst, indices.data(), indices.size() * sizeof(u32));
+        return indices.size();
+    }
+
+}
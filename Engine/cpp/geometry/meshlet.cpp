@@ -0,0 +1,200 @@
+#include <geometry/meshlet.h>
+
+namespace gl {
+
+    static constexpr u8 NO_LOCAL_INDEX = 0xFF;
+
+    void MeshletMesh::clear() {
+        meshlets.clear();
+        bounds.clear();
+        vertices.clear();
+        triangles.clear();
+    }
+
+    static glm::vec3 readPosition(const u8* vertices, size_t vertexStride, u32 index) {
+        glm::vec3 position;
+        std::memcpy(&position, vertices + index * vertexStride, sizeof(glm::vec3));
+        return position;
+    }
+
+    static MeshletBounds computeBounds(const MeshletMesh& mesh, const Meshlet& meshlet, const u8* vertices, size_t vertexStride) {
+        MeshletBounds bounds;
+
+        // sphere around center of AABB, cheaper than minimal sphere and tight enough for small clusters
+        Bounds box;
+        for (u32 i = 0 ; i < meshlet.vertexCount ; i++) {
+            box.add(readPosition(vertices, vertexStride, mesh.vertices[meshlet.vertexOffset + i]));
+        }
+        glm::vec3 center = box.center();
+        float radius = 0;
+        for (u32 i = 0 ; i < meshlet.vertexCount ; i++) {
+            glm::vec3 position = readPosition(vertices, vertexStride, mesh.vertices[meshlet.vertexOffset + i]);
+            radius = std::max(radius, glm::length(position - center));
+        }
+        bounds.sphere = Sphere(center, radius);
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis = { 0, 0, 0 };
+        for (u32 t = 0 ; t < meshlet.triangleCount ; t++) {
+            const u8* triangle = &mesh.triangles[(meshlet.triangleOffset + t) * 3];
+            glm::vec3 p0 = readPosition(vertices, vertexStride, mesh.vertices[meshlet.vertexOffset + triangle[0]]);
+            glm::vec3 p1 = readPosition(vertices, vertexStride, mesh.vertices[meshlet.vertexOffset + triangle[1]]);
+            glm::vec3 p2 = readPosition(vertices, vertexStride, mesh.vertices[meshlet.vertexOffset + triangle[2]]);
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            if (area == 0) {
+                continue;
+            }
+            normal /= area;
+            normals.emplace_back(normal);
+            axis += normal;
+        }
+
+        float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength == 0) {
+            return bounds;
+        }
+        axis /= axisLength;
+
+        float minDot = 1;
+        for (auto& normal : normals) {
+            minDot = std::min(minDot, glm::dot(axis, normal));
+        }
+
+        // cone wider than hemisphere can't reject anything
+        if (minDot <= 0) {
+            return bounds;
+        }
+
+        bounds.coneAxis = axis;
+        bounds.coneCutoff = std::sqrt(1 - minDot * minDot);
+        return bounds;
+    }
+
+    void MeshletBuilder::build(
+            MeshletMesh& result,
+            const u32* indices, size_t indexCount,
+            const u8* vertices, size_t vertexCount, size_t vertexStride
+    ) {
+        result.clear();
+
+        std::vector<u8> localIndices(vertexCount, NO_LOCAL_INDEX);
+        Meshlet meshlet;
+
+        auto flush = [&]() {
+            if (meshlet.triangleCount == 0) {
+                return;
+            }
+
+            for (u32 i = 0 ; i < meshlet.vertexCount ; i++) {
+                localIndices[result.vertices[meshlet.vertexOffset + i]] = NO_LOCAL_INDEX;
+            }
+
+            result.meshlets.emplace_back(meshlet);
+            result.bounds.emplace_back(computeBounds(result, meshlet, vertices, vertexStride));
+
+            meshlet.vertexOffset = result.vertices.size();
+            meshlet.triangleOffset = result.triangles.size() / 3;
+            meshlet.vertexCount = 0;
+            meshlet.triangleCount = 0;
+        };
+
+        for (size_t i = 0 ; i + 2 < indexCount ; i += 3) {
+            u32 a = indices[i];
+            u32 b = indices[i + 1];
+            u32 c = indices[i + 2];
+
+            u32 newVertices = (localIndices[a] == NO_LOCAL_INDEX) + (localIndices[b] == NO_LOCAL_INDEX) + (localIndices[c] == NO_LOCAL_INDEX);
+            if (meshlet.vertexCount + newVertices > MAX_VERTICES || meshlet.triangleCount + 1 > MAX_TRIANGLES) {
+                flush();
+            }
+
+            for (u32 v : { a, b, c }) {
+                if (localIndices[v] == NO_LOCAL_INDEX) {
+                    localIndices[v] = meshlet.vertexCount++;
+                    result.vertices.emplace_back(v);
+                }
+                result.triangles.emplace_back(localIndices[v]);
+            }
+            meshlet.triangleCount++;
+        }
+
+        flush();
+    }
+
+    static Sphere toWorld(const Sphere& sphere, const glm::mat4& model) {
+        // largest axis scale keeps sphere conservative for non uniform scale
+        float scale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        return Sphere(glm::vec3(model * glm::vec4(sphere.center, 1)), sphere.radius * scale);
+    }
+
+    bool MeshletCuller::isVisible(
+            const MeshletBounds& bounds,
+            const Frustum& frustum,
+            const glm::mat4& model,
+            const glm::vec3& cameraPosition
+    ) {
+        Sphere sphere = toWorld(bounds.sphere, model);
+        if (!frustum.intersects(sphere)) {
+            return false;
+        }
+
+        if (bounds.coneCutoff >= 1) {
+            return true;
+        }
+
+        // every triangle faces away, if camera sees sphere from inside of the backface cone
+        glm::vec3 axis = glm::normalize(glm::vec3(model * glm::vec4(bounds.coneAxis, 0)));
+        glm::vec3 view = sphere.center - cameraPosition;
+        return glm::dot(view, axis) < bounds.coneCutoff * glm::length(view) + sphere.radius;
+    }
+
+    bool MeshletCuller::isVisible(const MeshletBounds& bounds, const Frustum& frustum, const glm::mat4& model) {
+        return frustum.intersects(toWorld(bounds.sphere, model));
+    }
+
+    void MeshletCuller::cull(
+            std::vector<u32>& visible,
+            const MeshletMesh& mesh,
+            const Frustum& frustum,
+            const glm::mat4& model,
+            const glm::vec3& cameraPosition
+    ) {
+        visible.clear();
+        for (u32 i = 0 ; i < mesh.meshlets.size() ; i++) {
+            if (isVisible(mesh.bounds[i], frustum, model, cameraPosition)) {
+                visible.emplace_back(i);
+            }
+        }
+    }
+
+    void MeshletCuller::cull(
+            std::vector<u32>& visible,
+            const MeshletMesh& mesh,
+            const Frustum& frustum,
+            const glm::mat4& model
+    ) {
+        visible.clear();
+        for (u32 i = 0 ; i < mesh.meshlets.size() ; i++) {
+            if (isVisible(mesh.bounds[i], frustum, model)) {
+                visible.emplace_back(i);
+            }
+        }
+    }
+
+    void MeshletCuller::getRanges(std::vector<MeshletRange>& ranges, const MeshletMesh& mesh, const std::vector<u32>& visible) {
+        ranges.clear();
+        for (u32 i : visible) {
+            const Meshlet& meshlet = mesh.meshlets[i];
+            u32 firstIndex = meshlet.triangleOffset * 3;
+            u32 indexCount = meshlet.triangleCount * 3;
+            if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == firstIndex) {
+                ranges.back().indexCount += indexCount;
+            } else {
+                ranges.push_back({ firstIndex, indexCount });
+            }
+        }
+    }
+
+}
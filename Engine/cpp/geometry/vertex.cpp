@@ -2,6 +2,32 @@
 
 namespace gl {
 
+    size_t Attribute::size() const {
+        switch (type) {
+            case ATTRIBUTE_F16:
+            case ATTRIBUTE_UNORM16:
+            case ATTRIBUTE_SNORM16:
+                return primitiveType * sizeof(u16);
+            case ATTRIBUTE_UNORM8:
+            case ATTRIBUTE_U8:
+                return primitiveType * sizeof(u8);
+            case ATTRIBUTE_I32:
+                return primitiveType * sizeof(int);
+            default:
+                return primitiveType * sizeof(float);
+        }
+    }
+
+    static constexpr UniformHandle<bool> QUANTIZED = "quantized";
+    static constexpr UniformHandle<glm::vec3> QUANTIZATION_OFFSET = "quantization_offset";
+    static constexpr UniformHandle<glm::vec3> QUANTIZATION_SCALE = "quantization_scale";
+
+    void VertexDequantization::update(Shader& shader) {
+        shader.setUniform(QUANTIZED, enabled);
+        shader.setUniform(QUANTIZATION_OFFSET, offset);
+        shader.setUniform(QUANTIZATION_SCALE, scale);
+    }
+
     VertexFormat VertexDefault::format = {
             { Attributes::POS3 },
             sizeof(VertexDefault)
@@ -0,0 +1,152 @@
+#include <geometry/vertex_quantization.h>
+
+namespace gl {
+
+    u16 VertexQuantizer::encodeUnorm16(float v) {
+        return (u16) std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    float VertexQuantizer::decodeUnorm16(u16 v) {
+        return (float) v / 65535.0f;
+    }
+
+    int16_t VertexQuantizer::encodeSnorm16(float v) {
+        return (int16_t) std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    float VertexQuantizer::decodeSnorm16(int16_t v) {
+        // same as GL conversion of normalized signed integers, -32768 and -32767 both map to -1
+        return std::max((float) v / 32767.0f, -1.0f);
+    }
+
+    u8 VertexQuantizer::encodeUnorm8(float v) {
+        return (u8) std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f);
+    }
+
+    float VertexQuantizer::decodeUnorm8(u8 v) {
+        return (float) v / 255.0f;
+    }
+
+    static float signNotZero(float v) {
+        return v >= 0 ? 1.0f : -1.0f;
+    }
+
+    glm::vec2 VertexQuantizer::encodeOctahedral(const glm::vec3& direction) {
+        float l1 = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (l1 == 0) {
+            return { 0, 0 };
+        }
+
+        glm::vec2 v = { direction.x / l1, direction.y / l1 };
+        // lower hemisphere is folded over diagonals
+        if (direction.z < 0) {
+            v = {
+                    (1 - std::abs(v.y)) * signNotZero(v.x),
+                    (1 - std::abs(v.x)) * signNotZero(v.y)
+            };
+        }
+        return v;
+    }
+
+    glm::vec3 VertexQuantizer::decodeOctahedral(const glm::vec2& v) {
+        glm::vec3 direction = { v.x, v.y, 1 - std::abs(v.x) - std::abs(v.y) };
+        if (direction.z < 0) {
+            direction.x = (1 - std::abs(v.y)) * signNotZero(v.x);
+            direction.y = (1 - std::abs(v.x)) * signNotZero(v.y);
+        }
+        return glm::normalize(direction);
+    }
+
+    glm::i16vec2 VertexQuantizer::encodeDirection(const glm::vec3& direction) {
+        glm::vec2 v = encodeOctahedral(direction);
+        return { encodeSnorm16(v.x), encodeSnorm16(v.y) };
+    }
+
+    glm::vec3 VertexQuantizer::decodeDirection(const glm::i16vec2& v) {
+        return decodeOctahedral({ decodeSnorm16(v.x), decodeSnorm16(v.y) });
+    }
+
+    glm::u16vec4 VertexQuantizer::encodePosition(const glm::vec3& position, const VertexDequantization& dequantization) {
+        glm::vec3 v = (position - dequantization.offset) / dequantization.scale;
+        return { encodeUnorm16(v.x), encodeUnorm16(v.y), encodeUnorm16(v.z), 0 };
+    }
+
+    glm::vec3 VertexQuantizer::decodePosition(const glm::u16vec4& v, const VertexDequantization& dequantization) {
+        glm::vec3 position = { decodeUnorm16(v.x), decodeUnorm16(v.y), decodeUnorm16(v.z) };
+        return dequantization.offset + position * dequantization.scale;
+    }
+
+    glm::u16vec2 VertexQuantizer::encodeUV(const glm::vec2& uv) {
+        return { glm::packHalf1x16(uv.x), glm::packHalf1x16(uv.y) };
+    }
+
+    glm::vec2 VertexQuantizer::decodeUV(const glm::u16vec2& v) {
+        return { glm::unpackHalf1x16(v.x), glm::unpackHalf1x16(v.y) };
+    }
+
+    void VertexQuantizer::encodeBones(
+            const glm::ivec4& ids, const glm::vec4& weights,
+            glm::u8vec4& encodedIds, glm::u8vec4& encodedWeights
+    ) {
+        glm::vec4 used = { 0, 0, 0, 0 };
+        float sum = 0;
+        for (int i = 0 ; i < 4 ; i++) {
+            if (ids[i] >= 0 && ids[i] <= 255 && weights[i] > 0) {
+                used[i] = weights[i];
+                sum += weights[i];
+            }
+        }
+
+        encodedIds = { 0, 0, 0, 0 };
+        encodedWeights = { 0, 0, 0, 0 };
+        if (sum == 0) {
+            return;
+        }
+
+        // rounding error goes into the largest weight
+        int total = 0;
+        int largest = 0;
+        for (int i = 0 ; i < 4 ; i++) {
+            if (used[i] == 0) {
+                continue;
+            }
+            encodedIds[i] = (u8) ids[i];
+            encodedWeights[i] = encodeUnorm8(used[i] / sum);
+            total += encodedWeights[i];
+            if (used[i] > used[largest]) {
+                largest = i;
+            }
+        }
+        encodedWeights[largest] = (u8) std::clamp(encodedWeights[largest] + 255 - total, 0, 255);
+    }
+
+    void VertexQuantizer::decodeBones(
+            const glm::u8vec4& encodedIds, const glm::u8vec4& encodedWeights,
+            glm::ivec4& ids, glm::vec4& weights
+    ) {
+        for (int i = 0 ; i < 4 ; i++) {
+            bool used = encodedWeights[i] != 0;
+            ids[i] = used ? (int) encodedIds[i] : -1;
+            weights[i] = decodeUnorm8(encodedWeights[i]);
+        }
+    }
+
+    VertexDequantization VertexQuantizer::dequantization(const Bounds& bounds) {
+        VertexDequantization dequantization;
+        dequantization.enabled = true;
+
+        if (bounds.min.x > bounds.max.x) {
+            return dequantization;
+        }
+
+        glm::vec3 extent = bounds.extent();
+        dequantization.offset = bounds.min;
+        dequantization.scale = {
+                std::max(extent.x, 1e-6f),
+                std::max(extent.y, 1e-6f),
+                std::max(extent.z, 1e-6f)
+        };
+        return dequantization;
+    }
+
+}
@@ -0,0 +1,194 @@
+#include <imgui/profiler_window.h>
+
+namespace gl {
+
+    const char* ProfilerWindow::title = "Profiler";
+    glm::vec2 ProfilerWindow::position = { 0, 0 };
+    glm::vec2 ProfilerWindow::resolution = { 800, 400 };
+    ImGuiWindowFlags ProfilerWindow::windowFlags = ImGuiWindowFlags_None;
+    const char* ProfilerWindow::traceFilepath = "profile.json";
+
+    static bool pOpen = false;
+    static bool pInitialized = false;
+    static bool pPaused = false;
+    // frame index selected in history, newest frame if 0
+    static u64 pSelectedFrame = 0;
+    // frame history copied on pause, so that it doesn't scroll away
+    static std::vector<ProfileFrame> pFrames;
+
+    static constexpr float ROW_HEIGHT = 18;
+
+    static void pause() {
+        pPaused = true;
+        pFrames.clear();
+        pFrames.reserve(Profiler::getFrameCount());
+        for (u32 i = 0 ; i < Profiler::getFrameCount() ; i++) {
+            pFrames.emplace_back(Profiler::getFrame(i));
+        }
+    }
+
+    // live history is read in place, only paused one is a copy
+    static u32 getFrameCount() {
+        return pPaused ? pFrames.size() : Profiler::getFrameCount();
+    }
+
+    static const ProfileFrame& getFrame(u32 i) {
+        return pPaused ? pFrames[i] : Profiler::getFrame(i);
+    }
+
+    static ImU32 getColor(const char* name) {
+        u32 hash = 2166136261u;
+        for (const char* c = name ; *c ; c++) {
+            hash = (hash ^ (u8) *c) * 16777619u;
+        }
+        float hue = (float) (hash % 360) / 360.0f;
+        float r, g, b;
+        ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.8f, r, g, b);
+        return ImGui::ColorConvertFloat4ToU32({ r, g, b, 1 });
+    }
+
+    void ProfilerWindow::render() {
+        if (!ImGui::Begin(title, &pOpen, windowFlags)) {
+            end();
+            return;
+        }
+
+        if (!pInitialized) {
+            pInitialized = true;
+            ImGui::SetWindowPos({ position.x, position.y });
+            ImGui::SetWindowSize({ resolution.x, resolution.y });
+        }
+
+        ImGui::Checkbox("Enabled", &Profiler::isEnabled);
+        ImGui::SameLine();
+        ImGui::Checkbox("GPU", &Profiler::isGpuEnabled);
+        ImGui::SameLine();
+        bool paused = pPaused;
+        if (ImGui::Checkbox("Pause", &paused)) {
+            if (paused) {
+                pause();
+            } else {
+                pPaused = false;
+                pFrames.clear();
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export trace")) {
+            Profiler::exportTrace(traceFilepath);
+        }
+
+        u32 frameCount = getFrameCount();
+        if (frameCount == 0) {
+            end();
+            return;
+        }
+
+        std::vector<float> frameTimes;
+        frameTimes.reserve(frameCount);
+        const ProfileFrame* selected = &getFrame(frameCount - 1);
+        for (u32 i = 0 ; i < frameCount ; i++) {
+            const ProfileFrame& frame = getFrame(i);
+            frameTimes.emplace_back(frame.getMillis());
+            if (frame.index == pSelectedFrame) {
+                selected = &frame;
+            }
+        }
+
+        float width = ImGui::GetContentRegionAvail().x;
+        ImGui::PlotHistogram("##FrameTimes", frameTimes.data(), frameTimes.size(), 0,
+                             null, 0, 50, { width, 60 });
+        // select frame by clicking its bar
+        if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(0)) {
+            float x = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+            u32 i = std::min<u32>(x * frameCount, frameCount - 1);
+            pSelectedFrame = getFrame(i).index;
+            if (!pPaused) {
+                pause();
+            }
+            // copy of history doesn't move, unlike live frame it was selected from
+            selected = &pFrames.back();
+            for (const auto& frame : pFrames) {
+                if (frame.index == pSelectedFrame) {
+                    selected = &frame;
+                }
+            }
+        }
+
+        ImGui::Text("Frame %llu: %.3f ms", (unsigned long long) selected->index, selected->getMillis());
+
+        ImGui::BeginChild("FlameGraph", { 0, 0 }, false, ImGuiWindowFlags_HorizontalScrollbar);
+        width = ImGui::GetContentRegionAvail().x;
+        for (u32 thread = 0 ; thread < Profiler::getThreadCount() ; thread++) {
+            std::string threadName = Profiler::getThreadName(thread);
+            renderRow(threadName.c_str(), selected->events, thread, false,
+                      selected->begin, selected->end, width);
+        }
+        if (selected->gpuEvents.empty()) {
+            ImGui::TextDisabled("GPU: pending");
+        } else {
+            renderRow("GPU", selected->gpuEvents, 0, true, selected->begin, selected->end, width);
+        }
+        ImGui::EndChild();
+
+        end();
+    }
+
+    void ProfilerWindow::renderRow(const char* name, const std::vector<ProfileEvent>& events, u32 thread, bool gpu,
+                                   u64 frameBegin, u64 frameEnd, float width) {
+        u32 maxDepth = 0;
+        bool empty = true;
+        for (const auto& event : events) {
+            if ((gpu || event.thread == thread) && event.end > frameBegin) {
+                maxDepth = std::max(maxDepth, event.depth);
+                empty = false;
+            }
+        }
+        if (empty) {
+            return;
+        }
+
+        ImGui::TextUnformatted(name);
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float height = (maxDepth + 1) * ROW_HEIGHT;
+        // GPU work of frame may end after CPU frame ended
+        u64 end = frameEnd;
+        for (const auto& event : events) {
+            if (gpu || event.thread == thread) {
+                end = std::max(end, event.end);
+            }
+        }
+        float scale = width / (float) (end - frameBegin);
+
+        ImGui::InvisibleButton(name, { width, height });
+        ImVec2 mouse = ImGui::GetMousePos();
+        bool hovered = ImGui::IsItemHovered();
+
+        for (const auto& event : events) {
+            if ((!gpu && event.thread != thread) || event.end <= frameBegin) {
+                continue;
+            }
+
+            u64 begin = std::max(event.begin, frameBegin);
+            ImVec2 min = { origin.x + (float) (begin - frameBegin) * scale, origin.y + event.depth * ROW_HEIGHT };
+            ImVec2 max = { origin.x + (float) (event.end - frameBegin) * scale, min.y + ROW_HEIGHT - 1 };
+            max.x = std::max(max.x, min.x + 1);
+
+            drawList->AddRectFilled(min, max, getColor(event.name));
+            if (max.x - min.x > 8) {
+                ImVec4 clip = { min.x, min.y, max.x, max.y };
+                drawList->AddText(null, 0, { min.x + 2, min.y + 2 }, IM_COL32(0, 0, 0, 255), event.name, null, 0, &clip);
+            }
+
+            if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                ImGui::SetTooltip("%s: %.3f ms", event.name, event.getMillis());
+            }
+        }
+    }
+
+    void ProfilerWindow::end() {
+        ImGui::End();
+    }
+
+}
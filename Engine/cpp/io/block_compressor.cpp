@@ -0,0 +1,658 @@
+#include <io/block_compressor.h>
+#include <core/thread_pool.h>
+
+namespace gl {
+
+    static constexpr int BLOCK_PIXELS = 16;
+
+    // BC7 interpolation weights of 4-bit indices
+    static constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    static u8 clampByte(float v) {
+        return (u8) std::clamp((int) std::lround(v), 0, 255);
+    }
+
+    // principal axis of N-dimensional points by power iteration over covariance matrix
+    template<int N>
+    static void principalAxis(const float (*points)[4], int count, float* mean, float* axis) {
+        for (int c = 0 ; c < N ; c++) {
+            mean[c] = 0;
+            for (int i = 0 ; i < count ; i++) {
+                mean[c] += points[i][c];
+            }
+            mean[c] /= count;
+        }
+
+        float covariance[N][N] = {};
+        for (int i = 0 ; i < count ; i++) {
+            for (int r = 0 ; r < N ; r++) {
+                for (int c = 0 ; c < N ; c++) {
+                    covariance[r][c] += (points[i][r] - mean[r]) * (points[i][c] - mean[c]);
+                }
+            }
+        }
+
+        for (int c = 0 ; c < N ; c++) {
+            axis[c] = 1;
+        }
+        for (int iteration = 0 ; iteration < 8 ; iteration++) {
+            float next[N] = {};
+            for (int r = 0 ; r < N ; r++) {
+                for (int c = 0 ; c < N ; c++) {
+                    next[r] += covariance[r][c] * axis[c];
+                }
+            }
+
+            float length = 0;
+            for (int c = 0 ; c < N ; c++) {
+                length += next[c] * next[c];
+            }
+            length = std::sqrt(length);
+            if (length < 1e-6f) {
+                break;
+            }
+            for (int c = 0 ; c < N ; c++) {
+                axis[c] = next[c] / length;
+            }
+        }
+    }
+
+    // endpoints a, b on principal axis through extreme projections
+    template<int N>
+    static void fitEndpoints(const float (*points)[4], float* a, float* b) {
+        float mean[N];
+        float axis[N];
+        principalAxis<N>(points, BLOCK_PIXELS, mean, axis);
+
+        float minT = FLT_MAX;
+        float maxT = -FLT_MAX;
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            float t = 0;
+            for (int c = 0 ; c < N ; c++) {
+                t += (points[i][c] - mean[c]) * axis[c];
+            }
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        for (int c = 0 ; c < N ; c++) {
+            a[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+            b[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        }
+    }
+
+    // least squares endpoints for fixed interpolation factors t (0 = a, 1 = b), false if system is singular
+    template<int N>
+    static bool refitEndpoints(const float (*points)[4], const float* t, float* a, float* b) {
+        float aa = 0, ab = 0, bb = 0;
+        float ax[N] = {};
+        float bx[N] = {};
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            float wa = 1 - t[i];
+            float wb = t[i];
+            aa += wa * wa;
+            ab += wa * wb;
+            bb += wb * wb;
+            for (int c = 0 ; c < N ; c++) {
+                ax[c] += wa * points[i][c];
+                bx[c] += wb * points[i][c];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        float inverse = 1.0f / determinant;
+        for (int c = 0 ; c < N ; c++) {
+            a[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inverse, 0.0f, 255.0f);
+            b[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inverse, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    static void readPoints(const u8* rgba, float (*points)[4]) {
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            for (int c = 0 ; c < 4 ; c++) {
+                points[i][c] = rgba[i * 4 + c];
+            }
+        }
+    }
+
+    // BC1
+
+    static u16 packRGB565(const float* color) {
+        u16 r = (u16) std::clamp((int) std::lround(color[0] * 31.0f / 255.0f), 0, 31);
+        u16 g = (u16) std::clamp((int) std::lround(color[1] * 63.0f / 255.0f), 0, 63);
+        u16 b = (u16) std::clamp((int) std::lround(color[2] * 31.0f / 255.0f), 0, 31);
+        return (r << 11) | (g << 5) | b;
+    }
+
+    static void unpackRGB565(u16 color, int* rgb) {
+        int r = (color >> 11) & 31;
+        int g = (color >> 5) & 63;
+        int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    static void getPaletteBC1(u16 c0, u16 c1, int (*palette)[3]) {
+        unpackRGB565(c0, palette[0]);
+        unpackRGB565(c1, palette[1]);
+        for (int c = 0 ; c < 3 ; c++) {
+            if (c0 > c1) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            } else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+    }
+
+    // returns squared error of the block
+    static int selectIndicesBC1(const float (*points)[4], u16 c0, u16 c1, u32& indices) {
+        int palette[4][3];
+        getPaletteBC1(c0, c1, palette);
+
+        int total = 0;
+        indices = 0;
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            int bestIndex = 0;
+            int bestError = INT_MAX;
+            for (int p = 0 ; p < 4 ; p++) {
+                int error = 0;
+                for (int c = 0 ; c < 3 ; c++) {
+                    int d = (int) points[i][c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices |= (u32) bestIndex << (i * 2);
+            total += bestError;
+        }
+        return total;
+    }
+
+    static void writeBC1(u8* block, u16 c0, u16 c1, u32 indices) {
+        block[0] = c0 & 0xFF;
+        block[1] = c0 >> 8;
+        block[2] = c1 & 0xFF;
+        block[3] = c1 >> 8;
+        block[4] = indices & 0xFF;
+        block[5] = (indices >> 8) & 0xFF;
+        block[6] = (indices >> 16) & 0xFF;
+        block[7] = indices >> 24;
+    }
+
+    // always 4 color mode, so that BC3 color blocks decode the same way
+    static int encodeColorsBC1(const float (*points)[4], const float* a, const float* b, u16& c0, u16& c1, u32& indices) {
+        c0 = packRGB565(a);
+        c1 = packRGB565(b);
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        }
+        if (c0 == c1) {
+            // solid block, every index points to c0
+            indices = 0;
+            int palette[4][3];
+            getPaletteBC1(c0, c1, palette);
+            int total = 0;
+            for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+                for (int c = 0 ; c < 3 ; c++) {
+                    int d = (int) points[i][c] - palette[0][c];
+                    total += d * d;
+                }
+            }
+            return total;
+        }
+        return selectIndicesBC1(points, c0, c1, indices);
+    }
+
+    void BlockCompressor::encodeBlockBC1(const u8* rgba, u8* block) {
+        float points[BLOCK_PIXELS][4];
+        readPoints(rgba, points);
+
+        float a[3], b[3];
+        fitEndpoints<3>(points, a, b);
+
+        // inset endpoints by 1/16 of range, extremes are rarely worth a palette entry of their own
+        for (int c = 0 ; c < 3 ; c++) {
+            float inset = (a[c] - b[c]) / 16.0f;
+            a[c] -= inset;
+            b[c] += inset;
+        }
+
+        u16 c0, c1;
+        u32 indices;
+        int error = encodeColorsBC1(points, a, b, c0, c1, indices);
+
+        // one least squares pass over chosen indices
+        static constexpr float FACTORS[4] = { 0, 1, 1.0f / 3.0f, 2.0f / 3.0f };
+        float t[BLOCK_PIXELS];
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            t[i] = FACTORS[(indices >> (i * 2)) & 3];
+        }
+        if (c0 != c1 && refitEndpoints<3>(points, t, a, b)) {
+            u16 refitC0, refitC1;
+            u32 refitIndices;
+            int refitError = encodeColorsBC1(points, a, b, refitC0, refitC1, refitIndices);
+            if (refitError < error) {
+                c0 = refitC0;
+                c1 = refitC1;
+                indices = refitIndices;
+            }
+        }
+
+        writeBC1(block, c0, c1, indices);
+    }
+
+    void BlockCompressor::decodeBlockBC1(const u8* block, u8* rgba) {
+        u16 c0 = block[0] | (block[1] << 8);
+        u16 c1 = block[2] | (block[3] << 8);
+        u32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((u32) block[7] << 24);
+
+        int palette[4][3];
+        getPaletteBC1(c0, c1, palette);
+
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            u32 index = (indices >> (i * 2)) & 3;
+            rgba[i * 4] = palette[index][0];
+            rgba[i * 4 + 1] = palette[index][1];
+            rgba[i * 4 + 2] = palette[index][2];
+            rgba[i * 4 + 3] = c0 <= c1 && index == 3 ? 0 : 255;
+        }
+    }
+
+    // BC4
+
+    static void getPaletteBC4(int a0, int a1, int* palette) {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1) {
+            for (int i = 2 ; i < 8 ; i++) {
+                palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+            }
+        } else {
+            for (int i = 2 ; i < 6 ; i++) {
+                palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void BlockCompressor::encodeBlockBC4(const u8* rgba, int channel, u8* block) {
+        int a0 = 0;
+        int a1 = 255;
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            a0 = std::max(a0, (int) rgba[i * 4 + channel]);
+            a1 = std::min(a1, (int) rgba[i * 4 + channel]);
+        }
+
+        int palette[8];
+        getPaletteBC4(a0, a1, palette);
+
+        u64 indices = 0;
+        if (a0 != a1) {
+            for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+                int value = rgba[i * 4 + channel];
+                int bestIndex = 0;
+                int bestError = INT_MAX;
+                for (int p = 0 ; p < 8 ; p++) {
+                    int error = std::abs(value - palette[p]);
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                indices |= (u64) bestIndex << (i * 3);
+            }
+        }
+
+        block[0] = a0;
+        block[1] = a1;
+        for (int i = 0 ; i < 6 ; i++) {
+            block[2 + i] = (indices >> (i * 8)) & 0xFF;
+        }
+    }
+
+    void BlockCompressor::decodeBlockBC4(const u8* block, int channel, u8* rgba) {
+        int palette[8];
+        getPaletteBC4(block[0], block[1], palette);
+
+        u64 indices = 0;
+        for (int i = 0 ; i < 6 ; i++) {
+            indices |= (u64) block[2 + i] << (i * 8);
+        }
+
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            rgba[i * 4 + channel] = palette[(indices >> (i * 3)) & 7];
+        }
+    }
+
+    // BC3 and BC5
+
+    void BlockCompressor::encodeBlockBC3(const u8* rgba, u8* block) {
+        encodeBlockBC4(rgba, 3, block);
+        encodeBlockBC1(rgba, block + 8);
+    }
+
+    void BlockCompressor::decodeBlockBC3(const u8* block, u8* rgba) {
+        decodeBlockBC1(block + 8, rgba);
+        decodeBlockBC4(block, 3, rgba);
+    }
+
+    void BlockCompressor::encodeBlockBC5(const u8* rgba, u8* block) {
+        encodeBlockBC4(rgba, 0, block);
+        encodeBlockBC4(rgba, 1, block + 8);
+    }
+
+    void BlockCompressor::decodeBlockBC5(const u8* block, u8* rgba) {
+        decodeBlockBC4(block, 0, rgba);
+        decodeBlockBC4(block + 8, 1, rgba);
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+    }
+
+    // BC7 mode 6
+
+    struct BitWriter final {
+        u8* data;
+        int position = 0;
+
+        void write(u32 value, int count) {
+            for (int i = 0 ; i < count ; i++, position++) {
+                if ((value >> i) & 1) {
+                    data[position >> 3] |= 1 << (position & 7);
+                }
+            }
+        }
+    };
+
+    struct BitReader final {
+        const u8* data;
+        int position = 0;
+
+        u32 read(int count) {
+            u32 value = 0;
+            for (int i = 0 ; i < count ; i++, position++) {
+                value |= (u32) ((data[position >> 3] >> (position & 7)) & 1) << i;
+            }
+            return value;
+        }
+    };
+
+    // 7-bit endpoint with shared p-bit, picks p-bit that restores endpoint closer
+    static void quantizeEndpointBC7(const float* endpoint, int* quantized, int& pBit) {
+        float bestError = FLT_MAX;
+        for (int p = 0 ; p < 2 ; p++) {
+            int q[4];
+            float error = 0;
+            for (int c = 0 ; c < 4 ; c++) {
+                q[c] = std::clamp((int) std::lround((endpoint[c] - p) / 2.0f), 0, 127);
+                float d = (float) ((q[c] << 1) | p) - endpoint[c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                pBit = p;
+                for (int c = 0 ; c < 4 ; c++) {
+                    quantized[c] = q[c];
+                }
+            }
+        }
+    }
+
+    struct BlockBC7 final {
+        int e0[4];
+        int e1[4];
+        int p0 = 0;
+        int p1 = 0;
+        int indices[BLOCK_PIXELS];
+    };
+
+    // returns squared error of the block
+    static int selectIndicesBC7(const float (*points)[4], BlockBC7& block) {
+        int palette[16][4];
+        for (int c = 0 ; c < 4 ; c++) {
+            int a = (block.e0[c] << 1) | block.p0;
+            int b = (block.e1[c] << 1) | block.p1;
+            for (int i = 0 ; i < 16 ; i++) {
+                palette[i][c] = ((64 - BC7_WEIGHTS[i]) * a + BC7_WEIGHTS[i] * b + 32) >> 6;
+            }
+        }
+
+        int total = 0;
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            int bestIndex = 0;
+            int bestError = INT_MAX;
+            for (int p = 0 ; p < 16 ; p++) {
+                int error = 0;
+                for (int c = 0 ; c < 4 ; c++) {
+                    int d = (int) points[i][c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            block.indices[i] = bestIndex;
+            total += bestError;
+        }
+        return total;
+    }
+
+    static int encodeEndpointsBC7(const float (*points)[4], const float* a, const float* b, BlockBC7& block) {
+        quantizeEndpointBC7(a, block.e0, block.p0);
+        quantizeEndpointBC7(b, block.e1, block.p1);
+        return selectIndicesBC7(points, block);
+    }
+
+    void BlockCompressor::encodeBlockBC7(const u8* rgba, u8* block) {
+        float points[BLOCK_PIXELS][4];
+        readPoints(rgba, points);
+
+        float a[4], b[4];
+        fitEndpoints<4>(points, a, b);
+
+        BlockBC7 result;
+        int error = encodeEndpointsBC7(points, a, b, result);
+
+        // two least squares passes over chosen indices
+        for (int iteration = 0 ; iteration < 2 && error > 0 ; iteration++) {
+            float t[BLOCK_PIXELS];
+            for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+                t[i] = BC7_WEIGHTS[result.indices[i]] / 64.0f;
+            }
+            if (!refitEndpoints<4>(points, t, a, b)) {
+                break;
+            }
+
+            BlockBC7 refit;
+            int refitError = encodeEndpointsBC7(points, a, b, refit);
+            if (refitError >= error) {
+                break;
+            }
+            result = refit;
+            error = refitError;
+        }
+
+        // MSB of the first index is implicit zero, so endpoints are swapped when it's set
+        if (result.indices[0] & 8) {
+            std::swap(result.e0, result.e1);
+            std::swap(result.p0, result.p1);
+            for (int& index : result.indices) {
+                index = 15 - index;
+            }
+        }
+
+        std::memset(block, 0, 16);
+        BitWriter writer = { block };
+        writer.write(1 << 6, 7);
+        for (int c = 0 ; c < 4 ; c++) {
+            writer.write(result.e0[c], 7);
+            writer.write(result.e1[c], 7);
+        }
+        writer.write(result.p0, 1);
+        writer.write(result.p1, 1);
+        writer.write(result.indices[0], 3);
+        for (int i = 1 ; i < BLOCK_PIXELS ; i++) {
+            writer.write(result.indices[i], 4);
+        }
+    }
+
+    void BlockCompressor::decodeBlockBC7(const u8* block, u8* rgba) {
+        BitReader reader = { block };
+
+        if (reader.read(7) != (1 << 6)) {
+            for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+                rgba[i * 4] = 255;
+                rgba[i * 4 + 1] = 0;
+                rgba[i * 4 + 2] = 255;
+                rgba[i * 4 + 3] = 255;
+            }
+            return;
+        }
+
+        int e0[4], e1[4];
+        for (int c = 0 ; c < 4 ; c++) {
+            e0[c] = reader.read(7);
+            e1[c] = reader.read(7);
+        }
+        int p0 = reader.read(1);
+        int p1 = reader.read(1);
+
+        for (int i = 0 ; i < BLOCK_PIXELS ; i++) {
+            int index = reader.read(i == 0 ? 3 : 4);
+            for (int c = 0 ; c < 4 ; c++) {
+                int a = (e0[c] << 1) | p0;
+                int b = (e1[c] << 1) | p1;
+                rgba[i * 4 + c] = ((64 - BC7_WEIGHTS[index]) * a + BC7_WEIGHTS[index] * b + 32) >> 6;
+            }
+        }
+    }
+
+    // images
+
+    size_t BlockCompressor::getBlockBytes(BlockFormat format) {
+        return format == BC1 ? 8 : 16;
+    }
+
+    size_t BlockCompressor::getSize(int width, int height, BlockFormat format) {
+        size_t blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        return blocksX * blocksY * getBlockBytes(format);
+    }
+
+    void BlockCompressor::compress(const u8* rgba, int width, int height, BlockFormat format, std::vector<u8>& result) {
+        int blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        int blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t blockBytes = getBlockBytes(format);
+        result.resize(getSize(width, height, format));
+
+        ThreadPool::parallelFor(blocksY, [&](u32 by) {
+            u8 pixels[BLOCK_PIXELS * 4];
+            for (int bx = 0 ; bx < blocksX ; bx++) {
+                for (int y = 0 ; y < BLOCK_SIZE ; y++) {
+                    int py = std::min((int) by * BLOCK_SIZE + y, height - 1);
+                    for (int x = 0 ; x < BLOCK_SIZE ; x++) {
+                        int px = std::min(bx * BLOCK_SIZE + x, width - 1);
+                        std::memcpy(&pixels[(y * BLOCK_SIZE + x) * 4], &rgba[((size_t) py * width + px) * 4], 4);
+                    }
+                }
+
+                u8* block = &result[((size_t) by * blocksX + bx) * blockBytes];
+                switch (format) {
+                    case BC3:
+                        encodeBlockBC3(pixels, block);
+                        break;
+                    case BC5:
+                        encodeBlockBC5(pixels, block);
+                        break;
+                    case BC7:
+                        encodeBlockBC7(pixels, block);
+                        break;
+                    default:
+                        encodeBlockBC1(pixels, block);
+                        break;
+                }
+            }
+        });
+    }
+
+    void BlockCompressor::decompress(const u8* blocks, int width, int height, BlockFormat format, std::vector<u8>& rgba) {
+        int blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        int blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t blockBytes = getBlockBytes(format);
+        rgba.resize((size_t) width * height * 4);
+
+        ThreadPool::parallelFor(blocksY, [&](u32 by) {
+            u8 pixels[BLOCK_PIXELS * 4];
+            for (int bx = 0 ; bx < blocksX ; bx++) {
+                const u8* block = &blocks[((size_t) by * blocksX + bx) * blockBytes];
+                switch (format) {
+                    case BC3:
+                        decodeBlockBC3(block, pixels);
+                        break;
+                    case BC5:
+                        decodeBlockBC5(block, pixels);
+                        break;
+                    case BC7:
+                        decodeBlockBC7(block, pixels);
+                        break;
+                    default:
+                        decodeBlockBC1(block, pixels);
+                        break;
+                }
+
+                for (int y = 0 ; y < BLOCK_SIZE ; y++) {
+                    int py = by * BLOCK_SIZE + y;
+                    for (int x = 0 ; x < BLOCK_SIZE ; x++) {
+                        int px = bx * BLOCK_SIZE + x;
+                        if (px < width && py < height) {
+                            std::memcpy(&rgba[((size_t) py * width + px) * 4], &pixels[(y * BLOCK_SIZE + x) * 4], 4);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    CompressionStats BlockCompressor::measure(const u8* rgba, int width, int height, BlockFormat format) {
+        CompressionStats stats;
+
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<u8> blocks;
+        compress(rgba, width, height, format, blocks);
+        auto end = std::chrono::steady_clock::now();
+        stats.milliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        std::vector<u8> decoded;
+        decompress(blocks.data(), width, height, format, decoded);
+
+        int channels = format == BC1 ? 3 : format == BC5 ? 2 : 4;
+        double squaredError = 0;
+        size_t pixelCount = (size_t) width * height;
+        for (size_t i = 0 ; i < pixelCount ; i++) {
+            for (int c = 0 ; c < channels ; c++) {
+                double d = (double) rgba[i * 4 + c] - decoded[i * 4 + c];
+                squaredError += d * d;
+            }
+        }
+
+        double mse = pixelCount > 0 ? squaredError / (pixelCount * channels) : 0;
+        stats.rmse = std::sqrt(mse);
+        stats.psnr = mse > 0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+        return stats;
+    }
+
+}
@@ -0,0 +1,377 @@
+#include <io/derived_data_cache.h>
+#include <io/readers.h>
+#include <io/file_system.h>
+#include <io/io_service.h>
+
+namespace gl {
+
+    std::string DerivedDataCache::s_directory = "DerivedDataCache";
+    std::unordered_map<std::string, DerivedDataCache::FileHash> DerivedDataCache::s_files;
+    std::mutex DerivedDataCache::s_mutex;
+    bool DerivedDataCache::s_indexLoaded = false;
+    bool DerivedDataCache::s_indexDirty = false;
+    u64 DerivedDataCache::s_budget = 4ull << 30;
+
+    static constexpr u32 INDEX_MAGIC = 0x58444447; // GDDX
+    static constexpr u32 INDEX_VERSION = 1;
+
+    static constexpr u64 PRIME_1 = 0x9E3779B185EBCA87ull;
+    static constexpr u64 PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr u64 PRIME_3 = 0x165667B19E3779F9ull;
+    static constexpr u64 PRIME_4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr u64 PRIME_5 = 0x27D4EB2F165667C5ull;
+
+    static inline u64 rotateLeft(u64 x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static inline u64 read64(const u8* p) {
+        u64 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline u32 read32(const u8* p) {
+        u32 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline u64 hashRound(u64 acc, u64 input) {
+        acc += input * PRIME_2;
+        acc = rotateLeft(acc, 31);
+        return acc * PRIME_1;
+    }
+
+    static inline u64 mergeRound(u64 acc, u64 value) {
+        acc ^= hashRound(0, value);
+        return acc * PRIME_1 + PRIME_4;
+    }
+
+    u64 DerivedDataCache::hash(const void* data, size_t size, u64 seed) {
+        const u8* p = (const u8*) data;
+        const u8* end = p + size;
+        u64 h;
+
+        if (size >= 32) {
+            // 4 independent lanes over 32 byte stripes
+            u64 v1 = seed + PRIME_1 + PRIME_2;
+            u64 v2 = seed + PRIME_2;
+            u64 v3 = seed;
+            u64 v4 = seed - PRIME_1;
+            const u8* limit = end - 32;
+            do {
+                v1 = hashRound(v1, read64(p));
+                v2 = hashRound(v2, read64(p + 8));
+                v3 = hashRound(v3, read64(p + 16));
+                v4 = hashRound(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+
+            h = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+            h = mergeRound(h, v1);
+            h = mergeRound(h, v2);
+            h = mergeRound(h, v3);
+            h = mergeRound(h, v4);
+        } else {
+            h = seed + PRIME_5;
+        }
+
+        h += (u64) size;
+
+        for ( ; p + 8 <= end ; p += 8) {
+            h ^= hashRound(0, read64(p));
+            h = rotateLeft(h, 27) * PRIME_1 + PRIME_4;
+        }
+
+        if (p + 4 <= end) {
+            h ^= (u64) read32(p) * PRIME_1;
+            h = rotateLeft(h, 23) * PRIME_2 + PRIME_3;
+            p += 4;
+        }
+
+        for ( ; p < end ; p++) {
+            h ^= (u64) (*p) * PRIME_5;
+            h = rotateLeft(h, 11) * PRIME_1;
+        }
+
+        h ^= h >> 33;
+        h *= PRIME_2;
+        h ^= h >> 29;
+        h *= PRIME_3;
+        h ^= h >> 32;
+
+        return h;
+    }
+
+    u64 DerivedDataCache::hash(const std::string& string, u64 seed) {
+        return hash(string.data(), string.size(), seed);
+    }
+
+    void DerivedDataCache::setDirectory(const std::string& directory) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_indexDirty) {
+            saveIndex();
+        }
+        s_directory = directory;
+        s_files.clear();
+        s_indexLoaded = false;
+    }
+
+    const std::string& DerivedDataCache::getDirectory() {
+        return s_directory;
+    }
+
+    void DerivedDataCache::setBudget(u64 bytes) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_budget = bytes;
+    }
+
+    u64 DerivedDataCache::getBudget() {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_budget;
+    }
+
+    void DerivedDataCache::free() {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_indexDirty) {
+            saveIndex();
+        }
+        trim();
+    }
+
+    void DerivedDataCache::trim() {
+        struct Entry final {
+            std::filesystem::path path;
+            std::filesystem::file_time_type time;
+            u64 size;
+        };
+
+        std::vector<Entry> entries;
+        u64 totalSize = 0;
+        std::error_code errorCode;
+        for (auto it = std::filesystem::recursive_directory_iterator(s_directory, errorCode) ;
+             !errorCode && it != std::filesystem::recursive_directory_iterator() ;
+             it.increment(errorCode)) {
+            // index is small and needed by every entry
+            if (!it->is_regular_file(errorCode) || it->path().filename() == "files.index") {
+                continue;
+            }
+            Entry entry;
+            entry.path = it->path();
+            entry.time = it->last_write_time(errorCode);
+            entry.size = it->file_size(errorCode);
+            if (!errorCode) {
+                totalSize += entry.size;
+                entries.emplace_back(std::move(entry));
+            }
+            errorCode.clear();
+        }
+
+        if (totalSize <= s_budget) {
+            return;
+        }
+
+        // lookups touch entries, so the oldest write time is the least recently used one
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+        u64 evictedSize = 0;
+        u32 evictedCount = 0;
+        for (auto& entry : entries) {
+            if (totalSize - evictedSize <= s_budget) {
+                break;
+            }
+            if (std::filesystem::remove(entry.path, errorCode)) {
+                evictedSize += entry.size;
+                evictedCount++;
+            }
+        }
+        info("Derived data cache evicted {0} entries of {1} bytes", evictedCount, evictedSize);
+    }
+
+    void DerivedDataCache::loadIndex() {
+        s_indexLoaded = true;
+
+        BinaryStream stream;
+        if (!load(s_directory + "/files.index", stream) || stream.size() < sizeof(u32) * 3) {
+            return;
+        }
+
+        u32 magic = 0;
+        u32 version = 0;
+        u32 count = 0;
+        stream.get(magic);
+        stream.get(version);
+        stream.get(count);
+        // every entry has at least string length and file hash, so corrupted count can't exceed what's left
+        size_t minEntrySize = sizeof(size_t) + sizeof(FileHash);
+        if (magic != INDEX_MAGIC || version != INDEX_VERSION || count > stream.remaining() / minEntrySize) {
+            error("Derived data index {0}/files.index is invalid, file hashes are rebuilt", s_directory);
+            return;
+        }
+
+        for (u32 i = 0 ; i < count ; i++) {
+            std::string filepath;
+            FileHash fileHash;
+            stream.getString(filepath);
+            stream.get(fileHash);
+            if (stream.isFailed()) {
+                error("Derived data index {0}/files.index is truncated, file hashes are rebuilt", s_directory);
+                s_files.clear();
+                return;
+            }
+            s_files[filepath] = fileHash;
+        }
+    }
+
+    void DerivedDataCache::saveIndex() {
+        BinaryStream stream;
+        u32 magic = INDEX_MAGIC;
+        u32 version = INDEX_VERSION;
+        u32 count = s_files.size();
+        stream.add(magic);
+        stream.add(version);
+        stream.add(count);
+        for (auto& file : s_files) {
+            std::string filepath = file.first;
+            stream.addString(filepath);
+            stream.add(file.second);
+        }
+
+        std::error_code errorCode;
+        std::filesystem::create_directories(s_directory, errorCode);
+        if (store(s_directory + "/files.index", stream)) {
+            s_indexDirty = false;
+        }
+    }
+
+    u64 DerivedDataCache::hashFile(const std::string& filepath) {
+        // archived files carry their hash in TOC
+        u64 archivedHash = 0;
+        if (FileSystem::getHash(filepath, archivedHash)) {
+            return archivedHash;
+        }
+
+        FileHash fileHash;
+        if (!FileReader::readStamp(filepath, fileHash.size, fileHash.time)) {
+            return 0;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (!s_indexLoaded) {
+                loadIndex();
+            }
+            auto it = s_files.find(filepath);
+            if (it != s_files.end() && it->second.size == fileHash.size && it->second.time == fileHash.time) {
+                return it->second.hash;
+            }
+        }
+
+        BinaryStream stream;
+        if (!load(filepath, stream)) {
+            return 0;
+        }
+        fileHash.hash = hash(stream.data(), stream.size());
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_files[filepath] = fileHash;
+        s_indexDirty = true;
+        return fileHash.hash;
+    }
+
+    std::string DerivedDataCache::getPath(const std::string& type, u64 key, const std::string& extension) {
+        std::string directory = s_directory + "/" + type;
+        std::error_code errorCode;
+        std::filesystem::create_directories(directory, errorCode);
+        if (errorCode) {
+            error("Failed to create derived data directory {0}", directory);
+        }
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) key);
+        std::string path = directory + "/" + hex + extension;
+
+        // marks entry as recently used for trim, missing entry is just not touched
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), errorCode);
+
+        return path;
+    }
+
+    std::string DerivedDataCache::getPath(const std::string& type, const std::string& sourceFilepath, const std::string& settings, const std::string& extension) {
+        u64 sourceHash = hashFile(sourceFilepath);
+        if (sourceHash == 0) {
+            // source is gone, but its entries are still addressed by the last known hash
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (!s_indexLoaded) {
+                loadIndex();
+            }
+            auto it = s_files.find(sourceFilepath);
+            if (it == s_files.end()) {
+                return "";
+            }
+            sourceHash = it->second.hash;
+        }
+        return getPath(type, hash(settings, sourceHash), extension);
+    }
+
+    bool DerivedDataCache::store(const std::string& path, const void* data, size_t size) {
+        // unique per thread, so that two threads cooking the same entry don't write into one file
+        std::stringstream ss;
+        ss << path << "." << std::this_thread::get_id() << ".tmp";
+        std::string tmpPath = ss.str();
+
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                error("Failed to open derived data {0}", tmpPath);
+                return false;
+            }
+            file.write((const char*) data, size);
+            if (!file) {
+                error("Failed to write derived data {0}", tmpPath);
+                file.close();
+                std::filesystem::remove(tmpPath);
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpPath, path, errorCode);
+        if (errorCode) {
+            error("Failed to store derived data {0}", path);
+            std::filesystem::remove(tmpPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool DerivedDataCache::store(const std::string& path, BinaryStream& stream) {
+        return store(path, stream.data(), stream.size());
+    }
+
+    bool DerivedDataCache::load(const std::string& path, BinaryStream& stream) {
+        std::error_code errorCode;
+        size_t size = std::filesystem::file_size(path, errorCode);
+        if (errorCode) {
+            return false;
+        }
+
+        stream.clear();
+        stream.resize(size);
+
+        IORequest request;
+        request.filepath = path;
+        request.size = size;
+        request.buffer = stream.data();
+        IOResult result = IOService::readSync(request);
+        if (!result.success || result.bytes != size) {
+            error("Failed to read derived data {0}", path);
+            stream.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,631 @@
+#include <io/file_system.h>
+#include <io/derived_data_cache.h>
+#include <io/io_service.h>
+
+#ifdef WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#ifdef LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gl {
+
+    const char* PackedArchive::EXTENSION = ".gpak";
+
+    std::vector<PackedArchive*> FileSystem::s_archives;
+    bool FileSystem::s_looseFiles = true;
+
+    // LZ4 block format: token | literal length | literals | u16 offset | match length
+    static constexpr u32 LZ_HASH_BITS = 16;
+    static constexpr size_t LZ_MIN_MATCH = 4;
+    static constexpr size_t LZ_MAX_OFFSET = 65535;
+    // last match must start 12 bytes and end 5 bytes before end of input
+    static constexpr size_t LZ_MATCH_START_LIMIT = 12;
+    static constexpr size_t LZ_LAST_LITERALS = 5;
+
+    static inline u32 lzRead32(const u8* p) {
+        u32 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static void lzAddLength(std::vector<u8>& dst, size_t length) {
+        while (length >= 255) {
+            dst.push_back(255);
+            length -= 255;
+        }
+        dst.push_back((u8) length);
+    }
+
+    static void lzAddSequence(std::vector<u8>& dst, const u8* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        size_t tokenIndex = dst.size();
+        dst.push_back(0);
+
+        u8 token = (u8) (std::min<size_t>(literalLength, 15) << 4);
+        if (literalLength >= 15) {
+            lzAddLength(dst, literalLength - 15);
+        }
+        dst.insert(dst.end(), literals, literals + literalLength);
+
+        // last sequence has literals only
+        if (matchLength != 0) {
+            dst.push_back((u8) (offset & 0xFF));
+            dst.push_back((u8) (offset >> 8));
+            size_t length = matchLength - LZ_MIN_MATCH;
+            token |= (u8) std::min<size_t>(length, 15);
+            if (length >= 15) {
+                lzAddLength(dst, length - 15);
+            }
+        }
+
+        dst[tokenIndex] = token;
+    }
+
+    // greedy matching against the last position of every 4 byte sequence
+    static void lzCompress(const u8* src, size_t size, std::vector<u8>& dst) {
+        dst.clear();
+        dst.reserve(size / 2);
+
+        // position + 1 of every hash, 0 if there is none yet
+        std::vector<size_t> table(1 << LZ_HASH_BITS, 0);
+        size_t anchor = 0;
+        size_t i = 0;
+        size_t matchStartLimit = size > LZ_MATCH_START_LIMIT ? size - LZ_MATCH_START_LIMIT : 0;
+        size_t matchEndLimit = size > LZ_LAST_LITERALS ? size - LZ_LAST_LITERALS : 0;
+
+        while (i < matchStartLimit) {
+            u32 sequence = lzRead32(src + i);
+            u32 hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+            size_t slot = table[hash];
+            table[hash] = i + 1;
+
+            size_t candidate = slot - 1;
+            if (slot == 0 || i - candidate > LZ_MAX_OFFSET || lzRead32(src + candidate) != sequence) {
+                i++;
+                continue;
+            }
+
+            size_t length = LZ_MIN_MATCH;
+            while (i + length < matchEndLimit && src[candidate + length] == src[i + length]) {
+                length++;
+            }
+
+            lzAddSequence(dst, src + anchor, i - anchor, i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+
+        lzAddSequence(dst, src + anchor, size - anchor, 0, 0);
+    }
+
+    static bool lzReadLength(const u8* src, size_t srcSize, size_t& ip, size_t& length) {
+        u8 b;
+        do {
+            if (ip >= srcSize) {
+                return false;
+            }
+            b = src[ip++];
+            length += b;
+        } while (b == 255);
+        return true;
+    }
+
+    // validates every length and offset, so that corrupted archive can't write out of dst
+    static bool lzDecompress(const u8* src, size_t srcSize, u8* dst, size_t dstSize) {
+        size_t ip = 0;
+        size_t op = 0;
+
+        while (ip < srcSize) {
+            u8 token = src[ip++];
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !lzReadLength(src, srcSize, ip, literalLength)) {
+                return false;
+            }
+            if (ip + literalLength > srcSize || op + literalLength > dstSize) {
+                return false;
+            }
+            std::memcpy(dst + op, src + ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            if (ip == srcSize) {
+                break;
+            }
+
+            if (ip + 2 > srcSize) {
+                return false;
+            }
+            size_t offset = src[ip] | (src[ip + 1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > op) {
+                return false;
+            }
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !lzReadLength(src, srcSize, ip, matchLength)) {
+                return false;
+            }
+            matchLength += LZ_MIN_MATCH;
+            if (op + matchLength > dstSize) {
+                return false;
+            }
+
+            const u8* match = dst + op - offset;
+            if (offset >= matchLength) {
+                std::memcpy(dst + op, match, matchLength);
+            } else {
+                // overlapping match repeats last offset bytes
+                for (size_t i = 0 ; i < matchLength ; i++) {
+                    dst[op + i] = match[i];
+                }
+            }
+            op += matchLength;
+        }
+
+        return op == dstSize;
+    }
+
+    PackedArchive::~PackedArchive() {
+        close();
+    }
+
+    bool PackedArchive::open(const std::string& filepath) {
+        close();
+        mFilepath = filepath;
+
+#ifdef WINDOWS
+
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, null);
+        if (file == INVALID_HANDLE_VALUE) {
+            error("Failed to open archive {0}", filepath);
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        mSize = (size_t) fileSize.QuadPart;
+        // mapping keeps file open by itself
+        mMapping = CreateFileMappingA(file, null, PAGE_READONLY, 0, 0, null);
+        CloseHandle(file);
+        if (!mMapping) {
+            error("Failed to map archive {0}", filepath);
+            return false;
+        }
+
+        mData = (const u8*) MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+
+#elif defined(LINUX)
+
+        int file = ::open(filepath.c_str(), O_RDONLY);
+        if (file < 0) {
+            error("Failed to open archive {0}", filepath);
+            return false;
+        }
+
+        struct stat fileStat;
+        fstat(file, &fileStat);
+        mSize = (size_t) fileStat.st_size;
+        void* data = mmap(null, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+        // mapping keeps file open by itself
+        ::close(file);
+        mData = data == MAP_FAILED ? null : (const u8*) data;
+
+#endif
+
+        if (!mData) {
+            error("Failed to map archive {0}", filepath);
+            close();
+            return false;
+        }
+
+        mHeader = (const PackedArchiveHeader*) mData;
+        if (mSize < sizeof(PackedArchiveHeader)
+            || mHeader->magic != PackedArchiveHeader::MAGIC
+            || mHeader->version != PackedArchiveHeader::VERSION
+        ) {
+            error("Archive {0} has unknown format", filepath);
+            close();
+            return false;
+        }
+
+        const auto& header = *mHeader;
+        bool bucketsArePow2 = header.bucketCount != 0 && (header.bucketCount & (header.bucketCount - 1)) == 0;
+        if (!bucketsArePow2
+            || header.entriesOffset + (u64) header.entryCount * sizeof(PackedArchiveEntry) > mSize
+            || header.bucketsOffset + (u64) header.bucketCount * sizeof(u32) > mSize
+            || header.pathsOffset + header.pathsSize > mSize
+        ) {
+            error("Archive {0} is truncated", filepath);
+            close();
+            return false;
+        }
+
+        mEntries = (const PackedArchiveEntry*) (mData + header.entriesOffset);
+        mBuckets = (const u32*) (mData + header.bucketsOffset);
+        mPaths = (const char*) (mData + header.pathsOffset);
+
+        for (u32 i = 0 ; i < header.entryCount ; i++) {
+            auto& entry = mEntries[i];
+            if (entry.offset > mSize || entry.packedSize > mSize - entry.offset || (u64) entry.pathOffset + entry.pathLength > header.pathsSize) {
+                error("Archive {0} is truncated", filepath);
+                close();
+                return false;
+            }
+            // uncompressed entries are read in place, so that their size must be what is stored
+            if (!(entry.flags & PACKED_ENTRY_COMPRESSED) && entry.size != entry.packedSize) {
+                error("Archive {0} has corrupted entry {1}", filepath, std::string(mPaths + entry.pathOffset, entry.pathLength));
+                close();
+                return false;
+            }
+        }
+
+#ifdef LINUX
+        // TOC is touched by every lookup
+        madvise((void*) mData, mSize, MADV_RANDOM);
+#endif
+
+        info("Mounted archive {0}: {1} files, {2} bytes", filepath, header.entryCount, mSize);
+
+        return true;
+    }
+
+    void PackedArchive::close() {
+#ifdef WINDOWS
+        if (mData) {
+            UnmapViewOfFile(mData);
+        }
+        if (mMapping) {
+            CloseHandle((HANDLE) mMapping);
+        }
+#elif defined(LINUX)
+        if (mData) {
+            munmap((void*) mData, mSize);
+        }
+#endif
+        mData = null;
+        mSize = 0;
+        mMapping = null;
+        mHeader = null;
+        mEntries = null;
+        mBuckets = null;
+        mPaths = null;
+    }
+
+    const PackedArchiveEntry* PackedArchive::find(const std::string& filepath) const {
+        if (!mHeader) {
+            return null;
+        }
+
+        u64 hash = DerivedDataCache::hash(filepath);
+        u32 mask = mHeader->bucketCount - 1;
+        u32 bucket = (u32) hash & mask;
+        for (u32 probe = 0 ; probe < mHeader->bucketCount ; probe++) {
+            u32 slot = mBuckets[bucket];
+            if (slot == 0 || slot > mHeader->entryCount) {
+                return null;
+            }
+
+            const auto& entry = mEntries[slot - 1];
+            if (entry.pathHash == hash
+                && entry.pathLength == filepath.size()
+                && std::memcmp(mPaths + entry.pathOffset, filepath.data(), filepath.size()) == 0
+            ) {
+                return &entry;
+            }
+
+            bucket = (bucket + 1) & mask;
+        }
+
+        return null;
+    }
+
+    bool PackedArchive::read(const PackedArchiveEntry& entry, FileBlob& blob) const {
+        const u8* packed = mData + entry.offset;
+
+        if (!(entry.flags & PACKED_ENTRY_COMPRESSED)) {
+            blob.mBuffer.clear();
+            blob.data = packed;
+            blob.size = entry.size;
+            return true;
+        }
+
+        blob.mBuffer.resize(entry.size);
+        if (!lzDecompress(packed, entry.packedSize, blob.mBuffer.data(), entry.size)) {
+            error("Archive {0} has corrupted entry {1}", mFilepath, std::string(mPaths + entry.pathOffset, entry.pathLength));
+            blob.mBuffer.clear();
+            blob.data = null;
+            blob.size = 0;
+            return false;
+        }
+
+        blob.data = blob.mBuffer.data();
+        blob.size = entry.size;
+        return true;
+    }
+
+    static void writePadding(std::ofstream& file, u64& offset, u64 alignment) {
+        static const char zeros[PackedArchive::ALIGNMENT] = {};
+        u64 padding = (alignment - offset % alignment) % alignment;
+        file.write(zeros, padding);
+        offset += padding;
+    }
+
+    bool PackedArchive::pack(const std::string& filepath, const std::vector<std::string>& directories, bool compress) {
+        std::vector<std::string> paths;
+        for (auto& directory : directories) {
+            std::error_code errorCode;
+            for (auto& file : std::filesystem::recursive_directory_iterator(directory, errorCode)) {
+                if (file.is_regular_file()) {
+                    paths.emplace_back(FileSystem::normalize(file.path().generic_string()));
+                }
+            }
+            if (errorCode) {
+                error("Failed to pack directory {0}", directory);
+                return false;
+            }
+        }
+        // stable archive for the same files
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+        std::string tmpFilepath = filepath + ".tmp";
+        std::ofstream file(tmpFilepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error("Failed to open archive {0}", tmpFilepath);
+            return false;
+        }
+
+        PackedArchiveHeader header;
+        file.write((const char*) &header, sizeof(header));
+        u64 offset = sizeof(header);
+
+        std::vector<PackedArchiveEntry> entries;
+        std::string pathStrings;
+        std::vector<u8> packed;
+        u64 totalSize = 0;
+        u64 totalPackedSize = 0;
+
+        for (auto& path : paths) {
+            FileBlob blob;
+            if (!FileSystem::readLoose(path, blob)) {
+                error("Failed to pack file {0}", path);
+                return false;
+            }
+
+            PackedArchiveEntry entry;
+            entry.pathHash = DerivedDataCache::hash(path);
+            entry.contentHash = DerivedDataCache::hash(blob.data, blob.size);
+            entry.size = blob.size;
+            entry.packedSize = blob.size;
+            entry.pathOffset = pathStrings.size();
+            entry.pathLength = path.size();
+            pathStrings += path;
+
+            const u8* data = blob.data;
+            if (compress && blob.size > 0) {
+                lzCompress(blob.data, blob.size, packed);
+                // already compressed formats like PNG and JPG are kept as is
+                if (packed.size() < blob.size - blob.size / 8) {
+                    entry.flags |= PACKED_ENTRY_COMPRESSED;
+                    entry.packedSize = packed.size();
+                    data = packed.data();
+                }
+            }
+
+            writePadding(file, offset, ALIGNMENT);
+            entry.offset = offset;
+            file.write((const char*) data, entry.packedSize);
+            offset += entry.packedSize;
+            totalSize += entry.size;
+            totalPackedSize += entry.packedSize;
+
+            entries.emplace_back(entry);
+        }
+
+        header.entryCount = entries.size();
+        header.bucketCount = 16;
+        while (header.bucketCount < header.entryCount * 2) {
+            header.bucketCount *= 2;
+        }
+
+        std::vector<u32> buckets(header.bucketCount, 0);
+        u32 mask = header.bucketCount - 1;
+        for (u32 i = 0 ; i < entries.size() ; i++) {
+            u32 bucket = (u32) entries[i].pathHash & mask;
+            while (buckets[bucket] != 0) {
+                bucket = (bucket + 1) & mask;
+            }
+            buckets[bucket] = i + 1;
+        }
+
+        writePadding(file, offset, alignof(PackedArchiveEntry));
+        header.entriesOffset = offset;
+        file.write((const char*) entries.data(), entries.size() * sizeof(PackedArchiveEntry));
+        offset += entries.size() * sizeof(PackedArchiveEntry);
+
+        header.bucketsOffset = offset;
+        file.write((const char*) buckets.data(), buckets.size() * sizeof(u32));
+        offset += buckets.size() * sizeof(u32);
+
+        header.pathsOffset = offset;
+        header.pathsSize = pathStrings.size();
+        file.write(pathStrings.data(), pathStrings.size());
+
+        file.seekp(0);
+        file.write((const char*) &header, sizeof(header));
+        file.close();
+        if (!file) {
+            error("Failed to write archive {0}", tmpFilepath);
+            return false;
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFilepath, filepath, errorCode);
+        if (errorCode) {
+            error("Failed to write archive {0}", filepath);
+            return false;
+        }
+
+        info("Packed archive {0}: {1} files, {2} bytes packed into {3} bytes", filepath, entries.size(), totalSize, totalPackedSize);
+
+        return true;
+    }
+
+    bool FileSystem::mount(const std::string& archiveFilepath) {
+        auto* archive = new PackedArchive();
+        if (!archive->open(archiveFilepath)) {
+            delete archive;
+            return false;
+        }
+        s_archives.emplace_back(archive);
+        return true;
+    }
+
+    void FileSystem::free() {
+        for (auto* archive : s_archives) {
+            delete archive;
+        }
+        s_archives.clear();
+    }
+
+    void FileSystem::setLooseFiles(bool enabled) {
+        s_looseFiles = enabled;
+    }
+
+    std::string FileSystem::normalize(const std::string& filepath) {
+        std::string path = filepath;
+        std::replace(path.begin(), path.end(), '\\', '/');
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    const PackedArchiveEntry* FileSystem::find(const std::string& filepath, const PackedArchive** archive) {
+        if (s_archives.empty()) {
+            return null;
+        }
+
+        std::string path = normalize(filepath);
+        for (auto it = s_archives.rbegin() ; it != s_archives.rend() ; it++) {
+            const auto* entry = (*it)->find(path);
+            if (entry) {
+                *archive = *it;
+                return entry;
+            }
+        }
+
+        return null;
+    }
+
+    bool FileSystem::exists(const std::string& filepath) {
+        const PackedArchive* archive = null;
+        if (find(filepath, &archive)) {
+            return true;
+        }
+        return s_looseFiles && std::filesystem::is_regular_file(filepath);
+    }
+
+    bool FileSystem::readLoose(const std::string& filepath, FileBlob& blob) {
+        std::error_code errorCode;
+        size_t size = std::filesystem::file_size(filepath, errorCode);
+        if (errorCode) {
+            return false;
+        }
+
+        blob.mBuffer.resize(size);
+
+        IORequest request;
+        request.filepath = filepath;
+        request.size = size;
+        request.buffer = blob.mBuffer.data();
+        IOResult result = IOService::readSync(request);
+        if (!result.success) {
+            blob.mBuffer.clear();
+            return false;
+        }
+
+        blob.mBuffer.resize(result.bytes);
+        blob.data = blob.mBuffer.data();
+        blob.size = result.bytes;
+        return true;
+    }
+
+    bool FileSystem::read(const std::string& filepath, FileBlob& blob) {
+        const PackedArchive* archive = null;
+        const auto* entry = find(filepath, &archive);
+        if (entry) {
+            return archive->read(*entry, blob);
+        }
+        return s_looseFiles && readLoose(filepath, blob);
+    }
+
+    bool FileSystem::readText(const std::string& filepath, std::string& text) {
+        FileBlob blob;
+        if (!read(filepath, blob)) {
+            return false;
+        }
+        text = blob.toString();
+        return true;
+    }
+
+    void FileSystem::readAsync(const std::vector<std::string>& filepaths, const std::function<void(u32 index, bool success, FileBlob& blob)>& callback) {
+        std::vector<IORequest> requests;
+
+        for (u32 i = 0 ; i < filepaths.size() ; i++) {
+            auto& filepath = filepaths[i];
+
+            const PackedArchive* archive = null;
+            const auto* entry = find(filepath, &archive);
+            if (entry) {
+                FileBlob blob;
+                bool success = archive->read(*entry, blob);
+                callback(i, success, blob);
+                continue;
+            }
+
+            std::error_code errorCode;
+            size_t size = s_looseFiles ? std::filesystem::file_size(filepath, errorCode) : 0;
+            if (!s_looseFiles || errorCode) {
+                FileBlob blob;
+                callback(i, false, blob);
+                continue;
+            }
+
+            // blob lives until its request completes
+            auto blob = std::make_shared<FileBlob>();
+            blob->mBuffer.resize(size);
+
+            IORequest request;
+            request.filepath = filepath;
+            request.size = size;
+            request.buffer = blob->mBuffer.data();
+            request.callback = [i, blob, callback](const IOResult& result) {
+                blob->mBuffer.resize(result.bytes);
+                blob->data = blob->mBuffer.data();
+                blob->size = result.bytes;
+                callback(i, result.success, *blob);
+            };
+            requests.emplace_back(request);
+        }
+
+        if (!requests.empty()) {
+            IOService::read(requests);
+        }
+    }
+
+    bool FileSystem::getHash(const std::string& filepath, u64& hash) {
+        const PackedArchive* archive = null;
+        const auto* entry = find(filepath, &archive);
+        if (!entry) {
+            return false;
+        }
+        hash = entry->contentHash;
+        return true;
+    }
+
+}
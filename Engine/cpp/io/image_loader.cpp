@@ -1,4 +1,8 @@
 #include <io/image_loader.h>
+#include <io/texture_streamer.h>
+#include <io/file_system.h>
+#include <core/thread_pool.h>
+#include <debugging/profiler.h>
 
 #include <stb_image.h>
 #include <stb_image_write.h>
@@ -6,24 +10,40 @@
 namespace gl {
 
     Image ImageReader::read(const char* filepath, const bool flipUV, const PixelType pixelType, const bool srgb) {
+        PROFILE_SCOPE("ImageReader::read");
+        FileBlob blob;
+        if (!FileSystem::read(filepath, blob)) {
+            error("Failed to read image {0}", filepath);
+            return {};
+        }
+
+        Image image = decode(blob.data, blob.size, flipUV, pixelType, srgb);
+        if (!image.pixels) {
+            error("Failed to read image {0}", filepath);
+        }
+
+        return image;
+    }
+
+    Image ImageReader::decode(const u8* data, size_t size, const bool flipUV, const PixelType pixelType, const bool srgb) {
         Image image;
 
-        stbi_set_flip_vertically_on_load(flipUV);
+        // per-thread flag, images can be decoded concurrently on ThreadPool
+        stbi_set_flip_vertically_on_load_thread(flipUV);
 
         switch (pixelType) {
             case PixelType::U16:
-                image.pixels = stbi_load_16(filepath, &image.width, &image.height, &image.channels, 0);
+                image.pixels = stbi_load_16_from_memory(data, (int) size, &image.width, &image.height, &image.channels, 0);
                 break;
             case PixelType::FLOAT:
-                image.pixels = stbi_loadf(filepath, &image.width, &image.height, &image.channels, 0);
+                image.pixels = stbi_loadf_from_memory(data, (int) size, &image.width, &image.height, &image.channels, 0);
                 break;
             default:
-                image.pixels = stbi_load(filepath, &image.width, &image.height, &image.channels, 0);
+                image.pixels = stbi_load_from_memory(data, (int) size, &image.width, &image.height, &image.channels, 0);
                 break;
         }
 
         if (!image.pixels) {
-            error("Failed to read image {0}", filepath);
             return image;
         }
 
@@ -45,8 +65,175 @@ namespace gl {
         return images;
     }
 
+    std::future<Image> ImageReader::readAsync(const std::string& filepath, const bool flipUV, const PixelType pixelType, const bool srgb) {
+        return ThreadPool::submit([filepath, flipUV, pixelType, srgb]() {
+            return read(filepath.c_str(), flipUV, pixelType, srgb);
+        });
+    }
+
     void ImageWriter::write(const char* filepath, const Image &image) {
         stbi_write_png(filepath, image.width, image.height, image.channels, image.pixels, image.width * image.channels);
     }
 
-}
\ No newline at end of file
+    static bool hasMipmaps(const ImageParams& params) {
+        return params.minFilter == GL_LINEAR_MIPMAP_LINEAR || params.minFilter == GL_LINEAR_MIPMAP_NEAREST
+                || params.minFilter == GL_NEAREST_MIPMAP_LINEAR || params.minFilter == GL_NEAREST_MIPMAP_NEAREST;
+    }
+
+    static size_t getBytes(Image& image, const ImageParams& params) {
+        size_t bytes = image.size();
+
+        switch (image.pixelType) {
+            case PixelType::U16:
+                bytes *= 2;
+                break;
+            case PixelType::FLOAT:
+            case PixelType::U32:
+            case PixelType::UINT248:
+                bytes *= 4;
+                break;
+            default:
+                break;
+        }
+
+        if (hasMipmaps(params)) {
+            bytes += bytes / 3;
+        }
+
+        return bytes;
+    }
+
+    static bool isCooked(const ImageUpload& upload) {
+        if (upload.compress && upload.pixelType != PixelType::U8) {
+            error("ImageUploader: only U8 images can be block compressed, {0} is loaded uncompressed", upload.filepath);
+            return false;
+        }
+        return upload.compress;
+    }
+
+    static std::future<DecodedImage> decodeCookedAsync(const ImageUpload& upload) {
+        TextureCookSettings settings;
+        settings.flipUV = upload.flipUV;
+        settings.srgb = upload.srgb;
+        settings.normalMap = upload.normalMap;
+        settings.mipmaps = hasMipmaps(upload.params);
+        int maxResidentSize = upload.stream && settings.mipmaps ? TextureStreamer::TAIL_SIZE : 0;
+        std::string filepath = upload.filepath;
+        return ThreadPool::submit([filepath, settings, maxResidentSize]() {
+            DecodedImage decoded;
+            // source hash is memoized across runs, see DerivedDataCache
+            decoded.cookedFilepath = TextureCooker::getCookedPath(filepath, settings);
+            decoded.isCompressed = TextureCooker::loadOrCook(decoded.cookedFilepath, filepath, settings, decoded.compressed, maxResidentSize);
+            return decoded;
+        });
+    }
+
+    struct DecodeRequest final {
+        std::string filepath;
+        bool flipUV;
+        PixelType pixelType;
+        bool srgb;
+        std::promise<DecodedImage> promise;
+    };
+
+    // sources are read with one batch of IOService and each one is decoded on ThreadPool as soon as it's read
+    static void decodeAsync(const std::vector<ImageUpload>& uploads, const std::vector<u32>& indices, std::vector<std::future<DecodedImage>>& decodes) {
+        auto requests = std::make_shared<std::vector<DecodeRequest>>(indices.size());
+        std::vector<std::string> filepaths;
+        filepaths.reserve(indices.size());
+        for (u32 i = 0 ; i < indices.size() ; i++) {
+            auto& upload = uploads[indices[i]];
+            auto& request = (*requests)[i];
+            request.filepath = upload.filepath;
+            request.flipUV = upload.flipUV;
+            request.pixelType = upload.pixelType;
+            request.srgb = upload.srgb;
+            decodes[indices[i]] = request.promise.get_future();
+            filepaths.emplace_back(upload.filepath);
+        }
+
+        FileSystem::readAsync(filepaths, [requests](u32 index, bool success, FileBlob& blob) {
+            auto& request = (*requests)[index];
+            if (!success) {
+                error("Failed to read image {0}", request.filepath);
+                request.promise.set_value(DecodedImage());
+                return;
+            }
+
+            ThreadPool::submit([requests, index, blob = std::move(blob)]() {
+                auto& request = (*requests)[index];
+                DecodedImage decoded;
+                decoded.image = ImageReader::decode(blob.data, blob.size, request.flipUV, request.pixelType, request.srgb);
+                if (!decoded.image.pixels) {
+                    error("Failed to decode image {0}", request.filepath);
+                }
+                request.promise.set_value(std::move(decoded));
+            });
+        });
+    }
+
+    std::vector<std::future<DecodedImage>> ImageUploader::decode(const std::vector<ImageUpload>& uploads) {
+        std::vector<std::future<DecodedImage>> decodes(uploads.size());
+        std::vector<u32> sourceIndices;
+        for (u32 i = 0 ; i < uploads.size() ; i++) {
+            if (isCooked(uploads[i])) {
+                decodes[i] = decodeCookedAsync(uploads[i]);
+            } else {
+                sourceIndices.emplace_back(i);
+            }
+        }
+        decodeAsync(uploads, sourceIndices, decodes);
+        return decodes;
+    }
+
+    void ImageUploader::upload(ImageUpload& upload, DecodedImage& decoded) {
+        if (decoded.isCompressed && upload.stream && hasMipmaps(upload.params)) {
+            upload.buffer.init();
+            TextureStreamer::add(upload.buffer, decoded.cookedFilepath, decoded.compressed, upload.params);
+            upload.bytes = decoded.compressed.size();
+        } else if (decoded.isCompressed) {
+            upload.buffer.init();
+            upload.buffer.load(decoded.compressed, upload.params);
+            upload.bytes = decoded.compressed.size();
+        } else if (decoded.image.pixels) {
+            upload.buffer.init();
+            upload.buffer.load(decoded.image, upload.params);
+            upload.bytes = getBytes(decoded.image, upload.params);
+            decoded.image.free();
+        }
+    }
+
+    void ImageUploader::load(std::vector<ImageUpload>& uploads) {
+        std::vector<std::future<DecodedImage>> decodes = decode(uploads);
+
+        size_t remaining = uploads.size();
+        std::vector<bool> uploaded(uploads.size(), false);
+        while (remaining > 0) {
+            bool anyReady = false;
+
+            for (size_t i = 0 ; i < uploads.size() ; i++) {
+                if (uploaded[i] || decodes[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    continue;
+                }
+
+                DecodedImage decoded = decodes[i].get();
+                upload(uploads[i], decoded);
+
+                uploaded[i] = true;
+                remaining--;
+                anyReady = true;
+            }
+
+            // nothing to upload yet, block on first pending decode instead of spinning
+            if (!anyReady) {
+                for (size_t i = 0 ; i < uploads.size() ; i++) {
+                    if (!uploaded[i]) {
+                        decodes[i].wait();
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,477 @@
+#include <io/io_service.h>
+#include <core/thread_pool.h>
+#include <debugging/profiler.h>
+
+#ifdef LINUX
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gl {
+
+    bool IOService::s_async = false;
+
+    struct IOService::Operation final {
+        IORequest request;
+        std::promise<IOResult> promise;
+        // bytes read so far, short reads are resubmitted for the rest
+        size_t bytes = 0;
+        int fd = -1;
+#ifdef LINUX
+        iovec iov;
+#endif
+    };
+
+    static bool readFile(const IORequest& request, size_t& bytes) {
+        std::ifstream file(request.filepath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.seekg(request.offset);
+        file.read((char*) request.buffer, request.size);
+        bytes = file.gcount();
+        return !file.bad();
+    }
+
+    void IOService::complete(Operation* operation, bool success) {
+#ifdef LINUX
+        if (operation->fd >= 0) {
+            ::close(operation->fd);
+        }
+#endif
+
+        IOResult result;
+        result.bytes = operation->bytes;
+        result.success = success;
+
+        if (!success) {
+            error("Failed to read file {0}", operation->request.filepath);
+        }
+
+        if (operation->request.callback) {
+            operation->request.callback(result);
+        }
+        operation->promise.set_value(result);
+
+        delete operation;
+    }
+
+    void IOService::readOnPool(Operation* operation) {
+        auto task = [operation]() {
+            bool success = readFile(operation->request, operation->bytes);
+            complete(operation, success);
+        };
+
+        // waiting worker could wait for its own job
+        if (ThreadPool::isWorker() || ThreadPool::getThreadCount() == 0) {
+            task();
+        } else {
+            ThreadPool::submit(task);
+        }
+    }
+
+    std::future<IOResult> IOService::read(const IORequest& request) {
+        return std::move(read(std::vector<IORequest> { request })[0]);
+    }
+
+    std::vector<std::future<IOResult>> IOService::read(const std::vector<IORequest>& requests) {
+        std::vector<std::future<IOResult>> results;
+        results.reserve(requests.size());
+        std::vector<Operation*> operations;
+        operations.reserve(requests.size());
+
+        for (auto& request : requests) {
+            auto* operation = new Operation();
+            operation->request = request;
+            results.emplace_back(operation->promise.get_future());
+
+            if (!s_async) {
+                readOnPool(operation);
+                continue;
+            }
+
+#ifdef LINUX
+            operation->fd = ::open(request.filepath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (operation->fd < 0) {
+                complete(operation, false);
+                continue;
+            }
+#endif
+
+            if (request.size == 0) {
+                complete(operation, true);
+                continue;
+            }
+
+            operations.emplace_back(operation);
+        }
+
+        if (!operations.empty()) {
+            submitRing(operations);
+        }
+
+        return results;
+    }
+
+    IOResult IOService::readSync(const IORequest& request) {
+        if (s_async) {
+            return read(request).get();
+        }
+
+        IOResult result;
+        result.success = readFile(request, result.bytes);
+        if (!result.success) {
+            error("Failed to read file {0}", request.filepath);
+        }
+        if (request.callback) {
+            request.callback(result);
+        }
+        return result;
+    }
+
+    bool IOService::isAsync() {
+        return s_async;
+    }
+
+#ifdef LINUX
+
+    // io_uring through raw syscalls, the same way liburing does it
+    struct Ring final {
+        int fd = -1;
+        u32 entries = 0;
+        void* sq = null;
+        size_t sqSize = 0;
+        void* cq = null;
+        size_t cqSize = 0;
+        io_uring_sqe* sqes = null;
+        size_t sqesSize = 0;
+
+        u32* sqHead = null;
+        u32* sqTail = null;
+        u32 sqMask = 0;
+        u32* sqArray = null;
+
+        u32* cqHead = null;
+        u32* cqTail = null;
+        u32 cqMask = 0;
+        io_uring_cqe* cqes = null;
+
+        // in flight requests are limited by entries, so that completion queue never overflows.
+        // they are tracked, so that requests left on shutdown can be failed
+        std::unordered_set<void*> inFlight;
+        std::queue<void*> pending;
+        std::mutex mutex;
+        std::thread thread;
+        std::atomic<bool> running = false;
+    };
+
+    static Ring s_ring;
+
+    // user data of request that wakes up and stops completion thread
+    static constexpr u64 STOP_USER_DATA = 0;
+
+    static int ioUringSetup(u32 entries, io_uring_params* params) {
+        return (int) syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    static int ioUringEnter(int fd, u32 submitCount, u32 minComplete, u32 flags) {
+        return (int) syscall(__NR_io_uring_enter, fd, submitCount, minComplete, flags, null, 0);
+    }
+
+    bool IOService::initRing() {
+        io_uring_params params = {};
+        int fd = ioUringSetup(QUEUE_DEPTH, &params);
+        if (fd < 0) {
+            return false;
+        }
+
+        s_ring.fd = fd;
+        s_ring.entries = params.sq_entries;
+        s_ring.sqSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+        s_ring.cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        s_ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            s_ring.sqSize = std::max(s_ring.sqSize, s_ring.cqSize);
+            s_ring.cqSize = s_ring.sqSize;
+        }
+
+        void* sq = mmap(null, s_ring.sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        s_ring.sq = sq == MAP_FAILED ? null : sq;
+        if (singleMap) {
+            s_ring.cq = s_ring.sq;
+        } else if (s_ring.sq) {
+            void* cq = mmap(null, s_ring.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            s_ring.cq = cq == MAP_FAILED ? null : cq;
+        }
+        void* sqes = mmap(null, s_ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        s_ring.sqes = sqes == MAP_FAILED ? null : (io_uring_sqe*) sqes;
+
+        if (!s_ring.sq || !s_ring.cq || !s_ring.sqes) {
+            freeRing();
+            return false;
+        }
+
+        u8* sqBase = (u8*) s_ring.sq;
+        s_ring.sqHead = (u32*) (sqBase + params.sq_off.head);
+        s_ring.sqTail = (u32*) (sqBase + params.sq_off.tail);
+        s_ring.sqMask = *(u32*) (sqBase + params.sq_off.ring_mask);
+        s_ring.sqArray = (u32*) (sqBase + params.sq_off.array);
+
+        u8* cqBase = (u8*) s_ring.cq;
+        s_ring.cqHead = (u32*) (cqBase + params.cq_off.head);
+        s_ring.cqTail = (u32*) (cqBase + params.cq_off.tail);
+        s_ring.cqMask = *(u32*) (cqBase + params.cq_off.ring_mask);
+        s_ring.cqes = (io_uring_cqe*) (cqBase + params.cq_off.cqes);
+
+        s_ring.running = true;
+        s_ring.thread = std::thread(reapRing);
+
+        return true;
+    }
+
+    void IOService::freeRing() {
+        std::vector<Operation*> outstanding;
+
+        if (s_ring.thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(s_ring.mutex);
+                s_ring.running = false;
+                // queued requests are never submitted, in flight ones are drained by completion thread before it stops
+                while (!s_ring.pending.empty()) {
+                    outstanding.emplace_back((Operation*) s_ring.pending.front());
+                    s_ring.pending.pop();
+                }
+
+                u32 tail = *s_ring.sqTail;
+                u32 index = tail & s_ring.sqMask;
+                io_uring_sqe* sqe = &s_ring.sqes[index];
+                std::memset(sqe, 0, sizeof(io_uring_sqe));
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = STOP_USER_DATA;
+                s_ring.sqArray[index] = index;
+                __atomic_store_n(s_ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+                if (ioUringEnter(s_ring.fd, 1, 0, 0) < 1) {
+                    error("Failed to stop io_uring completion thread");
+                }
+            }
+            s_ring.thread.join();
+        }
+
+        if (s_ring.sqes) {
+            munmap(s_ring.sqes, s_ring.sqesSize);
+        }
+        if (s_ring.cq && s_ring.cq != s_ring.sq) {
+            munmap(s_ring.cq, s_ring.cqSize);
+        }
+        if (s_ring.sq) {
+            munmap(s_ring.sq, s_ring.sqSize);
+        }
+        if (s_ring.fd >= 0) {
+            ::close(s_ring.fd);
+        }
+
+        s_ring.fd = -1;
+        s_ring.sq = null;
+        s_ring.cq = null;
+        s_ring.sqes = null;
+
+        // left only if completion thread stopped on error, closed ring cancels them
+        for (void* operation : s_ring.inFlight) {
+            outstanding.emplace_back((Operation*) operation);
+        }
+        s_ring.inFlight.clear();
+
+        for (auto* operation : outstanding) {
+            complete(operation, false);
+        }
+    }
+
+    // must be called with locked ring mutex
+    void IOService::pushRing(Operation* operation) {
+        u32 tail = *s_ring.sqTail;
+        u32 index = tail & s_ring.sqMask;
+
+        operation->iov.iov_base = (u8*) operation->request.buffer + operation->bytes;
+        operation->iov.iov_len = operation->request.size - operation->bytes;
+
+        io_uring_sqe* sqe = &s_ring.sqes[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        // READV is supported by every kernel with io_uring, READ needs 5.6
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = operation->fd;
+        sqe->off = operation->request.offset + operation->bytes;
+        sqe->addr = (u64) &operation->iov;
+        sqe->len = 1;
+        sqe->user_data = (u64) operation;
+
+        s_ring.sqArray[index] = index;
+        __atomic_store_n(s_ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+        s_ring.inFlight.insert(operation);
+    }
+
+    // must be called with locked ring mutex
+    void IOService::enterRing(u32 submitCount, std::vector<Operation*>& rejected) {
+        if (submitCount == 0 || ioUringEnter(s_ring.fd, submitCount, 0, 0) == (int) submitCount) {
+            return;
+        }
+
+        // kernel consumes entries up to SQ head, the rest is still ours and would be submitted by any later enter
+        u32 head = __atomic_load_n(s_ring.sqHead, __ATOMIC_ACQUIRE);
+        u32 tail = *s_ring.sqTail;
+        error("Failed to submit {0} of {1} reads to io_uring", tail - head, submitCount);
+        for (u32 i = head ; i != tail ; i++) {
+            auto* operation = (Operation*) s_ring.sqes[s_ring.sqArray[i & s_ring.sqMask]].user_data;
+            s_ring.inFlight.erase(operation);
+            rejected.emplace_back(operation);
+        }
+        __atomic_store_n(s_ring.sqTail, head, __ATOMIC_RELEASE);
+    }
+
+    void IOService::submitRing(std::vector<Operation*>& operations) {
+        std::vector<Operation*> rejected;
+        {
+            std::lock_guard<std::mutex> lock(s_ring.mutex);
+
+            u32 submitCount = 0;
+            for (auto* operation : operations) {
+                if (s_ring.inFlight.size() < s_ring.entries) {
+                    pushRing(operation);
+                    submitCount++;
+                } else {
+                    s_ring.pending.push(operation);
+                }
+            }
+
+            // whole batch with one syscall
+            enterRing(submitCount, rejected);
+        }
+
+        // rejected reads fall back to blocking path, that starts them over
+        for (auto* operation : rejected) {
+            readOnPool(operation);
+        }
+    }
+
+    void IOService::reapRing() {
+        Profiler::setThreadName("IO");
+        std::vector<std::pair<Operation*, int>> completions;
+        bool stopped = false;
+
+        while (true) {
+            if (ioUringEnter(s_ring.fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                error("Failed to wait for io_uring completions");
+                break;
+            }
+            PROFILE_SCOPE("IOCompletions");
+
+            completions.clear();
+            u32 head = *s_ring.cqHead;
+            u32 tail = __atomic_load_n(s_ring.cqTail, __ATOMIC_ACQUIRE);
+            for ( ; head != tail ; head++) {
+                io_uring_cqe& cqe = s_ring.cqes[head & s_ring.cqMask];
+                if (cqe.user_data == STOP_USER_DATA) {
+                    stopped = true;
+                } else {
+                    completions.emplace_back((Operation*) cqe.user_data, cqe.res);
+                }
+            }
+            __atomic_store_n(s_ring.cqHead, head, __ATOMIC_RELEASE);
+
+            std::vector<Operation*> finished;
+            std::vector<Operation*> failed;
+            std::vector<Operation*> rejected;
+            bool drained = false;
+            {
+                std::lock_guard<std::mutex> lock(s_ring.mutex);
+
+                u32 submitCount = 0;
+                for (auto& completion : completions) {
+                    auto* operation = completion.first;
+                    int res = completion.second;
+                    s_ring.inFlight.erase(operation);
+
+                    // rest of short read isn't submitted once service is stopping
+                    if (res < 0 || (res > 0 && !s_ring.running && operation->bytes + res < operation->request.size)) {
+                        failed.emplace_back(operation);
+                        continue;
+                    }
+
+                    operation->bytes += res;
+                    // 0 is end of file
+                    if (res == 0 || operation->bytes >= operation->request.size) {
+                        finished.emplace_back(operation);
+                    } else {
+                        pushRing(operation);
+                        submitCount++;
+                    }
+                }
+
+                while (!s_ring.pending.empty() && s_ring.inFlight.size() < s_ring.entries) {
+                    pushRing((Operation*) s_ring.pending.front());
+                    s_ring.pending.pop();
+                    submitCount++;
+                }
+
+                enterRing(submitCount, rejected);
+                drained = s_ring.inFlight.empty();
+            }
+
+            // callbacks run without lock, so that they can submit new reads
+            for (auto* operation : finished) {
+                complete(operation, true);
+            }
+            for (auto* operation : failed) {
+                complete(operation, false);
+            }
+            for (auto* operation : rejected) {
+                readOnPool(operation);
+            }
+
+            if (stopped && drained) {
+                break;
+            }
+        }
+    }
+
+#else
+
+    bool IOService::initRing() {
+        return false;
+    }
+
+    void IOService::freeRing() {}
+
+    void IOService::submitRing(std::vector<Operation*>& operations) {
+        for (auto* operation : operations) {
+            readOnPool(operation);
+        }
+    }
+
+    void IOService::pushRing(Operation* operation) {}
+
+    void IOService::enterRing(u32 submitCount, std::vector<Operation*>& rejected) {}
+
+    void IOService::reapRing() {}
+
+#endif
+
+    void IOService::init() {
+        s_async = initRing();
+        info("IOService uses {0}", s_async ? "io_uring" : "ThreadPool");
+    }
+
+    void IOService::free() {
+        if (s_async) {
+            s_async = false;
+            freeRing();
+        }
+    }
+
+}
@@ -1,38 +1,22 @@
 #include <io/material_loader.h>
-#include <io/image_loader.h>
+#include <io/texture_cache.h>
 
 namespace gl {
 
-    static std::unordered_map<std::string, ImageBuffer> bufferTable {};
-
-    static void readMaterial(
+    static std::string readSource(
             aiMaterial* material,
             aiTextureType type,
-            const std::string& directory,
-            u32 flags,
-            ImageBuffer& buffer,
-            const ImageParams& params = {}
+            const std::string& directory
     ) {
+        if (material->GetTextureCount(type) == 0) {
+            return {};
+        }
+
         aiString textureFile;
         material->Get(AI_MATKEY_TEXTURE(type, 0), textureFile);
         std::stringstream ss;
         ss << directory << "/" << textureFile.data;
-        std::string imageFilepath = ss.str();
-
-        if (bufferTable.find(imageFilepath) != bufferTable.end()) {
-            buffer = bufferTable[imageFilepath];
-            return;
-        }
-
-        Image image = ImageReader::read(imageFilepath.c_str(), flags & aiProcess_FlipUVs);
-
-        buffer.init();
-        buffer.load(image, params);
-        if (buffer.id != InvalidImageBuffer) {
-            bufferTable[imageFilepath] = buffer;
-        }
-
-        image.free();
+        return ss.str();
     }
 
     u32 MaterialLoader::parseMaterial(
@@ -40,38 +24,101 @@ namespace gl {
             const aiScene* scene, aiMesh* mesh,
             const std::string& directory, u32 flags
     ) {
-        if (mesh->mMaterialIndex >= 0) {
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            u32 materialIndex = mesh->mMaterialIndex;
+        std::unordered_map<u32, MaterialSources> sources;
+        u32 materialIndex = parseSources(sources, scene, mesh, directory, flags);
+        load(sources, materials);
+        return materialIndex;
+    }
 
-            Material resultMaterial;
-            ImageParams materialParams;
-            materialParams.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    u32 MaterialLoader::parseSources(
+            std::unordered_map<u32, MaterialSources>& sources,
+            const aiScene* scene, aiMesh* mesh,
+            const std::string& directory, u32 flags
+    ) {
+        u32 materialIndex = mesh->mMaterialIndex;
 
-            readMaterial(material, aiTextureType_BASE_COLOR, directory, flags, resultMaterial.albedo, materialParams);
-            resultMaterial.enableAlbedo = resultMaterial.albedo.id != InvalidImageBuffer;
+        if (sources.find(materialIndex) != sources.end()) {
+            return materialIndex;
+        }
 
-            readMaterial(material, aiTextureType_NORMALS, directory, flags, resultMaterial.normal, materialParams);
-            resultMaterial.enableNormal = resultMaterial.normal.id != InvalidImageBuffer;
+        aiMaterial* material = scene->mMaterials[materialIndex];
 
-            readMaterial(material, aiTextureType_DISPLACEMENT, directory, flags, resultMaterial.parallax,
-                         materialParams);
-            resultMaterial.enableParallax = resultMaterial.parallax.id != InvalidImageBuffer;
+        MaterialSources result;
+        result.flipUV = flags & aiProcess_FlipUVs;
+        result.albedo = readSource(material, aiTextureType_BASE_COLOR, directory);
+        result.normal = readSource(material, aiTextureType_NORMALS, directory);
+        result.parallax = readSource(material, aiTextureType_DISPLACEMENT, directory);
+        result.metallic = readSource(material, aiTextureType_METALNESS, directory);
+        result.roughness = readSource(material, aiTextureType_DIFFUSE_ROUGHNESS, directory);
+        result.ao = readSource(material, aiTextureType_AMBIENT_OCCLUSION, directory);
+        result.emission = readSource(material, aiTextureType_EMISSIVE, directory);
 
-            readMaterial(material, aiTextureType_METALNESS, directory, flags, resultMaterial.metallic, materialParams);
-            resultMaterial.enableMetallic = resultMaterial.metallic.id != InvalidImageBuffer;
+        sources[materialIndex] = result;
+        return materialIndex;
+    }
 
-            readMaterial(material, aiTextureType_DIFFUSE_ROUGHNESS, directory, flags, resultMaterial.roughness,
-                         materialParams);
-            resultMaterial.enableRoughness = resultMaterial.roughness.id != InvalidImageBuffer;
+    static void addRequest(std::vector<TextureRequest>& requests, const std::string& filepath, bool flipUV, bool normalMap = false) {
+        TextureRequest request;
+        request.filepath = filepath;
+        request.flipUV = flipUV;
+        request.normalMap = normalMap;
+        request.compress = true;
+        request.params.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        requests.emplace_back(request);
+    }
 
-            readMaterial(material, aiTextureType_AMBIENT_OCCLUSION, directory, flags, resultMaterial.ao, materialParams);
-            resultMaterial.enableAO = resultMaterial.ao.id != InvalidImageBuffer;
+    void MaterialLoader::addRequests(std::vector<TextureRequest>& requests, const MaterialSources& sources) {
+        addRequest(requests, sources.albedo, sources.flipUV);
+        addRequest(requests, sources.normal, sources.flipUV, true);
+        addRequest(requests, sources.parallax, sources.flipUV);
+        addRequest(requests, sources.metallic, sources.flipUV);
+        addRequest(requests, sources.roughness, sources.flipUV);
+        addRequest(requests, sources.ao, sources.flipUV);
+        addRequest(requests, sources.emission, sources.flipUV);
+    }
 
-            materials[materialIndex] = resultMaterial;
-            return materialIndex;
+    static void readMaterial(const TextureRequest& request, ImageBuffer& buffer, bool& enable) {
+        buffer = request.buffer;
+        enable = buffer.id != InvalidImageBuffer;
+    }
+
+    Material MaterialLoader::create(const TextureRequest* requests) {
+        Material resultMaterial;
+        readMaterial(requests[0], resultMaterial.albedo, resultMaterial.enableAlbedo);
+        readMaterial(requests[1], resultMaterial.normal, resultMaterial.enableNormal);
+        readMaterial(requests[2], resultMaterial.parallax, resultMaterial.enableParallax);
+        readMaterial(requests[3], resultMaterial.metallic, resultMaterial.enableMetallic);
+        readMaterial(requests[4], resultMaterial.roughness, resultMaterial.enableRoughness);
+        readMaterial(requests[5], resultMaterial.ao, resultMaterial.enableAO);
+        readMaterial(requests[6], resultMaterial.emission, resultMaterial.enableEmission);
+        return resultMaterial;
+    }
+
+    Material MaterialLoader::load(const MaterialSources& sources) {
+        std::vector<TextureRequest> requests;
+        addRequests(requests, sources);
+        TextureCache::acquire(requests);
+        return create(requests.data());
+    }
+
+    void MaterialLoader::load(
+            const std::unordered_map<u32, MaterialSources>& sources,
+            std::unordered_map<u32, Material>& materials
+    ) {
+        // acquire textures of all materials at once, so the whole model decodes in parallel
+        std::vector<TextureRequest> requests;
+        requests.reserve(sources.size() * MaterialSources::TEXTURE_COUNT);
+        for (auto& source : sources) {
+            addRequests(requests, source.second);
+        }
+
+        TextureCache::acquire(requests);
+
+        size_t i = 0;
+        for (auto& source : sources) {
+            materials[source.first] = create(&requests[i]);
+            i += MaterialSources::TEXTURE_COUNT;
         }
-        return 0;
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,352 @@
+#include <io/mesh_cooker.h>
+
+namespace gl {
+
+    const char* MeshCooker::EXTENSION = ".gmesh";
+
+    static void writeSources(BinaryStream& stream, std::unordered_map<u32, MaterialSources>& materialSources) {
+        for (auto& source : materialSources) {
+            u32 materialIndex = source.first;
+            auto& sources = source.second;
+            u32 flipUV = sources.flipUV;
+            stream.add(materialIndex);
+            stream.add(flipUV);
+            stream.addString(sources.albedo);
+            stream.addString(sources.normal);
+            stream.addString(sources.parallax);
+            stream.addString(sources.metallic);
+            stream.addString(sources.roughness);
+            stream.addString(sources.ao);
+            stream.addString(sources.emission);
+        }
+    }
+
+    static void readSources(BinaryStream& stream, u32 materialCount, std::unordered_map<u32, MaterialSources>& materialSources) {
+        for (u32 i = 0 ; i < materialCount && !stream.isFailed() ; i++) {
+            u32 materialIndex = 0;
+            u32 flipUV = 0;
+            MaterialSources sources;
+            stream.get(materialIndex);
+            stream.get(flipUV);
+            stream.getString(sources.albedo);
+            stream.getString(sources.normal);
+            stream.getString(sources.parallax);
+            stream.getString(sources.metallic);
+            stream.getString(sources.roughness);
+            stream.getString(sources.ao);
+            stream.getString(sources.emission);
+            sources.flipUV = flipUV;
+            materialSources[materialIndex] = sources;
+        }
+    }
+
+    static void writeNode(BinaryStream& stream, AssimpNodeData& node) {
+        u32 childCount = node.children.size();
+        stream.addString(node.name);
+        stream.add(node.transformation);
+        stream.add(childCount);
+        for (auto& child : node.children) {
+            writeNode(stream, child);
+        }
+    }
+
+    static void readNode(BinaryStream& stream, AssimpNodeData& node) {
+        u32 childCount = 0;
+        stream.getString(node.name);
+        stream.get(node.transformation);
+        stream.get(childCount);
+        // every child takes more than a byte, larger count is corrupted
+        if (childCount > stream.remaining()) {
+            stream.fail();
+            return;
+        }
+        node.children.resize(childCount);
+        for (auto& child : node.children) {
+            readNode(stream, child);
+        }
+    }
+
+    static void writeSkeleton(BinaryStream& stream, SkeletalModel& model) {
+        for (auto& entry : model.bones) {
+            Bone& bone = entry.second;
+            stream.add(bone.id);
+            stream.addString(bone.name);
+            stream.add(bone.offset);
+            stream.add(bone.positions);
+            stream.add(bone.rotations);
+            stream.add(bone.scales);
+        }
+
+        auto& animation = model.animation;
+        stream.add(animation.duration);
+        stream.add(animation.ticksPerSecond);
+        writeNode(stream, animation.root);
+    }
+
+    static void readSkeleton(BinaryStream& stream, u32 boneCount, SkeletalModel& model) {
+        for (u32 i = 0 ; i < boneCount && !stream.isFailed() ; i++) {
+            Bone bone;
+            stream.get(bone.id);
+            stream.getString(bone.name);
+            stream.get(bone.offset);
+            stream.get(bone.positions);
+            stream.get(bone.rotations);
+            stream.get(bone.scales);
+            model.bones[bone.name] = bone;
+        }
+
+        auto& animation = model.animation;
+        stream.get(animation.duration);
+        stream.get(animation.ticksPerSecond);
+        readNode(stream, animation.root);
+        animation.bones = &model.bones;
+    }
+
+    template<typename M>
+    static bool writeMeshes(
+            BinaryStream& stream,
+            CookedMeshHeader& header,
+            const std::string& sourceFilepath,
+            std::vector<M>& meshes,
+            u32 vertexStride
+    ) {
+        if (meshes.empty()) {
+            error("Nothing to cook for {0}", sourceFilepath);
+            return false;
+        }
+
+        header.vertexStride = vertexStride;
+        header.meshCount = meshes.size();
+        stream.add(header);
+
+        for (auto& mesh : meshes) {
+            CookedMeshRecord record;
+            record.vertexCount = mesh.vertices.count;
+            record.indexCount = mesh.indices.count;
+            record.materialIndex = mesh.materialIndex;
+            record.lodCount = mesh.lods.size();
+            stream.add(record);
+        }
+
+        for (auto& mesh : meshes) {
+            stream.add(mesh.vertices.vertices, mesh.vertices.size());
+        }
+
+        for (auto& mesh : meshes) {
+            stream.add(mesh.indices.indices, mesh.indices.size());
+        }
+
+        for (auto& mesh : meshes) {
+            for (auto& lod : mesh.lods) {
+                u32 indexCount = lod.indices.count;
+                stream.add(indexCount);
+                stream.add(lod.error);
+                stream.add(lod.indices.indices, lod.indices.size());
+            }
+        }
+
+        return true;
+    }
+
+    template<typename M>
+    static bool corrupted(const std::string& cookedFilepath, std::vector<M>& meshes) {
+        error("Cooked mesh {0} is truncated or corrupted, recooking", cookedFilepath);
+        for (auto& mesh : meshes) {
+            mesh.free();
+        }
+        meshes.clear();
+        return false;
+    }
+
+    template<typename M>
+    static bool readMeshes(
+            BinaryStream& stream,
+            CookedMeshHeader& header,
+            const std::string& cookedFilepath,
+            std::vector<M>& meshes,
+            u32 vertexStride,
+            u32 flags
+    ) {
+        if (!DerivedDataCache::load(cookedFilepath, stream)) {
+            return false;
+        }
+
+        if (stream.size() < sizeof(CookedMeshHeader)) {
+            return false;
+        }
+
+        stream.get(header);
+
+        if (header.magic != CookedMeshHeader::MAGIC || header.version != CookedMeshHeader::VERSION) {
+            info("Cooked mesh {0} has unknown format, recooking", cookedFilepath);
+            return false;
+        }
+
+        if (header.flags != flags || header.vertexStride != vertexStride) {
+            info("Cooked mesh {0} was cooked with different settings, recooking", cookedFilepath);
+            return false;
+        }
+
+        // counts come from file, each of them is checked against bytes left before allocating
+        if (header.meshCount > stream.remaining() / sizeof(CookedMeshRecord)) {
+            return corrupted(cookedFilepath, meshes);
+        }
+
+        std::vector<CookedMeshRecord> records(header.meshCount);
+        for (auto& record : records) {
+            stream.get(record);
+        }
+
+        meshes.resize(header.meshCount);
+        for (u32 i = 0 ; i < header.meshCount ; i++) {
+            auto& mesh = meshes[i];
+            if ((u64) records[i].vertexCount * vertexStride > stream.remaining()) {
+                return corrupted(cookedFilepath, meshes);
+            }
+            mesh.vertices.init(records[i].vertexCount);
+            mesh.materialIndex = records[i].materialIndex;
+            stream.get(mesh.vertices.vertices, mesh.vertices.size());
+        }
+
+        for (u32 i = 0 ; i < header.meshCount ; i++) {
+            auto& mesh = meshes[i];
+            if ((u64) records[i].indexCount * sizeof(u32) > stream.remaining()) {
+                return corrupted(cookedFilepath, meshes);
+            }
+            mesh.indices.init(records[i].indexCount);
+            stream.get(mesh.indices.indices, mesh.indices.size());
+        }
+
+        for (u32 i = 0 ; i < header.meshCount ; i++) {
+            auto& mesh = meshes[i];
+            if (records[i].lodCount > stream.remaining()) {
+                return corrupted(cookedFilepath, meshes);
+            }
+            mesh.lods.resize(records[i].lodCount);
+            for (auto& lod : mesh.lods) {
+                u32 indexCount = 0;
+                stream.get(indexCount);
+                stream.get(lod.error);
+                if ((u64) indexCount * sizeof(u32) > stream.remaining()) {
+                    return corrupted(cookedFilepath, meshes);
+                }
+                lod.indices.init(indexCount);
+                stream.get(lod.indices.indices, lod.indices.size());
+            }
+        }
+
+        if (stream.isFailed()) {
+            return corrupted(cookedFilepath, meshes);
+        }
+
+        return true;
+    }
+
+    std::string MeshCooker::getCookedPath(const std::string& filepath, u32 flags, bool skeletal) {
+        std::stringstream settings;
+        settings << flags << "|" << skeletal << "|" << CookedMeshHeader::VERSION;
+        return DerivedDataCache::getPath("meshes", filepath, settings.str(), EXTENSION);
+    }
+
+    void MeshCooker::cook(const std::string& cookedFilepath, const std::string& sourceFilepath, Model& model, u32 flags) {
+        BinaryStream stream;
+        CookedMeshHeader header;
+        header.flags = flags;
+        header.materialCount = model.materialSources.size();
+        header.bounds = model.bounds;
+
+        if (!writeMeshes(stream, header, sourceFilepath, model.meshes, sizeof(VertexMesh))) {
+            return;
+        }
+        writeSources(stream, model.materialSources);
+
+        if (!DerivedDataCache::store(cookedFilepath, stream)) {
+            error("Failed to cook mesh {0}", sourceFilepath);
+        }
+    }
+
+    void MeshCooker::cook(const std::string& cookedFilepath, const std::string& sourceFilepath, SkeletalModel& model, u32 flags) {
+        BinaryStream stream;
+        CookedMeshHeader header;
+        header.flags = flags;
+        header.materialCount = model.materialSources.size();
+        header.boneCount = model.bones.size();
+        header.skeletal = 1;
+        header.bounds = model.bounds;
+
+        if (!writeMeshes(stream, header, sourceFilepath, model.meshes, sizeof(SkeletalVertex))) {
+            return;
+        }
+        writeSources(stream, model.materialSources);
+        writeSkeleton(stream, model);
+
+        if (!DerivedDataCache::store(cookedFilepath, stream)) {
+            error("Failed to cook skeletal mesh {0}", sourceFilepath);
+        }
+    }
+
+    bool MeshCooker::load(const std::string& cookedFilepath, Model& model, u32 flags) {
+        BinaryStream stream;
+        CookedMeshHeader header;
+
+        if (!readMeshes(stream, header, cookedFilepath, model.meshes, sizeof(VertexMesh), flags)) {
+            return false;
+        }
+
+        readSources(stream, header.materialCount, model.materialSources);
+        if (stream.isFailed()) {
+            model.materialSources.clear();
+            return corrupted(cookedFilepath, model.meshes);
+        }
+        model.bounds = header.bounds;
+
+        return true;
+    }
+
+    bool MeshCooker::load(const std::string& cookedFilepath, SkeletalModel& model, u32 flags) {
+        BinaryStream stream;
+        CookedMeshHeader header;
+
+        if (!readMeshes(stream, header, cookedFilepath, model.meshes, sizeof(SkeletalVertex), flags)) {
+            return false;
+        }
+
+        if (!header.skeletal) {
+            error("Cooked mesh {0} has no skeleton", cookedFilepath);
+            model.free();
+            model.meshes.clear();
+            return false;
+        }
+
+        readSources(stream, header.materialCount, model.materialSources);
+        readSkeleton(stream, header.boneCount, model);
+        if (stream.isFailed()) {
+            model.materialSources.clear();
+            model.bones.clear();
+            model.animation.root = {};
+            return corrupted(cookedFilepath, model.meshes);
+        }
+        model.bounds = header.bounds;
+
+        return true;
+    }
+
+    void MeshCooker::cookModel(const std::string& filepath, u32 flags) {
+        Model model;
+        model.import(filepath, flags);
+        cook(getCookedPath(filepath, flags, false), filepath, model, flags);
+        for (auto& mesh : model.meshes) {
+            mesh.free();
+        }
+    }
+
+    void MeshCooker::cookSkeletalModel(const std::string& filepath, u32 flags) {
+        SkeletalModel model;
+        model.import(filepath, flags);
+        cook(getCookedPath(filepath, flags, true), filepath, model, flags);
+        for (auto& mesh : model.meshes) {
+            mesh.free();
+        }
+    }
+
+}
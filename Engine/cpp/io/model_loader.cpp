@@ -1,4 +1,8 @@
 #include "io/model_loader.h"
+#include "io/mesh_cooker.h"
+
+#include <geometry/mesh_simplifier.h>
+#include <debugging/profiler.h>
 
 namespace gl {
 
@@ -7,6 +11,29 @@ namespace gl {
             sizeof(VertexMesh)
     };
 
+    VertexFormat VertexMeshQuantized::format = {
+            { Attributes::POS3_UNORM16, Attributes::UV_F16, Attributes::NORMAL_OCT16, Attributes::TANGENT_OCT16 },
+            sizeof(VertexMeshQuantized)
+    };
+
+    VertexMeshQuantized VertexMeshQuantized::encode(const VertexMesh& vertex, const VertexDequantization& dequantization) {
+        VertexMeshQuantized result;
+        result.pos = VertexQuantizer::encodePosition(vertex.pos, dequantization);
+        result.uv = VertexQuantizer::encodeUV(vertex.uv);
+        result.normal = VertexQuantizer::encodeDirection(vertex.normal);
+        result.tangent = VertexQuantizer::encodeDirection(vertex.tangent);
+        return result;
+    }
+
+    VertexMesh VertexMeshQuantized::decode(const VertexDequantization& dequantization) const {
+        VertexMesh result;
+        result.pos = VertexQuantizer::decodePosition(pos, dequantization);
+        result.uv = VertexQuantizer::decodeUV(uv);
+        result.normal = VertexQuantizer::decodeDirection(normal);
+        result.tangent = VertexQuantizer::decodeDirection(tangent);
+        return result;
+    }
+
     static VertexMesh parseVertex(aiMesh* mesh, u32 i) {
         VertexMesh vertex;
 
@@ -41,7 +68,6 @@ namespace gl {
     static Mesh parseMesh(aiMesh *mesh)
     {
         Mesh result;
-        std::vector<u32> indices;
 
         result.vertices.init(mesh->mNumVertices);
 
@@ -49,15 +75,17 @@ namespace gl {
             result.vertices[i] = parseVertex(mesh, i);
         }
 
+        int indexCount = 0;
         for (u32 i = 0 ; i < mesh->mNumFaces ; i++) {
-            aiFace face = mesh->mFaces[i];
-            for (u32 j = 0 ; j < face.mNumIndices ; j++)
-                indices.push_back(face.mIndices[j]);
+            indexCount += mesh->mFaces[i].mNumIndices;
         }
 
-        result.indices.init((int) indices.size());
-        for (int i = 0 ; i < indices.size() ; i++) {
-            result.indices[i] = indices[i];
+        result.indices.init(indexCount);
+        u32* indices = result.indices.indices;
+        for (u32 i = 0 ; i < mesh->mNumFaces ; i++) {
+            const aiFace& face = mesh->mFaces[i];
+            std::memcpy(indices, face.mIndices, face.mNumIndices * sizeof(u32));
+            indices += face.mNumIndices;
         }
 
         return result;
@@ -69,13 +97,14 @@ namespace gl {
             const std::string& directory, u32 flags
     ) {
         auto& meshes = model.meshes;
-        auto& materials = model.materials;
+        auto& materialSources = model.materialSources;
 
         for (u32 i = 0 ; i < node->mNumMeshes ; i++)
         {
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
             Mesh result = parseMesh(mesh);
-            result.materialIndex = MaterialLoader::parseMaterial(materials, scene, mesh, directory, flags);
+            result.materialIndex = MaterialLoader::parseSources(materialSources, scene, mesh, directory, flags);
+            model.bounds.add(result.bounds());
             meshes.push_back(result);
         }
 
@@ -90,44 +119,80 @@ namespace gl {
         size_t meshCount = meshes.size();
         u32 vertexCount = 0;
         u32 indexCount = 0;
+        u32 lodCount = meshCount > 0 ? meshes[0].lods.size() : 0;
         for (u32 i = 0 ; i < meshCount ; i++) {
             auto& mesh = meshes[i];
-            for (u32 j = 0 ; j < mesh.indices.count ; j++) {
+            for (int j = 0 ; j < mesh.indices.count ; j++) {
                 mesh.indices[j] += vertexCount;
             }
+            for (auto& lod : mesh.lods) {
+                for (int j = 0 ; j < lod.indices.count ; j++) {
+                    lod.indices[j] += vertexCount;
+                }
+                indexCount += lod.indices.count;
+            }
+            lodCount = std::min<u32>(lodCount, mesh.lods.size());
             vertexCount += mesh.vertices.count;
             indexCount += mesh.indices.count;
         }
 
-        drawable.vao.init();
-        drawable.vao.bind();
-
-        glGenBuffers(1, &drawable.vbo.id);
-        glBindBuffer(GL_ARRAY_BUFFER, drawable.vbo.id);
-        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(VertexMesh), null, GL_DYNAMIC_DRAW);
-        drawable.vbo.setFormat(VertexMesh::format);
+        // all meshes of model and their LOD chains are one mesh of GeometryPool
+        if (quantized) {
+            drawable.dequantization = VertexQuantizer::dequantization(bounds);
+            drawable.mesh = GeometryPool::allocate(VertexMeshQuantized::format, vertexCount, indexCount);
+        } else {
+            drawable.dequantization = {};
+            drawable.mesh = GeometryPool::allocate(VertexMesh::format, vertexCount, indexCount);
+        }
+        if (drawable.mesh == InvalidMesh) {
+            error("Model: failed to allocate {0} vertices and {1} indices", vertexCount, indexCount);
+            return;
+        }
 
-        glGenBuffers(1, &drawable.ibo.id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ibo.id);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(u32), null, GL_DYNAMIC_DRAW);
+        if (quantized) {
+            std::vector<VertexMeshQuantized> quantizedVertices;
+            encodeQuantized(quantizedVertices, drawable.dequantization);
+            GeometryPool::uploadVertices(drawable.mesh, 0, quantizedVertices.size(), quantizedVertices.data());
+            info("Model: quantized {0} vertices, {1} -> {2} bytes",
+                 vertexCount, vertexCount * sizeof(VertexMesh), vertexCount * sizeof(VertexMeshQuantized));
+        }
 
         u32 vertexOffset = 0;
         u32 indexOffset = 0;
         for (u32 i = 0 ; i < meshCount ; i++) {
             auto& mesh = meshes[i];
 
-            glBindBuffer(GL_ARRAY_BUFFER, drawable.vbo.id);
-            glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, mesh.vertices.size(), mesh.vertices.toFloat());
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ibo.id);
-            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, mesh.indices.size(), mesh.indices.indices);
+            if (!quantized) {
+                GeometryPool::uploadVertices(drawable.mesh, vertexOffset, mesh.vertices.count, mesh.vertices.vertices);
+            }
+            GeometryPool::uploadIndices(drawable.mesh, indexOffset, mesh.indices.count, mesh.indices.indices);
+
+            vertexOffset += mesh.vertices.count;
+            indexOffset += mesh.indices.count;
+        }
+
+        // every LOD level of all meshes goes after base indices as one contiguous range
+        lods.clear();
+        lods.push_back({ 0, (int) indexOffset, 0 });
+        for (u32 level = 0 ; level < lodCount ; level++) {
+            LodLevel lodLevel;
+            lodLevel.indexOffset = indexOffset;
+
+            for (u32 i = 0 ; i < meshCount ; i++) {
+                auto& lod = meshes[i].lods[level];
+                GeometryPool::uploadIndices(drawable.mesh, indexOffset, lod.indices.count, lod.indices.indices);
+                indexOffset += lod.indices.count;
+                lodLevel.indexCount += lod.indices.count;
+                lodLevel.error = std::max(lodLevel.error, lod.error);
+            }
 
-            vertexOffset += mesh.vertices.size();
-            indexOffset += mesh.indices.size();
+            lods.emplace_back(lodLevel);
         }
 
         drawable.type = DrawType::TRIANGLES;
         drawable.strips = 1;
-        drawable.verticesPerStrip = indexCount;
+        drawable.verticesPerStrip = lods[0].indexCount;
+        drawable.indexOffset = 0;
     }
 
     void Model::free() {
@@ -139,11 +204,48 @@ namespace gl {
         }
     }
 
+    SurfaceArea Model::surfaceArea() const {
+        SurfaceArea result;
+        for (auto& mesh : meshes) {
+            result.add(mesh.surfaceArea());
+        }
+        return result;
+    }
+
     void Model::generate(const std::string &filepath, u32 flags) {
+        PROFILE_SCOPE("Model::generate");
+        loadMeshes(filepath, flags);
+        MaterialLoader::load(materialSources, materials);
+    }
+
+    void Model::loadMeshes(const std::string &filepath, u32 flags) {
+        std::string cookedFilepath = MeshCooker::getCookedPath(filepath, flags, false);
+
+        if (!MeshCooker::load(cookedFilepath, *this, flags)) {
+            import(filepath, flags);
+            MeshCooker::cook(cookedFilepath, filepath, *this, flags);
+        }
+    }
+
+    void Model::import(const std::string &filepath, u32 flags) {
         AssimpCore::readFile([this, &filepath, &flags](const aiScene* scene) {
             std::string directory = filepath.substr(0, filepath.find_last_of('/'));
             parseMeshes(scene->mRootNode, scene, *this, directory, flags);
         }, filepath, flags);
+
+        for (u32 i = 0 ; i < meshes.size() ; i++) {
+            MeshOptimizer::optimize(meshes[i].vertices, meshes[i].indices, filepath + "#" + std::to_string(i));
+            MeshSimplifier::generateLods(meshes[i].vertices, meshes[i].indices, meshes[i].lods);
+        }
+    }
+
+    void Model::encodeQuantized(std::vector<VertexMeshQuantized>& result, const VertexDequantization& dequantization) const {
+        result.clear();
+        for (auto& mesh : meshes) {
+            for (u32 i = 0 ; i < mesh.vertices.count ; i++) {
+                result.emplace_back(VertexMeshQuantized::encode(mesh.vertices.vertices[i], dequantization));
+            }
+        }
     }
 
 }
\ No newline at end of file
@@ -1,24 +1,25 @@
 #include "io/readers.h"
+#include "io/file_system.h"
 
 namespace gl {
 
     std::string FileReader::read(const char* filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
+        std::string buffer;
+        if (!FileSystem::readText(filepath, buffer)) {
             error("Failed to open file {0}", filepath);
             exception("Failed to open file");
         }
+        return buffer;
+    }
 
-        std::string buffer;
-        std::string line;
-        while (std::getline(file, line)) {
-            buffer.append(line);
-            buffer.append("\n");
-            if (file.eof())
-                break;
+    bool FileReader::readStamp(const std::string& filepath, u64& size, u64& time) {
+        std::error_code errorCode;
+        size = std::filesystem::file_size(filepath, errorCode);
+        if (errorCode) {
+            return false;
         }
-
-        return buffer;
+        time = std::filesystem::last_write_time(filepath, errorCode).time_since_epoch().count();
+        return !errorCode;
     }
 
 }
\ No newline at end of file
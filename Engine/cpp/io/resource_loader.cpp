@@ -0,0 +1,134 @@
+#include <io/resource_loader.h>
+#include <io/texture_cache.h>
+
+#include <geometry/cube.h>
+
+namespace gl {
+
+    std::list<ResourceLoader::Job> ResourceLoader::s_jobs;
+    size_t ResourceLoader::s_budgetBytes = 32ull * 1024ull * 1024ull;
+    float ResourceLoader::s_budgetMillis = 4.0f;
+    ResourceLoaderStats ResourceLoader::s_stats;
+    ImageBuffer ResourceLoader::s_placeholderTexture;
+
+    void ResourceLoader::init() {
+        Image image;
+        image.width = 1;
+        image.height = 1;
+        image.channels = 4;
+        image.pixelType = PixelType::U8;
+        image.init();
+        image.setFormat();
+        std::memset(image.pixels, 255, 4);
+
+        s_placeholderTexture.init();
+        s_placeholderTexture.load(image);
+        image.free();
+    }
+
+    void ResourceLoader::free() {
+        s_jobs.clear();
+        s_stats.pending = 0;
+        s_placeholderTexture.free();
+        s_placeholderTexture.id = InvalidImageBuffer;
+    }
+
+    void ResourceLoader::setBudget(size_t bytesPerFrame, float millisPerFrame) {
+        s_budgetBytes = bytesPerFrame;
+        s_budgetMillis = millisPerFrame;
+    }
+
+    void ResourceLoader::update() {
+        s_stats.uploads = 0;
+        s_stats.bytes = 0;
+        s_stats.millis = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+
+        // jobs are uploaded in order they got prepared, the ones still on worker threads are skipped
+        auto it = s_jobs.begin();
+        while (it != s_jobs.end() && s_stats.bytes < s_budgetBytes && s_stats.millis < s_budgetMillis) {
+            if (!it->isPrepared()) {
+                it++;
+                continue;
+            }
+
+            // job is taken out of list first, as its upload may submit new jobs
+            Job job = std::move(*it);
+            it = s_jobs.erase(it);
+
+            s_stats.bytes += job.upload();
+            s_stats.uploads++;
+            s_stats.millis = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        }
+
+        s_stats.totalBytes += s_stats.bytes;
+        s_stats.pending = s_jobs.size();
+    }
+
+    bool ResourceLoader::isIdle() {
+        return s_jobs.empty();
+    }
+
+    const ResourceLoaderStats& ResourceLoader::getStats() {
+        return s_stats;
+    }
+
+    const ImageBuffer& ResourceLoader::getPlaceholderTexture() {
+        return s_placeholderTexture;
+    }
+
+    void ResourceLoader::initPlaceholder(DrawableElements& drawable) {
+        CubeDefault().init(drawable);
+        drawable.type = DrawType::TRIANGLES;
+        drawable.indexOffset = 0;
+        drawable.dequantization = {};
+    }
+
+    TextureHandle ResourceLoader::loadTexture(
+            const std::string& filepath,
+            bool flipUV,
+            const ImageParams& params,
+            const std::function<void(ImageBuffer&)>& onReady
+    ) {
+        TextureHandle handle(s_placeholderTexture);
+
+        std::vector<TextureRequest> requests(1);
+        requests[0].filepath = filepath;
+        requests[0].flipUV = flipUV;
+        requests[0].params = params;
+
+        TextureCache::acquireAsync(requests, [handle, onReady](std::vector<TextureRequest>& requests) mutable {
+            if (requests[0].buffer.id == InvalidImageBuffer) {
+                handle.setState(RESOURCE_FAILED);
+                return;
+            }
+
+            handle.get() = requests[0].buffer;
+            handle.setState(RESOURCE_READY);
+            if (onReady) {
+                onReady(handle.get());
+            }
+        });
+
+        return handle;
+    }
+
+    MaterialHandle ResourceLoader::loadMaterial(const MaterialSources& sources, const std::function<void(Material&)>& onReady) {
+        MaterialHandle handle = MaterialHandle(Material());
+
+        std::vector<TextureRequest> requests;
+        MaterialLoader::addRequests(requests, sources);
+
+        TextureCache::acquireAsync(requests, [handle, onReady](std::vector<TextureRequest>& requests) mutable {
+            handle.get() = MaterialLoader::create(requests.data());
+            handle.setState(RESOURCE_READY);
+            if (onReady) {
+                onReady(handle.get());
+            }
+        });
+
+        return handle;
+    }
+
+}
@@ -19,6 +19,7 @@ namespace gl {
     void BinaryStream::clear() {
         mBuffer.clear();
         mCursor = 0;
+        mFailed = false;
     }
 
     void BinaryStream::addString(std::string& string) {
@@ -31,7 +32,7 @@ namespace gl {
         add(stream.data(), stream.size());
     }
 
-    void BinaryStream::add(void* data, size_t newSize) {
+    void BinaryStream::add(const void* data, size_t newSize) {
         mBuffer.resize(mBuffer.size() + newSize);
         memcpy(mBuffer.data() + mCursor, data, newSize);
         mCursor += newSize;
@@ -40,17 +41,25 @@ namespace gl {
     void BinaryStream::getString(std::string& string) {
         size_t length = 0;
         get(length);
+        if (length > remaining()) {
+            mFailed = true;
+            return;
+        }
         string.resize(length);
         get(string.data(), length);
     }
 
     void BinaryStream::get(void* data, size_t size) {
+        if (mFailed || size > remaining()) {
+            mFailed = true;
+            return;
+        }
         memcpy(data, mBuffer.data() + mCursor, size);
         mCursor += size;
     }
 
     void BinaryStream::write(const char* filepath) {
-        std::ofstream file(filepath);
+        std::ofstream file(filepath, std::ios::binary);
 
         if (!file.is_open()) {
             error("Failed to open file {0}", filepath);
@@ -65,7 +74,7 @@ namespace gl {
     }
 
     void BinaryStream::read(const char* filepath) {
-        std::ifstream file(filepath);
+        std::ifstream file(filepath, std::ios::binary);
 
         if (!file.is_open()) {
             error("Failed to open file {0}", filepath);
@@ -1,4 +1,7 @@
 #include "io/skeletal_loader.h"
+#include "io/mesh_cooker.h"
+
+#include <geometry/mesh_simplifier.h>
 
 namespace gl {
 
@@ -14,6 +17,38 @@ namespace gl {
             sizeof(SkeletalVertex)
     };
 
+    VertexFormat SkeletalVertexQuantized::format = {
+            {
+                Attributes::POS3_UNORM16,
+                Attributes::UV_F16,
+                Attributes::NORMAL_OCT16,
+                Attributes::TANGENT_OCT16,
+                Attributes::BONE_ID_U8,
+                Attributes::WEIGHT_UNORM8
+            },
+            sizeof(SkeletalVertexQuantized)
+    };
+
+    SkeletalVertexQuantized SkeletalVertexQuantized::encode(const SkeletalVertex& vertex, const VertexDequantization& dequantization) {
+        SkeletalVertexQuantized result;
+        result.pos = VertexQuantizer::encodePosition(vertex.pos, dequantization);
+        result.uv = VertexQuantizer::encodeUV(vertex.uv);
+        result.normal = VertexQuantizer::encodeDirection(vertex.normal);
+        result.tangent = VertexQuantizer::encodeDirection(vertex.tangent);
+        VertexQuantizer::encodeBones(vertex.bone_id, vertex.weight, result.bone_id, result.weight);
+        return result;
+    }
+
+    SkeletalVertex SkeletalVertexQuantized::decode(const VertexDequantization& dequantization) const {
+        SkeletalVertex result;
+        result.pos = VertexQuantizer::decodePosition(pos, dequantization);
+        result.uv = VertexQuantizer::decodeUV(uv);
+        result.normal = VertexQuantizer::decodeDirection(normal);
+        result.tangent = VertexQuantizer::decodeDirection(tangent);
+        VertexQuantizer::decodeBones(bone_id, weight, result.bone_id, result.weight);
+        return result;
+    }
+
     Bone::Bone(int id, const std::string& name, const aiNodeAnim* channel, const glm::mat4& offset)
     : id(id), name(name), offset(offset) {
 
@@ -102,15 +137,20 @@ namespace gl {
             float weight = weights[weightIndex].mWeight;
             assert(vertexId <= skeletalMesh.vertices.count);
             SkeletalVertex& vertex = skeletalMesh.vertices[vertexId];
-            vertex.bone_id = { boneId, boneId, boneId, boneId };
-            vertex.weight = { weight, weight, weight, weight };
+            // every influence takes the first free slot, influences beyond four are dropped
+            for (int slot = 0 ; slot < 4 ; slot++) {
+                if (vertex.bone_id[slot] == -1) {
+                    vertex.bone_id[slot] = boneId;
+                    vertex.weight[slot] = weight;
+                    break;
+                }
+            }
         }
     }
 
     static SkeletalMesh parseSkeletalMesh(aiMesh* mesh, std::unordered_map<std::string, Bone>& bones, aiAnimation* animation)
     {
         SkeletalMesh result;
-        std::vector<u32> indices;
 
         result.vertices.init((int) mesh->mNumVertices);
 
@@ -123,15 +163,17 @@ namespace gl {
             parseBone(result, mesh, boneIndex, bones, animation->mChannels[boneIndex]);
         }
 
+        int indexCount = 0;
         for (u32 i = 0 ; i < mesh->mNumFaces ; i++) {
-            aiFace face = mesh->mFaces[i];
-            for (u32 j = 0 ; j < face.mNumIndices ; j++)
-                indices.push_back(face.mIndices[j]);
+            indexCount += mesh->mFaces[i].mNumIndices;
         }
 
-        result.indices.init((int) indices.size());
-        for (int i = 0 ; i < indices.size() ; i++) {
-            result.indices[i] = indices[i];
+        result.indices.init(indexCount);
+        u32* indices = result.indices.indices;
+        for (u32 i = 0 ; i < mesh->mNumFaces ; i++) {
+            const aiFace& face = mesh->mFaces[i];
+            std::memcpy(indices, face.mIndices, face.mNumIndices * sizeof(u32));
+            indices += face.mNumIndices;
         }
 
         return result;
@@ -143,13 +185,14 @@ namespace gl {
             const std::string& directory, u32 flags
     ) {
         auto& meshes = model.meshes;
-        auto& materials = model.materials;
+        auto& materialSources = model.materialSources;
 
         for (u32 i = 0 ; i < node->mNumMeshes ; i++)
         {
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
             SkeletalMesh result = parseSkeletalMesh(mesh, model.bones, scene->mAnimations[0]);
-            result.materialIndex = MaterialLoader::parseMaterial(materials, scene, mesh, directory, flags);
+            result.materialIndex = MaterialLoader::parseSources(materialSources, scene, mesh, directory, flags);
+            model.bounds.add(result.bounds());
             meshes.push_back(result);
         }
 
@@ -178,44 +221,80 @@ namespace gl {
         size_t meshCount = meshes.size();
         u32 vertexCount = 0;
         u32 indexCount = 0;
+        u32 lodCount = meshCount > 0 ? meshes[0].lods.size() : 0;
         for (u32 i = 0 ; i < meshCount ; i++) {
             auto& mesh = meshes[i];
             for (int j = 0 ; j < mesh.indices.count ; j++) {
                 mesh.indices[j] += vertexCount;
             }
+            for (auto& lod : mesh.lods) {
+                for (int j = 0 ; j < lod.indices.count ; j++) {
+                    lod.indices[j] += vertexCount;
+                }
+                indexCount += lod.indices.count;
+            }
+            lodCount = std::min<u32>(lodCount, mesh.lods.size());
             vertexCount += mesh.vertices.count;
             indexCount += mesh.indices.count;
         }
 
-        drawable.vao.init();
-        drawable.vao.bind();
-
-        glGenBuffers(1, &drawable.vbo.id);
-        glBindBuffer(GL_ARRAY_BUFFER, drawable.vbo.id);
-        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(SkeletalVertex), null, GL_DYNAMIC_DRAW);
-        drawable.vbo.setFormat(SkeletalVertex::format);
+        // all meshes of model and their LOD chains are one mesh of GeometryPool
+        if (quantized) {
+            drawable.dequantization = VertexQuantizer::dequantization(bounds);
+            drawable.mesh = GeometryPool::allocate(SkeletalVertexQuantized::format, vertexCount, indexCount);
+        } else {
+            drawable.dequantization = {};
+            drawable.mesh = GeometryPool::allocate(SkeletalVertex::format, vertexCount, indexCount);
+        }
+        if (drawable.mesh == InvalidMesh) {
+            error("SkeletalModel: failed to allocate {0} vertices and {1} indices", vertexCount, indexCount);
+            return;
+        }
 
-        glGenBuffers(1, &drawable.ibo.id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ibo.id);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(u32), null, GL_DYNAMIC_DRAW);
+        if (quantized) {
+            std::vector<SkeletalVertexQuantized> quantizedVertices;
+            encodeQuantized(quantizedVertices, drawable.dequantization);
+            GeometryPool::uploadVertices(drawable.mesh, 0, quantizedVertices.size(), quantizedVertices.data());
+            info("SkeletalModel: quantized {0} vertices, {1} -> {2} bytes",
+                 vertexCount, vertexCount * sizeof(SkeletalVertex), vertexCount * sizeof(SkeletalVertexQuantized));
+        }
 
         u32 vertexOffset = 0;
         u32 indexOffset = 0;
         for (u32 i = 0 ; i < meshCount ; i++) {
             auto& mesh = meshes[i];
 
-            glBindBuffer(GL_ARRAY_BUFFER, drawable.vbo.id);
-            glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, mesh.vertices.size(), mesh.vertices.toFloat());
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ibo.id);
-            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, mesh.indices.size(), mesh.indices.indices);
+            if (!quantized) {
+                GeometryPool::uploadVertices(drawable.mesh, vertexOffset, mesh.vertices.count, mesh.vertices.vertices);
+            }
+            GeometryPool::uploadIndices(drawable.mesh, indexOffset, mesh.indices.count, mesh.indices.indices);
+
+            vertexOffset += mesh.vertices.count;
+            indexOffset += mesh.indices.count;
+        }
+
+        // every LOD level of all meshes goes after base indices as one contiguous range
+        lods.clear();
+        lods.push_back({ 0, (int) indexOffset, 0 });
+        for (u32 level = 0 ; level < lodCount ; level++) {
+            LodLevel lodLevel;
+            lodLevel.indexOffset = indexOffset;
+
+            for (u32 i = 0 ; i < meshCount ; i++) {
+                auto& lod = meshes[i].lods[level];
+                GeometryPool::uploadIndices(drawable.mesh, indexOffset, lod.indices.count, lod.indices.indices);
+                indexOffset += lod.indices.count;
+                lodLevel.indexCount += lod.indices.count;
+                lodLevel.error = std::max(lodLevel.error, lod.error);
+            }
 
-            vertexOffset += mesh.vertices.size();
-            indexOffset += mesh.indices.size();
+            lods.emplace_back(lodLevel);
         }
 
         drawable.type = DrawType::TRIANGLES;
         drawable.strips = 1;
-        drawable.verticesPerStrip = indexCount;
+        drawable.verticesPerStrip = lods[0].indexCount;
+        drawable.indexOffset = 0;
     }
 
     void SkeletalModel::free() {
@@ -227,7 +306,29 @@ namespace gl {
         }
     }
 
+    SurfaceArea SkeletalModel::surfaceArea() const {
+        SurfaceArea result;
+        for (auto& mesh : meshes) {
+            result.add(mesh.surfaceArea());
+        }
+        return result;
+    }
+
     void SkeletalModel::generate(const std::string &filepath, u32 flags) {
+        loadMeshes(filepath, flags);
+        MaterialLoader::load(materialSources, materials);
+    }
+
+    void SkeletalModel::loadMeshes(const std::string &filepath, u32 flags) {
+        std::string cookedFilepath = MeshCooker::getCookedPath(filepath, flags, true);
+
+        if (!MeshCooker::load(cookedFilepath, *this, flags)) {
+            import(filepath, flags);
+            MeshCooker::cook(cookedFilepath, filepath, *this, flags);
+        }
+    }
+
+    void SkeletalModel::import(const std::string &filepath, u32 flags) {
         AssimpCore::readFile([&filepath, this, &flags](const aiScene* scene) {
 
             std::string directory = filepath.substr(0, filepath.find_last_of('/'));
@@ -240,6 +341,20 @@ namespace gl {
             animation.bones = &bones;
 
         }, filepath, flags);
+
+        for (u32 i = 0 ; i < meshes.size() ; i++) {
+            MeshOptimizer::optimize(meshes[i].vertices, meshes[i].indices, filepath + "#" + std::to_string(i));
+            MeshSimplifier::generateLods(meshes[i].vertices, meshes[i].indices, meshes[i].lods);
+        }
+    }
+
+    void SkeletalModel::encodeQuantized(std::vector<SkeletalVertexQuantized>& result, const VertexDequantization& dequantization) const {
+        result.clear();
+        for (auto& mesh : meshes) {
+            for (u32 i = 0 ; i < mesh.vertices.count ; i++) {
+                result.emplace_back(SkeletalVertexQuantized::encode(mesh.vertices.vertices[i], dequantization));
+            }
+        }
     }
 
 }
\ No newline at end of file
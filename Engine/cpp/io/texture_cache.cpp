@@ -0,0 +1,286 @@
+#include <io/texture_cache.h>
+#include <io/texture_streamer.h>
+#include <io/resource_loader.h>
+
+namespace gl {
+
+    std::unordered_map<std::string, TextureCache::Entry> TextureCache::s_entries;
+    std::unordered_map<u32, std::string> TextureCache::s_keys;
+    std::list<std::string> TextureCache::s_lru;
+    std::unordered_map<std::string, std::vector<TextureCache::Waiter>> TextureCache::s_pending;
+    TextureCacheStats TextureCache::s_stats = { 0, 0, 0, 0, 1024ull * 1024ull * 1024ull, 0, 0 };
+
+    void TextureCache::free() {
+        for (auto& entry : s_entries) {
+            TextureStreamer::remove(entry.second.buffer);
+            entry.second.buffer.free();
+        }
+        s_entries.clear();
+        s_keys.clear();
+        s_lru.clear();
+        s_pending.clear();
+        s_stats.bytes = 0;
+        s_stats.textures = 0;
+        s_stats.referenced = 0;
+    }
+
+    void TextureCache::setBudget(size_t bytes) {
+        s_stats.budget = bytes;
+        evict();
+    }
+
+    std::string TextureCache::getKey(const TextureRequest& request) {
+        const auto& filepath = request.filepath;
+        const auto& params = request.params;
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filepath, errorCode);
+
+        std::stringstream ss;
+        ss << (errorCode ? filepath : canonicalPath.generic_string()) << "|" << request.flipUV
+        << "|" << request.normalMap << "," << request.compress << "," << request.stream
+        << "|" << params.s << "," << params.t << "," << params.r
+        << "|" << params.minFilter << "," << params.magFilter
+        << "|" << params.lodBias << "," << params.baseLevel
+        << "|" << params.borderColor.r << "," << params.borderColor.g << "," << params.borderColor.b << "," << params.borderColor.a;
+        return ss.str();
+    }
+
+    void TextureCache::reference(Entry& entry) {
+        if (entry.refs++ == 0) {
+            s_lru.erase(entry.lru);
+            entry.lru = s_lru.end();
+            s_stats.referenced++;
+        }
+    }
+
+    void TextureCache::insert(const std::string& key, ImageUpload& upload) {
+        // blocking acquire may load the same key while its async upload is in flight
+        if (s_entries.find(key) != s_entries.end()) {
+            TextureStreamer::remove(upload.buffer);
+            upload.buffer.free();
+            upload.buffer.id = InvalidImageBuffer;
+            return;
+        }
+
+        Entry& newEntry = s_entries[key];
+        newEntry.buffer = upload.buffer;
+        newEntry.bytes = upload.bytes;
+        newEntry.lru = s_lru.insert(s_lru.begin(), key);
+        s_keys[upload.buffer.id] = key;
+        s_stats.bytes += upload.bytes;
+        s_stats.textures++;
+    }
+
+    ImageBuffer TextureCache::acquire(const std::string& filepath, bool flipUV, const ImageParams& params) {
+        std::vector<TextureRequest> requests(1);
+        requests[0].filepath = filepath;
+        requests[0].flipUV = flipUV;
+        requests[0].params = params;
+        acquire(requests);
+        return requests[0].buffer;
+    }
+
+    void TextureCache::acquire(std::vector<TextureRequest>& requests) {
+        std::vector<std::string> keys;
+        std::vector<ImageUpload> uploads;
+        std::unordered_map<std::string, size_t> pending;
+        keys.reserve(requests.size());
+
+        for (auto& request : requests) {
+            // materials leave unset maps empty, they are neither loaded nor counted
+            if (request.filepath.empty()) {
+                keys.emplace_back();
+                continue;
+            }
+
+            keys.emplace_back(getKey(request));
+            auto& key = keys.back();
+
+            if (s_entries.find(key) != s_entries.end() || pending.find(key) != pending.end()) {
+                continue;
+            }
+
+            ImageUpload upload;
+            upload.filepath = request.filepath;
+            upload.flipUV = request.flipUV;
+            upload.normalMap = request.normalMap;
+            upload.compress = request.compress;
+            upload.stream = request.stream;
+            upload.params = request.params;
+            pending[key] = uploads.size();
+            uploads.emplace_back(upload);
+            s_stats.misses++;
+        }
+
+        ImageUploader::load(uploads);
+
+        for (auto& entry : pending) {
+            auto& upload = uploads[entry.second];
+            if (upload.buffer.id == InvalidImageBuffer) {
+                continue;
+            }
+
+            insert(entry.first, upload);
+        }
+
+        for (size_t i = 0 ; i < requests.size() ; i++) {
+            auto it = keys[i].empty() ? s_entries.end() : s_entries.find(keys[i]);
+            if (it == s_entries.end()) {
+                requests[i].buffer = {};
+                continue;
+            }
+
+            auto pendingIt = pending.find(keys[i]);
+            if (pendingIt != pending.end()) {
+                // first request of a loaded key is the miss, the rest of batch are hits
+                pending.erase(pendingIt);
+            } else {
+                s_stats.hits++;
+            }
+
+            reference(it->second);
+            requests[i].buffer = it->second.buffer;
+        }
+
+        evict();
+    }
+
+    struct TextureCache::Batch final {
+        std::vector<TextureRequest> requests;
+        std::function<void(std::vector<TextureRequest>&)> onReady;
+        size_t remaining = 0;
+    };
+
+    void TextureCache::acquireAsync(const std::vector<TextureRequest>& requests, const std::function<void(std::vector<TextureRequest>&)>& onReady) {
+        auto batch = std::make_shared<Batch>();
+        batch->requests = requests;
+        batch->onReady = onReady;
+        // guards against onReady being called before all requests are walked through
+        batch->remaining = requests.size() + 1;
+
+        for (u32 i = 0 ; i < requests.size() ; i++) {
+            auto& request = batch->requests[i];
+            Waiter waiter = { batch, i };
+
+            if (request.filepath.empty()) {
+                request.buffer = {};
+                resolve(waiter, {});
+                continue;
+            }
+
+            std::string key = getKey(request);
+            if (s_entries.find(key) != s_entries.end()) {
+                s_stats.hits++;
+                resolve(waiter, key);
+                continue;
+            }
+
+            auto pendingIt = s_pending.find(key);
+            if (pendingIt != s_pending.end()) {
+                s_stats.hits++;
+                pendingIt->second.emplace_back(waiter);
+                continue;
+            }
+
+            s_stats.misses++;
+            s_pending[key].emplace_back(waiter);
+
+            auto upload = std::make_shared<ImageUpload>();
+            upload->filepath = request.filepath;
+            upload->flipUV = request.flipUV;
+            upload->normalMap = request.normalMap;
+            upload->compress = request.compress;
+            upload->stream = request.stream;
+            upload->params = request.params;
+
+            auto decodes = ImageUploader::decode({ *upload });
+            ResourceLoader::submit<DecodedImage>(std::move(decodes[0]), [key, upload](DecodedImage& decoded) {
+                ImageUploader::upload(*upload, decoded);
+                complete(key, *upload);
+                return upload->bytes;
+            });
+        }
+
+        resolve({ batch, 0 }, {});
+    }
+
+    void TextureCache::resolve(const Waiter& waiter, const std::string& key) {
+        auto& batch = *waiter.batch;
+        if (!key.empty()) {
+            auto it = s_entries.find(key);
+            auto& request = batch.requests[waiter.index];
+            if (it == s_entries.end()) {
+                request.buffer = {};
+            } else {
+                reference(it->second);
+                request.buffer = it->second.buffer;
+            }
+        }
+
+        if (--batch.remaining == 0) {
+            batch.onReady(batch.requests);
+        }
+    }
+
+    void TextureCache::complete(const std::string& key, ImageUpload& upload) {
+        if (upload.buffer.id != InvalidImageBuffer) {
+            insert(key, upload);
+        }
+
+        auto pendingIt = s_pending.find(key);
+        if (pendingIt != s_pending.end()) {
+            std::vector<Waiter> waiters = std::move(pendingIt->second);
+            s_pending.erase(pendingIt);
+            for (auto& waiter : waiters) {
+                resolve(waiter, key);
+            }
+        }
+
+        evict();
+    }
+
+    void TextureCache::release(ImageBuffer& buffer) {
+        if (buffer.id == InvalidImageBuffer) {
+            return;
+        }
+
+        auto keyIt = s_keys.find(buffer.id);
+        if (keyIt == s_keys.end()) {
+            TextureStreamer::remove(buffer);
+            buffer.free();
+            buffer.id = InvalidImageBuffer;
+            return;
+        }
+
+        Entry& entry = s_entries[keyIt->second];
+        if (entry.refs > 0 && --entry.refs == 0) {
+            entry.lru = s_lru.insert(s_lru.begin(), keyIt->second);
+            s_stats.referenced--;
+        }
+
+        buffer.id = InvalidImageBuffer;
+        evict();
+    }
+
+    void TextureCache::evict() {
+        while (s_stats.bytes > s_stats.budget && !s_lru.empty()) {
+            std::string key = s_lru.back();
+            s_lru.pop_back();
+
+            auto it = s_entries.find(key);
+            Entry& entry = it->second;
+            s_stats.bytes -= entry.bytes;
+            s_stats.textures--;
+            s_stats.evictions++;
+            s_keys.erase(entry.buffer.id);
+            TextureStreamer::remove(entry.buffer);
+            entry.buffer.free();
+            s_entries.erase(it);
+        }
+    }
+
+    const TextureCacheStats& TextureCache::getStats() {
+        return s_stats;
+    }
+
+}
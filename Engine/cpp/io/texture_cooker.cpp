@@ -0,0 +1,315 @@
+#include <io/texture_cooker.h>
+#include <io/image_loader.h>
+
+#include <api/image_kernels.h>
+
+namespace gl {
+
+    const char* TextureCooker::EXTENSION = ".gtex";
+
+    static constexpr u32 FLAG_FLIP_UV = 1 << 0;
+    static constexpr u32 FLAG_SRGB = 1 << 1;
+    static constexpr u32 FLAG_NORMAL_MAP = 1 << 2;
+    static constexpr u32 FLAG_MIPMAPS = 1 << 3;
+
+    static const char* FORMAT_NAMES[] = { "BC1", "BC3", "BC5", "BC7" };
+
+    u32 TextureCookSettings::getFlags() const {
+        return (flipUV ? FLAG_FLIP_UV : 0)
+                | (srgb ? FLAG_SRGB : 0)
+                | (normalMap ? FLAG_NORMAL_MAP : 0)
+                | (mipmaps ? FLAG_MIPMAPS : 0);
+    }
+
+    std::string TextureCooker::getCookedPath(const std::string& filepath, const TextureCookSettings& settings) {
+        std::stringstream ss;
+        ss << settings.getFlags() << "|" << CookedTextureHeader::VERSION;
+        return DerivedDataCache::getPath("textures", filepath, ss.str(), EXTENSION);
+    }
+
+    static Image toRGBA(const Image& image) {
+        Image result;
+        result.width = image.width;
+        result.height = image.height;
+        result.channels = 4;
+        result.pixelType = PixelType::U8;
+        result.srgb = image.srgb;
+        result.init();
+        result.setFormat();
+
+        const u8* src = (const u8*) image.pixels;
+        u8* dst = (u8*) result.pixels;
+        size_t pixelCount = (size_t) image.width * image.height;
+        for (size_t i = 0 ; i < pixelCount ; i++) {
+            const u8* s = &src[i * image.channels];
+            u8* d = &dst[i * 4];
+            switch (image.channels) {
+                case 1:
+                    d[0] = d[1] = d[2] = s[0];
+                    d[3] = 255;
+                    break;
+                case 2:
+                    d[0] = d[1] = d[2] = s[0];
+                    d[3] = s[1];
+                    break;
+                case 3:
+                    d[0] = s[0];
+                    d[1] = s[1];
+                    d[2] = s[2];
+                    d[3] = 255;
+                    break;
+                default:
+                    std::memcpy(d, s, 4);
+                    break;
+            }
+        }
+
+        return result;
+    }
+
+    static void normalize(Image& image) {
+        u8* pixels = (u8*) image.pixels;
+        size_t pixelCount = (size_t) image.width * image.height;
+        for (size_t i = 0 ; i < pixelCount ; i++) {
+            u8* p = &pixels[i * 4];
+            glm::vec3 n = glm::vec3(p[0], p[1], p[2]) / 127.5f - 1.0f;
+            float length = glm::length(n);
+            n = length > 0 ? n / length : glm::vec3(0, 0, 1);
+            p[0] = (u8) std::lround((n.x + 1) * 127.5f);
+            p[1] = (u8) std::lround((n.y + 1) * 127.5f);
+            p[2] = (u8) std::lround((n.z + 1) * 127.5f);
+        }
+    }
+
+    BlockFormat TextureCooker::chooseFormat(const Image& image, const TextureCookSettings& settings) {
+        if (settings.normalMap) {
+            return BC5;
+        }
+
+        if (image.channels == 2 || image.channels == 4) {
+            const u8* pixels = (const u8*) image.pixels;
+            size_t pixelCount = (size_t) image.width * image.height;
+            for (size_t i = 0 ; i < pixelCount ; i++) {
+                if (pixels[i * image.channels + image.channels - 1] != 255) {
+                    return BC7;
+                }
+            }
+        }
+
+        return BC1;
+    }
+
+    bool TextureCooker::generateMips(const Image& image, const TextureCookSettings& settings, std::vector<Image>& mips) {
+        mips.clear();
+        // encoders take 8-bit RGBA, wider pixel types would need tone mapping and formats as BC6H
+        if (image.pixelType != PixelType::U8 || image.channels < 1 || image.channels > 4) {
+            error("TextureCooker: only U8 images with 1-4 channels can be cooked, pixel type {0} channels {1}", (u32) image.pixelType, image.channels);
+            return false;
+        }
+
+        mips.emplace_back(toRGBA(image));
+        if (settings.normalMap) {
+            normalize(mips.back());
+        }
+
+        if (!settings.mipmaps) {
+            return true;
+        }
+
+        // every level is filtered from the previous one, texture tiling is kept by wrapping edges
+        while (mips.back().width > 1 || mips.back().height > 1) {
+            Image mip;
+            if (!ImageKernels::downsample(mips.back(), mip, IMAGE_FILTER_KAISER, IMAGE_EDGE_WRAP)) {
+                return true;
+            }
+
+            if (settings.normalMap) {
+                normalize(mip);
+            }
+
+            mips.emplace_back(mip);
+        }
+        return true;
+    }
+
+    bool TextureCooker::cook(
+            const std::string& cookedFilepath,
+            const std::string& sourceFilepath,
+            const TextureCookSettings& settings,
+            CompressedImage& result
+    ) {
+        CookedTextureHeader header;
+        header.flags = settings.getFlags();
+
+        Image image = ImageReader::read(sourceFilepath.c_str(), settings.flipUV, PixelType::U8, settings.srgb);
+        if (!image.pixels) {
+            return false;
+        }
+
+        std::vector<Image> mips;
+        if (!generateMips(image, settings, mips)) {
+            image.free();
+            return false;
+        }
+
+        result.width = image.width;
+        result.height = image.height;
+        result.format = chooseFormat(image, settings);
+        result.srgb = settings.srgb;
+        result.mips.resize(mips.size());
+        image.free();
+
+        for (size_t i = 0 ; i < mips.size() ; i++) {
+            auto& mip = mips[i];
+            auto& compressedMip = result.mips[i];
+            compressedMip.width = mip.width;
+            compressedMip.height = mip.height;
+            BlockCompressor::compress((const u8*) mip.pixels, mip.width, mip.height, result.format, compressedMip.data);
+            mip.free();
+        }
+
+        header.format = result.format;
+        header.width = result.width;
+        header.height = result.height;
+        header.mipCount = result.mips.size();
+
+        BinaryStream stream;
+        stream.add(header);
+        for (auto& mip : result.mips) {
+            stream.add(mip.data.data(), mip.data.size());
+        }
+
+        // raw layout, mips are read at offsets of getMipOffset
+        if (!DerivedDataCache::store(cookedFilepath, stream)) {
+            error("Failed to store cooked texture {0}", sourceFilepath);
+        }
+
+        info("Cooked texture {0}: {1}x{2} {3}, {4} mips, {5} bytes",
+             sourceFilepath, result.width, result.height, FORMAT_NAMES[result.format], result.mips.size(), result.size());
+
+        return true;
+    }
+
+    size_t TextureCooker::getMipOffset(const CompressedImage& image, u32 level) {
+        size_t offset = sizeof(CookedTextureHeader);
+        for (u32 i = 0 ; i < level ; i++) {
+            offset += BlockCompressor::getSize(image.mips[i].width, image.mips[i].height, image.format);
+        }
+        return offset;
+    }
+
+    bool TextureCooker::load(
+            const std::string& cookedFilepath,
+            const TextureCookSettings& settings,
+            CompressedImage& result,
+            int maxResidentSize
+    ) {
+        std::ifstream file(cookedFilepath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        CookedTextureHeader header;
+        if (!file.read((char*) &header, sizeof(header))) {
+            return false;
+        }
+
+        if (header.magic != CookedTextureHeader::MAGIC || header.version != CookedTextureHeader::VERSION) {
+            info("Cooked texture {0} has unknown format, recooking", cookedFilepath);
+            return false;
+        }
+
+        if (header.flags != settings.getFlags()) {
+            info("Cooked texture {0} was cooked with different settings, recooking", cookedFilepath);
+            return false;
+        }
+
+        result.width = header.width;
+        result.height = header.height;
+        result.format = (BlockFormat) header.format;
+        result.srgb = settings.srgb;
+        result.mips.resize(header.mipCount);
+
+        int width = header.width;
+        int height = header.height;
+        for (auto& mip : result.mips) {
+            mip.width = width;
+            mip.height = height;
+            mip.data.clear();
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+
+        // only the tail of chain is read, finer mips keep their sizes and empty data
+        for (u32 level = 0 ; level < result.mips.size() ; level++) {
+            auto& mip = result.mips[level];
+            if (maxResidentSize > 0 && std::max(mip.width, mip.height) > maxResidentSize && level + 1 < result.mips.size()) {
+                continue;
+            }
+
+            mip.data.resize(BlockCompressor::getSize(mip.width, mip.height, result.format));
+            file.seekg(getMipOffset(result, level));
+            if (!file.read((char*) mip.data.data(), mip.data.size())) {
+                error("Cooked texture {0} is truncated, recooking", cookedFilepath);
+                result.mips.clear();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool TextureCooker::loadOrCook(
+            const std::string& cookedFilepath,
+            const std::string& sourceFilepath,
+            const TextureCookSettings& settings,
+            CompressedImage& result,
+            int maxResidentSize
+    ) {
+        if (load(cookedFilepath, settings, result, maxResidentSize)) {
+            return true;
+        }
+
+        if (!cook(cookedFilepath, sourceFilepath, settings, result)) {
+            return false;
+        }
+
+        if (maxResidentSize > 0) {
+            for (size_t level = 0 ; level + 1 < result.mips.size() ; level++) {
+                auto& mip = result.mips[level];
+                if (std::max(mip.width, mip.height) > maxResidentSize) {
+                    mip.data.clear();
+                    mip.data.shrink_to_fit();
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void TextureCooker::cookTexture(const std::string& filepath, const TextureCookSettings& settings) {
+        CompressedImage result;
+        if (!cook(getCookedPath(filepath, settings), filepath, settings, result)) {
+            return;
+        }
+
+        // quality of base level, measured against source on CPU
+        Image image = ImageReader::read(filepath.c_str(), settings.flipUV, PixelType::U8, settings.srgb);
+        if (!image.pixels) {
+            return;
+        }
+        std::vector<Image> mips;
+        TextureCookSettings baseSettings = settings;
+        baseSettings.mipmaps = false;
+        if (!generateMips(image, baseSettings, mips)) {
+            image.free();
+            return;
+        }
+        CompressionStats stats = BlockCompressor::measure((const u8*) mips[0].pixels, image.width, image.height, result.format);
+        info("Texture {0}: {1} PSNR {2} dB, RMSE {3}, encoded in {4} ms",
+             filepath, FORMAT_NAMES[result.format], stats.psnr, stats.rmse, stats.milliseconds);
+        mips[0].free();
+        image.free();
+    }
+
+}
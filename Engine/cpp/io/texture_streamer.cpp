@@ -0,0 +1,252 @@
+#include <io/texture_streamer.h>
+
+namespace gl {
+
+    std::unordered_map<u32, TextureStreamer::Texture> TextureStreamer::s_textures;
+    std::vector<TextureStreamer::MipLoad> TextureStreamer::s_loads;
+    u64 TextureStreamer::s_serial = 0;
+    TextureStreamerStats TextureStreamer::s_stats = { 0, 0, 512ull * 1024ull * 1024ull, 0, 0, 0, 0 };
+
+    void TextureStreamer::free() {
+        for (auto& load : s_loads) {
+            load.result.wait();
+        }
+        s_loads.clear();
+        s_textures.clear();
+        s_stats.bytes = 0;
+        s_stats.pendingBytes = 0;
+        s_stats.textures = 0;
+        s_stats.loads = 0;
+    }
+
+    void TextureStreamer::setBudget(size_t bytes) {
+        s_stats.budget = bytes;
+        makeRoom(0);
+    }
+
+    size_t TextureStreamer::getBytes(const Texture& texture, u32 level) {
+        auto& mip = texture.image.mips[level];
+        return BlockCompressor::getSize(mip.width, mip.height, texture.image.format);
+    }
+
+    void TextureStreamer::add(ImageBuffer& buffer, const std::string& cookedFilepath, const CompressedImage& image, const ImageParams& params) {
+        if (image.mips.empty()) {
+            return;
+        }
+
+        Texture texture;
+        texture.buffer = buffer;
+        texture.cookedFilepath = cookedFilepath;
+        texture.internalFormat = image.getInternalFormat();
+        texture.serial = ++s_serial;
+        texture.image.width = image.width;
+        texture.image.height = image.height;
+        texture.image.format = image.format;
+        texture.image.srgb = image.srgb;
+        texture.image.mips.resize(image.mips.size());
+
+        u32 lastMip = image.mips.size() - 1;
+        texture.tailMip = lastMip;
+        for (u32 level = 0 ; level <= lastMip ; level++) {
+            auto& mip = image.mips[level];
+            texture.image.mips[level].width = mip.width;
+            texture.image.mips[level].height = mip.height;
+            if (!mip.data.empty() && level < texture.tailMip) {
+                texture.tailMip = level;
+            }
+        }
+
+        buffer.bind();
+        for (u32 level = texture.tailMip ; level <= lastMip ; level++) {
+            buffer.loadMip(image.mips[level], level, texture.internalFormat);
+            s_stats.bytes += image.mips[level].data.size();
+        }
+        // streamed texture must stay mutable, so it's sampled through slots without bindless handle
+        buffer.updateParams(params, false, false);
+        buffer.setMipRange(texture.tailMip, lastMip);
+
+        texture.residentMip = texture.tailMip;
+        texture.desiredMip = texture.tailMip;
+        s_textures[buffer.id] = texture;
+        s_stats.textures++;
+    }
+
+    void TextureStreamer::remove(const ImageBuffer& buffer) {
+        auto it = s_textures.find(buffer.id);
+        if (it == s_textures.end()) {
+            return;
+        }
+
+        auto& texture = it->second;
+        for (u32 level = texture.residentMip ; level < texture.image.mips.size() ; level++) {
+            s_stats.bytes -= getBytes(texture, level);
+        }
+        s_textures.erase(it);
+        s_stats.textures--;
+    }
+
+    void TextureStreamer::request(u32 id, float uvPerPixel) {
+        auto it = s_textures.find(id);
+        if (it == s_textures.end()) {
+            return;
+        }
+
+        auto& texture = it->second;
+        float texelsPerPixel = (float) std::max(texture.image.width, texture.image.height) * uvPerPixel;
+        u32 mip = texelsPerPixel > 1.0f ? (u32) std::floor(std::log2(texelsPerPixel)) : 0;
+        mip = std::clamp(mip, texture.finestMip, texture.tailMip);
+        texture.desiredMip = std::min(texture.desiredMip, mip);
+    }
+
+    void TextureStreamer::update(Scene* scene, const Camera& camera) {
+        finishLoads();
+
+        for (auto& entry : s_textures) {
+            entry.second.desiredMip = entry.second.tailMip;
+        }
+
+        scene->eachComponent<TextureStreaming>([scene, &camera](TextureStreaming* streaming) {
+            EntityID entityId = streaming->entityId;
+            auto* transform = scene->getComponent<Transform>(entityId);
+            auto* material = scene->getComponent<Material>(entityId);
+            if (!transform || !material) {
+                return;
+            }
+
+            float scale = std::max(transform->scale.x, std::max(transform->scale.y, transform->scale.z));
+            glm::vec3 worldCenter = transform->translation + streaming->center * scale;
+            // distance to the closest point of bounding sphere, same as MeshLod
+            float distance = glm::length(worldCenter - camera.position) - streaming->radius * scale;
+            float uvPerPixel = streaming->uvDensity / (scale * camera.getPixelsPerUnit(distance));
+
+            const ImageBuffer* buffers[] = {
+                    &material->albedo, &material->normal, &material->parallax, &material->metallic,
+                    &material->roughness, &material->ao, &material->emission
+            };
+            for (auto* buffer : buffers) {
+                request(buffer->id, uvPerPixel);
+            }
+        });
+
+        requestLoads();
+    }
+
+    void TextureStreamer::finishLoads() {
+        for (size_t i = 0 ; i < s_loads.size() ;) {
+            auto& load = s_loads[i];
+            if (load.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                i++;
+                continue;
+            }
+
+            IOResult result = load.result.get();
+            CompressedMip& mip = *load.mip;
+            if (!result.success || result.bytes != mip.data.size()) {
+                mip.data.clear();
+            }
+            s_stats.pendingBytes -= load.bytes;
+
+            auto it = s_textures.find(load.id);
+            if (it != s_textures.end() && it->second.serial == load.serial) {
+                auto& texture = it->second;
+                texture.loading = false;
+                if (mip.data.empty()) {
+                    texture.finestMip = load.level + 1;
+                } else {
+                    texture.buffer.loadMip(mip, load.level, texture.internalFormat);
+                    texture.residentMip = load.level;
+                    texture.buffer.setMipRange(texture.residentMip, texture.image.mips.size() - 1);
+                    s_stats.bytes += load.bytes;
+                    s_stats.streamedIn++;
+                }
+            }
+
+            s_loads[i] = std::move(s_loads.back());
+            s_loads.pop_back();
+        }
+        s_stats.loads = s_loads.size();
+    }
+
+    void TextureStreamer::requestLoads() {
+        std::vector<Texture*> candidates;
+        for (auto& entry : s_textures) {
+            auto& texture = entry.second;
+            if (!texture.loading && texture.desiredMip < texture.residentMip) {
+                candidates.emplace_back(&texture);
+            }
+        }
+
+        // textures that are the furthest from their desired mip go first
+        std::sort(candidates.begin(), candidates.end(), [](const Texture* a, const Texture* b) {
+            return a->residentMip - a->desiredMip > b->residentMip - b->desiredMip;
+        });
+
+        for (auto* texture : candidates) {
+            if (s_loads.size() >= MAX_LOADS) {
+                break;
+            }
+
+            u32 level = texture->residentMip - 1;
+            size_t bytes = getBytes(*texture, level);
+            if (!makeRoom(bytes)) {
+                continue;
+            }
+
+            MipLoad load;
+            load.id = texture->buffer.id;
+            load.serial = texture->serial;
+            load.level = level;
+            load.bytes = bytes;
+            load.mip = std::make_shared<CompressedMip>(texture->image.mips[level]);
+            load.mip->data.resize(bytes);
+
+            IORequest request;
+            request.filepath = texture->cookedFilepath;
+            request.offset = TextureCooker::getMipOffset(texture->image, level);
+            request.size = bytes;
+            request.buffer = load.mip->data.data();
+            load.result = IOService::read(request);
+            s_loads.emplace_back(std::move(load));
+
+            texture->loading = true;
+            s_stats.pendingBytes += bytes;
+        }
+        s_stats.loads = s_loads.size();
+    }
+
+    bool TextureStreamer::makeRoom(size_t bytes) {
+        while (s_stats.bytes + s_stats.pendingBytes + bytes > s_stats.budget) {
+            // finest mip of texture that is the sharpest against its desired mip
+            Texture* victim = null;
+            u32 surplus = 0;
+            for (auto& entry : s_textures) {
+                auto& texture = entry.second;
+                if (!texture.loading && texture.residentMip < texture.desiredMip && texture.desiredMip - texture.residentMip > surplus) {
+                    victim = &texture;
+                    surplus = texture.desiredMip - texture.residentMip;
+                }
+            }
+
+            if (!victim) {
+                return false;
+            }
+
+            dropMip(*victim);
+        }
+        return true;
+    }
+
+    void TextureStreamer::dropMip(Texture& texture) {
+        u32 level = texture.residentMip;
+        texture.residentMip++;
+        texture.buffer.setMipRange(texture.residentMip, texture.image.mips.size() - 1);
+        texture.buffer.freeMip(level, texture.internalFormat);
+        s_stats.bytes -= getBytes(texture, level);
+        s_stats.streamedOut++;
+    }
+
+    const TextureStreamerStats& TextureStreamer::getStats() {
+        return s_stats;
+    }
+
+}
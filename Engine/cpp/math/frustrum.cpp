@@ -27,6 +27,37 @@ namespace gl {
 //        farBottomRight = { xFar, -yFar, zFar, 1.0f };
     }
 
+    static Plane extractPlane(const glm::mat4& m, int row, float sign) {
+        // Gribb-Hartmann, plane is 4th row +/- one of first three rows of matrix
+        glm::vec4 equation = {
+                m[0][3] + sign * m[0][row],
+                m[1][3] + sign * m[1][row],
+                m[2][3] + sign * m[2][row],
+                m[3][3] + sign * m[3][row]
+        };
+        float length = glm::length(glm::vec3(equation));
+        return Plane(equation.w / length, glm::vec3(equation) / length);
+    }
+
+    void Frustum::init(const glm::mat4& viewProjection) {
+        leftFace = extractPlane(viewProjection, 0, 1);
+        rightFace = extractPlane(viewProjection, 0, -1);
+        bottomFace = extractPlane(viewProjection, 1, 1);
+        topFace = extractPlane(viewProjection, 1, -1);
+        nearFace = extractPlane(viewProjection, 2, 1);
+        farFace = extractPlane(viewProjection, 2, -1);
+    }
+
+    bool Frustum::intersects(const Sphere& sphere) const {
+        const Plane* planes[6] = { &leftFace, &rightFace, &bottomFace, &topFace, &nearFace, &farFace };
+        for (const Plane* plane : planes) {
+            if (plane->signedDistance(sphere.center) < -sphere.radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     void Frustum::fill(AABB& aabb) const {
 //        aabb.add(nearTopLeft);
 //        aabb.add(nearBottomLeft);
@@ -1,6 +1,8 @@
 #include <network/tcp/tcp_receiver.h>
 #include <network/tcp/tcp_client.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     void TCPReceiver::init() {
@@ -15,6 +17,7 @@ namespace gl {
         if (!m_running) {
             m_running = true;
             std::thread runThread([this]() {
+                Profiler::setThreadName("TCPReceiver");
                 runImpl();
             });
             runThread.detach();
@@ -23,6 +26,7 @@ namespace gl {
 
     void TCPReceiver::runImpl() {
         while (m_running) {
+            PROFILE_SCOPE("TCPReceiver");
 
             memset(m_buffer, 0, m_bufferSize);
 
@@ -1,5 +1,7 @@
 #include <network/tcp/tcp_server.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     TCPServer::TCPServer(const Address& address) {
@@ -70,6 +72,7 @@ namespace gl {
 
     void TCPServer::runImpl() {
         while (m_listening) {
+            PROFILE_SCOPE("TCPServer");
             memset(m_buffer, 0, m_bufferSize);
 
             // receive buffer from client
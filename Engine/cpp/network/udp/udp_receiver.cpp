@@ -1,6 +1,8 @@
 #include <network/udp/udp_receiver.h>
 #include <network/udp/udp_client.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     void UDPReceiver::init() {
@@ -15,6 +17,7 @@ namespace gl {
         if (!m_running) {
             m_running = true;
             std::thread runThread([this]() {
+                Profiler::setThreadName("UDPReceiver");
                 runImpl();
             });
             runThread.detach();
@@ -23,6 +26,7 @@ namespace gl {
 
     void UDPReceiver::runImpl() {
         while (m_running) {
+            PROFILE_SCOPE("UDPReceiver");
 
             memset(m_buffer, 0, m_bufferSize);
 
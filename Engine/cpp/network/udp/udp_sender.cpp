@@ -1,12 +1,15 @@
 #include <network/udp/udp_sender.h>
 #include <network/udp/udp_client.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     void UDPSender::run() {
         if (!m_running) {
             m_running = true;
             std::thread runThread([this]() {
+                Profiler::setThreadName("UDPSender");
                 runImpl();
             });
             runThread.detach();
@@ -24,6 +27,7 @@ namespace gl {
                 std::this_thread::yield();
             }
 
+            PROFILE_SCOPE("UDPSender");
             NetworkStream& stream = m_queue->front();
             auto response = m_client->send(stream.data(), stream.size() + 1, 0);
 
@@ -1,5 +1,7 @@
 #include <network/udp/udp_server.h>
 
+#include <debugging/profiler.h>
+
 namespace gl {
 
     UDPServer::UDPServer(const Address& address) {
@@ -70,6 +72,7 @@ namespace gl {
 
     void UDPServer::runImpl() {
         while (m_listening) {
+            PROFILE_SCOPE("UDPServer");
             memset(m_buffer, 0, m_bufferSize);
 
             // receive buffer from client
@@ -1,6 +1,9 @@
 #include <features/lighting/environment.h>
+#include <api/state_cache.h>
 #include <geometry/cube.h>
 
+#include <io/derived_data_cache.h>
+
 namespace gl {
 
     // create unit cube projection and view
@@ -43,6 +46,11 @@ namespace gl {
         prefilter.loadCubemap(prefilter_image, params);
     }
 
+    void Environment::setHDR(const std::string& filepath, bool flipUV) {
+        hdrFilepath = filepath;
+        hdrFlipUV = flipUV;
+    }
+
     void Environment::free() {
         hdr.free();
         skybox.free();
@@ -128,9 +136,153 @@ namespace gl {
         mDrawable.free();
     }
 
+    static constexpr u32 IBL_CACHE_MAGIC = 0x4C424947; // GIBL
+    static constexpr u32 IBL_CACHE_VERSION = 1;
+
+    // maps are cached as half floats, the same precision as their RGB16F and RG16F storage
+    static size_t getLevelSize(int width, int height, int channels) {
+        return (size_t) width * height * channels * sizeof(u16);
+    }
+
+    static void readLevel(u32 target, int level, int width, int height, int channels, BinaryStream& stream) {
+        std::vector<u16> pixels(getLevelSize(width, height, channels) / sizeof(u16));
+        glGetTexImage(target, level, channels == 2 ? GL_RG : GL_RGB, GL_HALF_FLOAT, pixels.data());
+        stream.add(pixels.data(), pixels.size() * sizeof(u16));
+    }
+
+    static void writeLevel(u32 target, int level, int width, int height, int channels, BinaryStream& stream) {
+        std::vector<u16> pixels(getLevelSize(width, height, channels) / sizeof(u16));
+        stream.get(pixels.data(), pixels.size() * sizeof(u16));
+        glTexSubImage2D(target, level, 0, 0, width, height, channels == 2 ? GL_RG : GL_RGB, GL_HALF_FLOAT, pixels.data());
+    }
+
+    std::string EnvRenderer::getCachePath() {
+        if (environment->hdrFilepath.empty()) {
+            return "";
+        }
+
+        // maps depend on every stage of conversion shaders and their includes as much as on hdr itself
+        std::stringstream settings;
+        settings << environment->hdrFlipUV
+        << "|" << environment->resolution.x << "," << environment->resolution.y
+        << "|" << environment->irradianceResolution.x << "," << environment->irradianceResolution.y
+        << "|" << environment->prefilterResolution.x << "," << environment->prefilterResolution.y
+        << "|" << environment->prefilterLevels
+        << "|" << mHdrToCubemapShader.getSourceHash()
+        << "," << mHdrIrradianceShader.getSourceHash()
+        << "," << mHdrPrefilterConvolutionShader.getSourceHash()
+        << "," << mBrdfConvolutionShader.getSourceHash()
+        << "|" << IBL_CACHE_VERSION;
+
+        return DerivedDataCache::getPath("environments", environment->hdrFilepath, settings.str(), ".gibl");
+    }
+
+    bool EnvRenderer::loadCached(const std::string& cachePath) {
+        BinaryStream stream;
+        if (!DerivedDataCache::load(cachePath, stream)) {
+            return false;
+        }
+
+        glm::ivec2 resolution = environment->resolution;
+        glm::ivec2 irradianceResolution = environment->irradianceResolution;
+        glm::ivec2 prefilterResolution = environment->prefilterResolution;
+
+        size_t expectedSize = sizeof(u32) * 2;
+        expectedSize += 6 * getLevelSize(resolution.x, resolution.y, 3);
+        expectedSize += 6 * getLevelSize(irradianceResolution.x, irradianceResolution.y, 3);
+        for (int mip = 0 ; mip < environment->prefilterLevels ; mip++) {
+            expectedSize += 6 * getLevelSize(prefilterResolution.x >> mip, prefilterResolution.y >> mip, 3);
+        }
+        expectedSize += getLevelSize(resolution.x, resolution.y, 2);
+
+        u32 magic = 0;
+        u32 version = 0;
+        if (stream.size() == expectedSize) {
+            stream.get(magic);
+            stream.get(version);
+        }
+        if (magic != IBL_CACHE_MAGIC || version != IBL_CACHE_VERSION) {
+            return false;
+        }
+
+        ImageBuffer::setUnpackAlignment(1);
+
+        environment->skybox.bind();
+        for (int i = 0 ; i < 6 ; i++) {
+            writeLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, resolution.x, resolution.y, 3, stream);
+        }
+        environment->skybox.generateMipmaps(environment->params);
+
+        environment->irradiance.bind();
+        for (int i = 0 ; i < 6 ; i++) {
+            writeLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, irradianceResolution.x, irradianceResolution.y, 3, stream);
+        }
+
+        environment->prefilter.bind();
+        for (int mip = 0 ; mip < environment->prefilterLevels ; mip++) {
+            for (int i = 0 ; i < 6 ; i++) {
+                writeLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, prefilterResolution.x >> mip, prefilterResolution.y >> mip, 3, stream);
+            }
+        }
+
+        environment->brdfConvolution.bind();
+        writeLevel(GL_TEXTURE_2D, 0, resolution.x, resolution.y, 2, stream);
+
+        ImageBuffer::setUnpackAlignment(4);
+
+        return true;
+    }
+
+    void EnvRenderer::storeCached(const std::string& cachePath) {
+        glm::ivec2 resolution = environment->resolution;
+        glm::ivec2 irradianceResolution = environment->irradianceResolution;
+        glm::ivec2 prefilterResolution = environment->prefilterResolution;
+
+        BinaryStream stream;
+        u32 magic = IBL_CACHE_MAGIC;
+        u32 version = IBL_CACHE_VERSION;
+        stream.add(magic);
+        stream.add(version);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        environment->skybox.bind();
+        for (int i = 0 ; i < 6 ; i++) {
+            readLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, resolution.x, resolution.y, 3, stream);
+        }
+
+        environment->irradiance.bind();
+        for (int i = 0 ; i < 6 ; i++) {
+            readLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, irradianceResolution.x, irradianceResolution.y, 3, stream);
+        }
+
+        environment->prefilter.bind();
+        for (int mip = 0 ; mip < environment->prefilterLevels ; mip++) {
+            for (int i = 0 ; i < 6 ; i++) {
+                readLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, prefilterResolution.x >> mip, prefilterResolution.y >> mip, 3, stream);
+            }
+        }
+
+        environment->brdfConvolution.bind();
+        readLevel(GL_TEXTURE_2D, 0, resolution.x, resolution.y, 2, stream);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        DerivedDataCache::store(cachePath, stream);
+    }
+
     void EnvRenderer::generate() {
         if (!environment) return;
 
+        std::string cachePath = getCachePath();
+        if (!cachePath.empty() && loadCached(cachePath)) {
+            return;
+        }
+
+        if (environment->hdr.id == InvalidImageBuffer && !environment->hdrFilepath.empty()) {
+            environment->hdr.loadHDR(environment->hdrFilepath.c_str(), environment->hdrFlipUV);
+        }
+
         mFrame.bind();
         // create HDR skybox cube map
         glViewport(0, 0, environment->resolution.x, environment->resolution.y);
@@ -203,16 +355,20 @@ namespace gl {
         mDrawable.draw();
 
         FrameBuffer::unbind();
+
+        if (!cachePath.empty()) {
+            storeCached(cachePath);
+        }
     }
 
     void EnvRenderer::render() {
         if (environment && environment->enable) {
-            glDepthFunc(GL_LEQUAL);
+            StateCache::setDepthFunc(GL_LEQUAL);
             mEnvShader.use();
             environment->skybox.activate(0);
             environment->skybox.bind();
             mEnvCube.draw();
-            glDepthFunc(GL_LESS);
+            StateCache::setDepthFunc(GL_LESS);
         }
     }
 
@@ -1,4 +1,9 @@
 #include <pbr/pbr.h>
+#include <api/state_cache.h>
+
+#include <features/draw_storage.h>
+
+#include <debugging/profiler.h>
 
 namespace gl {
 
@@ -12,6 +17,15 @@ namespace gl {
             ImageSampler { "ssao", 8 }
     };
 
+    static constexpr UniformHandle<int> ENVLIGHT_PREFILTER_LEVELS = { "envlight", "prefilter_levels" };
+    static constexpr SamplerHandle ENVLIGHT_IRRADIANCE = { "envlight", "irradiance" };
+    static constexpr SamplerHandle ENVLIGHT_PREFILTER = { "envlight", "prefilter" };
+    static constexpr SamplerHandle ENVLIGHT_BRDF_CONVOLUTION = { "envlight", "brdf_convolution" };
+
+    static constexpr SamplerHandle DIRECT_SHADOW_SAMPLER = "direct_shadow_sampler";
+    static constexpr UniformHandle<glm::mat4> DIRECT_LIGHT_SPACE = "direct_light_space";
+    static constexpr UniformHandle<int> SHADOW_FILTER_SIZE = "shadow_filter_size";
+
     PBR_Skeletal_ForwardRenderer::PBR_Skeletal_ForwardRenderer() {
         mShader.addVertexStage("shaders/skeletal.vert");
         mShader.addFragmentStage("shaders/pbr.frag");
@@ -20,10 +34,10 @@ namespace gl {
 
     void PBR_Skeletal_ForwardRenderer::update(Environment* env) {
         mShader.use();
-        mShader.setUniformStructArgs("envlight", "prefilter_levels", env->prefilterLevels);
-        mShader.bindSamplerStruct("envlight", "irradiance", 16, env->irradiance);
-        mShader.bindSamplerStruct("envlight", "prefilter", 17, env->prefilter);
-        mShader.bindSamplerStruct("envlight", "brdf_convolution", 18, env->brdfConvolution);
+        mShader.setUniform(ENVLIGHT_PREFILTER_LEVELS, env->prefilterLevels);
+        mShader.bindSampler(ENVLIGHT_IRRADIANCE, 16, env->irradiance);
+        mShader.bindSampler(ENVLIGHT_PREFILTER, 17, env->prefilter);
+        mShader.bindSampler(ENVLIGHT_BRDF_CONVOLUTION, 18, env->brdfConvolution);
     }
 
     PBR_Skeletal_DeferredRenderer::PBR_Skeletal_DeferredRenderer() {
@@ -34,10 +48,10 @@ namespace gl {
 
     void PBR_Skeletal_DeferredRenderer::update(Environment* env) {
         mShader.use();
-        mShader.setUniformStructArgs("envlight", "prefilter_levels", env->prefilterLevels);
-        mShader.bindSamplerStruct("envlight", "irradiance", 16, env->irradiance);
-        mShader.bindSamplerStruct("envlight", "prefilter", 17, env->prefilter);
-        mShader.bindSamplerStruct("envlight", "brdf_convolution", 18, env->brdfConvolution);
+        mShader.setUniform(ENVLIGHT_PREFILTER_LEVELS, env->prefilterLevels);
+        mShader.bindSampler(ENVLIGHT_IRRADIANCE, 16, env->irradiance);
+        mShader.bindSampler(ENVLIGHT_PREFILTER, 17, env->prefilter);
+        mShader.bindSampler(ENVLIGHT_BRDF_CONVOLUTION, 18, env->brdfConvolution);
     }
 
     PBR_ForwardRenderer::PBR_ForwardRenderer(int width, int height) {
@@ -84,37 +98,45 @@ namespace gl {
 
     void PBR_ForwardRenderer::bind() {
         mFrame.bind();
-        glDepthFunc(GL_LESS);
-        glDepthMask(GL_TRUE);
+        StateCache::setDepthFunc(GL_LESS);
+        StateCache::setDepthMask(GL_TRUE);
     }
 
     void PBR_ForwardRenderer::use() {
         mShader.use();
-    }
-
-    void PBR_ForwardRenderer::update(Environment* env) {
-        mShader.use();
-        mShader.setUniformStructArgs("envlight", "prefilter_levels", env->prefilterLevels);
-        mShader.bindSamplerStruct("envlight", "irradiance", 16, env->irradiance);
-        mShader.bindSamplerStruct("envlight", "prefilter", 17, env->prefilter);
-        mShader.bindSamplerStruct("envlight", "brdf_convolution", 18, env->brdfConvolution);
-    }
 
-    void PBR_ForwardRenderer::render(Transform& transform, DrawableElements& drawable, Material& material) {
+        // shadow parameters are the same for every draw of frame
         if (!directShadow->lightSpaces.empty()) {
-            mShader.bindSampler("direct_shadow_sampler", 0, directShadow->map.buffer);
-            mShader.setUniformArgs("direct_light_space", directShadow->lightSpaces[0]);
-            mShader.setUniformArgs("shadow_filter_size", directShadow->filterSize);
+            mShader.bindSampler(DIRECT_SHADOW_SAMPLER, 0, directShadow->map.buffer);
+            mShader.setUniform(DIRECT_LIGHT_SPACE, directShadow->lightSpaces[0]);
+            mShader.setUniform(SHADOW_FILTER_SIZE, directShadow->filterSize);
         }
 
 //        m_shader.bindSampler("point_shadow_sampler", 1, pointShadow->map.buffer);
 //        m_shader.setUniformArgs("far_plane", pointShadow->zFar);
+    }
+
+    void PBR_ForwardRenderer::update(Environment* env) {
+        mShader.use();
+        mShader.setUniform(ENVLIGHT_PREFILTER_LEVELS, env->prefilterLevels);
+        mShader.bindSampler(ENVLIGHT_IRRADIANCE, 16, env->irradiance);
+        mShader.bindSampler(ENVLIGHT_PREFILTER, 17, env->prefilter);
+        mShader.bindSampler(ENVLIGHT_BRDF_CONVOLUTION, 18, env->brdfConvolution);
+    }
 
-        transform.update(mShader);
-        material.update(mShader, 0);
+    void PBR_ForwardRenderer::render(Transform& transform, DrawableElements& drawable, Material& material) {
+        u32 index = DrawStorage::push(transform, drawable, material);
+        if (index == InvalidDrawIndex) return;
+        DrawStorage::bind(mShader, index);
+        // slot 0 is taken by direct shadow map
+        material.update(mShader, 1);
         drawable.draw();
     }
 
+    void PBR_ForwardRenderer::render(DrawBatcher& batcher) {
+        batcher.draw(mShader, 1);
+    }
+
     PBR_DeferredRenderer::PBR_DeferredRenderer(int width, int height, SsaoRenderer* ssaoRenderer)
     : mSsaoRenderer(ssaoRenderer) {
         mGeometryShader.addVertexStage("shaders/pbr_material.vert");
@@ -284,8 +306,8 @@ namespace gl {
     }
 
     void PBR_DeferredRenderer::unbind() {
-        glDisable(GL_STENCIL_TEST);
-        glDisable(GL_BLEND);
+        StateCache::disable(GL_STENCIL_TEST);
+        StateCache::disable(GL_BLEND);
 
         // render SSAO
         if (mSsaoRenderer->isEnabled) {
@@ -300,10 +322,10 @@ namespace gl {
         mLightShader.use();
 
         int samplers_size = samplers.size();
-        mLightShader.bindSampler("direct_shadow_sampler", 0, directShadow->map.buffer);
+        mLightShader.bindSampler(DIRECT_SHADOW_SAMPLER, 0, directShadow->map.buffer);
         mLightShader.bindSampler("point_shadow_sampler", 1, pointShadow->map.buffer);
         mLightShader.setUniformArgs("far_plane", pointShadow->zFar);
-        mLightShader.setUniformArgs("shadow_filter_size", directShadow->filterSize);
+        mLightShader.setUniform(SHADOW_FILTER_SIZE, directShadow->filterSize);
 
         for (int i = 0 ; i < samplers_size - 1 ; i++) {
             mLightShader.bindSampler(samplers[i], mGeometryFrame.colors[i].buffer);
@@ -316,30 +338,36 @@ namespace gl {
 
         mDrawable.draw();
 
-        glEnable(GL_STENCIL_TEST);
-        glEnable(GL_BLEND);
+        StateCache::enable(GL_STENCIL_TEST);
+        StateCache::enable(GL_BLEND);
     }
 
     void PBR_DeferredRenderer::use() {
         mGeometryShader.use();
-    }
 
-    void PBR_DeferredRenderer::render(Transform& transform, DrawableElements& drawable, Material& material) {
         if (!directShadow->lightSpaces.empty()) {
-            mGeometryShader.setUniformArgs("direct_light_space", directShadow->lightSpaces[0]);
+            mGeometryShader.setUniform(DIRECT_LIGHT_SPACE, directShadow->lightSpaces[0]);
         }
+    }
 
-        transform.update(mGeometryShader);
+    void PBR_DeferredRenderer::render(Transform& transform, DrawableElements& drawable, Material& material) {
+        u32 index = DrawStorage::push(transform, drawable, material);
+        if (index == InvalidDrawIndex) return;
+        DrawStorage::bind(mGeometryShader, index);
         material.update(mGeometryShader, 0);
         drawable.draw();
     }
 
+    void PBR_DeferredRenderer::render(DrawBatcher& batcher) {
+        batcher.draw(mGeometryShader);
+    }
+
     void PBR_DeferredRenderer::update(Environment* env) {
         mLightShader.use();
-        mLightShader.setUniformStructArgs("envlight", "prefilter_levels", env->prefilterLevels);
-        mLightShader.bindSamplerStruct("envlight", "irradiance", 16, env->irradiance);
-        mLightShader.bindSamplerStruct("envlight", "prefilter", 17, env->prefilter);
-        mLightShader.bindSamplerStruct("envlight", "brdf_convolution", 18, env->brdfConvolution);
+        mLightShader.setUniform(ENVLIGHT_PREFILTER_LEVELS, env->prefilterLevels);
+        mLightShader.bindSampler(ENVLIGHT_IRRADIANCE, 16, env->irradiance);
+        mLightShader.bindSampler(ENVLIGHT_PREFILTER, 17, env->prefilter);
+        mLightShader.bindSampler(ENVLIGHT_BRDF_CONVOLUTION, 18, env->brdfConvolution);
     }
 
     void PBR_DeferredRenderer::blitColorDepth(int w, int h, u32 srcColorFrame, u32 srcDepthFrame) const {
@@ -369,6 +397,8 @@ namespace gl {
         mSkeletalForwardRenderer = new PBR_Skeletal_ForwardRenderer();
         mSkeletalDeferredRenderer = new PBR_Skeletal_DeferredRenderer();
 
+        mOpaqueBatcher.pass = RENDER_PASS_OPAQUE;
+        mTransparentBatcher.pass = RENDER_PASS_TRANSPARENT;
     }
 
     PBR_Pipeline::~PBR_Pipeline() {
@@ -376,6 +406,14 @@ namespace gl {
         delete mPbrDeferredRenderer;
         delete mSkeletalForwardRenderer;
         delete mSkeletalDeferredRenderer;
+        mOpaqueBatcher.free();
+        mTransparentBatcher.free();
+    }
+
+    RenderQueueStats PBR_Pipeline::getRenderQueueStats() const {
+        RenderQueueStats stats = mOpaqueBatcher.getQueueStats();
+        stats += mTransparentBatcher.getQueueStats();
+        return stats;
     }
 
     void PBR_Pipeline::setEnvironment(Environment* environment) {
@@ -399,20 +437,27 @@ namespace gl {
     }
 
     void PBR_Pipeline::renderForward() {
+        PROFILE_PASS("Forward");
         mPbrForwardRenderer->bind();
 
-        glDisable(GL_CULL_FACE);
+        StateCache::disable(GL_CULL_FACE);
         mEnvRenderer->render();
-        glEnable(GL_CULL_FACE);
+        StateCache::enable(GL_CULL_FACE);
 
         renderTransparent();
     }
 
     void PBR_Pipeline::renderTransparent() {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        PROFILE_PASS("Transparent");
+        StateCache::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         mPbrForwardRenderer->use();
 
+        // alpha blending depends on order, batches are sorted back to front
+        mTransparentBatcher.clear();
+        if (camera) {
+            mTransparentBatcher.viewPosition = camera->position;
+        }
         scene->eachComponent<Transparent>([this](Transparent* transparent) {
             EntityID entityId = transparent->entityId;
             auto& transform = *scene->getComponent<Transform>(entityId);
@@ -433,34 +478,45 @@ namespace gl {
                 mOutlineRenderer->unbind();
                 mPbrForwardRenderer->use();
             } else {
-                mPbrForwardRenderer->render(transform, drawable, material);
+                mTransparentBatcher.add(transform, drawable, &material);
             }
         });
+
+        mTransparentBatcher.build();
+        mPbrForwardRenderer->render(mTransparentBatcher);
     }
 
     void PBR_Pipeline::renderDeferred() {
+        PROFILE_PASS("Deferred");
         mPbrDeferredRenderer->bind();
 
         mPbrDeferredRenderer->use();
 
         // render terrain
         if (terrain) {
-            glCullFace(GL_FRONT);
+            StateCache::setCullFace(GL_FRONT);
             mPbrDeferredRenderer->render(
                     terrain->transform,
                     terrain->drawable,
                     terrain->material
             );
-            glCullFace(GL_BACK);
+            StateCache::setCullFace(GL_BACK);
         }
 
-        // render scene
-        scene->eachComponent<Opaque>([this](Opaque* opaque) {
+        // render scene, entities without outline are batched and drawn instanced front to back afterwards
+        mOpaqueBatcher.clear();
+        Frustum frustum;
+        if (camera) {
+            mOpaqueBatcher.viewPosition = camera->position;
+            frustum = camera->frustrum();
+        }
+        scene->eachComponent<Opaque>([this, &frustum](Opaque* opaque) {
             EntityID entityId = opaque->entityId;
             auto& transform = *scene->getComponent<Transform>(entityId);
             auto& drawable = *scene->getComponent<DrawableElements>(entityId);
             auto& material = *scene->getComponent<Material>(entityId);
             auto* outline = scene->getComponent<Outline>(entityId);
+            auto* meshlets = camera ? scene->getComponent<MeshletCulling>(entityId) : null;
 
             if (outline) {
                 mOutlineRenderer->unbind();
@@ -474,11 +530,16 @@ namespace gl {
                 // reset renderer state
                 mOutlineRenderer->unbind();
                 mPbrDeferredRenderer->use();
+            } else if (meshlets && meshlets->cull(mMeshletRanges, transform, drawable, frustum, &camera->position)) {
+                mOpaqueBatcher.add(transform, drawable, mMeshletRanges, &material);
             } else {
-                mPbrDeferredRenderer->render(transform, drawable, material);
+                mOpaqueBatcher.add(transform, drawable, &material);
             }
         });
 
+        mOpaqueBatcher.build();
+        mPbrDeferredRenderer->render(mOpaqueBatcher);
+
         // todo handle skeletal animation rendering
 //        mSkeletalDeferredRenderer->use();
 //        scene->eachComponent<SkeletalComponent>([this](SkeletalComponent* component) {
@@ -494,6 +555,7 @@ namespace gl {
     }
 
     void PBR_Pipeline::render() {
+        PROFILE_PASS("PBR");
         renderDeferred();
         mPbrForwardRenderer->blitColorDepth(
                 mResolution.x, mResolution.y,
@@ -1,4 +1,5 @@
 #include <postfx/bloom.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -58,7 +59,6 @@ namespace gl {
 
         mDrawable.init();
 
-        initMixColor();
         initMips();
         mFrame.colors = {mMips[0] };
         mFrame.init();
@@ -66,7 +66,6 @@ namespace gl {
         mFrame.complete();
 
         mMixShader.bloomBuffer = mFrame.colors[0].buffer;
-        mRenderTarget = mMixColor.buffer;
     }
 
     BloomRenderer::~BloomRenderer() {
@@ -76,29 +75,11 @@ namespace gl {
         mMixShader.free();
         mDrawable.free();
 
-        mMixColor.free();
         for (auto& mip : mMips) {
             mip.free();
         }
     }
 
-    void BloomRenderer::initMixColor() {
-        // data
-        mMixColor.image.width = mResolution.x;
-        mMixColor.image.height = mResolution.y;
-        mMixColor.image.internalFormat = GL_RGB16F;
-        mMixColor.image.pixelFormat = GL_RGB;
-        mMixColor.image.pixelType = PixelType::FLOAT;
-        // filter
-        mMixColor.params.s = GL_CLAMP_TO_EDGE;
-        mMixColor.params.t = GL_CLAMP_TO_EDGE;
-        mMixColor.params.r = GL_CLAMP_TO_EDGE;
-        mMixColor.params.minFilter = GL_LINEAR;
-        mMixColor.params.magFilter = GL_LINEAR;
-
-        mMixColor.init();
-    }
-
     void BloomRenderer::initMips() {
         if (mipLevels <= 0)
             mipLevels = 1;
@@ -137,25 +118,25 @@ namespace gl {
 
         mFrame.bind();
 
-        mMixColor.free();
         for (auto& mip : mMips) {
             mip.free();
         }
 
-        initMixColor();
         initMips();
 
         mFrame.colors = {mMips[0] };
         mFrame.attachColors();
         mFrame.complete();
+
+        mMixShader.bloomBuffer = mFrame.colors[0].buffer;
     }
 
-    void BloomRenderer::render() {
+    void BloomRenderer::render(const FrameBuffer& frame) {
         mFrame.bind();
         FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT);
         renderDownsample();
         renderUpsample();
-        renderMix();
+        renderMix(frame);
     }
 
     void BloomRenderer::renderDownsample() {
@@ -192,9 +173,9 @@ namespace gl {
 
     void BloomRenderer::renderUpsample() {
         // Enable additive blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
-        glBlendEquation(GL_FUNC_ADD);
+        StateCache::enable(GL_BLEND);
+        StateCache::setBlendFunc(GL_ONE, GL_ONE);
+        StateCache::setBlendEquation(GL_FUNC_ADD);
 
         mUpsampleShader.use();
         mUpsampleShader.update();
@@ -211,11 +192,11 @@ namespace gl {
             mDrawable.draw();
         }
 
-        glDisable(GL_BLEND);
+        StateCache::disable(GL_BLEND);
     }
 
-    void BloomRenderer::renderMix() {
-        mMixColor.attach();
+    void BloomRenderer::renderMix(const FrameBuffer& frame) {
+        frame.bind();
         glViewport(0, 0, mResolution.x, mResolution.y);
         FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT);
 
@@ -19,30 +19,18 @@ namespace gl {
         setUniform(params.offset);
     }
 
-    BlurRenderer::BlurRenderer(int w, int h) {
+    BlurRenderer::BlurRenderer() {
         mShader.init();
         mDrawable.init();
-
-        mFrame.colors = { initColor(w, h) };
-        mFrame.init();
-        mFrame.attachColors();
-        mFrame.complete();
-
-        mRenderTarget = mFrame.colors[0].buffer;
     }
 
     BlurRenderer::~BlurRenderer() {
-        mFrame.free();
         mShader.free();
         mDrawable.free();
     }
 
-    void BlurRenderer::resize(int w, int h) {
-        mFrame.resize(w, h);
-    }
-
-    void BlurRenderer::render() {
-        mFrame.bind();
+    void BlurRenderer::render(const FrameBuffer& frame) {
+        frame.bind();
         FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT);
 
         mShader.use();
@@ -54,13 +42,4 @@ namespace gl {
         mShader.updateOffset();
     }
 
-    ColorAttachment BlurRenderer::initColor(int width, int height) {
-        ColorAttachment color = { 0, width, height };
-        color.image.internalFormat = GL_RGB;
-        color.image.pixelFormat = GL_RGB;
-        color.image.pixelType = PixelType::U8;
-        color.init();
-        return color;
-    }
-
 }
\ No newline at end of file
@@ -20,13 +20,6 @@ namespace gl {
         mShader.init();
         mDrawable.init();
 
-        mFrame.colors = { initColor(width, height) };
-        mFrame.init();
-        mFrame.attachColors();
-        mFrame.complete();
-
-        mRenderTarget = mFrame.colors[0].buffer;
-
         mShader.params.inverseFilterSize.value = {
                 1.0f / static_cast<float>(width),
                 1.0f / static_cast<float>(height),
@@ -37,11 +30,9 @@ namespace gl {
     FXAARenderer::~FXAARenderer() {
         mDrawable.free();
         mShader.free();
-        mFrame.free();
     }
 
     void FXAARenderer::resize(int width, int height) {
-        mFrame.resize(width, height);
         mShader.params.inverseFilterSize.value = {
                 1.0f / static_cast<float>(width),
                 1.0f / static_cast<float>(height),
@@ -49,8 +40,8 @@ namespace gl {
         };
     }
 
-    void FXAARenderer::render() {
-        mFrame.bind();
+    void FXAARenderer::render(const FrameBuffer& frame) {
+        frame.bind();
         FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT);
 
         mShader.use();
@@ -59,23 +50,4 @@ namespace gl {
         mDrawable.draw();
     }
 
-    ColorAttachment FXAARenderer::initColor(int width, int height) {
-        ColorAttachment color;
-
-        // data
-        color.image.width = width;
-        color.image.height = height;
-        color.image.internalFormat = GL_RGB;
-        color.image.pixelFormat = GL_RGB;
-        color.image.pixelType = PixelType::U8;
-
-        // filter
-        color.params.minFilter = GL_LINEAR;
-        color.params.magFilter = GL_LINEAR;
-
-        color.init();
-
-        return color;
-    }
-
 }
\ No newline at end of file
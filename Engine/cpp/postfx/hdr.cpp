@@ -25,31 +25,19 @@ namespace gl {
         setUniform(params.shinyStrength);
     }
 
-    HdrRenderer::HdrRenderer(int width, int height) {
+    HdrRenderer::HdrRenderer() {
         mShader.init();
         mDrawable.init();
-
-        mFrame.colors = { initColor(width, height) };
-        mFrame.init();
-        mFrame.attachColors();
-        mFrame.complete();
-
-        mRenderTarget = mFrame.colors[0].buffer;
     }
 
     HdrRenderer::~HdrRenderer() {
         mDrawable.free();
         mShader.free();
-        mFrame.free();
         mShader.params.shinyBuffer.free();
     }
 
-    void HdrRenderer::resize(int w, int h) {
-        mFrame.resize(w, h);
-    }
-
-    void HdrRenderer::render() {
-        mFrame.bind();
+    void HdrRenderer::render(const FrameBuffer& frame) {
+        frame.bind();
         FrameBuffer::clearBuffer(COLOR_CLEAR, GL_COLOR_BUFFER_BIT);
 
         mShader.use();
@@ -66,23 +54,4 @@ namespace gl {
         mShader.updateShinyStrength();
     }
 
-    ColorAttachment HdrRenderer::initColor(int width, int height) {
-        ColorAttachment color;
-
-        // data
-        color.image.width = width;
-        color.image.height = height;
-        color.image.internalFormat = GL_RGB;
-        color.image.pixelFormat = GL_RGB;
-        color.image.pixelType = PixelType::U8;
-
-        // filter
-        color.params.minFilter = GL_LINEAR;
-        color.params.magFilter = GL_LINEAR;
-
-        color.init();
-
-        return color;
-    }
-
 }
\ No newline at end of file
@@ -29,11 +29,19 @@ namespace gl {
         bitmap.free();
         buffer.free();
         FT_Done_Face(face);
+        mFaceData.reset();
         delete[] mWidths;
     }
 
     bool FontAtlas::loadFace(const char* filepath, Font& font) {
-        FT_Error error = FT_New_Face(sLib, filepath, 0, &font.face);
+        font.mFaceData = std::make_shared<FileBlob>();
+        if (!FileSystem::read(filepath, *font.mFaceData)) {
+            error("Failed to read font {0}", filepath);
+            font.mFaceData.reset();
+            return false;
+        }
+
+        FT_Error error = FT_New_Memory_Face(sLib, font.mFaceData->data, (FT_Long) font.mFaceData->size, 0, &font.face);
         if (error == FT_Err_Unknown_File_Format) {
             error("Failed to load font {0}. Unknown file format", filepath);
             return false;
@@ -1,4 +1,5 @@
 #include <ui/ui.h>
+#include <api/state_cache.h>
 
 namespace gl {
 
@@ -41,7 +42,7 @@ namespace gl {
 
     void UI_Pipeline::render() {
         mFrame.bind();
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        StateCache::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         mText2dRenderer->begin();
         scene->eachComponent<Text2d>([this](Text2d* text) {
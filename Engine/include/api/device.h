@@ -21,7 +21,8 @@ namespace gl {
         int MAX_COMBINED_SHADER_STORAGE_BLOCKS;
         int MAX_SAMPLES;
 
-        Device(int width, int height);
+        // loader resolves GL functions of current context, GLFW loader is used by default
+        Device(int width, int height, void* (*loader)(const char* name) = null);
         ~Device();
 
         static Device& get() {
@@ -2,6 +2,7 @@
 
 #include <api/buffers.h>
 #include <api/shader.h>
+#include <api/geometry_pool.h>
 
 namespace gl {
 
@@ -33,6 +34,12 @@ namespace gl {
         IndexBuffer ibo;
         u32 strips = 1;
         int verticesPerStrip = 0;
+        // first index to draw from, used to switch between LODs stored in one index buffer
+        int indexOffset = 0;
+        // set by geometry with quantized vertices, renderers pass it to vertex shaders
+        VertexDequantization dequantization;
+        // handle of GeometryPool, vao, vbo and ibo aren't used if it's set, indexOffset is relative to mesh
+        u32 mesh = InvalidMesh;
 
         GABRIEL_API void free();
 
@@ -40,6 +47,28 @@ namespace gl {
         GABRIEL_API void draw(int instances) const;
     };
 
+    // layout of glMultiDrawElementsIndirect commands
+    struct GABRIEL_API DrawElementsIndirectCommand final {
+        u32 count = 0;
+        u32 instanceCount = 0;
+        u32 firstIndex = 0;
+        int baseVertex = 0;
+        u32 baseInstance = 0;
+    };
+
+    struct GABRIEL_API DrawIndirectBuffer final {
+        u32 id = 0;
+
+        void init();
+        void free();
+
+        // orphans previous commands, so that draws still reading them don't stall upload
+        void update(const std::vector<DrawElementsIndirectCommand>& commands);
+
+        // draws commands from first to first + count with vertex array of GeometryPool
+        void draw(DrawType type, u32 pool, u32 first, u32 count) const;
+    };
+
     component(DrawableQuad) {
 
         GABRIEL_API void init();
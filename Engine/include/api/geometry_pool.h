@@ -0,0 +1,92 @@
+#pragma once
+
+#include <api/buffers.h>
+
+#include <core/offset_allocator.h>
+
+#define InvalidMesh 0xFFFFFFFF
+
+namespace gl {
+
+    // range of mesh in shared buffers of GeometryPool, indices are relative to baseVertex
+    struct GABRIEL_API PooledMesh final {
+        u32 pool = 0;
+        u32 vertexCount = 0;
+        u32 indexCount = 0;
+        OffsetAllocation vertices;
+        OffsetAllocation indices;
+
+        [[nodiscard]] inline int baseVertex() const { return (int) vertices.offset; }
+        [[nodiscard]] inline u32 firstIndex() const { return indices.offset; }
+    };
+
+    struct GABRIEL_API GeometryPoolStats final {
+        u32 pools = 0;
+        u32 meshes = 0;
+        size_t vertexBytes = 0;
+        size_t freeVertexBytes = 0;
+        size_t indexBytes = 0;
+        size_t freeIndexBytes = 0;
+    };
+
+    // static meshes share one vertex buffer per VertexFormat and one index buffer,
+    // so that draws of the same format don't rebind buffers and can be merged into multi draw indirect.
+    // meshes are referred to by handles, as their ranges move when buffers grow or get defragmented.
+    struct GABRIEL_API GeometryPool final {
+        // capacities of vertex buffer of every format and of index buffer, buffers grow twice when they are full
+        static void init(u32 vertexCapacity = 1 << 20, u32 indexCapacity = 1 << 22);
+        static void free();
+
+        // InvalidMesh if buffers can't grow anymore
+        static u32 allocate(const VertexFormat& format, u32 vertexCount, u32 indexCount);
+        static void free(u32 mesh);
+
+        // first and count are relative to mesh
+        static void uploadVertices(u32 mesh, u32 first, u32 count, const void* vertices);
+        static void uploadIndices(u32 mesh, u32 first, u32 count, const u32* indices);
+
+        [[nodiscard]] static const PooledMesh& getMesh(u32 mesh);
+        [[nodiscard]] static u32 getVertexArray(u32 pool);
+        [[nodiscard]] static inline u32 getIndexBuffer() { return s_indexBuffer; }
+
+        // binds vertex array of pool, index buffer is bound in it
+        static void bind(u32 pool);
+
+        // packs meshes to the start of buffers in order of their offsets, handles stay valid.
+        // allocate does it by itself for buffer that has enough free space only in holes, before growing it
+        static void defragment();
+
+        static GeometryPoolStats getStats();
+
+    private:
+        struct VertexPool final {
+            const VertexFormat* format = null;
+            VertexArray vao;
+            u32 buffer = 0;
+            OffsetAllocator allocator;
+        };
+
+        static u32 getPool(const VertexFormat& format);
+        static u32 createBuffer(size_t size);
+        static void copyBuffer(u32 src, size_t srcOffset, u32 dst, size_t dstOffset, size_t size);
+        static void attach(VertexPool& pool);
+        static bool growVertices(VertexPool& pool, u32 vertexCount);
+        static bool growIndices(u32 indexCount);
+
+        // buffer is packed instead of grown, if at least 1/DEFRAGMENT_FREE_DIVISOR of it is free
+        static constexpr u32 DEFRAGMENT_FREE_DIVISOR = 4;
+        static bool isFragmented(const OffsetAllocator& allocator, u32 count);
+        static std::vector<u32> getMeshOrder(bool byVertices);
+        static void defragmentVertices(u32 pool);
+        static void defragmentIndices();
+
+    private:
+        static u32 s_vertexCapacity;
+        static std::vector<VertexPool> s_pools;
+        static u32 s_indexBuffer;
+        static OffsetAllocator s_indexAllocator;
+        static std::vector<PooledMesh> s_meshes;
+        static std::vector<u32> s_freeMeshes;
+    };
+
+}
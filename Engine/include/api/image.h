@@ -30,7 +30,8 @@ namespace gl {
         void init();
         void free();
 
-        void resize(int w, int h);
+        // image is left unchanged if it can't be resized
+        bool resize(int w, int h);
 
         glm::vec4 getColor(int x, int y);
 
@@ -39,6 +40,33 @@ namespace gl {
         size_t size();
     };
 
+    // block compressed formats, 4x4 pixels per block
+    enum BlockFormat : u32 {
+        BC1,
+        BC3,
+        BC5,
+        BC7
+    };
+
+    struct GABRIEL_API CompressedMip final {
+        int width = 0;
+        int height = 0;
+        std::vector<u8> data;
+    };
+
+    struct GABRIEL_API CompressedImage final {
+        int width = 0;
+        int height = 0;
+        BlockFormat format = BC1;
+        bool srgb = false;
+        // complete chain from largest to smallest mip, uploaded as is without glGenerateMipmap
+        std::vector<CompressedMip> mips;
+
+        [[nodiscard]] int getInternalFormat() const;
+
+        [[nodiscard]] size_t size() const;
+    };
+
     struct GABRIEL_API ImageFace final {
         const char* filepath;
         int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
@@ -87,7 +115,9 @@ namespace gl {
         static void unbind();
 
         void bindParams(const ImageParams& params);
-        void updateParams(const ImageParams& params);
+        // generate = false keeps mip chain that was uploaded by caller,
+        // bindless = false skips resident handle, as its texture state can't be changed anymore
+        void updateParams(const ImageParams& params, bool generate = true, bool bindless = true);
         void generateMipmaps(const ImageParams& params);
 
         void store(const Image& image);
@@ -95,6 +125,13 @@ namespace gl {
         void storeCubemap(const std::array<Image, 6> &images);
 
         void load(const Image &image, const ImageParams& params = {});
+        void load(const CompressedImage& image, const ImageParams& params = {});
+
+        // mip levels of mutable compressed texture, used by TextureStreamer
+        void loadMip(const CompressedMip& mip, int level, int internalFormat);
+        // releases GPU memory of level by respecifying it as empty
+        void freeMip(int level, int internalFormat);
+        void setMipRange(int baseLevel, int maxLevel);
         void loadCubemap(const Image &image, const ImageParams& params = {});
         void loadCubemap(const std::array<Image, 6> &images, const ImageParams& params = {});
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <api/image.h>
+
+namespace gl {
+
+    enum ImageFilter : u32 {
+        // 2x2 average when halving
+        IMAGE_FILTER_BOX,
+        // bicubic with B = C = 1/3, same as default of stb_image_resize
+        IMAGE_FILTER_MITCHELL,
+        // windowed sinc with 3 lobes and Kaiser window, sharpest for mip chains
+        IMAGE_FILTER_KAISER
+    };
+
+    enum ImageEdge : u32 {
+        IMAGE_EDGE_CLAMP,
+        // for tiling textures
+        IMAGE_EDGE_WRAP
+    };
+
+    // CPU kernels over U8, U16 and FLOAT images, parallelized over rows with ThreadPool.
+    // inner loops run over contiguous float rows, so that they are vectorized by compiler.
+    // result images are allocated by kernels and must be freed by caller.
+    struct GABRIEL_API ImageKernels final {
+
+        // separable resampling, U8 images with srgb flag are filtered in linear space
+        static bool resize(const Image& src, Image& dst, int width, int height,
+                           ImageFilter filter = IMAGE_FILTER_MITCHELL, ImageEdge edge = IMAGE_EDGE_CLAMP);
+
+        // next mip level, half size rounded down but at least 1
+        static bool downsample(const Image& src, Image& dst,
+                               ImageFilter filter = IMAGE_FILTER_BOX, ImageEdge edge = IMAGE_EDGE_CLAMP);
+
+        // mips[0] is a copy of src, every next level is downsampled from the previous one until 1x1
+        static void generateMips(const Image& src, std::vector<Image>& mips,
+                                 ImageFilter filter = IMAGE_FILTER_BOX, ImageEdge edge = IMAGE_EDGE_CLAMP);
+
+        // dst is FLOAT image of linear colors, alpha is copied as is
+        static void srgbToLinear(const Image& src, Image& dst);
+        // src is FLOAT image of linear colors, dst is sRGB encoded U8 image
+        static void linearToSrgb(const Image& src, Image& dst);
+
+        // pattern of dst channels from "rgba01", e.g. "bgra" or "rrr1"
+        static bool swizzle(const Image& src, Image& dst, const char* pattern);
+
+        // dst channel i is first channel of sources[i], null sources are filled with 0 and alpha with 1.
+        // sources must have same size and pixel type, e.g. AO, roughness and metallic packed into one image
+        static bool pack(const std::array<const Image*, 4>& sources, int channels, Image& dst);
+
+        // tangent space RGB8 normal map from first channel of height map with Sobel operator,
+        // strength is height range in texels, Y points up in texture space
+        static bool normalFromHeight(const Image& height, Image& normal, float strength = 1.0f, ImageEdge edge = IMAGE_EDGE_WRAP);
+    };
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+namespace gl {
+
+    struct GABRIEL_API NullDeviceStats final {
+        u64 calls = 0;
+        u64 bufferCalls = 0;
+        u64 textureCalls = 0;
+        u64 shaderCalls = 0;
+        u64 drawCalls = 0;
+        u64 uniformCalls = 0;
+        // bytes passed to buffer uploads, texture uploads and uniform setters
+        u64 bufferBytes = 0;
+        u64 textureBytes = 0;
+        u64 uniformBytes = 0;
+    };
+
+    struct GABRIEL_API NullDeviceCall final {
+        const char* name;
+        u64 calls;
+    };
+
+    // GL loader for Device whose entry points count calls and bytes instead of calling driver,
+    // so that CPU cost of frame can be measured without driver and GPU.
+    // objects get ids, mapped buffers get host memory, framebuffers are complete, shaders compile and link,
+    // uniforms are reflected from "uniform" declarations of shader sources, nothing is rendered.
+    struct GABRIEL_API NullDevice final {
+        // false on targets where entry points without own behaviour can't be called safely, see null_device.cpp
+        [[nodiscard]] static bool isSupported();
+
+        static void* getProcAddress(const char* name);
+
+        static void free();
+
+        [[nodiscard]] static const NullDeviceStats& getStats();
+        static void resetStats();
+
+        // calls of every entry point since last reset, most called first
+        static std::vector<NullDeviceCall> getCalls();
+    };
+
+}
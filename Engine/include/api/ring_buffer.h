@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace gl {
+
+    // persistently mapped buffer split into regions of FRAME_COUNT frames.
+    // CPU writes data of current frame linearly into its region, while GPU still reads regions of previous frames,
+    // each region is fenced at end of its frame and waited on before it's written again.
+    struct GABRIEL_API RingBuffer final {
+        static constexpr u32 FRAME_COUNT = 3;
+
+        // target is GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER, frameSize is rounded up to offset alignment of target
+        void init(u32 target, u32 binding, size_t frameSize);
+        void free();
+
+        // waits for region of next frame and binds it to binding of buffer
+        void begin();
+        // fences commands that read region of current frame
+        void end();
+
+        // linear allocation in region of current frame, null if region is full
+        void* allocate(size_t size, size_t alignment, size_t& offset);
+        // memory at offset in region of current frame, null if buffer isn't mapped
+        [[nodiscard]] inline void* getData(size_t offset) const { return mData ? mData + mFrame * mFrameSize + offset : null; }
+
+        [[nodiscard]] inline size_t getFrameSize() const { return mFrameSize; }
+        [[nodiscard]] inline size_t getUsedSize() const { return mHead; }
+
+    private:
+        u32 mId = 0;
+        u32 mTarget = GL_SHADER_STORAGE_BUFFER;
+        u32 mBinding = 0;
+        size_t mFrameSize = 0;
+        u8* mData = null;
+        u32 mFrame = 0;
+        size_t mHead = 0;
+        GLsync mFences[FRAME_COUNT] = {};
+    };
+
+}
@@ -7,15 +7,33 @@
 namespace gl {
 
     struct GABRIEL_API ShaderReader final {
-        static std::string read(const std::string& path, std::string includeIdentifier = "#include");
+        // paths of included files are appended to includes, if it's not null.
+        // every file is preprocessed once per run, shaders that share includes reuse their resolved source
+        static std::string read(const std::string& path, const std::string& includeIdentifier = "#include", std::vector<std::string>* includes = null);
+        // preprocessed source from DerivedDataCache, valid while contents of shader and all its includes are the same
+        static std::string readCached(const std::string& path, const std::string& includeIdentifier = "#include");
+        // drops memoized sources, e.g. to pick up edited shaders
+        static void free();
+
     private:
+        struct Include final {
+            std::string src;
+            // nested includes in order of appearance
+            std::vector<std::string> includes;
+        };
+
+        static const Include* resolve(const std::string& path, const std::string& includeIdentifier, u32 depth);
         static void getFilepath(const std::string& fullPath, std::string& pathWithoutFilename);
+
+    private:
+        static constexpr u32 MAX_INCLUDE_DEPTH = 32;
+        static std::unordered_map<std::string, Include> s_includes;
     };
 
     struct GABRIEL_API ShaderStage final {
         u32 id;
 
-        ShaderStage(u32 type, const char* filepath);
+        ShaderStage(u32 type, const char* filepath, const std::string& src);
 
     private:
         void generateCode(const char* filepath, const std::string& src);
@@ -30,8 +48,16 @@ namespace gl {
         void addTessControlStage(const char* filepath);
         void addTessEvalStage(const char* filepath);
 
+        // linked program is loaded from binary cached by the previous run with the same sources and driver,
+        // otherwise stages are compiled, linked and the program binary is cached for the next run
         void complete();
 
+        // hash of preprocessed sources of all stages with their includes, valid after complete.
+        // for data derived from shader output, that must be rebuilt when any stage changes
+        [[nodiscard]] inline u64 getSourceHash() const {
+            return mSourceHash;
+        }
+
         void use();
         static void stop();
 
@@ -43,6 +69,28 @@ namespace gl {
         void bindSamplerStruct(const char* struct_name, const char* name, int slot, const ImageBuffer& buffer);
         void bindSamplerStruct(const char* struct_name, const ImageSampler& sampler, const ImageBuffer& buffer);
 
+        void bindSampler(const SamplerHandle& sampler, int slot, const ImageBuffer& buffer);
+
+        // locations are looked up in table of uniforms reflected by complete, -1 if uniform isn't active.
+        // string helpers hash names piecewise, so none of them formats strings or queries GL
+        [[nodiscard]] int getUniformLocation(u64 hash) const;
+
+        template<typename T>
+        [[nodiscard]] inline int getUniformLocation(const UniformHandle<T>& uniform) const {
+            return getUniformLocation(uniform.hash);
+        }
+
+        template<typename T>
+        inline void setUniform(const UniformHandle<T>& uniform, T& value) {
+            setUniform(getUniformLocation(uniform.hash), value);
+        }
+
+        // element of uniform array
+        template<typename T>
+        inline void setUniform(const UniformHandle<T>& uniform, u32 index, T& value) {
+            setUniform(getUniformLocation(UniformName::hashIndex(index, uniform.hash)), value);
+        }
+
         int getUniformLocation(const char* name) const;
         int getUniformArrayLocation(u32 index, const char* name);
         int getUniformStructLocation(const char *structName, const char *fieldName);
@@ -108,10 +156,39 @@ namespace gl {
         void setUniformStructArgs(const char *struct_name, const char *field_name, T &field_value);
 
     protected:
+        struct StageSource final {
+            u32 type;
+            std::string filepath;
+            std::string src;
+        };
+
         void addStage(u32 type, const char* filepath);
 
+    private:
+        struct UniformSlot final {
+            // 0 marks empty slot
+            u64 hash = 0;
+            int location = -1;
+        };
+
+        // fills open addressing table of active uniforms, array elements are added one by one
+        void reflect();
+        void addUniform(u64 hash, int location);
+
+        [[nodiscard]] u64 getProgramKey() const;
+        bool loadBinary(const std::string& cachePath);
+        void storeBinary(const std::string& cachePath);
+        bool link();
+
+        // vendor, renderer and version, binaries of other drivers are rejected
+        static u64 getDriverHash();
+
     protected:
-        std::vector<u32> stages;
+        std::vector<StageSource> stages;
+
+    private:
+        std::vector<UniformSlot> mUniforms;
+        u64 mSourceHash = 0;
     };
 
     template<typename T>
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace gl {
+
+    struct GABRIEL_API StateCacheStats final {
+        u32 issued = 0;
+        u32 skipped = 0;
+    };
+
+    // shadow copy of GL state, changes that match current state are skipped before they reach driver.
+    // all binds and toggles of cached state must go through it, otherwise cache gets out of sync.
+    // unknown state, e.g. after init or invalidate, is always issued.
+    struct GABRIEL_API StateCache final {
+        static constexpr u32 TEXTURE_UNITS = 32;
+
+        // compares cache against glGet at the end of every frame
+        static bool validation;
+
+        static void init();
+
+        // forgets all state, e.g. after code outside of engine changed it
+        static void invalidate();
+
+        // GL_DEPTH_TEST, GL_STENCIL_TEST, GL_BLEND and GL_CULL_FACE are cached, other capabilities are passed through
+        static void enable(u32 capability);
+        static void disable(u32 capability);
+
+        static void useProgram(u32 program);
+        static void bindVertexArray(u32 vao);
+        // GL_FRAMEBUFFER binds both draw and read framebuffers
+        static void bindFramebuffer(u32 target, u32 framebuffer);
+
+        static void activeTexture(int slot);
+        // binds to active texture unit
+        static void bindTexture(u32 type, u32 texture);
+        static void bindTexture(int slot, u32 type, u32 texture);
+
+        static void setBlendFunc(u32 src, u32 dst);
+        // blend function of single draw buffer, leaves cached blend function unknown
+        static void setBlendFunc(u32 buffer, u32 src, u32 dst);
+        static void setBlendEquation(u32 mode);
+
+        static void setDepthFunc(u32 func);
+        static void setDepthMask(bool mask);
+
+        static void setStencilFunc(u32 func, int ref, u32 mask);
+        static void setStencilOp(u32 stencilFail, u32 depthFail, u32 depthPass);
+        static void setStencilMask(u32 mask);
+
+        static void setCullFace(u32 face);
+
+        // GL unbinds deleted objects, so that their ids may be bound again after reuse
+        static void deleteProgram(u32 program);
+        static void deleteVertexArray(u32 vao);
+        static void deleteFramebuffer(u32 framebuffer);
+        static void deleteTexture(u32 texture);
+
+        // logs every cached state that differs from driver, false if any differs
+        static bool validate();
+
+        [[nodiscard]] static inline const StateCacheStats& getStats() { return s_stats; }
+        static inline void resetStats() { s_stats = {}; }
+
+    private:
+        enum Capability : u32 {
+            DEPTH_TEST,
+            STENCIL_TEST,
+            BLEND,
+            CULL_FACE,
+            CAPABILITY_COUNT
+        };
+
+        struct TextureUnit final {
+            u32 type;
+            u32 texture;
+        };
+
+        static int getCapability(u32 capability);
+        static void setEnabled(u32 capability, bool enabled);
+        static bool skip(bool equal);
+
+    private:
+        static StateCacheStats s_stats;
+        static u32 s_capabilities[CAPABILITY_COUNT];
+        static u32 s_program;
+        static u32 s_vao;
+        static u32 s_drawFramebuffer;
+        static u32 s_readFramebuffer;
+        static u32 s_activeTexture;
+        static TextureUnit s_textureUnits[TEXTURE_UNITS];
+        static u32 s_blendSrc;
+        static u32 s_blendDst;
+        static u32 s_blendEquation;
+        static u32 s_depthFunc;
+        static u32 s_depthMask;
+        static u32 s_stencilFunc;
+        static int s_stencilRef;
+        static u32 s_stencilFuncMask;
+        static u32 s_stencilFail;
+        static u32 s_stencilDepthFail;
+        static u32 s_stencilDepthPass;
+        static u32 s_stencilMask;
+        static u32 s_cullFace;
+    };
+
+}
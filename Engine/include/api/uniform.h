@@ -2,6 +2,57 @@
 
 namespace gl {
 
+    // 64-bit FNV-1a of uniform names, constexpr so that names of hot uniforms are hashed by compiler.
+    // names are hashed piecewise to the same value as formatted name, e.g. hashField("material", "color") == hash("material.color")
+    struct GABRIEL_API UniformName final {
+        static constexpr u64 OFFSET = 14695981039346656037ull;
+        static constexpr u64 PRIME = 1099511628211ull;
+
+        static constexpr u64 hash(const char* name, u64 seed = OFFSET) {
+            u64 result = seed;
+            while (*name) {
+                result = (result ^ (u8) *name++) * PRIME;
+            }
+            return result;
+        }
+
+        // appends "[index]"
+        static constexpr u64 hashIndex(u32 index, u64 seed) {
+            char digits[10] = {};
+            int count = 0;
+            do {
+                digits[count++] = (char) ('0' + index % 10);
+                index /= 10;
+            } while (index > 0);
+
+            u64 result = (seed ^ (u8) '[') * PRIME;
+            while (count > 0) {
+                result = (result ^ (u8) digits[--count]) * PRIME;
+            }
+            return (result ^ (u8) ']') * PRIME;
+        }
+
+        // "structName.fieldName"
+        static constexpr u64 hashField(const char* structName, const char* fieldName, u64 seed = OFFSET) {
+            return hash(fieldName, hash(".", hash(structName, seed)));
+        }
+    };
+
+    // hashed name of uniform of type T, Shader resolves it against its table of reflected uniforms without querying GL.
+    // meant to be declared as static constexpr next to the code that updates uniform
+    template<typename T>
+    struct UniformHandle final {
+        u64 hash = 0;
+
+        constexpr UniformHandle(const char* name) : hash(UniformName::hash(name)) {}
+        constexpr UniformHandle(const char* structName, const char* fieldName) : hash(UniformName::hashField(structName, fieldName)) {}
+    };
+
+    struct ImageBuffer;
+
+    // samplers are set by slot, see Shader::bindSampler
+    typedef UniformHandle<ImageBuffer> SamplerHandle;
+
     template<typename T>
     struct GABRIEL_API Uniform {
         const char* name;
@@ -42,6 +42,8 @@ namespace gl {
         KEY keyMoveRight = KEY::D;
 
         Camera(const u32 binding, Window* window);
+        // camera without window, e.g. for headless rendering, it ignores input and never resizes
+        Camera(const u32 binding, int width, int height);
         ~Camera();
 
         void onMouseCursor(const double x, const double y, const float dt);
@@ -71,7 +73,7 @@ namespace gl {
         void update();
 
         [[nodiscard]] inline float getAspectRatio() const {
-            return mWindow->getAspectRatio();
+            return mWindow ? mWindow->getAspectRatio() : (float) mWidth / (float) mHeight;
         }
 
         RayCollider shootRay(const double x, const double y);
@@ -80,8 +82,13 @@ namespace gl {
 
         Frustum frustrum();
 
+        // how many pixels one world unit covers on screen at given distance from camera
+        [[nodiscard]] float getPixelsPerUnit(float distance) const;
+
     private:
-        Window* mWindow;
+        Window* mWindow = null;
+        int mWidth = 0;
+        int mHeight = 0;
         UniformBuffer mUbo;
         float mLastCursorX = 400;
         float mLastCursorY = 300;
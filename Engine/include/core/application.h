@@ -1,11 +1,14 @@
 #pragma once
 
 #include <core/window.h>
+#include <core/headless_context.h>
 #include <core/imgui_core.h>
 #include <core/timer.h>
+#include <core/thread_pool.h>
 
 #include <debugging/debugger.h>
 #include <debugging/visuals.h>
+#include <debugging/profiler.h>
 
 #include <control/camera.h>
 #include <control/entity_control.h>
@@ -15,9 +18,18 @@
 #include <features/lighting/light.h>
 #include <features/screen.h>
 #include <features/shadow/shadow.h>
+#include <features/lod.h>
+#include <features/draw_storage.h>
+#include <features/render_target_pool.h>
 
 #include <io/model_loader.h>
 #include <io/image_loader.h>
+#include <io/texture_cache.h>
+#include <io/texture_streamer.h>
+#include <io/derived_data_cache.h>
+#include <io/file_system.h>
+#include <io/io_service.h>
+#include <io/resource_loader.h>
 
 #include <math/maths.h>
 
@@ -43,6 +55,7 @@
 #include <imgui/entity_window.h>
 #include <imgui/component_window.h>
 #include <imgui/gizmo.h>
+#include <imgui/profiler_window.h>
 
 #include <network/services/database_service.h>
 
@@ -64,6 +77,10 @@ namespace gl {
         virtual ~Application();
 
         void run();
+        // renders fixed number of frames offscreen without window and input, logs frame times
+        void runHeadless(const HeadlessParams& params);
+        // offline step of shipping builds: packs directories into archive that is mounted at startup instead of loose files
+        bool pack(const char* archiveFilepath, const std::vector<std::string>& directories);
 
         virtual void onWindowClose();
         virtual void onWindowMove(const int x, const int y);
@@ -87,6 +104,9 @@ namespace gl {
         virtual void onDestroy();
         virtual void onRender(const float dt);
         virtual void onRenderPostFX(const float dt);
+        // declares fullscreen effect from input into transient texture of desc, returns the texture
+        u32 addPostFX(const char* name, u32 input, const RenderTextureDesc& desc,
+                      const std::function<void(const ImageBuffer&, const FrameBuffer&)>& render);
         virtual void onRenderImgui(const float dt);
         virtual void onSimulate(const float dt);
         virtual void onUpdateInput(const float dt);
@@ -103,6 +123,7 @@ namespace gl {
     private:
         void initLogger();
         void initWindow();
+        void initHeadless();
         void initApi();
         void initNetwork();
         void initImgui();
@@ -111,6 +132,8 @@ namespace gl {
 
         void printDt();
 
+        void dumpFinalRenderTarget(const char* filepath);
+
     protected:
         const char* mTitle;
         const char* mLogoName;
@@ -124,6 +147,9 @@ namespace gl {
         Camera* mCamera = null;
 
         Window* mWindow = null;
+        // window is null in headless mode
+        HeadlessParams mHeadless;
+        HeadlessContext* mHeadlessContext = null;
         Device* mDevice = null;
         Debugger* mDebugger = null;
 
@@ -156,6 +182,9 @@ namespace gl {
         FrameBuffer mColorFrame;
         FrameBuffer mDepthFrame;
 
+        RenderGraph mPostFxGraph;
+        RenderTargetPool mRenderTargetPool;
+
         ImageBuffer mFinalRenderTarget;
         ImageBuffer mDebugRenderTarget;
 
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace gl {
+
+    // command line of headless run: --headless [--null-device] [--frames N] [--warmup N] [--dump filepath] [--trace filepath]
+    struct GABRIEL_API HeadlessParams final {
+        bool enabled = false;
+        // GL calls are only counted by NullDevice, so that frame time is CPU cost of engine alone
+        bool nullDevice = false;
+        u32 frames = 100;
+        // frames rendered before measuring, so that shader compilation and uploads don't count
+        u32 warmupFrames = 10;
+        // png of final render target after last frame, nothing is written if null
+        const char* dumpFilepath = null;
+        // Chrome trace of profiled frames, nothing is written if null
+        const char* traceFilepath = null;
+
+        static HeadlessParams parse(int argc, char** argv);
+    };
+
+    // GL context without window and display, created through EGL surfaceless platform,
+    // or through OSMesa when engine is built with OSMESA.
+    // context has no default framebuffer, everything must be rendered into frame buffers.
+    struct GABRIEL_API HeadlessContext final {
+
+        HeadlessContext(int width, int height, int majorVersion = 4, int minorVersion = 6);
+        ~HeadlessContext();
+
+        [[nodiscard]] inline bool isCreated() const {
+            return mCreated;
+        }
+
+        // loader for Device
+        static void* getProcAddress(const char* name);
+
+    private:
+        void* mDisplay = null;
+        void* mContext = null;
+        // OSMesa needs color buffer to make context current, it is never presented
+        std::vector<u8> mBuffer;
+        bool mCreated = false;
+    };
+
+}
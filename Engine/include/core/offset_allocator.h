@@ -0,0 +1,71 @@
+#pragma once
+
+namespace gl {
+
+    struct GABRIEL_API OffsetAllocation final {
+        static constexpr u32 INVALID = 0xFFFFFFFF;
+
+        u32 offset = INVALID;
+        // node of allocator, needed to free allocation
+        u32 node = INVALID;
+
+        [[nodiscard]] inline bool isValid() const { return offset != INVALID; }
+    };
+
+    // two-level segregated fit allocator of ranges in external memory, e.g. in GPU buffers.
+    // sizes and offsets are in units of caller, allocation and free run in constant time,
+    // free neighbour ranges are merged right away.
+    struct GABRIEL_API OffsetAllocator final {
+        void init(u32 size);
+        void free();
+
+        // invalid allocation if there is no free range large enough
+        OffsetAllocation allocate(u32 size);
+        void free(const OffsetAllocation& allocation);
+
+        // extends range at its end, e.g. after backing buffer was resized
+        void grow(u32 size);
+
+        [[nodiscard]] inline u32 getSize() const { return mSize; }
+        [[nodiscard]] inline u32 getFreeSize() const { return mFreeSize; }
+        [[nodiscard]] u32 getAllocationSize(const OffsetAllocation& allocation) const;
+
+    private:
+        static constexpr u32 SECOND_LEVEL_BITS = 3;
+        static constexpr u32 SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_BITS;
+        static constexpr u32 FIRST_LEVEL_COUNT = 32;
+        static constexpr u32 BIN_COUNT = FIRST_LEVEL_COUNT * SECOND_LEVEL_COUNT;
+
+        struct Node final {
+            u32 offset = 0;
+            u32 size = 0;
+            // neighbours in memory
+            u32 prev = OffsetAllocation::INVALID;
+            u32 next = OffsetAllocation::INVALID;
+            // neighbours in list of free nodes of the same bin
+            u32 prevFree = OffsetAllocation::INVALID;
+            u32 nextFree = OffsetAllocation::INVALID;
+            bool used = false;
+        };
+
+        static u32 getBin(u32 size);
+        static u32 getBinRoundUp(u32 size);
+
+        u32 createNode(u32 offset, u32 size);
+        void releaseNode(u32 node);
+        void insertFree(u32 node);
+        void removeFree(u32 node);
+        u32 findFree(u32 size) const;
+
+    private:
+        std::vector<Node> mNodes;
+        std::vector<u32> mReleasedNodes;
+        u32 mBins[BIN_COUNT];
+        u32 mFirstLevelMask = 0;
+        u32 mSecondLevelMasks[FIRST_LEVEL_COUNT] = {};
+        u32 mSize = 0;
+        u32 mFreeSize = 0;
+        u32 mLastNode = OffsetAllocation::INVALID;
+    };
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+namespace gl {
+
+    // fixed set of worker threads for CPU-only jobs (decoding, cooking, processing)
+    // jobs must not touch GL, results are handed back to GL thread through futures
+    struct GABRIEL_API ThreadPool final {
+
+        // threadCount = 0 uses all hardware threads except the calling one
+        static void init(u32 threadCount = 0);
+        static void free();
+
+        static u32 getThreadCount();
+
+        // true on pool workers, where blocking on other pool jobs may deadlock
+        static bool isWorker();
+
+        template<typename F>
+        static std::future<std::invoke_result_t<F>> submit(F&& task);
+
+        // calls function(i) for i in [0, count) split into contiguous chunks over workers and calling thread,
+        // blocks until all chunks are done, runs in place when called from a worker
+        template<typename F>
+        static void parallelFor(u32 count, F&& function);
+
+    private:
+        static void enqueue(std::function<void()>&& job);
+        static void work();
+
+    private:
+        static std::vector<std::thread> s_threads;
+        static std::queue<std::function<void()>> s_jobs;
+        static std::mutex s_mutex;
+        static std::condition_variable s_condition;
+        static bool s_running;
+        static thread_local bool s_worker;
+    };
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task) {
+        using R = std::invoke_result_t<F>;
+        auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+        std::future<R> result = job->get_future();
+        enqueue([job]() { (*job)(); });
+        return result;
+    }
+
+    template<typename F>
+    void ThreadPool::parallelFor(u32 count, F&& function) {
+        u32 chunkCount = std::min<u32>(count, getThreadCount() + 1);
+
+        if (chunkCount <= 1 || isWorker()) {
+            for (u32 i = 0 ; i < count ; i++) {
+                function(i);
+            }
+            return;
+        }
+
+        auto runChunk = [&function, count, chunkCount](u32 chunk) {
+            u32 begin = (u64) count * chunk / chunkCount;
+            u32 end = (u64) count * (chunk + 1) / chunkCount;
+            for (u32 i = begin ; i < end ; i++) {
+                function(i);
+            }
+        };
+
+        std::vector<std::future<void>> chunks;
+        chunks.reserve(chunkCount - 1);
+        for (u32 chunk = 1 ; chunk < chunkCount ; chunk++) {
+            chunks.emplace_back(submit([&runChunk, chunk]() { runChunk(chunk); }));
+        }
+
+        runChunk(0);
+
+        for (auto& chunk : chunks) {
+            chunk.wait();
+        }
+    }
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#define InvalidGpuScope 0xFFFFFFFF
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// names are kept by pointer, so that they must be string literals
+#define PROFILE_SCOPE(name) gl::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+// CPU and GPU time of render pass, GL thread only
+#define PROFILE_PASS(name) PROFILE_SCOPE(name); gl::GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+
+namespace gl {
+
+    struct GABRIEL_API ProfileEvent final {
+        const char* name = null;
+        // nanoseconds since profiler start, GPU events are converted into CPU time
+        u64 begin = 0;
+        u64 end = 0;
+        u32 depth = 0;
+        u32 thread = 0;
+
+        [[nodiscard]] inline float getMillis() const {
+            return (float) (end - begin) * 1e-6f;
+        }
+    };
+
+    struct GABRIEL_API ProfileFrame final {
+        u64 index = 0;
+        u64 begin = 0;
+        u64 end = 0;
+        // events of all threads that ended during frame
+        std::vector<ProfileEvent> events;
+        // GPU timestamps are read back once GPU is done with them, up to GPU_LATENCY frames later.
+        // empty until then, and for frames GPU is more than GPU_LATENCY frames behind
+        std::vector<ProfileEvent> gpuEvents;
+
+        [[nodiscard]] inline float getMillis() const {
+            return (float) (end - begin) * 1e-6f;
+        }
+    };
+
+    // hierarchical CPU and GPU profiler.
+    // every thread writes its scopes into its own ring without locks, main thread collects rings
+    // into frame history at the end of every frame. GPU scopes are timestamp queries that are read back
+    // GPU_LATENCY frames later, so that readback never waits for GPU.
+    struct GABRIEL_API Profiler final {
+        static constexpr u32 MAX_FRAMES = 300;
+        // events per thread between two collects, older events are dropped
+        static constexpr u32 RING_SIZE = 1 << 14;
+        // slots next to head are skipped when ring overflowed, as owner thread may be writing them while collected
+        static constexpr u32 RING_MARGIN = 1 << 8;
+        static constexpr u32 GPU_LATENCY = 3;
+
+        static bool isEnabled;
+        static bool isGpuEnabled;
+
+        // names calling thread in UI and trace, threads are named "Thread N" otherwise
+        static void setThreadName(const char* name);
+
+        // main thread, around whole frame
+        static void beginFrame();
+        static void endFrame();
+
+        // deletes GPU queries, rings of threads and frame history.
+        // GL thread only, after every other profiled thread has stopped
+        static void free();
+
+        // nanoseconds since profiler start
+        static u64 now();
+
+        // GL thread only, returns InvalidGpuScope if GPU profiling is disabled
+        static u32 beginGpu(const char* name);
+        static void endGpu(u32 scope);
+
+        // frames from oldest to newest
+        [[nodiscard]] static u32 getFrameCount();
+        [[nodiscard]] static const ProfileFrame& getFrame(u32 i);
+
+        [[nodiscard]] static u32 getThreadCount();
+        // copy, as thread may be renamed by other thread meanwhile
+        [[nodiscard]] static std::string getThreadName(u32 thread);
+
+        // Chrome trace event JSON of frame history, opens in chrome://tracing and Perfetto
+        static bool exportTrace(const char* filepath);
+
+    private:
+        static void collect(ProfileFrame& frame);
+        static void resolveGpu(u32 slot);
+    };
+
+    struct GABRIEL_API ProfileScope final {
+        ProfileScope(const char* name);
+        ~ProfileScope();
+
+    private:
+        const char* mName;
+        u64 mBegin = 0;
+        bool mEnabled;
+    };
+
+    struct GABRIEL_API GpuProfileScope final {
+        GpuProfileScope(const char* name);
+        ~GpuProfileScope();
+
+    private:
+        u32 mScope;
+    };
+
+}
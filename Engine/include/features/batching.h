@@ -0,0 +1,92 @@
+#pragma once
+
+#include <features/draw_storage.h>
+#include <features/render_queue.h>
+
+#include <geometry/meshlet.h>
+
+namespace gl {
+
+    // instances of one geometry and one set of material textures,
+    // their per-draw data is stored in DrawStorage from first to first + count
+    struct GABRIEL_API DrawBatch final {
+        const DrawableElements* drawable = null;
+        Material* material = null;
+        u32 first = 0;
+        u32 count = 0;
+
+        // binds material textures from slot and draws all instances
+        void draw(Shader& shader, int slot = 0) const;
+    };
+
+    // batches of different meshes of GeometryPool with the same vertex format and textures,
+    // drawn with one glMultiDrawElementsIndirect from commands first to first + count
+    struct GABRIEL_API DrawGroup final {
+        u32 batch = 0;
+        u32 batchCount = 0;
+        bool indirect = false;
+        u32 command = 0;
+    };
+
+    // groups draws of one pass by geometry and material textures, so that each group is drawn instanced.
+    // color and factors of materials are per-draw data, so materials that differ only in them still share a batch.
+    // draws of depth only passes are added without material and are grouped by geometry only.
+    // batches of pooled meshes that share textures are merged further into multi draw indirect.
+    struct GABRIEL_API DrawBatcher final {
+        RenderPass pass = RENDER_PASS_OPAQUE;
+        // depth of draws is their distance to view position, opaque draws are sorted front to back, transparent back to front
+        glm::vec3 viewPosition = { 0, 0, 0 };
+
+        void free();
+
+        void clear();
+
+        void add(const Transform& transform, const DrawableElements& drawable, Material* material = null);
+
+        // draws only ranges of drawable indices, as visible meshlets, every range is batched as its own geometry
+        void add(const Transform& transform, const DrawableElements& drawable, const std::vector<MeshletRange>& ranges, Material* material = null);
+
+        // sorts draws, writes their data into DrawStorage and fills batches and groups
+        void build();
+
+        // binds material textures from slot and draws all groups
+        void draw(Shader& shader, int slot = 0);
+
+        [[nodiscard]] inline const std::vector<DrawBatch>& getBatches() const { return mBatches; }
+        [[nodiscard]] inline const std::vector<DrawGroup>& getGroups() const { return mGroups; }
+        [[nodiscard]] inline size_t getDrawCount() const { return mDraws.size(); }
+        [[nodiscard]] inline const RenderQueueStats& getQueueStats() const { return mQueue.getStats(); }
+
+    private:
+        struct Draw final {
+            const Transform* transform;
+            const DrawableElements* drawable;
+            Material* material;
+            float depth;
+            // enabled textures, geometry and LOD range, equal keys can be drawn as instances
+            u32 key[14];
+        };
+
+        static void initKey(Draw& draw);
+        static u32 getId(std::unordered_map<u64, u32>& ids, const u32* key, u32 count);
+        static bool isEqual(const Draw& left, const Draw& right);
+        static bool isIndirect(const Draw& left, const Draw& right);
+
+        void buildGroups();
+
+    private:
+        std::vector<Draw> mDraws;
+        // copies of drawables narrowed to ranges, deque keeps pointers of draws valid until clear
+        std::deque<DrawableElements> mRangeDrawables;
+        RenderQueue mQueue;
+        std::unordered_map<u64, u32> mMaterialIds;
+        std::unordered_map<u64, u32> mMeshIds;
+        std::vector<DrawBatch> mBatches;
+        std::vector<DrawGroup> mGroups;
+        std::vector<DrawElementsIndirectCommand> mCommands;
+        DrawIndirectBuffer mIndirectBuffer;
+        // first draw of every batch, needed to compare batches
+        std::vector<u32> mBatchDraws;
+    };
+
+}
@@ -2,6 +2,8 @@
 
 #include <geometry/geometry.h>
 
+#include <core/thread_pool.h>
+
 namespace gl {
 
     struct GABRIEL_API DisplacementMap {
@@ -54,7 +56,8 @@ namespace gl {
         void mix(int width, int height);
 
     private:
-        void resizeImages(int width, int height);
+        // fills indices of U8 images that are resized to width x height
+        void resizeImages(int width, int height, std::vector<u32>& images);
         float regionPercent(int tile, float height);
     };
 
@@ -105,14 +108,18 @@ namespace gl {
         int size = map.size();
         float s = scale;
 
-        for (int i = 0 ; i < size ; i++) {
+        ThreadPool::parallelFor(size, [&](u32 i) {
             auto& displacedV = displacedVertices[i];
             auto& originV = mOriginVertices[i];
             displacedV.pos = originV.pos + map[i] * s * glm::normalize(originV.normal);
-        }
+        });
 
-        drawable.vao.bind();
-        drawable.vbo.update(*mVertices);
+        if (drawable.mesh != InvalidMesh) {
+            GeometryPool::uploadVertices(drawable.mesh, 0, mVertices->count, mVertices->vertices);
+        } else {
+            drawable.vao.bind();
+            drawable.vbo.update(*mVertices);
+        }
     }
 
     template<typename T>
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <api/draw.h>
+#include <api/ring_buffer.h>
+
+#include <features/transform.h>
+#include <features/material.h>
+
+namespace gl {
+
+    enum DrawFlags : u32 {
+        DRAW_ALBEDO = 1 << 0,
+        DRAW_NORMAL = 1 << 1,
+        DRAW_PARALLAX = 1 << 2,
+        DRAW_METALLIC = 1 << 3,
+        DRAW_ROUGHNESS = 1 << 4,
+        DRAW_AO = 1 << 5,
+        DRAW_EMISSION = 1 << 6,
+        DRAW_QUANTIZED = 1 << 7
+    };
+
+    // std430 layout of DrawData in shaders/features/draw.glsl
+    struct GABRIEL_API DrawData final {
+        glm::mat4 model;
+        glm::vec4 color;
+        glm::vec4 emissionFactor;
+        glm::vec4 quantizationOffset;
+        glm::vec4 quantizationScale;
+        float heightScale;
+        float parallaxMinLayers;
+        float parallaxMaxLayers;
+        float metallicFactor;
+        float roughnessFactor;
+        float aoFactor;
+        u32 flags;
+        u32 padding;
+    };
+
+    static constexpr u32 InvalidDrawIndex = UINT32_MAX;
+
+    // per-draw transform, material factors and dequantization of PBR and shadow renderers,
+    // written linearly into persistently mapped ring and read by shaders at draw_index.
+    // all draws of frame must be pushed between begin and end.
+    // draws beyond capacity are dropped, and ring is grown at the next begin to fit them.
+    struct GABRIEL_API DrawStorage final {
+        static constexpr u32 BINDING = 6;
+
+        static void init(u32 capacity = 16384);
+        static void free();
+
+        static void begin();
+        static void end();
+
+        // InvalidDrawIndex if frame is out of capacity, then draw must be skipped
+        static u32 push(const Transform& transform, const DrawableElements& drawable, const Material& material);
+        // default material, e.g. for depth only passes
+        static u32 push(const Transform& transform, const DrawableElements& drawable);
+        // instanced draws read data at draw_index + gl_InstanceID
+        static void bind(Shader& shader, u32 index);
+
+        [[nodiscard]] static inline u32 getCount() { return s_count; }
+        [[nodiscard]] static inline u32 getDroppedCount() { return s_dropped; }
+        [[nodiscard]] static inline u32 getCapacity() { return s_capacity; }
+
+    private:
+        static RingBuffer s_ring;
+        static u32 s_capacity;
+        static u32 s_count;
+        // draws of current frame that didn't fit
+        static u32 s_dropped;
+    };
+
+}
@@ -12,6 +12,9 @@ namespace gl {
         glm::ivec2 prefilterResolution;
         glm::ivec2 irradianceResolution = {32, 32 };
         int prefilterLevels = 5;
+        // source of hdr, maps generated from it are kept in DerivedDataCache
+        std::string hdrFilepath;
+        bool hdrFlipUV = false;
         ImageBuffer hdr = GL_TEXTURE_2D;
         ImageBuffer skybox = GL_TEXTURE_CUBE_MAP;
         ImageBuffer irradiance = GL_TEXTURE_CUBE_MAP;
@@ -33,6 +36,9 @@ namespace gl {
 
         void init();
 
+        // hdr is decoded only if its maps are not cached yet
+        void setHDR(const std::string& filepath, bool flipUV);
+
         void makeResident();
         void makeNonResident();
 
@@ -72,6 +78,11 @@ namespace gl {
 
         void setEnvironment(Environment* environment);
 
+    private:
+        std::string getCachePath();
+        bool loadCached(const std::string& cachePath);
+        void storeCached(const std::string& cachePath);
+
     private:
         FrameBuffer mFrame;
         DrawableQuad mDrawable;
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <control/camera.h>
+
+#include <features/transform.h>
+
+#include <geometry/mesh_simplifier.h>
+
+namespace gl {
+
+    // LOD chain of DrawableElements, levels are ranges of its index buffer from finest to coarsest
+    component(MeshLod) {
+        std::vector<LodLevel> levels;
+        // bounding sphere in object space
+        glm::vec3 center = { 0, 0, 0 };
+        float radius = 0;
+        // simplification error allowed on screen, in pixels
+        float pixelError = 1.0f;
+        u32 current = 0;
+
+        MeshLod() = default;
+
+        MeshLod(const std::vector<LodLevel>& levels, const Bounds& bounds)
+        : levels(levels), center(bounds.center()), radius(bounds.radius()) {}
+
+        GABRIEL_API void select(const Camera& camera, const Transform& transform, DrawableElements& drawable);
+    };
+
+    struct GABRIEL_API LodSelector final {
+        // picks coarsest level whose projected error stays under MeshLod::pixelError
+        static void select(Scene* scene, const Camera& camera);
+    };
+
+}
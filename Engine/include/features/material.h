@@ -57,13 +57,15 @@ namespace gl {
             const char* emissionPath = null
         );
 
+        // takes over enabled textures of other material, e.g. loaded by ResourceLoader,
+        // the rest of textures, color and factors of this one are kept
+        void setTextures(const Material& other);
+
         void free();
         static void free(std::vector<Material>& materials);
 
+        // binds enabled textures from slot onwards, color and factors are passed per draw with DrawStorage
         void update(Shader& shader, int slot);
-
-    private:
-        void load(const char* filepath, const bool uv, const ImageParams& params, ImageBuffer& outBuffer, bool& outEnable);
     };
 
 }
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <features/transform.h>
+
+#include <geometry/meshlet.h>
+
+namespace gl {
+
+    // meshlets of finest LOD of DrawableElements, passes draw only index ranges of meshlets that are visible
+    component(MeshletCulling) {
+        MeshletMesh mesh;
+
+        MeshletCulling() = default;
+
+        MeshletCulling(const MeshletMesh& mesh) : mesh(mesh) {}
+
+        // returns false if meshlets don't match drawn indices, as coarser LOD, and drawable should be drawn whole.
+        // camera position enables backface cone test, it's null for passes with front face culling, as shadows.
+        GABRIEL_API bool cull(
+                std::vector<MeshletRange>& ranges,
+                const Transform& transform,
+                const DrawableElements& drawable,
+                const Frustum& frustum,
+                const glm::vec3* cameraPosition = null
+        );
+
+    private:
+        std::vector<u32> mVisible;
+    };
+
+}
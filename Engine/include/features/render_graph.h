@@ -0,0 +1,116 @@
+#pragma once
+
+#include <api/image.h>
+
+#define InvalidRenderResource 0xFFFFFFFF
+
+namespace gl {
+
+    struct FrameBuffer;
+
+    // textures with equal descriptions may share memory when their lifetimes don't overlap
+    struct GABRIEL_API RenderTextureDesc final {
+        int width = 0;
+        int height = 0;
+        int internalFormat = GL_RGB;
+        int pixelFormat = GL_RGB;
+        PixelType pixelType = PixelType::U8;
+
+        RenderTextureDesc() = default;
+
+        RenderTextureDesc(int width, int height, int internalFormat, int pixelFormat, PixelType pixelType)
+        : width(width), height(height), internalFormat(internalFormat), pixelFormat(pixelFormat), pixelType(pixelType) {}
+
+        bool operator ==(const RenderTextureDesc& other) const;
+        inline bool operator !=(const RenderTextureDesc& other) const { return !(*this == other); }
+
+        [[nodiscard]] size_t size() const;
+    };
+
+    // physical textures of transient resources and imported textures, provided to passes while graph executes
+    struct GABRIEL_API RenderGraphResources {
+        virtual ~RenderGraphResources() = default;
+
+        [[nodiscard]] virtual const ImageBuffer& getTexture(u32 resource) const = 0;
+        // framebuffer with texture of resource as its only color attachment, null for imported textures
+        [[nodiscard]] virtual const FrameBuffer* getFrame(u32 resource) const = 0;
+    };
+
+    struct GABRIEL_API RenderGraphStats final {
+        u32 passes = 0;
+        u32 culledPasses = 0;
+        u32 transientTextures = 0;
+        u32 physicalTextures = 0;
+        // memory of transient textures without and with aliasing
+        size_t transientBytes = 0;
+        size_t physicalBytes = 0;
+    };
+
+    // frame graph of fullscreen passes, built every frame.
+    // passes declare textures they read and write in order of execution, compile() culls passes
+    // that don't contribute to output and assigns transient textures to physical slots,
+    // so that textures whose lifetimes don't overlap share one slot.
+    // compile() doesn't touch GL, physical textures are provided to execute() by RenderTargetPool.
+    struct GABRIEL_API RenderGraph final {
+        typedef std::function<void(const RenderGraphResources&)> Execute;
+
+        void clear();
+
+        u32 createTexture(const char* name, const RenderTextureDesc& desc);
+        u32 importTexture(const char* name, const ImageBuffer& texture);
+
+        u32 addPass(const char* name, const Execute& execute);
+        void read(u32 pass, u32 resource);
+        void write(u32 pass, u32 resource);
+
+        // resource that must be produced, passes not leading to it are culled
+        void setOutput(u32 resource);
+
+        // false if passes read resources that aren't written before
+        bool compile();
+
+        void execute(const RenderGraphResources& resources) const;
+
+        [[nodiscard]] inline bool isCulled(u32 pass) const { return mPasses[pass].culled; }
+        [[nodiscard]] inline bool isImported(u32 resource) const { return mResources[resource].imported; }
+        [[nodiscard]] inline const ImageBuffer& getImportedTexture(u32 resource) const { return mResources[resource].texture; }
+        [[nodiscard]] inline const RenderTextureDesc& getDesc(u32 resource) const { return mResources[resource].desc; }
+        // physical slot of transient resource, InvalidRenderResource for imported and unused resources
+        [[nodiscard]] inline u32 getPhysical(u32 resource) const { return mResources[resource].physical; }
+
+        [[nodiscard]] inline const std::vector<RenderTextureDesc>& getPhysicalDescs() const { return mPhysicalDescs; }
+        [[nodiscard]] inline const RenderGraphStats& getStats() const { return mStats; }
+
+    private:
+        struct Resource final {
+            const char* name;
+            RenderTextureDesc desc;
+            bool imported = false;
+            ImageBuffer texture;
+            u32 physical = InvalidRenderResource;
+            // first and last pass that uses resource
+            u32 firstPass = InvalidRenderResource;
+            u32 lastPass = InvalidRenderResource;
+        };
+
+        struct Pass final {
+            const char* name;
+            Execute execute;
+            std::vector<u32> reads;
+            std::vector<u32> writes;
+            bool culled = true;
+        };
+
+        void cull();
+        bool computeLifetimes();
+        void alias();
+
+    private:
+        std::vector<Resource> mResources;
+        std::vector<Pass> mPasses;
+        std::vector<u32> mOutputs;
+        std::vector<RenderTextureDesc> mPhysicalDescs;
+        RenderGraphStats mStats;
+    };
+
+}
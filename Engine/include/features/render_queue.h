@@ -0,0 +1,75 @@
+#pragma once
+
+namespace gl {
+
+    enum RenderPass : u8 {
+        RENDER_PASS_SHADOW = 0,
+        RENDER_PASS_OPAQUE = 1,
+        RENDER_PASS_TRANSPARENT = 2
+    };
+
+    // 64-bit sort key of draw, sorting keys ascending gives draw order of a frame.
+    // opaque:      pass 4 | layer 4 | shader 8 | material 12 | mesh 12 | depth 24, front to back inside of state
+    // transparent: pass 4 | layer 4 | depth 24 | shader 8 | material 12 | mesh 12, back to front before state
+    struct GABRIEL_API RenderKey final {
+        static constexpr u32 MAX_SHADER = 0xFF;
+        static constexpr u32 MAX_MATERIAL = 0xFFF;
+        static constexpr u32 MAX_MESH = 0xFFF;
+
+        // ids above max are clamped, which only makes sorting coarser
+        static u64 create(RenderPass pass, u8 layer, u32 shader, u32 material, u32 mesh, float depth);
+
+        [[nodiscard]] static inline RenderPass getPass(u64 key) { return (RenderPass) (key >> 60); }
+
+        // key without depth, equal states need no state changes between them
+        [[nodiscard]] static u64 getState(u64 key);
+
+    private:
+        static u32 quantizeDepth(float depth);
+    };
+
+    struct GABRIEL_API RenderItem final {
+        u64 key = 0;
+        // index of draw in list of caller
+        u32 index = 0;
+    };
+
+    struct GABRIEL_API RenderQueueStats final {
+        u32 draws = 0;
+        // number of times state differs from previous draw, in order of submission and in sorted order
+        u32 submittedStateChanges = 0;
+        u32 sortedStateChanges = 0;
+
+        [[nodiscard]] inline u32 getSavedStateChanges() const { return submittedStateChanges - sortedStateChanges; }
+
+        RenderQueueStats& operator +=(const RenderQueueStats& other);
+    };
+
+    // sorts draws of a frame by RenderKey with LSD radix sort, large queues are sorted on ThreadPool
+    struct GABRIEL_API RenderQueue final {
+        static constexpr u32 PARALLEL_THRESHOLD = 4096;
+
+        void clear();
+
+        void push(u64 key, u32 index);
+
+        // stable, draws with equal keys keep order of submission
+        void sort();
+
+        [[nodiscard]] inline const std::vector<RenderItem>& getItems() const { return mItems; }
+        [[nodiscard]] inline size_t size() const { return mItems.size(); }
+        [[nodiscard]] inline const RenderQueueStats& getStats() const { return mStats; }
+
+    private:
+        static u32 countStateChanges(const std::vector<RenderItem>& items);
+
+        void sortSerial();
+        void sortParallel();
+
+    private:
+        std::vector<RenderItem> mItems;
+        std::vector<RenderItem> mTemp;
+        RenderQueueStats mStats;
+    };
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <features/render_graph.h>
+
+#include <api/frame.h>
+
+namespace gl {
+
+    // GPU textures of physical slots of RenderGraph, kept between frames while descriptions of slots don't change
+    struct GABRIEL_API RenderTargetPool final : RenderGraphResources {
+        void free();
+
+        // call after RenderGraph::compile()
+        void acquire(const RenderGraph& graph);
+
+        [[nodiscard]] const ImageBuffer& getTexture(u32 resource) const override;
+        [[nodiscard]] const FrameBuffer* getFrame(u32 resource) const override;
+
+        [[nodiscard]] size_t getBytes() const;
+
+    private:
+        static FrameBuffer createFrame(const RenderTextureDesc& desc);
+
+    private:
+        const RenderGraph* mGraph = null;
+        std::vector<RenderTextureDesc> mDescs;
+        std::vector<FrameBuffer> mFrames;
+    };
+
+}
@@ -2,6 +2,7 @@
 
 #include <features/shadow/shadow_direct.h>
 #include <features/shadow/shadow_point.h>
+#include <features/meshlet_culling.h>
 
 namespace gl {
 
@@ -32,10 +33,14 @@ namespace gl {
         void renderDirectShadows();
         void renderPointShadows();
 
+        void addCasters(const Frustum& frustum);
+
     private:
         FrameBuffer mFrame;
         DirectShadowRenderer* mDirectShadowRenderer;
         PointShadowRenderer* mPointShadowRenderer;
+        DrawBatcher mBatcher;
+        std::vector<MeshletRange> mMeshletRanges;
     };
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <api/draw.h>
 
 #include <features/transform.h>
+#include <features/batching.h>
 
 #include <control/camera.h>
 
@@ -29,13 +30,10 @@ namespace gl {
         void begin();
         void end();
 
-        void render(
-                Transform& transform,
-                DrawableElements& drawable,
-                DirectShadow& directShadow,
-                const glm::vec3& lightPos,
-                const glm::vec3& lightDirection
-        );
+        // light space is the same for all draws of light
+        glm::mat4 update(DirectShadow& directShadow, const glm::vec3& lightPos, const glm::vec3& lightDirection);
+
+        void render(DrawBatcher& batcher);
 
     private:
         Shader mShader;
@@ -97,27 +97,125 @@ namespace gl {
         void copyFrom(Indices* src);
     };
 
+    // simplified index buffer referencing vertices of its source mesh
+    struct GABRIEL_API LodIndices final {
+        Indices indices;
+        // max deviation from source mesh in object space units
+        float error = 0;
+    };
+
+    // range of shared index buffer that draws one level of detail
+    struct GABRIEL_API LodLevel final {
+        int indexOffset = 0;
+        int indexCount = 0;
+        float error = 0;
+    };
+
+    struct GABRIEL_API Bounds final {
+        glm::vec3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        glm::vec3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        [[nodiscard]] inline glm::vec3 center() const { return (min + max) * 0.5f; }
+        [[nodiscard]] inline glm::vec3 extent() const { return max - min; }
+        [[nodiscard]] inline float radius() const { return glm::length(max - min) * 0.5f; }
+
+        void add(const glm::vec3& point);
+        void add(const Bounds& bounds);
+    };
+
+    // surface areas of triangles in object and UV space, used to estimate texel density
+    struct GABRIEL_API SurfaceArea final {
+        float area = 0;
+        float uvArea = 0;
+
+        void add(const SurfaceArea& surfaceArea);
+        // UV units per object space unit
+        [[nodiscard]] float uvDensity() const;
+    };
+
     template<typename T>
     struct Geometry {
         Vertices<T> vertices;
         Indices indices;
+        std::vector<LodIndices> lods;
 
+        // LODs, if any, are stored in the same index buffer after base indices
         void initDrawable(DrawableElements& drawable);
         void free();
+
+        [[nodiscard]] std::vector<LodLevel> lodLevels() const;
+
+        [[nodiscard]] Bounds bounds() const;
+
+        [[nodiscard]] SurfaceArea surfaceArea() const;
     };
 
     template<typename T>
     void Geometry<T>::initDrawable(DrawableElements &drawable) {
-        drawable.vao.init();
-        drawable.vao.bind();
-        drawable.vbo.init(vertices, T::format, BufferAllocType::DYNAMIC);
-        drawable.ibo.init(indices.indices, drawable.strips * drawable.verticesPerStrip, BufferAllocType::DYNAMIC);
+        int baseCount = drawable.strips * drawable.verticesPerStrip;
+        int indexCount = baseCount;
+        for (auto& lod : lods) {
+            indexCount += lod.indices.count;
+        }
+
+        drawable.mesh = GeometryPool::allocate(T::format, vertices.count, indexCount);
+        if (drawable.mesh == InvalidMesh) {
+            return;
+        }
+
+        GeometryPool::uploadVertices(drawable.mesh, 0, vertices.count, vertices.vertices);
+        GeometryPool::uploadIndices(drawable.mesh, 0, baseCount, indices.indices);
+        int indexOffset = baseCount;
+        for (auto& lod : lods) {
+            GeometryPool::uploadIndices(drawable.mesh, indexOffset, lod.indices.count, lod.indices.indices);
+            indexOffset += lod.indices.count;
+        }
     }
 
     template<typename T>
     void Geometry<T>::free() {
         vertices.free();
         indices.free();
+        for (auto& lod : lods) {
+            lod.indices.free();
+        }
+        lods.clear();
+    }
+
+    template<typename T>
+    std::vector<LodLevel> Geometry<T>::lodLevels() const {
+        std::vector<LodLevel> levels;
+        levels.push_back({ 0, indices.count, 0 });
+        int indexOffset = indices.count;
+        for (auto& lod : lods) {
+            levels.push_back({ indexOffset, lod.indices.count, lod.error });
+            indexOffset += lod.indices.count;
+        }
+        return levels;
+    }
+
+    template<typename T>
+    Bounds Geometry<T>::bounds() const {
+        Bounds result;
+        for (int i = 0 ; i < vertices.count ; i++) {
+            result.add(vertices.vertices[i].pos);
+        }
+        return result;
+    }
+
+    template<typename T>
+    SurfaceArea Geometry<T>::surfaceArea() const {
+        SurfaceArea result;
+        for (int i = 0 ; i + 2 < indices.count ; i += 3) {
+            auto& v0 = vertices.vertices[indices[i]];
+            auto& v1 = vertices.vertices[indices[i + 1]];
+            auto& v2 = vertices.vertices[indices[i + 2]];
+            result.area += glm::length(glm::cross(v1.pos - v0.pos, v2.pos - v0.pos)) * 0.5f;
+            glm::vec2 uv1 = v1.uv - v0.uv;
+            glm::vec2 uv2 = v2.uv - v0.uv;
+            result.uvArea += std::abs(uv1.x * uv2.y - uv1.y * uv2.x) * 0.5f;
+        }
+        return result;
     }
 
 }
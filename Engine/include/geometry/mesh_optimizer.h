@@ -0,0 +1,108 @@
+#pragma once
+
+#include <geometry/geometry.h>
+
+namespace gl {
+
+    // post-transform cache efficiency of an index buffer, simulated with FIFO cache
+    // ACMR - transformed vertices per triangle, 0.5 is ideal for regular grids, 3 is the worst
+    // ATVR - transformed vertices per unique vertex, 1 is ideal
+    struct GABRIEL_API VertexCacheStats final {
+        u32 triangles = 0;
+        u32 vertices = 0;
+        u32 transformed = 0;
+        float acmr = 0;
+        float atvr = 0;
+    };
+
+    struct GABRIEL_API MeshOptimizer final {
+        static constexpr u32 FIFO_CACHE_SIZE = 16;
+        static constexpr u32 INVALID_INDEX = ~0u;
+
+        static VertexCacheStats analyzeVertexCache(const u32* indices, size_t indexCount, size_t vertexCount, u32 cacheSize = FIFO_CACHE_SIZE);
+
+        // Forsyth linear-speed vertex cache ordering, reorders triangles only
+        static void optimizeVertexCache(u32* indices, size_t indexCount, size_t vertexCount);
+
+        // splits cache-optimized triangles into clusters at cache restarts and sorts clusters
+        // so that outward facing ones are drawn first, should run after optimizeVertexCache
+        // vertex position is read as vec3 at the beginning of each vertex
+        static void optimizeOverdraw(u32* indices, size_t indexCount, const u8* vertices, size_t vertexCount, size_t vertexStride);
+
+        // remap[old] = new, INVALID_INDEX for vertices that are dropped; returns new vertex count
+        static size_t remapDuplicates(u32* remap, const u8* vertices, size_t vertexCount, size_t vertexStride);
+        static size_t remapVertexFetch(u32* remap, const u32* indices, size_t indexCount, size_t vertexCount);
+
+        static void remapVertices(u8* dst, const u8* src, size_t vertexCount, size_t vertexStride, const u32* remap);
+        static void remapIndices(u32* indices, size_t indexCount, const u32* remap);
+
+        template<typename T>
+        static void deduplicate(Vertices<T>& vertices, Indices& indices);
+
+        template<typename T>
+        static void optimizeVertexFetch(Vertices<T>& vertices, Indices& indices);
+
+        // triangle order only, for geometry which relies on vertex order, like displaced grids
+        template<typename T>
+        static void optimizeIndices(Vertices<T>& vertices, Indices& indices);
+
+        // full import pipeline: dedup, vertex cache, overdraw, vertex fetch; logs ACMR/ATVR
+        template<typename T>
+        static void optimize(Vertices<T>& vertices, Indices& indices, const std::string& name);
+
+    private:
+        template<typename T>
+        static void remap(Vertices<T>& vertices, Indices& indices, const u32* remap, size_t newCount);
+    };
+
+    template<typename T>
+    void MeshOptimizer::remap(Vertices<T>& vertices, Indices& indices, const u32* remap, size_t newCount) {
+        Vertices<T> newVertices;
+        newVertices.init(newCount);
+        remapVertices((u8*) newVertices.vertices, (const u8*) vertices.vertices, vertices.count, sizeof(T), remap);
+        remapIndices(indices.indices, indices.count, remap);
+        vertices.free();
+        vertices = newVertices;
+    }
+
+    template<typename T>
+    void MeshOptimizer::deduplicate(Vertices<T>& vertices, Indices& indices) {
+        std::vector<u32> remapTable(vertices.count);
+        size_t newCount = remapDuplicates(remapTable.data(), (const u8*) vertices.vertices, vertices.count, sizeof(T));
+        if (newCount != vertices.count) {
+            remap(vertices, indices, remapTable.data(), newCount);
+        }
+    }
+
+    template<typename T>
+    void MeshOptimizer::optimizeVertexFetch(Vertices<T>& vertices, Indices& indices) {
+        std::vector<u32> remapTable(vertices.count);
+        size_t newCount = remapVertexFetch(remapTable.data(), indices.indices, indices.count, vertices.count);
+        remap(vertices, indices, remapTable.data(), newCount);
+    }
+
+    template<typename T>
+    void MeshOptimizer::optimizeIndices(Vertices<T>& vertices, Indices& indices) {
+        optimizeVertexCache(indices.indices, indices.count, vertices.count);
+        optimizeOverdraw(indices.indices, indices.count, (const u8*) vertices.vertices, vertices.count, sizeof(T));
+    }
+
+    template<typename T>
+    void MeshOptimizer::optimize(Vertices<T>& vertices, Indices& indices, const std::string& name) {
+        if (indices.count < 3 || vertices.count == 0) {
+            return;
+        }
+
+        VertexCacheStats before = analyzeVertexCache(indices.indices, indices.count, vertices.count);
+
+        deduplicate(vertices, indices);
+        optimizeIndices(vertices, indices);
+        optimizeVertexFetch(vertices, indices);
+
+        VertexCacheStats after = analyzeVertexCache(indices.indices, indices.count, vertices.count);
+
+        info("MeshOptimizer: {0} vertices {1} -> {2}, ACMR {3} -> {4}, ATVR {5} -> {6}",
+             name, before.vertices, after.vertices, before.acmr, after.acmr, before.atvr, after.atvr);
+    }
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <geometry/mesh_optimizer.h>
+
+namespace gl {
+
+    // quadric error metric simplification by edge collapses onto existing vertices,
+    // so simplified indices reference the same vertex buffer as the source mesh.
+    // vertices on borders are locked to keep silhouettes, vertices on attribute seams collapse only along the seam
+    // together with their pair on other side, so that UVs stay intact.
+    struct GABRIEL_API MeshSimplifier final {
+        static constexpr u32 LOD_COUNT = 4;
+        static constexpr float LOD_REDUCTION = 0.5f;
+
+        // writes at most indexCount indices into dst and returns their count,
+        // resultError is the largest collapse error in object space units
+        static size_t simplify(
+                u32* dst,
+                const u32* indices, size_t indexCount,
+                const u8* vertices, size_t vertexCount, size_t vertexStride,
+                size_t targetIndexCount, float targetError,
+                float& resultError
+        );
+
+        // chain of LOD_COUNT - 1 levels, every level halves triangle count of previous one
+        template<typename T>
+        static void generateLods(Vertices<T>& vertices, Indices& indices, std::vector<LodIndices>& lods, u32 lodCount = LOD_COUNT);
+    };
+
+    template<typename T>
+    void MeshSimplifier::generateLods(Vertices<T>& vertices, Indices& indices, std::vector<LodIndices>& lods, u32 lodCount) {
+        for (auto& lod : lods) {
+            lod.indices.free();
+        }
+        lods.clear();
+        lods.reserve(lodCount - 1);
+
+        const Indices* source = &indices;
+        float error = 0;
+
+        for (u32 i = 1 ; i < lodCount ; i++) {
+            size_t targetIndexCount = (size_t) (source->count * LOD_REDUCTION) / 3 * 3;
+
+            LodIndices lod;
+            lod.indices.init(source->count);
+            float levelError = 0;
+            lod.indices.count = simplify(
+                    lod.indices.indices,
+                    source->indices, source->count,
+                    (const u8*) vertices.vertices, vertices.count, sizeof(T),
+                    targetIndexCount, FLT_MAX,
+                    levelError
+            );
+            MeshOptimizer::optimizeVertexCache(lod.indices.indices, lod.indices.count, vertices.count);
+
+            // errors are accumulated, because every level is simplified from previous one
+            error += levelError;
+            lod.error = error;
+
+            lods.emplace_back(lod);
+            source = &lods.back().indices;
+        }
+    }
+
+}
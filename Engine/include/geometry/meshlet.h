@@ -0,0 +1,102 @@
+#pragma once
+
+#include <geometry/geometry.h>
+
+namespace gl {
+
+    struct GABRIEL_API Meshlet final {
+        // offsets into MeshletMesh::vertices and MeshletMesh::triangles
+        u32 vertexOffset = 0;
+        u32 triangleOffset = 0;
+        u32 vertexCount = 0;
+        u32 triangleCount = 0;
+    };
+
+    struct GABRIEL_API MeshletBounds final {
+        Sphere sphere;
+        // all triangle normals are within cone around axis, cutoff = sin(cone half angle)
+        // cutoff = 1 means the cone is too wide and meshlet can't be backface culled
+        glm::vec3 coneAxis = { 0, 0, 0 };
+        float coneCutoff = 1;
+    };
+
+    // range of source index buffer, meshlets are built in index order, so each one covers consecutive triangles
+    struct GABRIEL_API MeshletRange final {
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+    };
+
+    struct GABRIEL_API MeshletMesh final {
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshletBounds> bounds;
+        // indices into source vertex buffer
+        std::vector<u32> vertices;
+        // 3 local vertex indices per triangle
+        std::vector<u8> triangles;
+
+        void clear();
+    };
+
+    struct GABRIEL_API MeshletBuilder final {
+        static constexpr u32 MAX_VERTICES = 64;
+        static constexpr u32 MAX_TRIANGLES = 124;
+
+        // greedy partition in index order, so indices should be cache optimized beforehand
+        // vertex position is read as vec3 at the beginning of each vertex
+        static void build(
+                MeshletMesh& result,
+                const u32* indices, size_t indexCount,
+                const u8* vertices, size_t vertexCount, size_t vertexStride
+        );
+
+        template<typename T>
+        static void build(MeshletMesh& result, const Geometry<T>& geometry);
+    };
+
+    struct GABRIEL_API MeshletCuller final {
+        // object space bounds are moved to world space with model matrix, which is expected to have uniform scale
+        [[nodiscard]] static bool isVisible(
+                const MeshletBounds& bounds,
+                const Frustum& frustum,
+                const glm::mat4& model,
+                const glm::vec3& cameraPosition
+        );
+
+        // frustum test only, for passes that don't draw from camera position, as shadow maps
+        [[nodiscard]] static bool isVisible(
+                const MeshletBounds& bounds,
+                const Frustum& frustum,
+                const glm::mat4& model
+        );
+
+        // emits indices of meshlets that pass frustum and backface cone tests
+        static void cull(
+                std::vector<u32>& visible,
+                const MeshletMesh& mesh,
+                const Frustum& frustum,
+                const glm::mat4& model,
+                const glm::vec3& cameraPosition
+        );
+
+        // emits indices of meshlets that pass frustum test
+        static void cull(
+                std::vector<u32>& visible,
+                const MeshletMesh& mesh,
+                const Frustum& frustum,
+                const glm::mat4& model
+        );
+
+        // merges visible meshlets that are neighbours in index buffer into ranges
+        static void getRanges(std::vector<MeshletRange>& ranges, const MeshletMesh& mesh, const std::vector<u32>& visible);
+    };
+
+    template<typename T>
+    void MeshletBuilder::build(MeshletMesh& result, const Geometry<T>& geometry) {
+        build(
+                result,
+                geometry.indices.indices, geometry.indices.count,
+                (const u8*) geometry.vertices.vertices, geometry.vertices.count, sizeof(T)
+        );
+    }
+
+}
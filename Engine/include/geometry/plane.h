@@ -1,6 +1,6 @@
 #pragma once
 
-#include <geometry/geometry.h>
+#include <geometry/mesh_optimizer.h>
 
 namespace gl {
 
@@ -12,6 +12,8 @@ namespace gl {
 
         PlaneGeometry(int size) : size(size) {
             generate();
+            // vertex order is kept, terrain displacement maps vertices to height map as a grid
+            MeshOptimizer::optimizeIndices(this->vertices, this->indices);
         }
 
         void generate();
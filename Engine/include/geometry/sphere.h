@@ -1,6 +1,6 @@
 #pragma once
 
-#include <geometry/geometry.h>
+#include <geometry/mesh_optimizer.h>
 
 namespace gl {
 
@@ -13,6 +13,8 @@ namespace gl {
 
         SphereGeometry(int xSegments, int ySegments) : xSegments(xSegments), ySegments(ySegments) {
             generate();
+            // vertex order is kept, displacement maps vertices to height map as a grid
+            MeshOptimizer::optimizeIndices(this->vertices, this->indices);
         }
 
         void generate();
@@ -56,34 +58,31 @@ namespace gl {
             }
         }
 
-        bool oddRow = false;
-        Indices newIndices;
-        std::vector<u32> indexList;
+        // triangle list with the same winding as former strip, so that triangles can be reordered
+        this->indices.init(ySegments * xSegments * 6);
+        int k = 0;
 
         for (u32 y = 0; y < ySegments; y++) {
-            if (!oddRow) {
-                for (u32 x = 0; x <= xSegments; x++) {
-                    indexList.push_back(y * (xSegments + 1) + x);
-                    indexList.push_back((y + 1) * (xSegments + 1) + x);
-                }
+            for (u32 x = 0; x < xSegments; x++) {
+                u32 topLeft = y * (xSegments + 1) + x;
+                u32 bottomLeft = (y + 1) * (xSegments + 1) + x;
+                u32 topRight = topLeft + 1;
+                u32 bottomRight = bottomLeft + 1;
+
+                this->indices[k++] = topLeft;
+                this->indices[k++] = bottomLeft;
+                this->indices[k++] = topRight;
+
+                this->indices[k++] = topRight;
+                this->indices[k++] = bottomLeft;
+                this->indices[k++] = bottomRight;
             }
-            else {
-                for (int x = xSegments; x >= 0; x--) {
-                    indexList.push_back((y + 1) * (xSegments + 1) + x);
-                    indexList.push_back(y * (xSegments + 1) + x);
-                }
-            }
-            oddRow = !oddRow;
         }
-
-        newIndices.indices = indexList.data();
-        newIndices.count = (int) indexList.size();
-        this->indices.copyFrom(&newIndices);
     }
 
     template<typename T>
     void SphereGeometry<T>::init(DrawableElements &drawable) {
-        drawable.type = DrawType::TRIANGLE_STRIP;
+        drawable.type = DrawType::TRIANGLES;
         drawable.strips = 1;
         drawable.verticesPerStrip = this->indices.count;
         this->initDrawable(drawable);
@@ -18,9 +18,23 @@ namespace gl {
         Mat4 = 16,
     };
 
+    // storage type of attribute components, integer types are read as ivec in shaders, normalized as vec
+    enum AttributeType : u32 {
+        ATTRIBUTE_F32,
+        ATTRIBUTE_F16,
+        ATTRIBUTE_UNORM16,
+        ATTRIBUTE_SNORM16,
+        ATTRIBUTE_UNORM8,
+        ATTRIBUTE_U8,
+        ATTRIBUTE_I32
+    };
+
     struct GABRIEL_API Attribute {
         u32 location;
         PrimitiveType primitiveType;
+        AttributeType type = ATTRIBUTE_F32;
+
+        [[nodiscard]] size_t size() const;
     };
 
     namespace Attributes {
@@ -30,8 +44,16 @@ namespace gl {
         static constexpr Attribute NORMAL = {2, Vec3 };
         static constexpr Attribute TANGENT = {3, Vec3 };
         static constexpr Attribute BITANGENT = {4, Vec3 };
-        static constexpr Attribute BONE_ID = {5, Vec4 };
+        static constexpr Attribute BONE_ID = {5, Vec4, ATTRIBUTE_I32 };
         static constexpr Attribute WEIGHT = {6, Vec4 };
+
+        // quantized attributes, position has 4 components to keep next attributes 4 bytes aligned
+        static constexpr Attribute POS3_UNORM16 = {0, Vec4, ATTRIBUTE_UNORM16 };
+        static constexpr Attribute UV_F16 = {1, Vec2, ATTRIBUTE_F16 };
+        static constexpr Attribute NORMAL_OCT16 = {2, Vec2, ATTRIBUTE_SNORM16 };
+        static constexpr Attribute TANGENT_OCT16 = {3, Vec2, ATTRIBUTE_SNORM16 };
+        static constexpr Attribute BONE_ID_U8 = {5, Vec4, ATTRIBUTE_U8 };
+        static constexpr Attribute WEIGHT_UNORM8 = {6, Vec4, ATTRIBUTE_UNORM8 };
     }
 
     struct GABRIEL_API VertexFormat final {
@@ -41,6 +63,15 @@ namespace gl {
 
 #define VERTEX() static VertexFormat format;
 
+    // uniforms that restore quantized positions and octahedral normals in vertex shaders, see shaders/quantization.glsl
+    struct GABRIEL_API VertexDequantization final {
+        bool enabled = false;
+        glm::vec3 offset = { 0, 0, 0 };
+        glm::vec3 scale = { 1, 1, 1 };
+
+        void update(Shader& shader);
+    };
+
     struct GABRIEL_API VertexDefault final {
         VERTEX()
         glm::fvec3 pos = { 0, 0, 0 };
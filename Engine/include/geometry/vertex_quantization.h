@@ -0,0 +1,41 @@
+#pragma once
+
+#include <geometry/geometry.h>
+
+namespace gl {
+
+    struct GABRIEL_API VertexQuantizer final {
+        static u16 encodeUnorm16(float v);
+        static float decodeUnorm16(u16 v);
+
+        static int16_t encodeSnorm16(float v);
+        static float decodeSnorm16(int16_t v);
+
+        static u8 encodeUnorm8(float v);
+        static float decodeUnorm8(u8 v);
+
+        // octahedral mapping of unit vector onto [-1, 1] square
+        static glm::vec2 encodeOctahedral(const glm::vec3& direction);
+        static glm::vec3 decodeOctahedral(const glm::vec2& v);
+
+        static glm::i16vec2 encodeDirection(const glm::vec3& direction);
+        static glm::vec3 decodeDirection(const glm::i16vec2& v);
+
+        // position is stored as unorm16 relative to bounds, w is unused
+        static glm::u16vec4 encodePosition(const glm::vec3& position, const VertexDequantization& dequantization);
+        static glm::vec3 decodePosition(const glm::u16vec4& v, const VertexDequantization& dequantization);
+
+        // UVs may be out of [0, 1] for tiled textures, so they are stored as halfs
+        static glm::u16vec2 encodeUV(const glm::vec2& uv);
+        static glm::vec2 decodeUV(const glm::u16vec2& v);
+
+        // unused influences (id -1 or zero weight) are stored as bone 0 with zero weight,
+        // weights are normalized and rounded so that they still sum exactly to 255
+        static void encodeBones(const glm::ivec4& ids, const glm::vec4& weights, glm::u8vec4& encodedIds, glm::u8vec4& encodedWeights);
+        static void decodeBones(const glm::u8vec4& encodedIds, const glm::u8vec4& encodedWeights, glm::ivec4& ids, glm::vec4& weights);
+
+        // maps bounds onto unorm16 range, flat axes get a tiny scale to stay invertible
+        static VertexDequantization dequantization(const Bounds& bounds);
+    };
+
+}
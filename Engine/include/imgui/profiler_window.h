@@ -0,0 +1,26 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <debugging/profiler.h>
+
+namespace gl {
+
+    // frame time history and flame graph of selected frame, one row per thread and one for GPU
+    struct GABRIEL_API ProfilerWindow final {
+
+        static const char* title;
+        static glm::vec2 position;
+        static glm::vec2 resolution;
+        static ImGuiWindowFlags windowFlags;
+        static const char* traceFilepath;
+
+        static void render();
+
+    private:
+        static void end();
+        static void renderRow(const char* name, const std::vector<ProfileEvent>& events, u32 thread, bool gpu,
+                              u64 frameBegin, u64 frameEnd, float width);
+    };
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <api/image.h>
+
+namespace gl {
+
+    struct GABRIEL_API CompressionStats final {
+        // error over channels that format keeps: RGB for BC1, RG for BC5, RGBA for BC3 and BC7
+        double rmse = 0;
+        double psnr = 0;
+        double milliseconds = 0;
+    };
+
+    // CPU encoders and decoders of 4x4 blocks from/to RGBA8 pixels.
+    // BC1 and BC3 colors are fitted along principal axis and refined with least squares,
+    // BC7 is encoded with mode 6 only (single subset RGBA endpoints with p-bits and 4-bit indices).
+    struct GABRIEL_API BlockCompressor final {
+        static constexpr int BLOCK_SIZE = 4;
+
+        static void encodeBlockBC1(const u8* rgba, u8* block);
+        static void encodeBlockBC3(const u8* rgba, u8* block);
+        // single channel of RGBA pixels, used for BC3 alpha and both BC5 channels
+        static void encodeBlockBC4(const u8* rgba, int channel, u8* block);
+        static void encodeBlockBC5(const u8* rgba, u8* block);
+        static void encodeBlockBC7(const u8* rgba, u8* block);
+
+        static void decodeBlockBC1(const u8* block, u8* rgba);
+        static void decodeBlockBC3(const u8* block, u8* rgba);
+        static void decodeBlockBC4(const u8* block, int channel, u8* rgba);
+        static void decodeBlockBC5(const u8* block, u8* rgba);
+        // other modes than 6 are decoded as magenta
+        static void decodeBlockBC7(const u8* block, u8* rgba);
+
+        static size_t getBlockBytes(BlockFormat format);
+        static size_t getSize(int width, int height, BlockFormat format);
+
+        // rgba has width * height * 4 bytes, edge blocks are padded by clamping,
+        // rows of blocks are encoded in parallel on ThreadPool
+        static void compress(const u8* rgba, int width, int height, BlockFormat format, std::vector<u8>& result);
+        static void decompress(const u8* blocks, int width, int height, BlockFormat format, std::vector<u8>& rgba);
+
+        // compresses image and decodes it back to measure encoder speed and quality
+        static CompressionStats measure(const u8* rgba, int width, int height, BlockFormat format);
+    };
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <io/serialization.h>
+
+namespace gl {
+
+    // on-disk cache of data derived from source assets: cooked meshes and textures, preprocessed shaders and IBL maps.
+    // entries are addressed by hash of source contents and of settings that derived data depends on,
+    // so edited sources or changed settings get new entries, while touched or copied sources keep hitting old ones.
+    // can be used from any thread.
+    struct GABRIEL_API DerivedDataCache final {
+
+        static void setDirectory(const std::string& directory);
+        static const std::string& getDirectory();
+
+        // entries over budget are evicted by free, least recently looked up first
+        static void setBudget(u64 bytes);
+        static u64 getBudget();
+
+        // saves memoized file hashes for the next run and trims entries to budget
+        static void free();
+
+        // 64-bit xxHash
+        static u64 hash(const void* data, size_t size, u64 seed = 0);
+        static u64 hash(const std::string& string, u64 seed = 0);
+
+        // hash of file contents, memoized by path, size and modification time, so that unchanged files are read only once.
+        // returns 0 if file can't be read
+        static u64 hashFile(const std::string& filepath);
+
+        // <directory>/<type>/<key in hex><extension>, type directory is created if missing
+        static std::string getPath(const std::string& type, u64 key, const std::string& extension);
+        // key of source contents and settings. if source can't be read, its last hash from index is used,
+        // so that cooked data outlives sources removed from disk. empty if source was never hashed
+        static std::string getPath(const std::string& type, const std::string& sourceFilepath, const std::string& settings, const std::string& extension);
+
+        // entries are raw bytes without size prefix of BinaryStream::write.
+        // they are written to temporary file and renamed, so that readers and crashes never see partial entries
+        static bool store(const std::string& path, const void* data, size_t size);
+        static bool store(const std::string& path, BinaryStream& stream);
+        // returns false if entry is missing
+        static bool load(const std::string& path, BinaryStream& stream);
+
+    private:
+        struct FileHash final {
+            u64 size = 0;
+            u64 time = 0;
+            u64 hash = 0;
+        };
+
+        static void loadIndex();
+        static void saveIndex();
+        static void trim();
+
+    private:
+        static std::string s_directory;
+        static std::unordered_map<std::string, FileHash> s_files;
+        static std::mutex s_mutex;
+        static bool s_indexLoaded;
+        static bool s_indexDirty;
+        static u64 s_budget;
+    };
+
+}
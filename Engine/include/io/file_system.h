@@ -0,0 +1,130 @@
+#pragma once
+
+namespace gl {
+
+    // contents of virtual file, points either into mapped archive or into its own buffer
+    struct GABRIEL_API FileBlob final {
+        const u8* data = null;
+        size_t size = 0;
+
+        FileBlob() = default;
+        FileBlob(const FileBlob&) = delete;
+        FileBlob& operator=(const FileBlob&) = delete;
+        // moved buffer keeps its memory, so data stays valid
+        FileBlob(FileBlob&&) = default;
+        FileBlob& operator=(FileBlob&&) = default;
+
+        inline std::string toString() const {
+            return std::string((const char*) data, size);
+        }
+
+    private:
+        friend struct FileSystem;
+        friend struct PackedArchive;
+        std::vector<u8> mBuffer;
+    };
+
+    // binary layout of packed archive:
+    // header | data of entries aligned to ALIGNMENT | entries | hash table of entry indices | paths
+    // TOC is written after data, so that packing streams files one by one,
+    // and it's used in place from mapped memory, so that mounting doesn't parse or allocate anything.
+    struct GABRIEL_API PackedArchiveHeader final {
+        static constexpr u32 MAGIC = 0x4B415047; // GPAK
+        static constexpr u32 VERSION = 1;
+
+        u32 magic = MAGIC;
+        u32 version = VERSION;
+        u32 entryCount = 0;
+        // power of 2, open addressing with linear probing
+        u32 bucketCount = 0;
+        u64 entriesOffset = 0;
+        u64 bucketsOffset = 0;
+        u64 pathsOffset = 0;
+        u64 pathsSize = 0;
+    };
+
+    enum PackedEntryFlags : u32 {
+        PACKED_ENTRY_COMPRESSED = 1 << 0
+    };
+
+    struct GABRIEL_API PackedArchiveEntry final {
+        u64 pathHash = 0;
+        // hash of uncompressed contents, DerivedDataCache takes it instead of reading file
+        u64 contentHash = 0;
+        u64 offset = 0;
+        u64 size = 0;
+        u64 packedSize = 0;
+        u32 pathOffset = 0;
+        u32 pathLength = 0;
+        u32 flags = 0;
+        u32 padding = 0;
+    };
+
+    struct GABRIEL_API PackedArchive final {
+        static const char* EXTENSION;
+        static constexpr u64 ALIGNMENT = 64;
+
+        PackedArchive() = default;
+        PackedArchive(const PackedArchive&) = delete;
+        PackedArchive& operator=(const PackedArchive&) = delete;
+        ~PackedArchive();
+
+        // maps whole archive into memory
+        bool open(const std::string& filepath);
+        void close();
+
+        // path must be normalized with FileSystem::normalize
+        [[nodiscard]] const PackedArchiveEntry* find(const std::string& filepath) const;
+        // uncompressed entries are returned without copy
+        bool read(const PackedArchiveEntry& entry, FileBlob& blob) const;
+
+        // offline step: packs all files under directories, entries are LZ4 compressed if it saves at least 1/8 of size
+        static bool pack(const std::string& filepath, const std::vector<std::string>& directories, bool compress = true);
+
+    private:
+        std::string mFilepath;
+        const u8* mData = null;
+        size_t mSize = 0;
+        const PackedArchiveHeader* mHeader = null;
+        const PackedArchiveEntry* mEntries = null;
+        const u32* mBuckets = null;
+        const char* mPaths = null;
+        // file mapping object on Windows
+        void* mMapping = null;
+    };
+
+    // virtual file system over mounted packed archives with fallback to loose files for development.
+    // paths are the same as on disk relative to working directory, e.g. "shaders/pbr/pbr.frag".
+    // archives must be mounted before assets are loaded, reading can be done from any thread.
+    struct GABRIEL_API FileSystem final {
+        // archives mounted later override entries of earlier ones
+        static bool mount(const std::string& archiveFilepath);
+        static void free();
+
+        // files missing in archives are read from disk, enabled by default
+        static void setLooseFiles(bool enabled);
+
+        static bool exists(const std::string& filepath);
+        static bool read(const std::string& filepath, FileBlob& blob);
+        static bool readText(const std::string& filepath, std::string& text);
+        // archived files are passed to callback right away, loose files are read as one batch of IOService
+        // and passed to callback on I/O thread as they complete, so callback should hand heavy work over to ThreadPool
+        static void readAsync(const std::vector<std::string>& filepaths, const std::function<void(u32 index, bool success, FileBlob& blob)>& callback);
+        // content hash of archived file, false for loose files
+        static bool getHash(const std::string& filepath, u64& hash);
+
+        // forward slashes without "." and ".." segments, the form paths are stored in archives
+        static std::string normalize(const std::string& filepath);
+
+    private:
+        friend struct PackedArchive;
+
+        static const PackedArchiveEntry* find(const std::string& filepath, const PackedArchive** archive);
+        static bool readLoose(const std::string& filepath, FileBlob& blob);
+
+    private:
+        static std::vector<PackedArchive*> s_archives;
+        static bool s_looseFiles;
+    };
+
+}
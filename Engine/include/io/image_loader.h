@@ -7,10 +7,49 @@ namespace gl {
     struct GABRIEL_API ImageReader final {
         static Image read(const char* filepath, const bool flipUV = false, const PixelType pixelType = PixelType::U8, const bool srgb = false);
         static std::array<Image, 6> read(const std::array<ImageFace, 6> &faces);
+        // decodes encoded file contents, e.g. of FileBlob
+        static Image decode(const u8* data, size_t size, const bool flipUV = false, const PixelType pixelType = PixelType::U8, const bool srgb = false);
+        // decodes on ThreadPool, image must be uploaded and freed by the caller on GL thread
+        static std::future<Image> readAsync(const std::string& filepath, const bool flipUV = false, const PixelType pixelType = PixelType::U8, const bool srgb = false);
     };
 
     struct GABRIEL_API ImageWriter final {
         static void write(const char* filepath, const Image& image);
     };
 
-}
\ No newline at end of file
+    struct GABRIEL_API ImageUpload final {
+        std::string filepath;
+        bool flipUV = false;
+        PixelType pixelType = PixelType::U8;
+        bool srgb = false;
+        bool normalMap = false;
+        // U8 images are loaded from cooked block compressed file, which is cooked on first load
+        bool compress = false;
+        // only mip tail of compressed mipmapped image is uploaded, finer mips are streamed by TextureStreamer
+        bool stream = false;
+        ImageParams params;
+        ImageBuffer buffer;
+        // GPU memory taken by uploaded image including mip chain, filled by ImageUploader
+        size_t bytes = 0;
+    };
+
+    // CPU side of ImageUpload, either decoded pixels or cooked block compressed mips
+    struct GABRIEL_API DecodedImage final {
+        Image image;
+        CompressedImage compressed;
+        std::string cookedFilepath;
+        bool isCompressed = false;
+    };
+
+    struct GABRIEL_API ImageUploader final {
+        // decodes all images on worker threads and uploads each one on calling GL thread
+        // as soon as its decode finishes, so uploads overlap with decoding of the rest
+        static void load(std::vector<ImageUpload>& uploads);
+
+        // starts decoding of all images on worker threads without touching GL, futures are in order of uploads
+        static std::vector<std::future<DecodedImage>> decode(const std::vector<ImageUpload>& uploads);
+        // GL thread only, fills buffer and bytes of upload, upload is left invalid if image failed to decode
+        static void upload(ImageUpload& upload, DecodedImage& decoded);
+    };
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+namespace gl {
+
+    struct GABRIEL_API IOResult final {
+        size_t bytes = 0;
+        // false if file can't be opened or read, reading past end of file is not an error
+        bool success = false;
+    };
+
+    struct GABRIEL_API IORequest final {
+        std::string filepath;
+        u64 offset = 0;
+        size_t size = 0;
+        // destination of size bytes, must stay alive until request is completed
+        void* buffer = null;
+        // called on I/O thread right before future of request gets ready, must not block on other reads
+        std::function<void(const IOResult&)> callback;
+    };
+
+    // reads byte ranges of files asynchronously.
+    // on Linux requests go through io_uring, every batch is submitted with one syscall and completes in any order,
+    // so that level loads keep deep queues of NVMe drives busy. elsewhere, or if kernel has no io_uring,
+    // requests are read on ThreadPool.
+    struct GABRIEL_API IOService final {
+        static constexpr u32 QUEUE_DEPTH = 128;
+
+        static void init();
+        static void free();
+
+        // true if io_uring is used
+        static bool isAsync();
+
+        static std::future<IOResult> read(const IORequest& request);
+        static std::vector<std::future<IOResult>> read(const std::vector<IORequest>& requests);
+        // blocks calling thread, may be called from ThreadPool workers
+        static IOResult readSync(const IORequest& request);
+
+    private:
+        struct Operation;
+
+        static void complete(Operation* operation, bool success);
+        static void readOnPool(Operation* operation);
+
+        static bool initRing();
+        static void freeRing();
+        static void submitRing(std::vector<Operation*>& operations);
+        static void pushRing(Operation* operation);
+        // submitted entries the kernel didn't take are taken back into rejected
+        static void enterRing(u32 submitCount, std::vector<Operation*>& rejected);
+        static void reapRing();
+
+    private:
+        static bool s_async;
+    };
+
+}
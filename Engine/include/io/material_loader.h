@@ -4,14 +4,44 @@
 
 #include <features/material.h>
 
+#include <io/texture_cache.h>
+
 namespace gl {
 
+    // texture files referenced by an imported material, resolved against the model directory
+    struct GABRIEL_API MaterialSources final {
+        std::string albedo;
+        std::string normal;
+        std::string parallax;
+        std::string metallic;
+        std::string roughness;
+        std::string ao;
+        std::string emission;
+        bool flipUV = false;
+
+        static constexpr u32 TEXTURE_COUNT = 7;
+    };
+
     struct GABRIEL_API MaterialLoader final {
         static u32 parseMaterial(
                 std::unordered_map<u32, Material>& materials,
                 const aiScene* scene, aiMesh* mesh,
                 const std::string& directory, u32 flags
         );
+
+        static u32 parseSources(
+                std::unordered_map<u32, MaterialSources>& sources,
+                const aiScene* scene, aiMesh* mesh,
+                const std::string& directory, u32 flags
+        );
+
+        // empty sources are skipped by TextureCache, their textures are left disabled
+        static void addRequests(std::vector<TextureRequest>& requests, const MaterialSources& sources);
+        // material of TEXTURE_COUNT requests added by addRequests and resolved by TextureCache
+        static Material create(const TextureRequest* requests);
+
+        static Material load(const MaterialSources& sources);
+        static void load(const std::unordered_map<u32, MaterialSources>& sources, std::unordered_map<u32, Material>& materials);
     };
 
-}
\ No newline at end of file
+}
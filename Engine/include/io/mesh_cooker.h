@@ -0,0 +1,53 @@
+#pragma once
+
+#include <io/model_loader.h>
+#include <io/skeletal_loader.h>
+#include <io/derived_data_cache.h>
+
+namespace gl {
+
+    // binary layout of cooked mesh file:
+    // header | mesh records | vertex blob | index blob | LOD blob | material sources | skeleton (skeletal only)
+    // vertex and index blobs are laid out exactly as VertexMesh/SkeletalVertex and u32 indices,
+    // so loading is a single file read followed by one memcpy per mesh.
+    struct GABRIEL_API CookedMeshHeader final {
+        static constexpr u32 MAGIC = 0x48534D47; // GMSH
+        static constexpr u32 VERSION = 5;
+
+        u32 magic = MAGIC;
+        u32 version = VERSION;
+        u32 flags = 0;
+        u32 vertexStride = 0;
+        u32 meshCount = 0;
+        u32 materialCount = 0;
+        u32 boneCount = 0;
+        u32 skeletal = 0;
+        Bounds bounds;
+    };
+
+    struct GABRIEL_API CookedMeshRecord final {
+        u32 vertexCount = 0;
+        u32 indexCount = 0;
+        u32 materialIndex = 0;
+        u32 lodCount = 0;
+    };
+
+    struct GABRIEL_API MeshCooker final {
+        static const char* EXTENSION;
+
+        // entry of DerivedDataCache keyed by source contents and import flags
+        static std::string getCookedPath(const std::string& filepath, u32 flags, bool skeletal);
+
+        static void cook(const std::string& cookedFilepath, const std::string& sourceFilepath, Model& model, u32 flags);
+        static void cook(const std::string& cookedFilepath, const std::string& sourceFilepath, SkeletalModel& model, u32 flags);
+
+        // returns false if cooked file is missing or was cooked with different import flags
+        static bool load(const std::string& cookedFilepath, Model& model, u32 flags);
+        static bool load(const std::string& cookedFilepath, SkeletalModel& model, u32 flags);
+
+        // offline step: imports source with Assimp and writes cooked file into DerivedDataCache
+        static void cookModel(const std::string& filepath, u32 flags);
+        static void cookSkeletalModel(const std::string& filepath, u32 flags);
+    };
+
+}
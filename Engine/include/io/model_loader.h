@@ -4,6 +4,7 @@
 
 #include "geometry/vertex.h"
 #include "geometry/geometry.h"
+#include "geometry/vertex_quantization.h"
 
 namespace gl {
 
@@ -15,6 +16,18 @@ namespace gl {
         glm::fvec3 tangent = { 0, 0, 0 };
     };
 
+    // 20 bytes instead of 44 of VertexMesh, decoded by shaders/quantization.glsl
+    struct GABRIEL_API VertexMeshQuantized final {
+        VERTEX()
+        glm::u16vec4 pos = { 0, 0, 0, 0 };
+        glm::u16vec2 uv = { 0, 0 };
+        glm::i16vec2 normal = { 0, 0 };
+        glm::i16vec2 tangent = { 0, 0 };
+
+        static VertexMeshQuantized encode(const VertexMesh& vertex, const VertexDequantization& dequantization);
+        [[nodiscard]] VertexMesh decode(const VertexDequantization& dequantization) const;
+    };
+
     struct GABRIEL_API Mesh : Geometry<VertexMesh> {
         u32 materialIndex = 0;
     };
@@ -22,10 +35,20 @@ namespace gl {
     struct GABRIEL_API Model final {
         std::vector<Mesh> meshes;
         std::unordered_map<u32, Material> materials;
+        std::unordered_map<u32, MaterialSources> materialSources;
+        Bounds bounds;
+        // filled by init, levels of LOD chain in drawable index buffer
+        std::vector<LodLevel> lods;
+        // init uploads VertexMeshQuantized with positions relative to model bounds
+        bool quantized = false;
 
         void init(DrawableElements& drawable);
         void free();
 
+        // sum over all meshes, its UV density drives TextureStreamer
+        [[nodiscard]] SurfaceArea surfaceArea() const;
+
+        // loads cooked mesh if it's up-to-date, otherwise imports with Assimp and cooks it for the next run
         void generate(
                 const std::string& filepath,
                 u32 flags = aiProcess_Triangulate
@@ -33,6 +56,15 @@ namespace gl {
                             | aiProcess_CalcTangentSpace
                             | aiProcess_OptimizeMeshes
         );
+
+        // CPU part of generate, safe to call on worker threads, material textures are left to caller
+        void loadMeshes(const std::string& filepath, u32 flags);
+
+        // imports meshes and material sources with Assimp, optimizes meshes for GPU and generates LOD chains, without touching GL
+        void import(const std::string& filepath, u32 flags);
+
+        // encodes vertices of all meshes in order
+        void encodeQuantized(std::vector<VertexMeshQuantized>& result, const VertexDequantization& dequantization) const;
     };
 
 }
\ No newline at end of file
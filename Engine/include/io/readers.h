@@ -4,6 +4,8 @@ namespace gl {
 
     struct GABRIEL_API FileReader final {
         static std::string read(const char* filepath);
+        // size and modification time, DerivedDataCache memoizes file hashes by them
+        static bool readStamp(const std::string& filepath, u64& size, u64& time);
     };
 
 }
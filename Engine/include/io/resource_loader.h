@@ -0,0 +1,192 @@
+#pragma once
+
+#include <io/model_loader.h>
+#include <io/skeletal_loader.h>
+
+#include <core/thread_pool.h>
+
+namespace gl {
+
+    enum ResourceState : u32 {
+        RESOURCE_LOADING,
+        RESOURCE_READY,
+        RESOURCE_FAILED
+    };
+
+    // shared between owner and ResourceLoader, resolves to copy of placeholder until resource is ready.
+    // value is prepared on worker threads while loading, so owner must not touch it before isReady,
+    // state changes on GL thread only.
+    template<typename T>
+    struct ResourceHandle final {
+        ResourceHandle() = default;
+
+        explicit ResourceHandle(const T& placeholder) : mSlot(std::make_shared<Slot>()) {
+            mSlot->value = placeholder;
+        }
+
+        [[nodiscard]] inline bool isValid() const { return mSlot != null; }
+        [[nodiscard]] inline ResourceState getState() const { return mSlot ? mSlot->state : RESOURCE_FAILED; }
+        [[nodiscard]] inline bool isReady() const { return getState() == RESOURCE_READY; }
+        [[nodiscard]] inline bool isLoading() const { return getState() == RESOURCE_LOADING; }
+
+        inline T& get() { return mSlot->value; }
+        inline const T& get() const { return mSlot->value; }
+
+        inline T* operator->() { return &mSlot->value; }
+        inline const T* operator->() const { return &mSlot->value; }
+
+        inline void setState(ResourceState state) { mSlot->state = state; }
+
+    private:
+        struct Slot final {
+            T value;
+            ResourceState state = RESOURCE_LOADING;
+        };
+
+        std::shared_ptr<Slot> mSlot;
+    };
+
+    typedef ResourceHandle<ImageBuffer> TextureHandle;
+    typedef ResourceHandle<Material> MaterialHandle;
+    typedef ResourceHandle<Model> ModelHandle;
+    typedef ResourceHandle<SkeletalModel> SkeletalModelHandle;
+
+    struct GABRIEL_API ResourceLoaderStats final {
+        // jobs that are still prepared on worker threads or wait for budget
+        u32 pending = 0;
+        // uploads of the last frame
+        u32 uploads = 0;
+        size_t bytes = 0;
+        float millis = 0;
+        // bytes uploaded since init
+        u64 totalBytes = 0;
+    };
+
+    // streams resources in without stalling frames.
+    // CPU work, like reading, decoding, importing and cooking, runs on ThreadPool,
+    // finished jobs are uploaded to GL on update as long as they fit into per-frame budget of bytes and milliseconds.
+    // at least one job is uploaded every frame, so that resources larger than budget still make progress.
+    // onReady callbacks are called on GL thread from update, they may submit new jobs.
+    struct GABRIEL_API ResourceLoader final {
+        static void init();
+        // jobs in flight are dropped, their handles stay in loading state
+        static void free();
+
+        static void setBudget(size_t bytesPerFrame, float millisPerFrame);
+
+        static void update();
+
+        [[nodiscard]] static bool isIdle();
+        static const ResourceLoaderStats& getStats();
+
+        // 1x1 white texture, bound in place of textures that are still loading
+        static const ImageBuffer& getPlaceholderTexture();
+        // unit cube drawn in place of meshes that are still loading
+        static void initPlaceholder(DrawableElements& drawable);
+
+        static TextureHandle loadTexture(
+                const std::string& filepath,
+                bool flipUV = false,
+                const ImageParams& params = {},
+                const std::function<void(ImageBuffer&)>& onReady = {}
+        );
+
+        // textures come from TextureCache and get disabled in resolved material if they fail to load
+        static MaterialHandle loadMaterial(const MaterialSources& sources, const std::function<void(Material&)>& onReady = {});
+
+        // meshes are loaded or imported on ThreadPool, onReady is called on GL thread to upload them,
+        // materials of model are loaded afterwards in the same way and filled in as they are ready
+        template<typename T>
+        static ResourceHandle<T> loadModel(
+                const std::string& filepath,
+                const std::function<void(T&)>& onReady,
+                u32 flags = aiProcess_Triangulate
+                            | aiProcess_FlipUVs
+                            | aiProcess_CalcTangentSpace
+                            | aiProcess_OptimizeMeshes
+        );
+
+        // prepared future is produced on worker threads, upload is called on GL thread once it's ready
+        // and returns number of bytes that it uploaded
+        template<typename T>
+        static void submit(std::future<T>&& prepared, std::function<size_t(T&)>&& upload);
+
+    private:
+        struct Job final {
+            std::function<bool()> isPrepared;
+            std::function<size_t()> upload;
+        };
+
+        template<typename T>
+        static size_t getBytes(const T& model);
+
+    private:
+        static std::list<Job> s_jobs;
+        static size_t s_budgetBytes;
+        static float s_budgetMillis;
+        static ResourceLoaderStats s_stats;
+        static ImageBuffer s_placeholderTexture;
+    };
+
+    template<typename T>
+    void ResourceLoader::submit(std::future<T>&& prepared, std::function<size_t(T&)>&& upload) {
+        auto future = std::make_shared<std::future<T>>(std::move(prepared));
+        auto callback = std::make_shared<std::function<size_t(T&)>>(std::move(upload));
+
+        Job job;
+        job.isPrepared = [future]() {
+            return future->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        };
+        job.upload = [future, callback]() {
+            T value = future->get();
+            return (*callback)(value);
+        };
+        s_jobs.emplace_back(std::move(job));
+    }
+
+    template<typename T>
+    size_t ResourceLoader::getBytes(const T& model) {
+        size_t bytes = 0;
+        for (auto& mesh : model.meshes) {
+            bytes += mesh.vertices.size() + mesh.indices.size();
+            for (auto& lod : mesh.lods) {
+                bytes += lod.indices.size();
+            }
+        }
+        return bytes;
+    }
+
+    template<typename T>
+    ResourceHandle<T> ResourceLoader::loadModel(const std::string& filepath, const std::function<void(T&)>& onReady, u32 flags) {
+        ResourceHandle<T> handle = ResourceHandle<T>(T());
+
+        // worker keeps its own reference, as owner may drop handle while model is still imported
+        submit<bool>(ThreadPool::submit([handle, filepath, flags]() mutable {
+            handle->loadMeshes(filepath, flags);
+            return !handle->meshes.empty();
+        }), [handle, filepath, onReady](bool& loaded) mutable {
+            if (!loaded) {
+                error("Failed to load model {0}", filepath);
+                handle.setState(RESOURCE_FAILED);
+                return (size_t) 0;
+            }
+
+            if (onReady) {
+                onReady(handle.get());
+            }
+            handle.setState(RESOURCE_READY);
+
+            for (auto& source : handle->materialSources) {
+                u32 materialIndex = source.first;
+                loadMaterial(source.second, [handle, materialIndex](Material& material) mutable {
+                    handle->materials[materialIndex] = material;
+                });
+            }
+
+            return getBytes(handle.get());
+        });
+
+        return handle;
+    }
+
+}
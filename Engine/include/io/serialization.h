@@ -21,6 +21,25 @@ namespace gl {
             return mBuffer.size();
         }
 
+        inline void resize(size_t size) {
+            mBuffer.resize(size);
+        }
+
+        // bytes left to get from cursor
+        inline size_t remaining() const {
+            return mCursor < mBuffer.size() ? mBuffer.size() - mCursor : 0;
+        }
+
+        // set when get would read past the end, nothing is read after that
+        inline bool isFailed() const {
+            return mFailed;
+        }
+
+        // readers fail stream on counts that can't fit into bytes left
+        inline void fail() {
+            mFailed = true;
+        }
+
         void clear();
 
         template<class T>
@@ -33,6 +52,8 @@ namespace gl {
 
         void add(BinaryStream& stream);
 
+        void add(const void* data, size_t newSize);
+
         template<class T>
         void get(T& primitive);
 
@@ -41,18 +62,17 @@ namespace gl {
         template<class T>
         void get(std::vector<T>& vector);
 
+        void get(void* data, size_t size);
+
         void write(const char* filepath);
         void read(const char* filepath);
 
         void seek(size_t index);
 
-    private:
-        void add(void* data, size_t newSize);
-        void get(void* data, size_t size);
-
     private:
         std::vector<u8> mBuffer;
         size_t mCursor = 0;
+        bool mFailed = false;
     };
 
     template<class T>
@@ -76,6 +96,11 @@ namespace gl {
     void BinaryStream::get(std::vector<T>& vector) {
         size_t size = 0;
         get(size);
+        // size comes from data, it's checked before allocating
+        if (size > remaining() / sizeof(T)) {
+            mFailed = true;
+            return;
+        }
         vector.resize(size);
         get(vector.data(), size * sizeof(T));
     }
@@ -2,6 +2,7 @@
 
 #include "geometry/vertex.h"
 #include "geometry/geometry.h"
+#include "geometry/vertex_quantization.h"
 
 #include "material_loader.h"
 
@@ -17,6 +18,20 @@ namespace gl {
         glm::fvec4 weight = {0, 0, 0, 0 };
     };
 
+    // 28 bytes instead of 76 of SkeletalVertex, decoded by shaders/quantization.glsl
+    struct GABRIEL_API SkeletalVertexQuantized final {
+        VERTEX()
+        glm::u16vec4 pos = { 0, 0, 0, 0 };
+        glm::u16vec2 uv = { 0, 0 };
+        glm::i16vec2 normal = { 0, 0 };
+        glm::i16vec2 tangent = { 0, 0 };
+        glm::u8vec4 bone_id = { 0, 0, 0, 0 };
+        glm::u8vec4 weight = { 0, 0, 0, 0 };
+
+        static SkeletalVertexQuantized encode(const SkeletalVertex& vertex, const VertexDequantization& dequantization);
+        [[nodiscard]] SkeletalVertex decode(const VertexDequantization& dequantization) const;
+    };
+
     struct GABRIEL_API SkeletalMesh : Geometry<SkeletalVertex> {
         u32 materialIndex = 0;
     };
@@ -74,12 +89,22 @@ namespace gl {
     struct GABRIEL_API SkeletalModel final {
         std::vector<SkeletalMesh> meshes;
         std::unordered_map<u32, Material> materials;
+        std::unordered_map<u32, MaterialSources> materialSources;
         std::unordered_map<std::string, Bone> bones;
         Animation animation;
+        Bounds bounds;
+        // filled by init, levels of LOD chain in drawable index buffer
+        std::vector<LodLevel> lods;
+        // init uploads SkeletalVertexQuantized with positions relative to model bounds
+        bool quantized = false;
 
         void init(DrawableElements& drawable);
         void free();
 
+        // sum over all meshes, its UV density drives TextureStreamer
+        [[nodiscard]] SurfaceArea surfaceArea() const;
+
+        // loads cooked mesh if it's up-to-date, otherwise imports with Assimp and cooks it for the next run
         void generate(
                 const std::string& filepath,
                 u32 flags = aiProcess_Triangulate
@@ -87,6 +112,15 @@ namespace gl {
                             | aiProcess_CalcTangentSpace
                             | aiProcess_OptimizeMeshes
         );
+
+        // CPU part of generate, safe to call on worker threads, material textures are left to caller
+        void loadMeshes(const std::string& filepath, u32 flags);
+
+        // imports meshes, skeleton and material sources with Assimp, optimizes meshes for GPU and generates LOD chains, without touching GL
+        void import(const std::string& filepath, u32 flags);
+
+        // encodes vertices of all meshes in order
+        void encodeQuantized(std::vector<SkeletalVertexQuantized>& result, const VertexDequantization& dequantization) const;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <io/image_loader.h>
+
+namespace gl {
+
+    struct GABRIEL_API TextureRequest final {
+        // empty filepath is skipped and resolves to InvalidImageBuffer
+        std::string filepath;
+        bool flipUV = false;
+        // normal maps are cooked to BC5, see TextureCooker
+        bool normalMap = false;
+        // opt-in, loads block compressed mip chain cooked by TextureCooker, U8 images only
+        bool compress = false;
+        // mips finer than TextureStreamer::TAIL_SIZE are streamed by TextureStreamer
+        bool stream = true;
+        ImageParams params;
+        // filled by TextureCache, InvalidImageBuffer if file can't be loaded
+        ImageBuffer buffer;
+    };
+
+    struct GABRIEL_API TextureCacheStats final {
+        u64 hits = 0;
+        u64 misses = 0;
+        u64 evictions = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+        u32 textures = 0;
+        u32 referenced = 0;
+    };
+
+    // engine-wide texture cache, keyed by canonical path, flip and sampling params.
+    // budget of streamed textures counts only their mip tails, the rest is under TextureStreamer budget.
+    // every acquire must be paired with release, unreferenced textures stay resident
+    // until the cache grows over its budget and then get evicted in LRU order.
+    // must be used from GL thread only.
+    struct GABRIEL_API TextureCache final {
+
+        static void free();
+
+        static void setBudget(size_t bytes);
+
+        static ImageBuffer acquire(const std::string& filepath, bool flipUV = false, const ImageParams& params = {});
+        // misses are decoded in parallel with ImageUploader
+        static void acquire(std::vector<TextureRequest>& requests);
+        // misses are decoded on worker threads and uploaded by ResourceLoader within its frame budget,
+        // onReady is called on GL thread once buffers of all requests are filled, right away if all of them hit
+        static void acquireAsync(const std::vector<TextureRequest>& requests, const std::function<void(std::vector<TextureRequest>&)>& onReady);
+
+        // textures that don't belong to cache are deleted right away
+        static void release(ImageBuffer& buffer);
+
+        static void evict();
+
+        static const TextureCacheStats& getStats();
+
+    private:
+        struct Entry final {
+            ImageBuffer buffer;
+            size_t bytes = 0;
+            u32 refs = 0;
+            std::list<std::string>::iterator lru;
+        };
+
+        struct Batch;
+
+        // request of async batch waiting for texture that is in flight
+        struct Waiter final {
+            std::shared_ptr<Batch> batch;
+            u32 index = 0;
+        };
+
+        static std::string getKey(const TextureRequest& request);
+        static void reference(Entry& entry);
+        // takes uploaded buffer into cache, buffer of key that is cached already is dropped
+        static void insert(const std::string& key, ImageUpload& upload);
+
+        static void resolve(const Waiter& waiter, const std::string& key);
+        static void complete(const std::string& key, ImageUpload& upload);
+
+    private:
+        static std::unordered_map<std::string, Entry> s_entries;
+        static std::unordered_map<u32, std::string> s_keys;
+        // unreferenced keys, most recently released first
+        static std::list<std::string> s_lru;
+        // keys of async uploads in flight, so that every texture is decoded once
+        static std::unordered_map<std::string, std::vector<Waiter>> s_pending;
+        static TextureCacheStats s_stats;
+    };
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <io/block_compressor.h>
+#include <io/derived_data_cache.h>
+
+namespace gl {
+
+    struct GABRIEL_API TextureCookSettings final {
+        bool flipUV = false;
+        bool srgb = false;
+        // stored as BC5 with X and Y only, shaders restore Z
+        bool normalMap = false;
+        // full mip chain down to 1x1, otherwise only the base level is cooked
+        bool mipmaps = true;
+
+        [[nodiscard]] u32 getFlags() const;
+    };
+
+    // binary layout of cooked texture file:
+    // header | block data of every mip from largest to smallest
+    // mip sizes are derived from header, so loading is a single file read and upload of each mip as is.
+    struct GABRIEL_API CookedTextureHeader final {
+        static constexpr u32 MAGIC = 0x58455447; // GTEX
+        static constexpr u32 VERSION = 2;
+
+        u32 magic = MAGIC;
+        u32 version = VERSION;
+        u32 flags = 0;
+        u32 format = BC1;
+        u32 width = 0;
+        u32 height = 0;
+        u32 mipCount = 0;
+        u32 padding = 0;
+    };
+
+    struct GABRIEL_API TextureCooker final {
+        static const char* EXTENSION;
+
+        // entry of DerivedDataCache keyed by source contents and settings
+        static std::string getCookedPath(const std::string& filepath, const TextureCookSettings& settings);
+
+        // BC5 for normal maps, BC7 for images with translucent alpha and BC1 for the rest
+        static BlockFormat chooseFormat(const Image& image, const TextureCookSettings& settings);
+
+        // RGBA8 mip chain filtered with edge wrapping Kaiser filter of ImageKernels,
+        // sRGB images are filtered in linear space and normal maps are renormalized on every level.
+        // returns false with error for images other than U8 with 1-4 channels
+        static bool generateMips(const Image& image, const TextureCookSettings& settings, std::vector<Image>& mips);
+
+        static bool cook(const std::string& cookedFilepath, const std::string& sourceFilepath, const TextureCookSettings& settings, CompressedImage& result);
+
+        // returns false if cooked file is missing or was cooked with different settings.
+        // maxResidentSize > 0 reads only mips that fit into it, finer mips are left with empty data
+        static bool load(const std::string& cookedFilepath, const TextureCookSettings& settings, CompressedImage& result, int maxResidentSize = 0);
+
+        // loads cooked texture from cookedFilepath if it's there, otherwise decodes source, cooks it and stores cooked file for the next run
+        static bool loadOrCook(const std::string& cookedFilepath, const std::string& sourceFilepath, const TextureCookSettings& settings, CompressedImage& result, int maxResidentSize = 0);
+
+        // byte offset of mip level in cooked file, streamed mips are read from it with IOService
+        static size_t getMipOffset(const CompressedImage& image, u32 level);
+
+        // offline step: decodes source and stores cooked file into DerivedDataCache
+        static void cookTexture(const std::string& filepath, const TextureCookSettings& settings);
+    };
+
+}
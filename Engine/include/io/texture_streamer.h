@@ -0,0 +1,104 @@
+#pragma once
+
+#include <control/camera.h>
+
+#include <features/transform.h>
+#include <features/material.h>
+
+#include <geometry/geometry.h>
+
+#include <io/texture_cooker.h>
+#include <io/io_service.h>
+
+namespace gl {
+
+    // screen-space usage of entity Material textures, TextureStreamer picks their mip levels from it
+    component(TextureStreaming) {
+        // bounding sphere in object space
+        glm::vec3 center = { 0, 0, 0 };
+        float radius = 0;
+        // UV units per object space unit
+        float uvDensity = 1;
+
+        TextureStreaming() = default;
+
+        TextureStreaming(const Bounds& bounds, const SurfaceArea& surfaceArea)
+        : center(bounds.center()), radius(bounds.radius()), uvDensity(surfaceArea.uvDensity()) {}
+    };
+
+    struct GABRIEL_API TextureStreamerStats final {
+        // GPU memory of resident mips and of mips being read from disk
+        size_t bytes = 0;
+        size_t pendingBytes = 0;
+        size_t budget = 0;
+        u32 textures = 0;
+        u32 loads = 0;
+        u64 streamedIn = 0;
+        u64 streamedOut = 0;
+    };
+
+    // streams mips of cooked textures between disk and GPU under memory budget.
+    // textures start with mip tail only, finer mips are read with IOService when entities using them
+    // get close enough to need them and are dropped again, finest first, when budget is exceeded.
+    // must be used from GL thread only.
+    struct GABRIEL_API TextureStreamer final {
+        // mips up to this size are loaded with texture and are never streamed out
+        static constexpr int TAIL_SIZE = 128;
+        static constexpr u32 MAX_LOADS = 8;
+
+        static void free();
+
+        static void setBudget(size_t bytes);
+
+        // uploads resident tail of cooked texture, finer mips of image have empty data
+        static void add(ImageBuffer& buffer, const std::string& cookedFilepath, const CompressedImage& image, const ImageParams& params);
+        static void remove(const ImageBuffer& buffer);
+
+        // once per frame: uploads finished loads, derives desired mips from TextureStreaming
+        // components and requests finer mips in order of how much they lack
+        static void update(Scene* scene, const Camera& camera);
+
+        static const TextureStreamerStats& getStats();
+
+    private:
+        struct Texture final {
+            ImageBuffer buffer;
+            std::string cookedFilepath;
+            // mip sizes only, block data isn't kept after upload
+            CompressedImage image;
+            int internalFormat = 0;
+            // distinguishes textures with reused GL ids
+            u64 serial = 0;
+            u32 residentMip = 0;
+            u32 tailMip = 0;
+            // finest mip that can be read, raised if reading fails
+            u32 finestMip = 0;
+            u32 desiredMip = 0;
+            bool loading = false;
+        };
+
+        struct MipLoad final {
+            u32 id;
+            u64 serial;
+            u32 level;
+            size_t bytes;
+            // filled by IOService
+            std::shared_ptr<CompressedMip> mip;
+            std::future<IOResult> result;
+        };
+
+        static void request(u32 id, float uvPerPixel);
+        static void finishLoads();
+        static void requestLoads();
+        static bool makeRoom(size_t bytes);
+        static void dropMip(Texture& texture);
+        static size_t getBytes(const Texture& texture, u32 level);
+
+    private:
+        static std::unordered_map<u32, Texture> s_textures;
+        static std::vector<MipLoad> s_loads;
+        static u64 s_serial;
+        static TextureStreamerStats s_stats;
+    };
+
+}
@@ -2,9 +2,22 @@
 
 #include <core/application.h>
 
+#include <cstring>
+
 int main(int argc, char** argv) {
     auto* application = gl::createApplication();
-    application->run();
+    // e.g. --pack Assets.gpak shaders Assets, run from working directory of application
+    if (argc >= 3 && std::strcmp(argv[1], "--pack") == 0) {
+        bool packed = application->pack(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+        delete application;
+        return packed ? 0 : 1;
+    }
+    gl::HeadlessParams headless = gl::HeadlessParams::parse(argc, argv);
+    if (headless.enabled) {
+        application->runHeadless(headless);
+    } else {
+        application->run();
+    }
     delete application;
 
     return 0;
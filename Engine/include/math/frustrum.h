@@ -19,7 +19,15 @@ namespace gl {
             init(perspectiveMat);
         }
 
+        // world space planes from projection * view, normals point inside
+        explicit Frustum(const glm::mat4& viewProjection) {
+            init(viewProjection);
+        }
+
         void init(const PerspectiveMat& perspectiveMat);
+        void init(const glm::mat4& viewProjection);
+
+        [[nodiscard]] bool intersects(const Sphere& sphere) const;
 
         inline Frustum& operator *(const glm::mat4& m) {
 //            nearTopLeft     = m * nearTopLeft;
@@ -8,6 +8,11 @@ namespace gl {
 
         Plane(const float distance = 1.0f, const glm::vec3& normal = { 0, 1, 0 })
         : distance(distance), normal(normal) {}
+
+        // positive in front of plane, where normal points to
+        [[nodiscard]] inline float signedDistance(const glm::vec3& point) const {
+            return glm::dot(normal, point) + distance;
+        }
     };
 
 }
\ No newline at end of file
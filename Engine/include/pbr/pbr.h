@@ -4,6 +4,7 @@
 
 #include <features/transform.h>
 #include <features/material.h>
+#include <features/batching.h>
 #include <features/lighting/light.h>
 #include <features/outline.h>
 #include <features/transparency.h>
@@ -78,6 +79,7 @@ namespace gl {
         void use();
 
         void render(Transform& transform, DrawableElements& drawable, Material& material);
+        void render(DrawBatcher& batcher);
 
         void update(Environment* env);
 
@@ -123,6 +125,7 @@ namespace gl {
         void use();
 
         void render(Transform& transform, DrawableElements& drawable, Material& material);
+        void render(DrawBatcher& batcher);
 
         void update(Environment* env);
 
@@ -152,6 +155,7 @@ namespace gl {
     struct GABRIEL_API PBR_Pipeline final {
         Scene* scene;
         Terrain* terrain = null;
+        Camera* camera = null;
 
         PBR_Pipeline(Scene* scene, int width, int height,
                      SsaoRenderer* ssaoRenderer,
@@ -195,6 +199,9 @@ namespace gl {
 
         void render();
 
+        // draws and state changes of opaque and transparent queues in last frame
+        [[nodiscard]] RenderQueueStats getRenderQueueStats() const;
+
     private:
         void renderTransparent();
         void renderForward();
@@ -214,6 +221,10 @@ namespace gl {
         OutlineRenderer* mOutlineRenderer;
 
         EnvRenderer* mEnvRenderer;
+
+        DrawBatcher mOpaqueBatcher;
+        DrawBatcher mTransparentBatcher;
+        std::vector<MeshletRange> mMeshletRanges;
     };
 
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <functional>
 #include <array>
 #include <vector>
+#include <list>
 #include <thread>
 #include <future>
 #include <map>
@@ -22,8 +23,11 @@
 #include <unordered_set>
 #include <set>
 #include <queue>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -39,6 +43,8 @@
 #include <gtx/quaternion.hpp>
 #include <gtc/type_ptr.hpp>
 #include <gtc/matrix_transform.hpp>
+#include <gtc/type_precision.hpp>
+#include <gtc/packing.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <gtx/string_cast.hpp>
 
@@ -43,10 +43,6 @@ namespace gl {
         BloomRenderer(int width, int height);
         ~BloomRenderer();
 
-        inline const ImageBuffer& getRenderTarget() {
-            return mRenderTarget;
-        }
-
         inline ImageBuffer& getHdrBuffer() {
             return mMixShader.hdrBuffer;
         }
@@ -63,32 +59,26 @@ namespace gl {
             return mMixShader.bloomStrength.value;
         }
 
-        [[nodiscard]] inline const FrameBuffer& getColorFrame() const {
-            return mFrame;
-        }
-
         void resize(int w, int h);
 
-        void render();
+        // mips stay in renderer, mixed result goes into target provided by RenderGraph
+        void render(const FrameBuffer& frame);
 
     private:
-        void initMixColor();
         void initMips();
 
         void renderDownsample();
         void renderUpsample();
-        void renderMix();
+        void renderMix(const FrameBuffer& frame);
 
     private:
         glm::ivec2 mResolution;
-        ImageBuffer mRenderTarget;
         FrameBuffer mFrame;
         BloomDownsampleShader mDownsampleShader;
         BloomUpsampleShader mUpsampleShader;
         BloomMixShader mMixShader;
         DrawableQuad mDrawable;
         std::vector<ColorAttachment> mMips;
-        ColorAttachment mMixColor;
     };
 
 }
\ No newline at end of file
@@ -23,33 +23,19 @@ namespace gl {
     struct GABRIEL_API BlurRenderer final {
         bool isEnabled = false;
 
-        BlurRenderer(int w, int h);
+        BlurRenderer();
         ~BlurRenderer();
 
-        inline const ImageBuffer& getRenderTarget() {
-            return mRenderTarget;
-        }
-
         inline BlurParams& getParams() {
             return mShader.params;
         }
 
-        [[nodiscard]] inline const FrameBuffer& getColorFrame() const {
-            return mFrame;
-        }
-
-        void resize(int w, int h);
-
         void updateOffset();
 
-        void render();
-
-    private:
-        ColorAttachment initColor(int width, int height);
+        // target is provided by RenderGraph
+        void render(const FrameBuffer& frame);
 
     private:
-        ImageBuffer mRenderTarget;
-        FrameBuffer mFrame;
         BlurShader mShader;
         DrawableQuad mDrawable;
     };
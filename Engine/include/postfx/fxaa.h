@@ -27,28 +27,16 @@ namespace gl {
         FXAARenderer(int width, int height);
         ~FXAARenderer();
 
-        [[nodiscard]] inline const ImageBuffer& getRenderTarget() const {
-            return mRenderTarget;
-        }
-
         inline FXAAParams& getParams() {
             return mShader.params;
         }
 
-        [[nodiscard]] inline const FrameBuffer& getColorFrame() const {
-            return mFrame;
-        }
-
         void resize(int width, int height);
 
-        void render();
-
-    private:
-        ColorAttachment initColor(int width, int height);
+        // target is provided by RenderGraph
+        void render(const FrameBuffer& frame);
 
     private:
-        ImageBuffer mRenderTarget;
-        FrameBuffer mFrame;
         DrawableQuad mDrawable;
         FXAAShader mShader;
     };
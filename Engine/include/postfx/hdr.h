@@ -30,34 +30,20 @@ namespace gl {
     struct GABRIEL_API HdrRenderer final {
         bool isEnabled = false;
 
-        HdrRenderer(int w, int h);
+        HdrRenderer();
         ~HdrRenderer();
 
-        inline const ImageBuffer& getRenderTarget() {
-            return mRenderTarget;
-        }
-
         inline HdrParams& getParams() {
             return mShader.params;
         }
 
-        [[nodiscard]] inline const FrameBuffer& getColorFrame() const {
-            return mFrame;
-        }
-
-        void resize(int w, int h);
-
-        void render();
+        // target is provided by RenderGraph
+        void render(const FrameBuffer& frame);
 
         void updateExposure();
         void updateShinyStrength();
 
     private:
-        ColorAttachment initColor(int width, int height);
-
-    private:
-        ImageBuffer mRenderTarget;
-        FrameBuffer mFrame;
         HdrShader mShader;
         DrawableQuad mDrawable;
     };
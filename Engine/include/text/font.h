@@ -5,6 +5,7 @@
 #include <geometry/rect.h>
 
 #include <io/bitmap_loader.h>
+#include <io/file_system.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H"freetype/freetype.h"
@@ -68,8 +69,12 @@ namespace gl {
         void saveWidths(const char* filepath) const;
 
     private:
+        friend struct FontAtlas;
+
         int* mWidths = null;
         int mWidthSize = 128;
+        // memory face reads font file in place, so it's kept until face is done
+        std::shared_ptr<FileBlob> mFaceData;
     };
 
     struct GABRIEL_API FontAtlas final {
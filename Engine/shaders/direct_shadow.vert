@@ -1,11 +1,15 @@
 #version 460 core
 
+#include quantization.glsl
+#include features/draw.glsl
+
 layout (location = 0) in vec3 a_pos;
 
 uniform mat4 direct_light_space;
-uniform mat4 model;
 
 void main()
 {
-    gl_Position = direct_light_space * model * vec4(a_pos, 1.0);
+    DrawData draw = draws[draw_index + gl_BaseInstance + gl_InstanceID];
+    vec3 pos = decode_position(a_pos, has_flag(draw, DRAW_QUANTIZED), draw.quantization_offset.xyz, draw.quantization_scale.xyz);
+    gl_Position = direct_light_space * draw.model * vec4(pos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+// per-draw data written by DrawStorage, see features/draw_storage.h
+const uint DRAW_ALBEDO = 1u << 0;
+const uint DRAW_NORMAL = 1u << 1;
+const uint DRAW_PARALLAX = 1u << 2;
+const uint DRAW_METALLIC = 1u << 3;
+const uint DRAW_ROUGHNESS = 1u << 4;
+const uint DRAW_AO = 1u << 5;
+const uint DRAW_EMISSION = 1u << 6;
+const uint DRAW_QUANTIZED = 1u << 7;
+
+struct DrawData {
+    mat4 model;
+    vec4 color;
+    vec4 emission_factor;
+    vec4 quantization_offset;
+    vec4 quantization_scale;
+    float height_scale;
+    float parallax_min_layers;
+    float parallax_max_layers;
+    float metallic_factor;
+    float roughness_factor;
+    float ao_factor;
+    uint flags;
+    uint padding;
+};
+
+layout (std430, binding = 6) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
+
+// first draw of batch, instances are at draw_index + gl_BaseInstance + gl_InstanceID,
+// multi draw indirect sets draw_index to 0 and passes first draw of every command as base instance
+uniform uint draw_index;
+
+bool has_flag(DrawData draw, uint flag) {
+    return (draw.flags & flag) != 0u;
+}
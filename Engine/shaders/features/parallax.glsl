@@ -1,8 +1,8 @@
-vec2 parallax_function(vec2 uv)
+vec2 parallax_function(vec2 uv, DrawData draw)
 {
-    float height_scale = material.height_scale;
-    float min_layers = material.parallax_min_layers;
-    float max_layers = material.parallax_max_layers;
+    float height_scale = draw.height_scale;
+    float min_layers = draw.parallax_min_layers;
+    float max_layers = draw.parallax_max_layers;
     float layers = mix(max_layers, min_layers, abs(dot(vec3(0.0, 0.0, 1.0), V)));
     // calculate the size of each layer
     float layer_depth = 1.0 / layers;
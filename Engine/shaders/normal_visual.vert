@@ -1,5 +1,7 @@
 #version 460 core
 
+#include quantization.glsl
+
 layout (location = 0) in vec3 a_pos;
 layout (location = 2) in vec3 a_normal;
 
@@ -11,6 +13,6 @@ uniform mat4 model;
 
 void main()
 {
-    gl_Position = model * vec4(a_pos, 1.0);
-    vertex_out.a_normal = a_normal;
+    gl_Position = model * vec4(decode_position(a_pos), 1.0);
+    vertex_out.a_normal = decode_direction(a_normal);
 }
\ No newline at end of file
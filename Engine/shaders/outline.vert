@@ -2,6 +2,7 @@
 
 #include core.glsl
 #include camera.glsl
+#include quantization.glsl
 
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec3 a_normal;
@@ -12,5 +13,5 @@ uniform float outline_thickness;
 
 void main()
 {
-    gl_Position = perspective * view * model * vec4(a_pos + a_normal * outline_thickness, 1.0);
+    gl_Position = perspective * view * model * vec4(decode_position(a_pos) + a_normal * outline_thickness, 1.0);
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ in vec2 l_uv;
 in vec3 w_pos;
 in vec3 w_normal;
 in vec4 dls_pos;
+flat in uint l_draw;
 in vec3 v_pos;
 in vec3 v_normal;
 
@@ -19,26 +20,31 @@ layout(location = 5) out vec4 out_shadow_proj_coords; // shadow proj coords
 layout(location = 6) out vec4 out_view_position;
 layout(location = 7) out vec4 out_view_normal;
 
+#include features/draw.glsl
 #include features/material.glsl
 #include features/parallax.glsl
 
 void main()
 {
+    DrawData draw = draws[l_draw];
+
     UV = l_uv;
     V = normalize(camera_pos - w_pos);
     vec3 world_normal = normalize(w_normal);
     vec3 view_normal = normalize(v_normal);
 
     // parallax mapping
-    if (material.enable_parallax) {
-        UV = parallax_function(l_uv);
+    if (has_flag(draw, DRAW_PARALLAX)) {
+        UV = parallax_function(l_uv, draw);
         if (UV.x > 1.0 || UV.y > 1.0 || UV.x < 0.0 || UV.y < 0.0)
             discard;
     }
 
     // normal mapping
-    if (material.enable_normal) {
-        vec3 tangentNormal = texture(material.normal, UV).xyz * 2.0 - 1.0;
+    if (has_flag(draw, DRAW_NORMAL)) {
+        // normal maps are stored as XY only, Z is restored from unit length
+        vec2 normalXY = texture(material.normal, UV).xy * 2.0 - 1.0;
+        vec3 tangentNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
         {
             vec3 Q1  = dFdx(w_pos);
             vec3 Q2  = dFdy(w_pos);
@@ -66,34 +72,34 @@ void main()
     }
 
     // albedo mapping
-    vec4 albedo = material.color;
-    if (material.enable_albedo) {
+    vec4 albedo = draw.color;
+    if (has_flag(draw, DRAW_ALBEDO)) {
         albedo *= texture(material.albedo, UV);
     }
     // gamma correction
     albedo = vec4(pow(albedo.rgb, vec3(2.2)), albedo.a);
 
     // metal mapping
-    float metallic = material.metallic_factor;
-    if (material.enable_metallic) {
+    float metallic = draw.metallic_factor;
+    if (has_flag(draw, DRAW_METALLIC)) {
         metallic *= texture(material.metallic, UV).r;
     }
 
     // roughness mapping
-    float roughness = material.roughness_factor;
-    if (material.enable_roughness) {
+    float roughness = draw.roughness_factor;
+    if (has_flag(draw, DRAW_ROUGHNESS)) {
         roughness *= texture(material.roughness, UV).r;
     }
 
     // AO mapping
-    float ao = material.ao_factor;
-    if (material.enable_ao) {
+    float ao = draw.ao_factor;
+    if (has_flag(draw, DRAW_AO)) {
         ao *= texture(material.ao, UV).r;
     }
 
     // emission mapping
-    vec3 emission = material.emission_factor;
-    if (material.enable_emission) {
+    vec3 emission = draw.emission_factor.rgb;
+    if (has_flag(draw, DRAW_EMISSION)) {
         emission *= texture(material.emission, UV).rgb;
     }
     // tone mapping
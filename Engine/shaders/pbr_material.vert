@@ -2,6 +2,8 @@
 
 #include core.glsl
 #include camera.glsl
+#include quantization.glsl
+#include features/draw.glsl
 
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec2 a_uv;
@@ -12,21 +14,29 @@ out vec2 l_uv;
 out vec3 w_pos;
 out vec3 w_normal;
 out vec4 dls_pos;
+flat out uint l_draw;
 out vec3 v_pos;
 out vec3 v_normal;
 
-uniform mat4 model;
 uniform mat4 direct_light_space;
 
 void main()
 {
+    // instances of batch have consecutive draw data
+    l_draw = draw_index + gl_BaseInstance + gl_InstanceID;
+    DrawData draw = draws[l_draw];
+    mat4 model = draw.model;
+    bool is_quantized = has_flag(draw, DRAW_QUANTIZED);
+    vec3 pos = decode_position(a_pos, is_quantized, draw.quantization_offset.xyz, draw.quantization_scale.xyz);
+    vec3 normal = decode_direction(a_normal, is_quantized);
+
     l_uv = a_uv;
 
-    w_pos = (model * vec4(a_pos, 1.0)).xyz;
+    w_pos = (model * vec4(pos, 1.0)).xyz;
     v_pos = (view * vec4(w_pos, 1.0)).xyz;
 
-    w_normal = transpose(inverse(mat3(model))) * a_normal;
-    v_normal = transpose(inverse(mat3(view * model))) * a_normal;
+    w_normal = transpose(inverse(mat3(model))) * normal;
+    v_normal = transpose(inverse(mat3(view * model))) * normal;
 
     dls_pos = direct_light_space * vec4(w_pos, 1.0);
 
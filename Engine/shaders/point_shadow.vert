@@ -1,10 +1,12 @@
 #version 460 core
 
+#include quantization.glsl
+
 layout (location = 0) in vec3 a_pos;
 
 uniform mat4 model;
 
 void main()
 {
-    gl_Position = model * vec4(a_pos, 1.0);
+    gl_Position = model * vec4(decode_position(a_pos), 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+// quantized vertices store positions as unorm16 relative to mesh bounds
+// and normals, tangents as octahedral snorm16, see geometry/vertex_quantization.h
+uniform bool quantized = false;
+uniform vec3 quantization_offset = vec3(0);
+uniform vec3 quantization_scale = vec3(1);
+
+vec3 decode_position(vec3 position, bool is_quantized, vec3 offset, vec3 scale) {
+    return is_quantized ? offset + position * scale : position;
+}
+
+vec3 decode_position(vec3 position) {
+    return decode_position(position, quantized, quantization_offset, quantization_scale);
+}
+
+vec3 decode_octahedral(vec2 v) {
+    vec3 direction = vec3(v.x, v.y, 1.0 - abs(v.x) - abs(v.y));
+    if (direction.z < 0) {
+        direction.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(direction);
+}
+
+vec3 decode_direction(vec3 direction, bool is_quantized) {
+    return is_quantized ? decode_octahedral(direction.xy) : direction;
+}
+
+vec3 decode_direction(vec3 direction) {
+    return decode_direction(direction, quantized);
+}
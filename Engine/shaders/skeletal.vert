@@ -2,6 +2,8 @@
 
 #include core.glsl
 #include camera.glsl
+#include quantization.glsl
+#include features/draw.glsl
 
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec2 a_uv;
@@ -14,8 +16,8 @@ out vec2 l_uv;
 out vec3 w_pos;
 out vec3 w_normal;
 out vec4 dls_pos;
+flat out uint l_draw;
 
-uniform mat4 model;
 uniform mat4 direct_light_space;
 
 const int MAX_BONES = 100;
@@ -23,27 +25,36 @@ uniform mat4 bone_transforms[MAX_BONES];
 
 void main()
 {
+    // instances of batch have consecutive draw data
+    l_draw = draw_index + gl_BaseInstance + gl_InstanceID;
+    DrawData draw = draws[l_draw];
+    mat4 model = draw.model;
+    bool is_quantized = has_flag(draw, DRAW_QUANTIZED);
+    vec3 pos = decode_position(a_pos, is_quantized, draw.quantization_offset.xyz, draw.quantization_scale.xyz);
+    vec3 normal = decode_direction(a_normal, is_quantized);
+
     l_uv = a_uv;
 
     vec4 totalPosition = vec4(0.0f);
 
     for (int i = 0 ; i < 4 ; i++) {
-        if (a_bone_id[i] == -1)
+        // quantized vertices keep unused influences as bone 0 with zero weight
+        if (a_bone_id[i] == -1 || (is_quantized && a_weight[i] == 0.0))
             continue;
 
         if (a_bone_id[i] >= MAX_BONES) {
-            totalPosition = vec4(a_pos, 1.0f);
+            totalPosition = vec4(pos, 1.0f);
             break;
         }
 
-        vec4 localPosition = bone_transforms[a_bone_id[i]] * vec4(a_pos, 1.0f);
-        totalPosition += localPosition;
-        vec3 localNormal = mat3(bone_transforms[a_bone_id[i]]) * a_normal;
+        vec4 localPosition = bone_transforms[a_bone_id[i]] * vec4(pos, 1.0f);
+        totalPosition += localPosition * a_weight[i];
+        vec3 localNormal = mat3(bone_transforms[a_bone_id[i]]) * normal;
     }
 
     w_pos = (model * totalPosition).xyz;
 
-    w_normal = transpose(inverse(mat3(model))) * a_normal;
+    w_normal = transpose(inverse(mat3(model))) * normal;
 
     dls_pos = direct_light_space * vec4(w_pos, 1.0);
 
@@ -2,6 +2,8 @@
 
 #include core.glsl
 #include camera.glsl
+#include quantization.glsl
+#include features/draw.glsl
 
 layout (location = 0) in vec3 a_pos;
 layout (location = 1) in vec2 a_uv;
@@ -14,10 +16,10 @@ out vec2 l_uv;
 out vec3 w_pos;
 out vec3 w_normal;
 out vec4 dls_pos;
+flat out uint l_draw;
 out vec3 v_pos;
 out vec3 v_normal;
 
-uniform mat4 model;
 uniform mat4 direct_light_space;
 
 const int MAX_BONES = 100;
@@ -25,6 +27,14 @@ uniform mat4 bone_transforms[MAX_BONES];
 
 void main()
 {
+    // instances of batch have consecutive draw data
+    l_draw = draw_index + gl_BaseInstance + gl_InstanceID;
+    DrawData draw = draws[l_draw];
+    mat4 model = draw.model;
+    bool is_quantized = has_flag(draw, DRAW_QUANTIZED);
+    vec3 pos = decode_position(a_pos, is_quantized, draw.quantization_offset.xyz, draw.quantization_scale.xyz);
+    vec3 normal = decode_direction(a_normal, is_quantized);
+
     l_uv = a_uv;
 
     vec4 l_pos = vec4(0);
@@ -33,22 +43,23 @@ void main()
     for (int i = 0 ; i < 4 ; i++) {
         int b_id = a_bone_id[i];
 
-        if (b_id == -1) continue;
+        // quantized vertices keep unused influences as bone 0 with zero weight
+        if (b_id == -1 || (is_quantized && a_weight[i] == 0.0)) continue;
         if (b_id >= MAX_BONES) {
-            l_pos = vec4(a_pos, 1.0);
+            l_pos = vec4(pos, 1.0);
             break;
         }
 
-        mat4 bone = bone_transforms[b_id] * a_weight[b_id];
-        l_pos += bone * vec4(a_pos, 1.0);
+        mat4 bone = bone_transforms[b_id] * a_weight[i];
+        l_pos += bone * vec4(pos, 1.0);
         bone_transform += bone;
     }
 
     w_pos = (model * l_pos).xyz;
     v_pos = (view * vec4(w_pos, 1.0)).xyz;
 
-    w_normal = transpose(inverse(mat3(bone_transform))) * a_normal;
-    v_normal = transpose(inverse(mat3(view * bone_transform))) * a_normal;
+    w_normal = transpose(inverse(mat3(bone_transform))) * normal;
+    v_normal = transpose(inverse(mat3(view * bone_transform))) * normal;
 
     dls_pos = direct_light_space * vec4(w_pos, 1.0);
 
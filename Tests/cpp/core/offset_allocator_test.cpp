@@ -0,0 +1,150 @@
+#include <test.h>
+
+#include <core/offset_allocator.h>
+
+using namespace gl;
+
+TEST(OffsetAllocator, Allocate) {
+    OffsetAllocator allocator;
+    allocator.init(1000);
+    EXPECT(allocator.getSize() == 1000);
+    EXPECT(allocator.getFreeSize() == 1000);
+
+    // sequential allocations are packed one after another
+    OffsetAllocation a = allocator.allocate(100);
+    OffsetAllocation b = allocator.allocate(50);
+    OffsetAllocation c = allocator.allocate(1);
+    EXPECT(a.isValid() && b.isValid() && c.isValid());
+    EXPECT(a.offset == 0);
+    EXPECT(b.offset == 100);
+    EXPECT(c.offset == 150);
+    EXPECT(allocator.getAllocationSize(a) == 100);
+    EXPECT(allocator.getAllocationSize(b) == 50);
+    EXPECT(allocator.getFreeSize() == 849);
+
+    EXPECT(!allocator.allocate(0).isValid());
+    EXPECT(allocator.getAllocationSize({}) == 0);
+    allocator.free();
+}
+
+TEST(OffsetAllocator, Free) {
+    OffsetAllocator allocator;
+    allocator.init(1000);
+    OffsetAllocation a = allocator.allocate(100);
+    OffsetAllocation b = allocator.allocate(100);
+    OffsetAllocation rest = allocator.allocate(800);
+    EXPECT(allocator.getFreeSize() == 0);
+
+    // freed range is reused by allocation that fits it
+    allocator.free(b);
+    EXPECT(allocator.getFreeSize() == 100);
+    OffsetAllocation d = allocator.allocate(100);
+    EXPECT(d.offset == 100);
+
+    // double and invalid frees are ignored
+    allocator.free(a);
+    allocator.free(a);
+    allocator.free({});
+    EXPECT(allocator.getFreeSize() == 100);
+    allocator.free(rest);
+    EXPECT(allocator.getFreeSize() == 900);
+    allocator.free();
+}
+
+TEST(OffsetAllocator, Merge) {
+    OffsetAllocator allocator;
+    allocator.init(300);
+    OffsetAllocation a = allocator.allocate(100);
+    OffsetAllocation b = allocator.allocate(100);
+    OffsetAllocation c = allocator.allocate(100);
+    EXPECT(allocator.getFreeSize() == 0);
+
+    // holes on both sides of b merge with it, whole range fits again
+    allocator.free(a);
+    allocator.free(c);
+    EXPECT(!allocator.allocate(200).isValid());
+    allocator.free(b);
+    EXPECT(allocator.getFreeSize() == 300);
+    OffsetAllocation whole = allocator.allocate(300);
+    EXPECT(whole.isValid());
+    EXPECT(whole.offset == 0);
+    allocator.free();
+}
+
+TEST(OffsetAllocator, Exhaustion) {
+    OffsetAllocator allocator;
+    allocator.init(256);
+    EXPECT(!allocator.allocate(257).isValid());
+
+    std::vector<OffsetAllocation> allocations;
+    for (u32 i = 0 ; i < 16 ; i++) {
+        allocations.emplace_back(allocator.allocate(16));
+        EXPECT(allocations.back().isValid());
+    }
+    EXPECT(allocator.getFreeSize() == 0);
+    EXPECT(!allocator.allocate(1).isValid());
+
+    // free space in holes doesn't fit larger allocation, until buffer grows
+    allocator.free(allocations[3]);
+    allocator.free(allocations[7]);
+    EXPECT(allocator.getFreeSize() == 32);
+    EXPECT(!allocator.allocate(32).isValid());
+    allocator.grow(512);
+    OffsetAllocation grown = allocator.allocate(32);
+    EXPECT(grown.isValid());
+    EXPECT(grown.offset == 256);
+    EXPECT(allocator.getFreeSize() == 256);
+    allocator.free();
+}
+
+TEST(OffsetAllocator, Random) {
+    // random allocations never overlap and free size matches what is allocated
+    OffsetAllocator allocator;
+    u32 size = 1 << 16;
+    allocator.init(size);
+    std::vector<OffsetAllocation> allocations;
+    std::vector<u32> sizes;
+    u32 used = 0;
+    u32 state = 12345;
+
+    for (u32 i = 0 ; i < 20000 ; i++) {
+        state = state * 1664525u + 1013904223u;
+        if ((state >> 28) < 9 || allocations.empty()) {
+            u32 allocationSize = 1 + (state >> 8) % 700;
+            OffsetAllocation allocation = allocator.allocate(allocationSize);
+            if (allocation.isValid()) {
+                EXPECT(allocator.getAllocationSize(allocation) == allocationSize);
+                allocations.emplace_back(allocation);
+                sizes.emplace_back(allocationSize);
+                used += allocationSize;
+            }
+        } else {
+            u32 index = (state >> 8) % allocations.size();
+            allocator.free(allocations[index]);
+            used -= sizes[index];
+            allocations[index] = allocations.back();
+            sizes[index] = sizes.back();
+            allocations.pop_back();
+            sizes.pop_back();
+        }
+        EXPECT(allocator.getFreeSize() == size - used);
+    }
+
+    std::vector<std::pair<u32, u32>> ranges;
+    for (size_t i = 0 ; i < allocations.size() ; i++) {
+        ranges.emplace_back(allocations[i].offset, allocations[i].offset + sizes[i]);
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 0 ; i < ranges.size() ; i++) {
+        EXPECT(ranges[i].second <= size);
+        EXPECT(i == 0 || ranges[i - 1].second <= ranges[i].first);
+    }
+
+    // everything merges back into one range
+    for (auto& allocation : allocations) {
+        allocator.free(allocation);
+    }
+    EXPECT(allocator.getFreeSize() == size);
+    EXPECT(allocator.allocate(size).isValid());
+    allocator.free();
+}
@@ -0,0 +1,250 @@
+#include <test.h>
+
+#include <features/render_graph.h>
+#include <debugging/profiler.h>
+
+using namespace gl;
+
+static const RenderTextureDesc COLOR = { 64, 64, GL_RGBA16F, GL_RGBA, PixelType::FLOAT };
+static const RenderTextureDesc LUMA = { 64, 64, GL_R8, GL_RED, PixelType::U8 };
+
+struct NullResources final : RenderGraphResources {
+    ImageBuffer texture;
+
+    [[nodiscard]] const ImageBuffer& getTexture(u32 resource) const override { return texture; }
+    [[nodiscard]] const FrameBuffer* getFrame(u32 resource) const override { return null; }
+};
+
+static bool isAliased(const RenderGraph& graph, u32 left, u32 right) {
+    return graph.getPhysical(left) != InvalidRenderResource && graph.getPhysical(left) == graph.getPhysical(right);
+}
+
+TEST(RenderGraph, CullUnused) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 debug = graph.createTexture("Debug", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+
+    u32 render = graph.addPass("Render", {});
+    graph.write(render, scene);
+    // writes texture that nothing reads
+    u32 visualize = graph.addPass("Visualize", {});
+    graph.read(visualize, scene);
+    graph.write(visualize, debug);
+    u32 present = graph.addPass("Present", {});
+    graph.read(present, scene);
+    graph.write(present, screen);
+    graph.setOutput(screen);
+
+    EXPECT(graph.compile());
+    EXPECT(!graph.isCulled(render));
+    EXPECT(graph.isCulled(visualize));
+    EXPECT(!graph.isCulled(present));
+    EXPECT(graph.getStats().passes == 3);
+    EXPECT(graph.getStats().culledPasses == 1);
+    // texture of culled pass gets no memory
+    EXPECT(graph.getPhysical(debug) == InvalidRenderResource);
+    EXPECT(graph.getPhysical(scene) != InvalidRenderResource);
+    EXPECT(graph.getPhysical(screen) == InvalidRenderResource);
+}
+
+TEST(RenderGraph, CullOrder) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+
+    // first write of scene is overwritten before anyone reads it
+    u32 clear = graph.addPass("Clear", {});
+    graph.write(clear, scene);
+    u32 render = graph.addPass("Render", {});
+    graph.write(render, scene);
+    u32 present = graph.addPass("Present", {});
+    graph.read(present, scene);
+    graph.write(present, screen);
+    // pass after output's last reader doesn't contribute
+    u32 late = graph.addPass("Late", {});
+    graph.read(late, scene);
+    graph.setOutput(screen);
+
+    EXPECT(graph.compile());
+    EXPECT(graph.isCulled(clear));
+    EXPECT(!graph.isCulled(render));
+    EXPECT(!graph.isCulled(present));
+    EXPECT(graph.isCulled(late));
+
+    // read-modify-write keeps earlier writer
+    RenderGraph blend;
+    scene = blend.createTexture("Scene", COLOR);
+    screen = blend.importTexture("Screen", {});
+    u32 opaque = blend.addPass("Opaque", {});
+    blend.write(opaque, scene);
+    u32 transparent = blend.addPass("Transparent", {});
+    blend.read(transparent, scene);
+    blend.write(transparent, scene);
+    present = blend.addPass("Present", {});
+    blend.read(present, scene);
+    blend.write(present, screen);
+    blend.setOutput(screen);
+
+    EXPECT(blend.compile());
+    EXPECT(!blend.isCulled(opaque));
+    EXPECT(!blend.isCulled(transparent));
+    EXPECT(!blend.isCulled(present));
+}
+
+TEST(RenderGraph, ReadBeforeWrite) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+    u32 history = graph.importTexture("History", {});
+
+    // imported textures are valid before graph, transient ones are not
+    u32 present = graph.addPass("Present", {});
+    graph.read(present, history);
+    graph.read(present, scene);
+    graph.write(present, screen);
+    graph.setOutput(screen);
+    EXPECT(!graph.compile());
+
+    graph.clear();
+    screen = graph.importTexture("Screen", {});
+    history = graph.importTexture("History", {});
+    present = graph.addPass("Present", {});
+    graph.read(present, history);
+    graph.write(present, screen);
+    graph.setOutput(screen);
+    EXPECT(graph.compile());
+}
+
+TEST(RenderGraph, LifetimeOverlap) {
+    RenderGraph graph;
+    u32 a = graph.createTexture("A", COLOR);
+    u32 b = graph.createTexture("B", COLOR);
+    u32 c = graph.createTexture("C", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+
+    u32 pass0 = graph.addPass("0", {});
+    graph.write(pass0, a);
+    u32 pass1 = graph.addPass("1", {});
+    graph.read(pass1, a);
+    graph.write(pass1, b);
+    u32 pass2 = graph.addPass("2", {});
+    graph.read(pass2, a);
+    graph.read(pass2, b);
+    graph.write(pass2, c);
+    u32 pass3 = graph.addPass("3", {});
+    graph.read(pass3, c);
+    graph.write(pass3, screen);
+    graph.setOutput(screen);
+
+    EXPECT(graph.compile());
+    // a lives in passes 0-2, b in 1-2 and c in 2-3, every pair overlaps
+    EXPECT(!isAliased(graph, a, b));
+    EXPECT(!isAliased(graph, a, c));
+    EXPECT(!isAliased(graph, b, c));
+    EXPECT(graph.getStats().transientTextures == 3);
+    EXPECT(graph.getStats().physicalTextures == 3);
+    EXPECT(graph.getStats().physicalBytes == graph.getStats().transientBytes);
+}
+
+TEST(RenderGraph, AliasReuse) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 blurX = graph.createTexture("BlurX", COLOR);
+    u32 blurY = graph.createTexture("BlurY", COLOR);
+    u32 luma = graph.createTexture("Luma", LUMA);
+    u32 tonemapped = graph.createTexture("Tonemapped", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+
+    u32 render = graph.addPass("Render", {});
+    graph.write(render, scene);
+    u32 horizontal = graph.addPass("BlurX", {});
+    graph.read(horizontal, scene);
+    graph.write(horizontal, blurX);
+    u32 vertical = graph.addPass("BlurY", {});
+    graph.read(vertical, blurX);
+    graph.write(vertical, blurY);
+    u32 luminance = graph.addPass("Luma", {});
+    graph.read(luminance, blurY);
+    graph.write(luminance, luma);
+    u32 tonemap = graph.addPass("Tonemap", {});
+    graph.read(tonemap, blurY);
+    graph.read(tonemap, luma);
+    graph.write(tonemap, tonemapped);
+    u32 present = graph.addPass("Present", {});
+    graph.read(present, tonemapped);
+    graph.write(present, screen);
+    graph.setOutput(screen);
+
+    EXPECT(graph.compile());
+    // scene ends in pass 1 and blurY starts in pass 2, so blurY takes slot of scene
+    EXPECT(isAliased(graph, scene, blurY));
+    // blurX ends in pass 2 and tonemapped starts in pass 4
+    EXPECT(isAliased(graph, blurX, tonemapped));
+    // pass reading one texture and writing other needs both at once
+    EXPECT(!isAliased(graph, scene, blurX));
+    EXPECT(!isAliased(graph, blurX, blurY));
+    // different descriptions never share memory
+    EXPECT(!isAliased(graph, luma, scene));
+    EXPECT(!isAliased(graph, luma, blurX));
+
+    const RenderGraphStats& stats = graph.getStats();
+    EXPECT(stats.transientTextures == 5);
+    EXPECT(stats.physicalTextures == 3);
+    EXPECT(graph.getPhysicalDescs().size() == 3);
+    EXPECT(stats.transientBytes == 4 * COLOR.size() + LUMA.size());
+    EXPECT(stats.physicalBytes == 2 * COLOR.size() + LUMA.size());
+    for (u32 resource : { scene, blurX, blurY, luma, tonemapped }) {
+        EXPECT(graph.getPhysicalDescs()[graph.getPhysical(resource)] == graph.getDesc(resource));
+    }
+}
+
+TEST(RenderGraph, OutputNotAliased) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 output = graph.createTexture("Output", COLOR);
+    u32 late = graph.createTexture("Late", COLOR);
+
+    u32 render = graph.addPass("Render", {});
+    graph.write(render, scene);
+    u32 resolve = graph.addPass("Resolve", {});
+    graph.read(resolve, scene);
+    graph.write(resolve, output);
+    // late starts after output's last pass, but output is still read after graph
+    u32 overlay = graph.addPass("Overlay", {});
+    graph.read(overlay, output);
+    graph.write(overlay, late);
+    graph.setOutput(output);
+    graph.setOutput(late);
+
+    EXPECT(graph.compile());
+    EXPECT(!isAliased(graph, output, late));
+    EXPECT(isAliased(graph, scene, late));
+}
+
+TEST(RenderGraph, Execute) {
+    RenderGraph graph;
+    u32 scene = graph.createTexture("Scene", COLOR);
+    u32 unused = graph.createTexture("Unused", COLOR);
+    u32 screen = graph.importTexture("Screen", {});
+    std::vector<std::string> executed;
+
+    u32 render = graph.addPass("Render", [&](const RenderGraphResources&) { executed.emplace_back("Render"); });
+    graph.write(render, scene);
+    u32 skipped = graph.addPass("Skipped", [&](const RenderGraphResources&) { executed.emplace_back("Skipped"); });
+    graph.write(skipped, unused);
+    u32 present = graph.addPass("Present", [&](const RenderGraphResources&) { executed.emplace_back("Present"); });
+    graph.read(present, scene);
+    graph.write(present, screen);
+    graph.setOutput(screen);
+    EXPECT(graph.compile());
+
+    // GPU scopes need GL context
+    bool isEnabled = Profiler::isEnabled;
+    Profiler::isEnabled = false;
+    graph.execute(NullResources());
+    Profiler::isEnabled = isEnabled;
+
+    // culled pass is skipped, the rest run in order of declaration
+    EXPECT(executed.size() == 2 && executed[0] == "Render" && executed[1] == "Present");
+}
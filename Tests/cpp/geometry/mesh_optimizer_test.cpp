@@ -0,0 +1,171 @@
+#include <test.h>
+
+#include <geometry/mesh_optimizer.h>
+
+using namespace gl;
+
+struct TestVertex final {
+    glm::vec3 pos;
+};
+
+// quads x quads grid, two triangles per quad in row order
+static void initGrid(u32 quads, std::vector<TestVertex>& vertices, std::vector<u32>& indices) {
+    u32 side = quads + 1;
+    for (u32 y = 0 ; y < side ; y++) {
+        for (u32 x = 0 ; x < side ; x++) {
+            vertices.push_back({ glm::vec3(x, y, 0) });
+        }
+    }
+
+    for (u32 y = 0 ; y < quads ; y++) {
+        for (u32 x = 0 ; x < quads ; x++) {
+            u32 i = y * side + x;
+            indices.insert(indices.end(), { i, i + 1, i + side, i + side, i + 1, i + side + 1 });
+        }
+    }
+}
+
+// Fisher-Yates with fixed LCG, so that order is the same on every standard library
+static void shuffleTriangles(std::vector<u32>& indices) {
+    u32 state = 12345;
+    for (size_t i = indices.size() / 3 - 1 ; i > 0 ; i--) {
+        state = state * 1664525u + 1013904223u;
+        size_t j = state % (i + 1);
+        std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+    }
+}
+
+static std::vector<std::array<u32, 3>> sortedTriangles(const std::vector<u32>& indices) {
+    std::vector<std::array<u32, 3>> triangles;
+    for (size_t i = 0 ; i < indices.size() ; i += 3) {
+        std::array<u32, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+        // rotation keeps winding, smallest index goes first
+        while (triangle[0] > triangle[1] || triangle[0] > triangle[2]) {
+            triangle = { triangle[1], triangle[2], triangle[0] };
+        }
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+TEST(MeshOptimizer, AnalyzeTriangle) {
+    u32 indices[] = { 0, 1, 2 };
+    VertexCacheStats stats = MeshOptimizer::analyzeVertexCache(indices, 3, 3);
+    EXPECT(stats.triangles == 1);
+    EXPECT(stats.transformed == 3);
+    EXPECT_NEAR(stats.acmr, 3.0f, 1e-6f);
+    EXPECT_NEAR(stats.atvr, 1.0f, 1e-6f);
+}
+
+TEST(MeshOptimizer, AnalyzeSharedEdge) {
+    u32 indices[] = { 0, 1, 2, 2, 1, 3 };
+    VertexCacheStats stats = MeshOptimizer::analyzeVertexCache(indices, 6, 4);
+    EXPECT(stats.transformed == 4);
+    EXPECT_NEAR(stats.acmr, 2.0f, 1e-6f);
+    EXPECT_NEAR(stats.atvr, 1.0f, 1e-6f);
+}
+
+TEST(MeshOptimizer, AnalyzeCacheEviction) {
+    // with 3 entries second triangle pushes out the first one, which is transformed again
+    u32 indices[] = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    VertexCacheStats stats = MeshOptimizer::analyzeVertexCache(indices, 9, 6, 3);
+    EXPECT(stats.transformed == 9);
+    EXPECT_NEAR(stats.acmr, 3.0f, 1e-6f);
+    EXPECT_NEAR(stats.atvr, 1.5f, 1e-6f);
+
+    // FIFO cache is not refreshed by hits, so 16 entries keep all six vertices
+    stats = MeshOptimizer::analyzeVertexCache(indices, 9, 6);
+    EXPECT(stats.transformed == 6);
+    EXPECT_NEAR(stats.atvr, 1.0f, 1e-6f);
+}
+
+TEST(MeshOptimizer, OptimizeGrid) {
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    initGrid(32, vertices, indices);
+    auto triangles = sortedTriangles(indices);
+
+    VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+    VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+    // row order transforms shared vertices of every row twice
+    EXPECT_NEAR(before.acmr, 1.031f, 0.005f);
+    EXPECT_NEAR(before.atvr, 1.939f, 0.005f);
+    EXPECT_NEAR(after.acmr, 0.688f, 0.005f);
+    EXPECT_NEAR(after.atvr, 1.294f, 0.005f);
+    EXPECT(after.acmr < before.acmr);
+    // same triangles with the same winding
+    EXPECT(sortedTriangles(indices) == triangles);
+}
+
+TEST(MeshOptimizer, OptimizeShuffledGrid) {
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    initGrid(32, vertices, indices);
+    shuffleTriangles(indices);
+    auto triangles = sortedTriangles(indices);
+
+    VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+    VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+    EXPECT_NEAR(before.acmr, 2.968f, 0.005f);
+    EXPECT_NEAR(before.atvr, 5.581f, 0.005f);
+    EXPECT_NEAR(after.acmr, 0.700f, 0.005f);
+    EXPECT_NEAR(after.atvr, 1.316f, 0.005f);
+    EXPECT(sortedTriangles(indices) == triangles);
+}
+
+TEST(MeshOptimizer, Deduplicate) {
+    // every quad has its own four vertices, as imported meshes with split normals
+    u32 quads = 8;
+    std::vector<TestVertex> gridVertices;
+    std::vector<u32> gridIndices;
+    initGrid(quads, gridVertices, gridIndices);
+
+    Vertices<TestVertex> vertices;
+    Indices indices;
+    vertices.init(gridIndices.size());
+    indices.init(gridIndices.size());
+    for (size_t i = 0 ; i < gridIndices.size() ; i++) {
+        vertices[i] = gridVertices[gridIndices[i]];
+        indices.indices[i] = i;
+    }
+
+    VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices.indices, indices.count, vertices.count);
+    MeshOptimizer::deduplicate(vertices, indices);
+    VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices.indices, indices.count, vertices.count);
+
+    EXPECT(vertices.count == (int) gridVertices.size());
+    EXPECT_NEAR(before.acmr, 3.0f, 1e-6f);
+    EXPECT_NEAR(before.atvr, 1.0f, 1e-6f);
+    EXPECT_NEAR(after.acmr, 1.016f, 0.005f);
+    EXPECT_NEAR(after.atvr, 1.605f, 0.005f);
+    for (size_t i = 0 ; i < gridIndices.size() ; i++) {
+        EXPECT(vertices[indices.indices[i]].pos == gridVertices[gridIndices[i]].pos);
+    }
+
+    vertices.free();
+    indices.free();
+}
+
+TEST(MeshOptimizer, VertexFetchOrder) {
+    u32 indices[] = { 4, 2, 0, 0, 2, 5 };
+    u32 remap[6];
+    size_t newCount = MeshOptimizer::remapVertexFetch(remap, indices, 6, 6);
+
+    // first use order, unused vertices 1 and 3 are dropped
+    EXPECT(newCount == 4);
+    EXPECT(remap[4] == 0);
+    EXPECT(remap[2] == 1);
+    EXPECT(remap[0] == 2);
+    EXPECT(remap[5] == 3);
+    EXPECT(remap[1] == MeshOptimizer::INVALID_INDEX);
+    EXPECT(remap[3] == MeshOptimizer::INVALID_INDEX);
+
+    MeshOptimizer::remapIndices(indices, 6, remap);
+    u32 expected[] = { 0, 1, 2, 2, 1, 3 };
+    EXPECT(std::equal(indices, indices + 6, expected));
+}
@@ -0,0 +1,134 @@
+#include <test.h>
+
+#include <geometry/mesh_simplifier.h>
+
+using namespace gl;
+
+struct UvVertex final {
+    glm::vec3 pos;
+    glm::vec2 uv;
+};
+
+// quadsX x quadsY grid starting at column x0, two triangles per quad in row order
+static void initGrid(u32 x0, u32 quadsX, u32 quadsY, std::vector<UvVertex>& vertices, std::vector<u32>& indices) {
+    u32 first = vertices.size();
+    u32 side = quadsX + 1;
+    for (u32 y = 0 ; y <= quadsY ; y++) {
+        for (u32 x = 0 ; x < side ; x++) {
+            vertices.push_back({ glm::vec3(x0 + x, y, 0), glm::vec2(x0, 0) });
+        }
+    }
+
+    for (u32 y = 0 ; y < quadsY ; y++) {
+        for (u32 x = 0 ; x < quadsX ; x++) {
+            u32 i = first + y * side + x;
+            indices.insert(indices.end(), { i, i + 1, i + side, i + side, i + 1, i + side + 1 });
+        }
+    }
+}
+
+static size_t simplify(const std::vector<UvVertex>& vertices, const std::vector<u32>& indices, std::vector<u32>& result, float& error) {
+    result.resize(indices.size());
+    size_t count = MeshSimplifier::simplify(
+            result.data(),
+            indices.data(), indices.size(),
+            (const u8*) vertices.data(), vertices.size(), sizeof(UvVertex),
+            0, 1e-3f,
+            error
+    );
+    result.resize(count);
+    return count;
+}
+
+static bool isFacingUp(const std::vector<UvVertex>& vertices, const std::vector<u32>& indices) {
+    for (size_t i = 0 ; i < indices.size() ; i += 3) {
+        glm::vec3 p0 = vertices[indices[i]].pos;
+        glm::vec3 p1 = vertices[indices[i + 1]].pos;
+        glm::vec3 p2 = vertices[indices[i + 2]].pos;
+        if (glm::cross(p1 - p0, p2 - p0).z <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(MeshSimplifier, Plane) {
+    std::vector<UvVertex> vertices;
+    std::vector<u32> indices;
+    initGrid(0, 8, 8, vertices, indices);
+
+    std::vector<u32> result;
+    float error = 0;
+    size_t count = simplify(vertices, indices, result, error);
+
+    // interior of flat grid collapses without error, border keeps the square
+    EXPECT(count < indices.size());
+    EXPECT(count % 3 == 0);
+    EXPECT_NEAR(error, 0.0f, 1e-4f);
+    EXPECT(isFacingUp(vertices, result));
+    for (u32 corner : { 0u, 8u, 72u, 80u }) {
+        EXPECT(std::find(result.begin(), result.end(), corner) != result.end());
+    }
+}
+
+TEST(MeshSimplifier, Seam) {
+    // two strips of one quad width with own UVs, seam at x = 1 and borders on both sides,
+    // so that only seam vertices are able to move
+    std::vector<UvVertex> vertices;
+    std::vector<u32> indices;
+    initGrid(0, 1, 8, vertices, indices);
+    u32 rightFirst = vertices.size();
+    initGrid(1, 1, 8, vertices, indices);
+
+    std::vector<u32> result;
+    float error = 0;
+    size_t count = simplify(vertices, indices, result, error);
+
+    EXPECT(count < indices.size());
+    EXPECT_NEAR(error, 0.0f, 1e-4f);
+    EXPECT(isFacingUp(vertices, result));
+
+    std::vector<glm::vec3> leftSeam;
+    std::vector<glm::vec3> rightSeam;
+    for (size_t i = 0 ; i < result.size() ; i += 3) {
+        // triangles never take vertices from other side of seam
+        bool isRight = result[i] >= rightFirst;
+        EXPECT(isRight == (result[i + 1] >= rightFirst) && isRight == (result[i + 2] >= rightFirst));
+
+        for (int k = 0 ; k < 3 ; k++) {
+            const UvVertex& vertex = vertices[result[i + k]];
+            EXPECT(vertex.uv.x == (isRight ? 1.0f : 0.0f));
+            if (vertex.pos.x == 1) {
+                (isRight ? rightSeam : leftSeam).push_back(vertex.pos);
+            }
+        }
+    }
+
+    // both sides keep the same seam vertices
+    auto less = [](const glm::vec3& l, const glm::vec3& r) { return l.y < r.y; };
+    std::sort(leftSeam.begin(), leftSeam.end(), less);
+    std::sort(rightSeam.begin(), rightSeam.end(), less);
+    leftSeam.erase(std::unique(leftSeam.begin(), leftSeam.end()), leftSeam.end());
+    rightSeam.erase(std::unique(rightSeam.begin(), rightSeam.end()), rightSeam.end());
+    EXPECT(leftSeam == rightSeam);
+    EXPECT(leftSeam.size() < 9);
+}
+
+TEST(MeshSimplifier, NonManifoldSeam) {
+    // three strips meet at x = 1, seam vertices have three wedges and stay where they are
+    std::vector<UvVertex> vertices;
+    std::vector<u32> indices;
+    initGrid(0, 1, 4, vertices, indices);
+    initGrid(1, 1, 4, vertices, indices);
+    // third strip goes away from plane of the other two
+    u32 first = vertices.size();
+    initGrid(1, 1, 4, vertices, indices);
+    for (u32 i = first ; i < vertices.size() ; i++) {
+        vertices[i].pos = glm::vec3(1, vertices[i].pos.y, 1 - vertices[i].pos.x);
+    }
+
+    std::vector<u32> result;
+    float error = 0;
+    size_t count = simplify(vertices, indices, result, error);
+    EXPECT(count == indices.size());
+}
@@ -0,0 +1,271 @@
+#include <test.h>
+
+#include <geometry/meshlet.h>
+
+using namespace gl;
+
+struct TestVertex final {
+    glm::vec3 pos;
+};
+
+// quads x quads grid in z = 0 plane facing +z, two triangles per quad in row order
+static void initGrid(u32 quads, std::vector<TestVertex>& vertices, std::vector<u32>& indices) {
+    u32 side = quads + 1;
+    for (u32 y = 0 ; y < side ; y++) {
+        for (u32 x = 0 ; x < side ; x++) {
+            vertices.push_back({ glm::vec3(x, y, 0) });
+        }
+    }
+
+    for (u32 y = 0 ; y < quads ; y++) {
+        for (u32 x = 0 ; x < quads ; x++) {
+            u32 i = y * side + x;
+            indices.insert(indices.end(), { i, i + 1, i + side, i + side, i + 1, i + side + 1 });
+        }
+    }
+}
+
+static void buildGrid(MeshletMesh& mesh, std::vector<TestVertex>& vertices, std::vector<u32>& indices) {
+    initGrid(32, vertices, indices);
+    MeshletBuilder::build(mesh, indices.data(), indices.size(), (const u8*) vertices.data(), vertices.size(), sizeof(TestVertex));
+}
+
+static Frustum getFrustum(const glm::vec3& eye, const glm::vec3& target, float fov) {
+    glm::mat4 projection = glm::perspective(glm::radians(fov), 1.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0, 1, 0));
+    return Frustum(projection * view);
+}
+
+// reference per triangle: visible if no frustum plane has all three vertices behind it
+// and, if backface is tested, its front side faces camera
+static bool isTriangleVisible(const glm::vec3 (&p)[3], const Frustum& frustum, const glm::vec3* cameraPosition) {
+    const Plane* planes[6] = { &frustum.leftFace, &frustum.rightFace, &frustum.bottomFace, &frustum.topFace, &frustum.nearFace, &frustum.farFace };
+    for (const Plane* plane : planes) {
+        if (plane->signedDistance(p[0]) < 0 && plane->signedDistance(p[1]) < 0 && plane->signedDistance(p[2]) < 0) {
+            return false;
+        }
+    }
+
+    if (cameraPosition) {
+        glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        return glm::dot(normal, p[0] - *cameraPosition) < 0;
+    }
+    return true;
+}
+
+static std::vector<bool> getReference(
+        const MeshletMesh& mesh,
+        const std::vector<TestVertex>& vertices,
+        const Frustum& frustum,
+        const glm::mat4& model,
+        const glm::vec3* cameraPosition
+) {
+    std::vector<bool> visible(mesh.meshlets.size(), false);
+    for (size_t m = 0 ; m < mesh.meshlets.size() ; m++) {
+        const Meshlet& meshlet = mesh.meshlets[m];
+        for (u32 t = 0 ; t < meshlet.triangleCount && !visible[m] ; t++) {
+            glm::vec3 p[3];
+            for (u32 v = 0 ; v < 3 ; v++) {
+                u8 local = mesh.triangles[(meshlet.triangleOffset + t) * 3 + v];
+                p[v] = glm::vec3(model * glm::vec4(vertices[mesh.vertices[meshlet.vertexOffset + local]].pos, 1));
+            }
+            visible[m] = isTriangleVisible(p, frustum, cameraPosition);
+        }
+    }
+    return visible;
+}
+
+// culling may keep invisible meshlets, but never drops one with a visible triangle
+static bool isConservative(const std::vector<bool>& reference, const std::vector<u32>& visible) {
+    std::vector<bool> culled(reference.size(), true);
+    for (u32 i : visible) {
+        culled[i] = false;
+    }
+    for (size_t i = 0 ; i < reference.size() ; i++) {
+        if (reference[i] && culled[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static u32 countVisible(const std::vector<bool>& reference) {
+    return std::count(reference.begin(), reference.end(), true);
+}
+
+TEST(Meshlet, BuildLimits) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    EXPECT(mesh.meshlets.size() == mesh.bounds.size());
+    EXPECT(mesh.meshlets.size() > 1);
+    u32 triangleOffset = 0;
+    for (const auto& meshlet : mesh.meshlets) {
+        EXPECT(meshlet.vertexCount <= MeshletBuilder::MAX_VERTICES);
+        EXPECT(meshlet.triangleCount <= MeshletBuilder::MAX_TRIANGLES);
+        // meshlets follow each other in index order
+        EXPECT(meshlet.triangleOffset == triangleOffset);
+        triangleOffset += meshlet.triangleCount;
+    }
+    EXPECT(triangleOffset * 3 == indices.size());
+}
+
+TEST(Meshlet, BuildTriangles) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    // local indices map back to source triangles in the same order
+    for (const auto& meshlet : mesh.meshlets) {
+        for (u32 i = 0 ; i < meshlet.triangleCount * 3 ; i++) {
+            u8 local = mesh.triangles[meshlet.triangleOffset * 3 + i];
+            EXPECT(local < meshlet.vertexCount);
+            EXPECT(mesh.vertices[meshlet.vertexOffset + local] == indices[meshlet.triangleOffset * 3 + i]);
+        }
+    }
+}
+
+TEST(Meshlet, BuildBounds) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    for (size_t m = 0 ; m < mesh.meshlets.size() ; m++) {
+        const Meshlet& meshlet = mesh.meshlets[m];
+        const MeshletBounds& bounds = mesh.bounds[m];
+        for (u32 i = 0 ; i < meshlet.vertexCount ; i++) {
+            glm::vec3 position = vertices[mesh.vertices[meshlet.vertexOffset + i]].pos;
+            EXPECT(glm::length(position - bounds.sphere.center) <= bounds.sphere.radius + 1e-4f);
+        }
+        // flat grid has zero wide cone around +z
+        EXPECT_NEAR(bounds.coneAxis.z, 1.0f, 1e-5f);
+        EXPECT_NEAR(bounds.coneCutoff, 0.0f, 1e-3f);
+    }
+}
+
+TEST(Meshlet, CullFront) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    glm::vec3 eye = { 16, 16, 40 };
+    Frustum frustum = getFrustum(eye, { 16, 16, 0 }, 60);
+    std::vector<u32> visible;
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1), eye);
+
+    auto reference = getReference(mesh, vertices, frustum, glm::mat4(1), &eye);
+    EXPECT(countVisible(reference) == mesh.meshlets.size());
+    EXPECT(visible.size() == mesh.meshlets.size());
+}
+
+TEST(Meshlet, CullBack) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    // grid seen from behind is rejected by normal cones, frustum test alone keeps all of it
+    glm::vec3 eye = { 16, 16, -40 };
+    Frustum frustum = getFrustum(eye, { 16, 16, 0 }, 60);
+    std::vector<u32> visible;
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1), eye);
+    EXPECT(countVisible(getReference(mesh, vertices, frustum, glm::mat4(1), &eye)) == 0);
+    EXPECT(visible.empty());
+
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1));
+    EXPECT(countVisible(getReference(mesh, vertices, frustum, glm::mat4(1), null)) == mesh.meshlets.size());
+    EXPECT(visible.size() == mesh.meshlets.size());
+}
+
+TEST(Meshlet, CullOutside) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    // camera above grid looks away from it, farther than meshlets of grid rows are wide
+    glm::vec3 eye = { 16, 16, 30 };
+    Frustum frustum = getFrustum(eye, { 16, 16, 40 }, 60);
+    std::vector<u32> visible;
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1), eye);
+    EXPECT(visible.empty());
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1));
+    EXPECT(visible.empty());
+}
+
+TEST(Meshlet, CullPartial) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    glm::vec3 eye = { 4, 4, 10 };
+    Frustum frustum = getFrustum(eye, { 4, 4, 0 }, 45);
+    std::vector<u32> visible;
+    MeshletCuller::cull(visible, mesh, frustum, glm::mat4(1), eye);
+
+    auto reference = getReference(mesh, vertices, frustum, glm::mat4(1), &eye);
+    EXPECT(countVisible(reference) > 0);
+    EXPECT(isConservative(reference, visible));
+    EXPECT(visible.size() < mesh.meshlets.size());
+}
+
+TEST(Meshlet, CullTransformed) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    // grid is moved and scaled, camera looks at a corner of it in world space
+    glm::mat4 model = glm::scale(glm::translate(glm::mat4(1), glm::vec3(-50, 20, -5)), glm::vec3(2, 2, 2));
+    glm::vec3 eye = { -40, 30, 15 };
+    Frustum frustum = getFrustum(eye, { -42, 28, -5 }, 50);
+    std::vector<u32> visible;
+
+    MeshletCuller::cull(visible, mesh, frustum, model, eye);
+    auto reference = getReference(mesh, vertices, frustum, model, &eye);
+    EXPECT(countVisible(reference) > 0);
+    EXPECT(isConservative(reference, visible));
+    EXPECT(visible.size() < mesh.meshlets.size());
+
+    MeshletCuller::cull(visible, mesh, frustum, model);
+    EXPECT(isConservative(getReference(mesh, vertices, frustum, model, null), visible));
+}
+
+TEST(Meshlet, Ranges) {
+    MeshletMesh mesh;
+    std::vector<TestVertex> vertices;
+    std::vector<u32> indices;
+    buildGrid(mesh, vertices, indices);
+
+    std::vector<u32> visible;
+    std::vector<MeshletRange> ranges;
+    for (u32 i = 0 ; i < mesh.meshlets.size() ; i++) {
+        visible.emplace_back(i);
+    }
+    MeshletCuller::getRanges(ranges, mesh, visible);
+    EXPECT(ranges.size() == 1);
+    EXPECT(ranges[0].firstIndex == 0);
+    EXPECT(ranges[0].indexCount == indices.size());
+
+    // every other meshlet gives one range per meshlet
+    visible.clear();
+    for (u32 i = 0 ; i < mesh.meshlets.size() ; i += 2) {
+        visible.emplace_back(i);
+    }
+    MeshletCuller::getRanges(ranges, mesh, visible);
+    EXPECT(ranges.size() == visible.size());
+    for (size_t i = 0 ; i < ranges.size() ; i++) {
+        const Meshlet& meshlet = mesh.meshlets[visible[i]];
+        EXPECT(ranges[i].firstIndex == meshlet.triangleOffset * 3);
+        EXPECT(ranges[i].indexCount == meshlet.triangleCount * 3);
+    }
+
+    MeshletCuller::getRanges(ranges, mesh, {});
+    EXPECT(ranges.empty());
+}
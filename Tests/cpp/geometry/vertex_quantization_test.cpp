@@ -0,0 +1,182 @@
+#include <test.h>
+
+#include <geometry/vertex_quantization.h>
+
+using namespace gl;
+
+static float angle(const glm::vec3& a, const glm::vec3& b) {
+    // atan2 keeps precision for tiny angles, where acos of dot is flat
+    return glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+}
+
+// evenly spread unit vectors, both poles and octahedron edges included
+static std::vector<glm::vec3> getDirections() {
+    std::vector<glm::vec3> directions = {
+            { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 },
+            glm::normalize(glm::vec3(1, 1, 0)), glm::normalize(glm::vec3(-1, 1, 0)),
+            glm::normalize(glm::vec3(1, -1, -1)), glm::normalize(glm::vec3(-1, -1, -1))
+    };
+    u32 count = 4096;
+    float golden = glm::pi<float>() * (3 - std::sqrt(5.0f));
+    for (u32 i = 0 ; i < count ; i++) {
+        float z = 1 - 2 * (i + 0.5f) / count;
+        float r = std::sqrt(1 - z * z);
+        directions.push_back({ r * std::cos(golden * i), r * std::sin(golden * i), z });
+    }
+    return directions;
+}
+
+TEST(VertexQuantization, Unorm16) {
+    float maxError = 0;
+    for (u32 i = 0 ; i <= 10000 ; i++) {
+        float v = i / 10000.0f;
+        maxError = std::max(maxError, std::abs(VertexQuantizer::decodeUnorm16(VertexQuantizer::encodeUnorm16(v)) - v));
+    }
+    EXPECT(maxError <= 0.5f / 65535.0f + 1e-7f);
+    EXPECT(VertexQuantizer::encodeUnorm16(-1) == 0);
+    EXPECT(VertexQuantizer::encodeUnorm16(2) == 65535);
+}
+
+TEST(VertexQuantization, Snorm16) {
+    float maxError = 0;
+    for (int i = -10000 ; i <= 10000 ; i++) {
+        float v = i / 10000.0f;
+        maxError = std::max(maxError, std::abs(VertexQuantizer::decodeSnorm16(VertexQuantizer::encodeSnorm16(v)) - v));
+    }
+    EXPECT(maxError <= 0.5f / 32767.0f + 1e-7f);
+    EXPECT(VertexQuantizer::decodeSnorm16(-32768) == -1.0f);
+    EXPECT(VertexQuantizer::decodeSnorm16(0) == 0.0f);
+}
+
+TEST(VertexQuantization, Unorm8) {
+    float maxError = 0;
+    for (u32 i = 0 ; i <= 1000 ; i++) {
+        float v = i / 1000.0f;
+        maxError = std::max(maxError, std::abs(VertexQuantizer::decodeUnorm8(VertexQuantizer::encodeUnorm8(v)) - v));
+    }
+    EXPECT(maxError <= 0.5f / 255.0f + 1e-7f);
+}
+
+TEST(VertexQuantization, Position) {
+    Bounds bounds;
+    bounds.add({ -3, 0.5f, -100 });
+    bounds.add({ 5, 0.75f, 20 });
+    VertexDequantization dequantization = VertexQuantizer::dequantization(bounds);
+    EXPECT(dequantization.enabled);
+
+    // half a step of unorm16 on every axis
+    glm::vec3 maxAxisError = bounds.extent() * (0.5f / 65535.0f);
+    glm::vec3 maxError = { 0, 0, 0 };
+    u32 steps = 16;
+    for (u32 x = 0 ; x <= steps ; x++) {
+        for (u32 y = 0 ; y <= steps ; y++) {
+            for (u32 z = 0 ; z <= steps ; z++) {
+                glm::vec3 t = glm::vec3(x, y, z) / (float) steps;
+                glm::vec3 position = bounds.min + bounds.extent() * t;
+                glm::vec3 decoded = VertexQuantizer::decodePosition(VertexQuantizer::encodePosition(position, dequantization), dequantization);
+                maxError = glm::max(maxError, glm::abs(decoded - position));
+            }
+        }
+    }
+    for (int i = 0 ; i < 3 ; i++) {
+        EXPECT(maxError[i] <= maxAxisError[i] * 1.01f + 1e-6f);
+    }
+}
+
+TEST(VertexQuantization, FlatPosition) {
+    // flat axis stays invertible and decodes to its only value
+    Bounds bounds;
+    bounds.add({ 0, 2, 0 });
+    bounds.add({ 1, 2, 1 });
+    VertexDequantization dequantization = VertexQuantizer::dequantization(bounds);
+    glm::vec3 position = { 0.25f, 2, 0.5f };
+    glm::vec3 decoded = VertexQuantizer::decodePosition(VertexQuantizer::encodePosition(position, dequantization), dequantization);
+    EXPECT_NEAR(decoded.y, 2.0f, 1e-6f);
+    EXPECT(glm::length(decoded - position) <= 1e-4f);
+}
+
+TEST(VertexQuantization, Direction) {
+    // octahedral snorm16 directions stay within a hundredth of degree
+    float maxAngle = 0;
+    for (const auto& direction : getDirections()) {
+        glm::vec3 decoded = VertexQuantizer::decodeDirection(VertexQuantizer::encodeDirection(direction));
+        EXPECT_NEAR(glm::length(decoded), 1.0f, 1e-5f);
+        maxAngle = std::max(maxAngle, angle(decoded, direction));
+    }
+    EXPECT(maxAngle <= 0.01f);
+}
+
+TEST(VertexQuantization, UV) {
+    // half floats keep 11 significant bits, tiled UVs up to 8 keep relative error of 2^-11
+    float maxRelativeError = 0;
+    for (int i = -8000 ; i <= 8000 ; i++) {
+        glm::vec2 uv = { i / 1000.0f, 1 - i / 8000.0f };
+        glm::vec2 decoded = VertexQuantizer::decodeUV(VertexQuantizer::encodeUV(uv));
+        for (int k = 0 ; k < 2 ; k++) {
+            if (std::abs(uv[k]) > 1e-3f) {
+                maxRelativeError = std::max(maxRelativeError, std::abs(decoded[k] - uv[k]) / std::abs(uv[k]));
+            } else {
+                EXPECT(std::abs(decoded[k] - uv[k]) <= 1e-6f);
+            }
+        }
+    }
+    EXPECT(maxRelativeError <= 1.0f / 2048.0f);
+}
+
+TEST(VertexQuantization, Bones) {
+    glm::ivec4 ids = { 3, 7, 250, -1 };
+    glm::vec4 weights = { 0.5f, 0.3f, 0.2f, 0.9f };
+    glm::u8vec4 encodedIds;
+    glm::u8vec4 encodedWeights;
+    VertexQuantizer::encodeBones(ids, weights, encodedIds, encodedWeights);
+
+    glm::ivec4 decodedIds;
+    glm::vec4 decodedWeights;
+    VertexQuantizer::decodeBones(encodedIds, encodedWeights, decodedIds, decodedWeights);
+
+    // unused influence is dropped, others keep ids
+    EXPECT(decodedIds[0] == 3);
+    EXPECT(decodedIds[1] == 7);
+    EXPECT(decodedIds[2] == 250);
+    EXPECT(decodedIds[3] == -1);
+    EXPECT(encodedWeights[0] + encodedWeights[1] + encodedWeights[2] + encodedWeights[3] == 255);
+    EXPECT_NEAR(decodedWeights[0], 0.5f, 1.0f / 255.0f);
+    EXPECT_NEAR(decodedWeights[1], 0.3f, 1.0f / 255.0f);
+    EXPECT_NEAR(decodedWeights[2], 0.2f, 1.0f / 255.0f);
+    EXPECT(decodedWeights[3] == 0.0f);
+}
+
+TEST(VertexQuantization, BoneWeights) {
+    // renormalized weights sum exactly to 255, rounding error of all influences goes into the largest one
+    u32 state = 12345;
+    float maxError = 0;
+    for (u32 i = 0 ; i < 10000 ; i++) {
+        glm::vec4 weights;
+        float sum = 0;
+        for (int k = 0 ; k < 4 ; k++) {
+            state = state * 1664525u + 1013904223u;
+            weights[k] = (state >> 8) / 16777216.0f;
+            sum += weights[k];
+        }
+
+        glm::u8vec4 encodedIds;
+        glm::u8vec4 encodedWeights;
+        VertexQuantizer::encodeBones({ 0, 1, 2, 3 }, weights, encodedIds, encodedWeights);
+        glm::ivec4 decodedIds;
+        glm::vec4 decodedWeights;
+        VertexQuantizer::decodeBones(encodedIds, encodedWeights, decodedIds, decodedWeights);
+
+        EXPECT(encodedWeights[0] + encodedWeights[1] + encodedWeights[2] + encodedWeights[3] == 255);
+        for (int k = 0 ; k < 4 && sum > 0 ; k++) {
+            maxError = std::max(maxError, std::abs(decodedWeights[k] - weights[k] / sum));
+        }
+    }
+    EXPECT(maxError <= 2.0f / 255.0f);
+}
+
+TEST(VertexQuantization, NoBones) {
+    glm::u8vec4 encodedIds;
+    glm::u8vec4 encodedWeights;
+    VertexQuantizer::encodeBones({ -1, -1, -1, -1 }, { 0, 0, 0, 0 }, encodedIds, encodedWeights);
+    EXPECT(encodedWeights[0] + encodedWeights[1] + encodedWeights[2] + encodedWeights[3] == 0);
+}
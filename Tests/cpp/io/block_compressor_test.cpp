@@ -0,0 +1,150 @@
+#include <test.h>
+
+#include <io/texture_cooker.h>
+
+using namespace gl;
+
+static constexpr BlockFormat FORMATS[] = { BC1, BC3, BC5, BC7 };
+
+// smooth color gradients with low amplitude noise, as typical albedo texture
+static std::vector<u8> initGradient(int width, int height, bool alpha) {
+    std::vector<u8> rgba(width * height * 4);
+    u32 state = 12345;
+    for (int y = 0 ; y < height ; y++) {
+        for (int x = 0 ; x < width ; x++) {
+            state = state * 1664525u + 1013904223u;
+            int noise = (int) (state >> 29) - 4;
+            u8* p = &rgba[(y * width + x) * 4];
+            p[0] = (u8) std::clamp(x * 255 / (width - 1) + noise, 0, 255);
+            p[1] = (u8) std::clamp(y * 255 / (height - 1) + noise, 0, 255);
+            p[2] = (u8) std::clamp((x + y) * 255 / (width + height - 2) - noise, 0, 255);
+            p[3] = alpha ? (u8) (255 - x * 255 / (width - 1)) : 255;
+        }
+    }
+    return rgba;
+}
+
+static int getMaxError(const std::vector<u8>& rgba, const std::vector<u8>& decoded, int channels) {
+    int maxError = 0;
+    for (size_t i = 0 ; i < rgba.size() ; i += 4) {
+        for (int c = 0 ; c < channels ; c++) {
+            maxError = std::max(maxError, std::abs((int) rgba[i + c] - (int) decoded[i + c]));
+        }
+    }
+    return maxError;
+}
+
+TEST(BlockCompressor, Size) {
+    EXPECT(BlockCompressor::getBlockBytes(BC1) == 8);
+    EXPECT(BlockCompressor::getBlockBytes(BC3) == 16);
+    EXPECT(BlockCompressor::getBlockBytes(BC5) == 16);
+    EXPECT(BlockCompressor::getBlockBytes(BC7) == 16);
+    // partial blocks at edges take whole blocks
+    EXPECT(BlockCompressor::getSize(4, 4, BC1) == 8);
+    EXPECT(BlockCompressor::getSize(5, 3, BC1) == 16);
+    EXPECT(BlockCompressor::getSize(1, 1, BC7) == 16);
+    EXPECT(BlockCompressor::getSize(64, 32, BC7) == 16 * 16 * 8);
+}
+
+TEST(BlockCompressor, SolidColor) {
+    // solid blocks lose only precision of endpoints: 5:6:5 for BC1, none for BC4/BC5 and 7-bit with p-bit for BC7
+    int width = 8;
+    int height = 8;
+    std::vector<u8> rgba(width * height * 4);
+    for (size_t i = 0 ; i < rgba.size() ; i += 4) {
+        rgba[i] = 200;
+        rgba[i + 1] = 100;
+        rgba[i + 2] = 37;
+        rgba[i + 3] = 128;
+    }
+
+    int maxErrors[] = { 4, 4, 0, 1 };
+    int channels[] = { 3, 4, 2, 4 };
+    for (int f = 0 ; f < 4 ; f++) {
+        std::vector<u8> blocks;
+        std::vector<u8> decoded;
+        BlockCompressor::compress(rgba.data(), width, height, FORMATS[f], blocks);
+        BlockCompressor::decompress(blocks.data(), width, height, FORMATS[f], decoded);
+        EXPECT(blocks.size() == BlockCompressor::getSize(width, height, FORMATS[f]));
+        EXPECT(getMaxError(rgba, decoded, channels[f]) <= maxErrors[f]);
+    }
+}
+
+TEST(BlockCompressor, Quality) {
+    // PSNR over channels kept by format, BC1 is bound by 5:6:5 endpoints and 2-bit indices
+    int width = 128;
+    int height = 128;
+    std::vector<u8> opaque = initGradient(width, height, false);
+    std::vector<u8> translucent = initGradient(width, height, true);
+
+    EXPECT(BlockCompressor::measure(opaque.data(), width, height, BC1).psnr >= 38.0);
+    EXPECT(BlockCompressor::measure(translucent.data(), width, height, BC3).psnr >= 38.0);
+    EXPECT(BlockCompressor::measure(opaque.data(), width, height, BC5).psnr >= 50.0);
+    EXPECT(BlockCompressor::measure(translucent.data(), width, height, BC7).psnr >= 41.0);
+}
+
+TEST(BlockCompressor, UnalignedSize) {
+    // edge blocks are padded by clamping and cropped on decode, so quality stays close to aligned image
+    int width = 13;
+    int height = 7;
+    std::vector<u8> gradient = initGradient(64, 64, true);
+    std::vector<u8> rgba;
+    for (int y = 0 ; y < height ; y++) {
+        rgba.insert(rgba.end(), gradient.begin() + y * 64 * 4, gradient.begin() + (y * 64 + width) * 4);
+    }
+    for (BlockFormat format : FORMATS) {
+        std::vector<u8> blocks;
+        std::vector<u8> decoded;
+        BlockCompressor::compress(rgba.data(), width, height, format, blocks);
+        BlockCompressor::decompress(blocks.data(), width, height, format, decoded);
+        EXPECT(blocks.size() == BlockCompressor::getSize(width, height, format));
+        EXPECT(decoded.size() == rgba.size());
+        EXPECT(BlockCompressor::measure(rgba.data(), width, height, format).psnr >= 35.0);
+    }
+}
+
+TEST(BlockCompressor, Speed) {
+    // loose bound, so that only order of magnitude regressions fail on slow or instrumented builds
+    int width = 256;
+    int height = 256;
+    std::vector<u8> rgba = initGradient(width, height, true);
+    for (BlockFormat format : FORMATS) {
+        CompressionStats stats = BlockCompressor::measure(rgba.data(), width, height, format);
+        EXPECT(stats.milliseconds > 0);
+        EXPECT(stats.milliseconds < 2000.0);
+    }
+}
+
+TEST(BlockCompressor, CookRejectsNonU8) {
+    Image image;
+    image.width = 4;
+    image.height = 4;
+    image.channels = 4;
+    image.pixelType = PixelType::FLOAT;
+    std::vector<float> pixels(4 * 4 * 4, 1.0f);
+    image.pixels = pixels.data();
+
+    std::vector<Image> mips;
+    EXPECT(!TextureCooker::generateMips(image, {}, mips));
+    EXPECT(mips.empty());
+}
+
+TEST(BlockCompressor, CookMips) {
+    Image image;
+    image.width = 16;
+    image.height = 4;
+    image.channels = 3;
+    image.pixelType = PixelType::U8;
+    std::vector<u8> pixels(16 * 4 * 3, 100);
+    image.pixels = pixels.data();
+
+    std::vector<Image> mips;
+    EXPECT(TextureCooker::generateMips(image, {}, mips));
+    // full chain down to 1x1, every level is RGBA8
+    EXPECT(mips.size() == 5);
+    for (auto& mip : mips) {
+        EXPECT(mip.channels == 4);
+        mip.free();
+    }
+    EXPECT(TextureCooker::chooseFormat(image, {}) == BC1);
+}
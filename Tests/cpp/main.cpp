@@ -0,0 +1,17 @@
+#include <test.h>
+
+// Tests [suite], runs every test without suite
+int main(int argc, char** argv) {
+
+#ifdef DEBUG
+    Logger::init("Tests", 32);
+#endif
+
+    int failedTests = gl::TestRegistry::run(argc > 1 ? argv[1] : null);
+
+#ifdef DEBUG
+    Logger::free();
+#endif
+
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include <test.h>
+
+namespace gl {
+
+    u32 TestRegistry::s_failures = 0;
+
+    std::vector<TestCase>& TestRegistry::getTests() {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    void TestRegistry::fail(const char* file, int line, const char* expression) {
+        s_failures++;
+        printf("    %s:%d: failed %s\n", file, line, expression);
+    }
+
+    void TestRegistry::failNear(const char* file, int line, const char* expression, double actual, double expected, double epsilon) {
+        s_failures++;
+        printf("    %s:%d: %s is %f, expected %f +- %f\n", file, line, expression, actual, expected, epsilon);
+    }
+
+    int TestRegistry::run(const char* suite) {
+        int failedTests = 0;
+        u32 testCount = 0;
+
+        for (const auto& test : getTests()) {
+            if (suite && strcmp(suite, test.suite) != 0) {
+                continue;
+            }
+
+            u32 failures = s_failures;
+            test.function();
+            testCount++;
+
+            bool passed = failures == s_failures;
+            printf("[%s] %s.%s\n", passed ? "PASSED" : "FAILED", test.suite, test.name);
+            if (!passed) {
+                failedTests++;
+            }
+        }
+
+        if (testCount == 0) {
+            printf("No tests in suite %s\n", suite ? suite : "");
+            return 1;
+        }
+
+        printf("%u tests, %d failed\n", testCount, failedTests);
+        return failedTests;
+    }
+
+    TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction function) {
+        TestRegistry::getTests().push_back({ suite, name, function });
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace gl {
+
+    typedef void (*TestFunction)();
+
+    struct TestCase final {
+        const char* suite;
+        const char* name;
+        TestFunction function;
+    };
+
+    // TEST registers every test case before main, run filters them by suite
+    struct TestRegistry final {
+        static std::vector<TestCase>& getTests();
+
+        static void fail(const char* file, int line, const char* expression);
+        static void failNear(const char* file, int line, const char* expression, double actual, double expected, double epsilon);
+
+        // runs tests of suite or all tests if suite is null, returns number of failed tests
+        static int run(const char* suite);
+
+    private:
+        static u32 s_failures;
+    };
+
+    struct TestRegistrar final {
+        TestRegistrar(const char* suite, const char* name, TestFunction function);
+    };
+
+}
+
+#define TEST(suite, name) \
+static void suite##_##name(); \
+static gl::TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+static void suite##_##name()
+
+#define EXPECT(condition) \
+do { if (!(condition)) gl::TestRegistry::fail(__FILE__, __LINE__, #condition); } while (false)
+
+#define EXPECT_NEAR(actual, expected, epsilon) \
+do { \
+    double testActual = (double) (actual); \
+    double testExpected = (double) (expected); \
+    if (!(std::abs(testActual - testExpected) <= (double) (epsilon))) \
+        gl::TestRegistry::failNear(__FILE__, __LINE__, #actual, testActual, testExpected, (double) (epsilon)); \
+} while (false)